@@ -86,6 +86,8 @@ typedef double MaxAlignmentType;
 #include "Hashing.hpp"
 #include "HashMap.hpp"
 #include "HashSet.hpp"
+#include "FlatHashMap.hpp"
+#include "FlatHashSet.hpp"
 #include "SlotMap.hpp"
 #include "Block.hpp"
 #include "Graph.hpp"
@@ -211,6 +213,8 @@ namespace Plasma
 #include "OsHandle.hpp"
 #include "Thread.hpp"
 #include "ThreadSync.hpp"
+#include "ThreadCachingPool.hpp"
+#include "FrameArena.hpp"
 #include "CrashHandler.hpp"
 #include "Debug.hpp"
 #include "DebugSymbolInformation.hpp"
@@ -220,6 +224,7 @@ namespace Plasma
 #include "FilePath.hpp"
 #include "FileSystem.hpp"
 #include "FpControl.hpp"
+#include "MappedFile.hpp"
 #include "Lock.hpp"
 #include "Process.hpp"
 #include "Resolution.hpp"
@@ -243,4 +248,5 @@ namespace Plasma
 #include "WebRequest.hpp"
 
 #include "ThreadableLoop.hpp"
+#include "ParallelFor.hpp"
 #include "Git.hpp"
@@ -0,0 +1,300 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+#include "HashMap.hpp"
+#include "FlatHashedContainer.hpp"
+
+namespace Plasma
+{
+
+/// Flat Hash Map is a HashMap stored in an open addressing table (see
+/// FlatHashedContainer). It has the same interface as HashMap and is faster
+/// for lookup heavy maps, especially on misses. Values are stored inline, so
+/// pointers to them are invalidated whenever the table grows.
+template <typename KeyType,
+          typename DataType,
+          typename Hasher = HashPolicy<KeyType>,
+          typename Allocator = DefaultAllocator>
+class PlasmaSharedTemplate FlatHashMap
+    : public FlatHashedContainer<Pair<KeyType, DataType>, PairHashAdapter<Hasher, KeyType, DataType>, Allocator>
+{
+public:
+  typedef KeyType key_type;
+  typedef DataType data_type;
+  typedef FlatHashMap<KeyType, DataType> this_type;
+  typedef Pair<KeyType, DataType> value_type;
+  typedef Pair<KeyType, DataType> pair;
+  typedef size_t size_type;
+  typedef data_type& reference;
+  typedef FlatHashedContainer<value_type, PairHashAdapter<Hasher, KeyType, DataType>, Allocator> base_type;
+  typedef value_type* iterator;
+  typedef typename base_type::range range;
+
+  typedef typename base_type::InsertResult InsertResult;
+
+  FlatHashMap()
+  {
+  }
+
+  ~FlatHashMap()
+  {
+  }
+
+  struct valuerange
+  {
+    typedef data_type value_type;
+    typedef reference FrontResult;
+
+    range r;
+    valuerange()
+    {
+    }
+    valuerange(const typename base_type::range& _r) : r(_r)
+    {
+    }
+    bool Empty()
+    {
+      return r.Empty();
+    }
+    void PopFront()
+    {
+      return r.PopFront();
+    }
+    size_type Size()
+    {
+      return r.Size();
+    }
+    size_type Length()
+    {
+      return r.Size();
+    }
+    reference Front()
+    {
+      return r.Front().second;
+    }
+    valuerange& All()
+    {
+      return *this;
+    }
+    const valuerange& All() const
+    {
+      return *this;
+    }
+  };
+
+  struct keyrange
+  {
+    typedef key_type value_type;
+    typedef value_type& FrontResult;
+    range r;
+    keyrange()
+    {
+    }
+    keyrange(const typename base_type::range& _r) : r(_r)
+    {
+    }
+    bool Empty()
+    {
+      return r.Empty();
+    }
+    void PopFront()
+    {
+      return r.PopFront();
+    }
+    size_type Size()
+    {
+      return r.Size();
+    }
+    size_type Length()
+    {
+      return r.Size();
+    }
+    value_type& Front()
+    {
+      return r.Front().first;
+    }
+    keyrange& All()
+    {
+      return *this;
+    }
+    const keyrange& All() const
+    {
+      return *this;
+    }
+  };
+
+  /// range of all the values in the map.
+  valuerange Values() const
+  {
+    return valuerange(base_type::All());
+  }
+
+  /// range of all the keys in the map.
+  keyrange Keys() const
+  {
+    return keyrange(base_type::All());
+  }
+
+  data_type& operator[](const key_type& key)
+  {
+    value_type* found = base_type::InternalFindAs(key, base_type::mHasher);
+    if (found != nullptr)
+    {
+      return found->second;
+    }
+    else
+    {
+      value_type newType(key, data_type());
+      return base_type::InsertInternal(newType, base_type::OnCollisionOverride).mValue->second;
+    }
+  }
+
+  InsertResult Insert(const value_type& datapair)
+  {
+    return base_type::InsertInternal(datapair, base_type::OnCollisionOverride);
+  }
+
+  InsertResult Insert(const key_type& key, const data_type& value)
+  {
+    return base_type::InsertInternal(value_type(key, value), base_type::OnCollisionOverride);
+  }
+
+  void Insert(range pair_range)
+  {
+    for (; !pair_range.Empty(); pair_range.PopFront())
+    {
+      base_type::InsertInternal(pair_range.Front(), base_type::OnCollisionOverride);
+    }
+  }
+
+  bool InsertOrError(const value_type& datapair)
+  {
+    return base_type::InsertInternal(datapair, base_type::OnCollisionError) != false;
+  }
+
+  bool InsertOrError(const key_type& key, const data_type& value)
+  {
+    return base_type::InsertInternal(value_type(key, value), base_type::OnCollisionError) != false;
+  }
+
+  template <typename VType>
+  bool InsertOrError(const VType& value, cstr error)
+  {
+    (void)error;
+    bool result = InsertOrError(value);
+    ErrorIf(result == false, "%s", error);
+    return result;
+  }
+
+  template <typename KType, typename VType>
+  bool InsertOrError(const KType& key, const VType& value, cstr error)
+  {
+    return InsertOrError(value_type(key, value), error);
+  }
+
+  InsertResult InsertNoOverwrite(const value_type& datapair)
+  {
+    return base_type::InsertInternal(datapair, base_type::OnCollisionReturn);
+  }
+
+  InsertResult InsertNoOverwrite(const key_type& key, const data_type& value)
+  {
+    return base_type::InsertInternal(value_type(key, value), base_type::OnCollisionReturn);
+  }
+
+  template <typename searchType, typename searchHasher>
+  range FindAs(const searchType& searchKey, searchHasher keyHasher = HashPolicy<searchType>())
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, PairHashAdapter<searchHasher, searchType, DataType>());
+    return FoundRange(found);
+  }
+
+  range Find(const key_type& searchKey) const
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, base_type::mHasher);
+    return FoundRange(found);
+  }
+
+  bool TryGetValue(const key_type& searchKey, data_type& valueOut)
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, base_type::mHasher);
+    if (found != nullptr)
+    {
+      valueOut = found->second;
+      return true;
+    }
+    else
+      return false;
+  }
+
+  bool Erase(const key_type& searchKey)
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, base_type::mHasher);
+    if (found != nullptr)
+    {
+      base_type::EraseSlot(found);
+      return true;
+    }
+    return false;
+  }
+
+  size_t Count(const key_type& searchKey)
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, base_type::mHasher);
+    if (found != nullptr)
+      return 1;
+    else
+      return 0;
+  }
+
+  data_type FindValue(const key_type& searchKey, const data_type& ifNotFound) const
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, base_type::mHasher);
+    if (found != nullptr)
+      return found->second;
+    else
+      return ifNotFound;
+  }
+
+  // Returns a pointer to the value if found, or null if not found
+  data_type* FindPointer(const key_type& searchKey, data_type* ifNotFound = nullptr) const
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, base_type::mHasher);
+    if (found != nullptr)
+      return &(found->second);
+    else
+      return ifNotFound;
+  }
+
+  bool ContainsKey(const key_type& searchKey) const
+  {
+    return base_type::InternalFindAs(searchKey, base_type::mHasher) != nullptr;
+  }
+
+  FlatHashMap(const FlatHashMap& other)
+  {
+    *this = other;
+  }
+
+  void operator=(const FlatHashMap& other)
+  {
+    this->Clear();
+    range r = other.All();
+    while (!r.Empty())
+    {
+      Insert(r.Front());
+      r.PopFront();
+    }
+  }
+
+private:
+  // A range over a single found value (or an empty range)
+  range FoundRange(value_type* found) const
+  {
+    if (found == nullptr)
+      return range();
+    size_type index = found - base_type::mSlots;
+    return range(base_type::mControl, base_type::mSlots, index, index + 1, 1);
+  }
+};
+
+} // namespace Plasma
@@ -0,0 +1,181 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+#include "HashSet.hpp"
+#include "FlatHashedContainer.hpp"
+
+namespace Plasma
+{
+
+/// Flat Hash Set is a HashSet stored in an open addressing table (see
+/// FlatHashedContainer). It has the same interface as HashSet and is faster
+/// for lookup heavy sets, especially on misses.
+template <typename ValueType, typename Hasher = HashPolicy<ValueType>, typename Allocator = DefaultAllocator>
+class PlasmaSharedTemplate FlatHashSet
+    : public FlatHashedContainer<ValueType, SetHashAdapter<Hasher, ValueType>, Allocator>
+{
+public:
+  typedef ValueType value_type;
+  typedef size_t size_type;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef FlatHashSet<ValueType, Hasher, Allocator> this_type;
+  typedef FlatHashedContainer<ValueType, SetHashAdapter<Hasher, ValueType>, Allocator> base_type;
+  typedef value_type* iterator;
+  typedef typename base_type::range range;
+
+  FlatHashSet()
+  {
+  }
+  FlatHashSet(ContainerInitializerDummy*, const_reference p0)
+  {
+    Insert(p0);
+  }
+  FlatHashSet(ContainerInitializerDummy*, const_reference p0, const_reference p1)
+  {
+    Insert(p0);
+    Insert(p1);
+  }
+  FlatHashSet(ContainerInitializerDummy*, const_reference p0, const_reference p1, const_reference p2)
+  {
+    Insert(p0);
+    Insert(p1);
+    Insert(p2);
+  }
+  FlatHashSet(ContainerInitializerDummy*, const_reference p0, const_reference p1, const_reference p2, const_reference p3)
+  {
+    Insert(p0);
+    Insert(p1);
+    Insert(p2);
+    Insert(p3);
+  }
+  FlatHashSet(ContainerInitializerDummy*,
+          const_reference p0,
+          const_reference p1,
+          const_reference p2,
+          const_reference p3,
+          const_reference p4)
+  {
+    Insert(p0);
+    Insert(p1);
+    Insert(p2);
+    Insert(p3);
+    Insert(p4);
+  }
+  FlatHashSet(ContainerInitializerDummy*,
+          const_reference p0,
+          const_reference p1,
+          const_reference p2,
+          const_reference p3,
+          const_reference p4,
+          const_reference p5)
+  {
+    Insert(p0);
+    Insert(p1);
+    Insert(p2);
+    Insert(p3);
+    Insert(p4);
+    Insert(p5);
+  }
+
+  /// Warning: Depending on the contents of the hash sets, this may be
+  /// expensive.
+  FlatHashSet(const FlatHashSet& other)
+  {
+    *this = other;
+  }
+
+  /// Warning: Depending on the contents of the hash sets, this may be
+  /// expensive.
+  void operator=(const FlatHashSet& other)
+  {
+    // Don't self Assign
+    if (&other == this)
+      return;
+
+    this->Clear();
+    range r = other.All();
+    while (!r.Empty())
+    {
+      base_type::InsertInternal(r.Front(), base_type::OnCollisionOverride);
+      r.PopFront();
+    }
+  }
+
+  range Find(const value_type& value)
+  {
+    // searching for the actual type of the container.
+    return FoundRange(base_type::InternalFindAs(value, base_type::mHasher));
+  }
+
+  template <typename searchType, typename searchHasher>
+  range FindAs(const searchType& searchKey, searchHasher keyHasher = HashPolicy<searchType>()) const
+  {
+    return FoundRange(base_type::InternalFindAs(searchKey, keyHasher));
+  }
+
+  value_type FindValue(const value_type& searchKey, const value_type& ifNotFound) const
+  {
+    value_type* found = base_type::InternalFindAs(searchKey, base_type::mHasher);
+    if (found != nullptr)
+      return *found;
+    else
+      return ifNotFound;
+  }
+
+  // Returns a pointer to the value if found, or null if not found
+  value_type* FindPointer(const value_type& searchKey) const
+  {
+    return base_type::InternalFindAs(searchKey, base_type::mHasher);
+  }
+
+  template <typename inputRangeType>
+  void Append(inputRangeType inputRange)
+  {
+    for (; !inputRange.Empty(); inputRange.PopFront())
+      Insert(inputRange.Front());
+  }
+
+  bool Insert(const value_type& value)
+  {
+    return base_type::InsertInternal(value, base_type::OnCollisionOverride);
+  }
+
+  bool InsertOrError(const value_type& value)
+  {
+    return base_type::InsertInternal(value, base_type::OnCollisionError) != false;
+  }
+
+  bool InsertOrError(const value_type& value, cstr error)
+  {
+    bool result = InsertOrError(value);
+    ErrorIf(result == false, "%s", error);
+    return result;
+  }
+
+  bool InsertNoOverwrite(const value_type& value)
+  {
+    return base_type::InsertInternal(value, base_type::OnCollisionReturn) != false;
+  }
+
+  bool Contains(const value_type& value) const
+  {
+    return base_type::InternalFindAs(value, base_type::mHasher) != nullptr;
+  }
+
+  ~FlatHashSet()
+  {
+  }
+
+private:
+  // A range over a single found value (or an empty range)
+  range FoundRange(value_type* found) const
+  {
+    if (found == nullptr)
+      return range();
+    size_type index = found - base_type::mSlots;
+    return range(base_type::mControl, base_type::mSlots, index, index + 1, 1);
+  }
+};
+
+} // namespace Plasma
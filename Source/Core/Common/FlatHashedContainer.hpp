@@ -0,0 +1,521 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+#include "Allocator.hpp"
+#include "Hashing.hpp"
+#include "Intrinsics.hpp"
+
+namespace Plasma
+{
+
+/// Open addressing hashed container used by FlatHashMap and FlatHashSet.
+/// Values are stored directly in one flat array next to an array of one byte
+/// control codes. A control byte is either empty, deleted or holds 7 bits of
+/// the value's hash. Lookups probe a group of 8 control bytes at once (packed
+/// into a 64-bit word) and only compare values whose hash bits match, so a
+/// miss rarely touches the values at all and there are no chains to follow.
+/// Unlike HashedContainer, erasing never moves other values, so erasing the
+/// value a range just popped past is safe.
+template <typename ValueType, typename Hasher, typename Allocator>
+class PlasmaSharedTemplate FlatHashedContainer : public AllocationContainer<Allocator>
+{
+public:
+  // standard container typedefs
+  typedef ValueType value_type;
+  typedef size_t size_type;
+  typedef ValueType& reference;
+  typedef const ValueType& const_reference;
+  typedef AllocationContainer<Allocator> base_type;
+  typedef FlatHashedContainer<ValueType, Hasher, Allocator> this_type;
+  using base_type::mAllocator;
+
+  /// How many control bytes are probed at once.
+  static const size_type cGroupWidth = 8;
+
+  // Control byte values. Full slots store the low 7 bits of the hash so the
+  // high bit tells full and open slots apart.
+  static const byte cControlEmpty = 0x80;
+  static const byte cControlDeleted = 0xFE;
+
+  struct InsertResult
+  {
+    bool mIsNewInsert;
+    ValueType* mValue;
+
+    InsertResult(bool newInsert, ValueType* value) : mIsNewInsert(newInsert), mValue(value)
+    {
+    }
+
+    operator bool() const
+    {
+      return mIsNewInsert;
+    }
+  };
+
+  FlatHashedContainer()
+  {
+    mControl = nullptr;
+    mSlots = nullptr;
+    mCapacity = 0;
+    mSize = 0;
+    mDeleted = 0;
+  }
+
+  ~FlatHashedContainer()
+  {
+    Deallocate();
+  }
+
+  // Range over the full slots of the table.
+  struct range
+  {
+    typedef typename this_type::value_type value_type;
+    typedef reference FrontResult;
+
+    range() : mControl(nullptr), mSlots(nullptr), mBegin(0), mEnd(0), mSize(0)
+    {
+    }
+
+    range(byte* control, ValueType* slots, size_type begin, size_type end, size_type size) :
+        mControl(control),
+        mSlots(slots),
+        mBegin(begin),
+        mEnd(end),
+        mSize(size)
+    {
+      SkipOpen();
+    }
+
+    bool Empty()
+    {
+      return mBegin == mEnd;
+    }
+
+    reference Front()
+    {
+      return mSlots[mBegin];
+    }
+
+    void PopFront()
+    {
+      ErrorIf(Empty(), "Popped an empty range.");
+      ++mBegin;
+      --mSize;
+      SkipOpen();
+    }
+
+    size_t Length()
+    {
+      return mSize;
+    }
+
+    size_type Size()
+    {
+      return Length();
+    }
+
+    range& All()
+    {
+      return *this;
+    }
+
+  private:
+    void SkipOpen()
+    {
+      while (mBegin != mEnd && (mControl[mBegin] & cControlEmpty) != 0)
+        ++mBegin;
+    }
+
+    byte* mControl;
+    ValueType* mSlots;
+    size_type mBegin;
+    size_type mEnd;
+    size_type mSize;
+  };
+
+  ///////Container Global Modify//////////////////
+
+  // Rebuild the table with the given number of slots (rounded up to a power of
+  // two). Also clears out any deleted markers.
+  void Rehash(size_type newCapacity)
+  {
+    size_type capacity = cGroupWidth * 2;
+    while (capacity < newCapacity)
+      capacity *= 2;
+    if (MaxFill(capacity) < mSize)
+      return;
+
+    byte* oldControl = mControl;
+    ValueType* oldSlots = mSlots;
+    size_type oldCapacity = mCapacity;
+
+    AllocateTable(capacity);
+
+    // Reinsert every value, they can't collide so skip the search
+    for (size_type i = 0; i < oldCapacity; ++i)
+    {
+      if ((oldControl[i] & cControlEmpty) == 0)
+      {
+        size_t hash = MixHash(mHasher(oldSlots[i]));
+        size_type index = FindOpenSlot(hash);
+        mControl[index] = HashControl(hash);
+        new (mSlots + index) value_type(oldSlots[i]);
+        oldSlots[i].~ValueType();
+      }
+    }
+
+    if (oldCapacity != 0)
+      mAllocator.Deallocate(oldSlots, TableBytes(oldCapacity));
+  }
+
+  // Make sure size values can be inserted without rehashing.
+  void Reserve(size_type size)
+  {
+    if (MaxFill(mCapacity) < size)
+      Rehash(size + size / 7 + 1);
+  }
+
+  // Destroy all elements.
+  void Clear()
+  {
+    DestructTableValues();
+    mSize = 0;
+    mDeleted = 0;
+  }
+
+  // Destroy all elements and frees all memory.
+  void Deallocate()
+  {
+    if (mSlots != nullptr)
+    {
+      DestructTableValues();
+      mAllocator.Deallocate(mSlots, TableBytes(mCapacity));
+    }
+
+    mControl = nullptr;
+    mSlots = nullptr;
+    mCapacity = 0;
+    mSize = 0;
+    mDeleted = 0;
+  }
+
+  range All() const
+  {
+    return range(mControl, mSlots, 0, mCapacity, mSize);
+  }
+
+  void Swap(this_type& other)
+  {
+    Plasma::Swap(mControl, other.mControl);
+    Plasma::Swap(mSlots, other.mSlots);
+    Plasma::Swap(mCapacity, other.mCapacity);
+    Plasma::Swap(mSize, other.mSize);
+    Plasma::Swap(mDeleted, other.mDeleted);
+    Plasma::Swap(mHasher, other.mHasher);
+  }
+
+  ////////////Insertion///////////////////////
+
+  // Override
+  static ValueType* OnCollisionOverride(ValueType* dest, const_reference value)
+  {
+    *dest = value;
+    return dest;
+  }
+
+  // Error
+  static ValueType* OnCollisionError(ValueType* dest, const_reference value)
+  {
+    (void)value;
+    (void)dest;
+    Error("Double Insert, value was not inserted!");
+    return nullptr;
+  }
+
+  // Just return the slot
+  static ValueType* OnCollisionReturn(ValueType* dest, const_reference value)
+  {
+    (void)value;
+    return dest;
+  }
+
+  // Insert a value.
+  template <typename CollisionFunc>
+  InsertResult InsertInternal(const_reference value, CollisionFunc onCollison)
+  {
+    size_t hash = MixHash(mHasher(value));
+    ValueType* found = FindWithHash(value, hash, mHasher);
+    if (found != nullptr)
+    {
+      onCollison(found, value);
+      return InsertResult(false, found);
+    }
+
+    // Only grow for values that are actually new. Deleted markers count
+    // against the load since probes still have to walk past them.
+    if (mSize + mDeleted + 1 > MaxFill(mCapacity))
+    {
+      // If most of the load is deleted markers rebuild at the same size
+      if (mSize + 1 <= MaxFill(mCapacity) / 2)
+        Rehash(mCapacity);
+      else
+        Rehash(mCapacity * 2);
+    }
+
+    size_type index = FindOpenSlot(hash);
+    if (mControl[index] == cControlDeleted)
+      --mDeleted;
+    mControl[index] = HashControl(hash);
+    new (mSlots + index) value_type(value);
+    ++mSize;
+    return InsertResult(true, mSlots + index);
+  }
+
+  ////////Find//////////////////////////////
+
+  // Find an element value that hashes and compares to a
+  // value in the container. Returns null if there isn't one.
+  template <typename searchType, typename searchHasherType>
+  ValueType* InternalFindAs(const searchType& searchValue, searchHasherType searchHasher) const
+  {
+    if (mSize == 0)
+      return nullptr;
+    return FindWithHash(searchValue, MixHash(searchHasher(searchValue)), searchHasher);
+  }
+
+  size_t Count(const_reference value)
+  {
+    return InternalFindAs(value, mHasher) != nullptr ? 1 : 0;
+  }
+
+  ///////Erasing//////////////////////////
+
+  // Erase a value if found.
+  bool Erase(const_reference value)
+  {
+    ValueType* found = InternalFindAs(value, mHasher);
+    if (found != nullptr)
+    {
+      EraseSlot(found);
+      return true;
+    }
+    return false;
+  }
+
+  void EraseSlot(ValueType* slot)
+  {
+    size_type index = slot - mSlots;
+    ErrorIf(index >= mCapacity || (mControl[index] & cControlEmpty) != 0, "Attempted to erase an invalid slot.");
+
+    slot->~ValueType();
+    --mSize;
+
+    // A probe only moves past a group once the group is full, and a full group
+    // never gets an empty slot back (see below). So if this group still has an
+    // empty slot no probe has ever walked past it and this slot can be marked
+    // empty. Otherwise a probe may need to continue past it.
+    size_type groupStart = index - index % cGroupWidth;
+    if (MatchEmpty(LoadGroup(groupStart)) != 0)
+    {
+      mControl[index] = cControlEmpty;
+    }
+    else
+    {
+      mControl[index] = cControlDeleted;
+      ++mDeleted;
+    }
+  }
+
+  //////////Information Functions///////////
+  size_type BucketCount() const
+  {
+    return mCapacity;
+  }
+  size_type Size() const
+  {
+    return mSize;
+  }
+  bool Empty() const
+  {
+    return mSize == 0;
+  }
+  float LoadFactor() const
+  {
+    return float(mSize) / float(mCapacity);
+  }
+
+  /// Equals///////////
+
+  bool operator==(const this_type& other)
+  {
+    if (other.Size() != this->Size())
+      return false;
+
+    range r = this->All();
+    while (!r.Empty())
+    {
+      ValueType* found = other.InternalFindAs(r.Front(), mHasher);
+      if (found == nullptr)
+        return false;
+
+      if (r.Front() != *found)
+        return false;
+
+      r.PopFront();
+    }
+
+    return true;
+  }
+
+protected:
+  static const u64 cGroupLsbs = 0x0101010101010101ull;
+  static const u64 cGroupMsbs = 0x8080808080808080ull;
+
+  byte* mControl;
+  ValueType* mSlots;
+  size_type mCapacity;
+  size_type mSize;
+  size_type mDeleted;
+  Hasher mHasher;
+
+  // Tables are kept at most 7/8 full.
+  static size_type MaxFill(size_type capacity)
+  {
+    return capacity - capacity / 8;
+  }
+
+  static size_type TableBytes(size_type capacity)
+  {
+    return capacity * sizeof(ValueType) + capacity;
+  }
+
+  // Many of our hash policies return the value itself (pointers and integers)
+  // so the bits are spread out before the table uses them.
+  static size_t MixHash(size_t hash)
+  {
+    u64 mixed = (u64)hash * 0x9E3779B97F4A7C15ull;
+    return (size_t)(mixed ^ (mixed >> 32));
+  }
+
+  static byte HashControl(size_t hash)
+  {
+    return (byte)(hash & 0x7F);
+  }
+
+  // The group the probe sequence starts at. The low bits are kept for the
+  // control byte.
+  size_type FirstGroup(size_t hash) const
+  {
+    return (hash >> 7) & (mCapacity / cGroupWidth - 1);
+  }
+
+  u64 LoadGroup(size_type groupStart) const
+  {
+    u64 group;
+    memcpy(&group, mControl + groupStart, sizeof(group));
+    return group;
+  }
+
+  // Sets the high bit of every byte that may equal control. Can report a false
+  // match right after a real one, which only costs an extra compare.
+  static u64 MatchControl(u64 group, byte control)
+  {
+    u64 bits = group ^ (cGroupLsbs * control);
+    return (bits - cGroupLsbs) & ~bits & cGroupMsbs;
+  }
+
+  // Sets the high bit of every empty byte.
+  static u64 MatchEmpty(u64 group)
+  {
+    return group & (~group << 6) & cGroupMsbs;
+  }
+
+  // Sets the high bit of every empty or deleted byte.
+  static u64 MatchOpen(u64 group)
+  {
+    return group & ~(group << 7) & cGroupMsbs;
+  }
+
+  // Index within the group of the first byte set in a match. Control bytes
+  // are loaded little endian so the first byte is the lowest. This sits on
+  // every lookup, and CountTrailingPlasmas is an out of line table lookup on
+  // platforms without the intrinsic, so count the whole bytes below the
+  // lowest match instead: one bit per byte, summed by the multiply.
+  static size_type FirstMatch(u64 match)
+  {
+    u64 bytesBelow = ((match & (0 - match)) >> 7) - 1;
+    return (size_type)(((bytesBelow & cGroupLsbs) * cGroupLsbs) >> 56);
+  }
+
+  template <typename searchType, typename searchHasherType>
+  ValueType* FindWithHash(const searchType& searchValue, size_t hash, searchHasherType& searchHasher) const
+  {
+    if (mCapacity == 0)
+      return nullptr;
+
+    byte control = HashControl(hash);
+    size_type groupMask = mCapacity / cGroupWidth - 1;
+    size_type group = FirstGroup(hash);
+
+    // Triangular probing visits every group once for power of two counts
+    for (size_type step = 1;; ++step)
+    {
+      size_type groupStart = group * cGroupWidth;
+      u64 bits = LoadGroup(groupStart);
+      for (u64 match = MatchControl(bits, control); match != 0; match &= match - 1)
+      {
+        size_type index = groupStart + FirstMatch(match);
+        if (searchHasher.Equal(searchValue, mSlots[index]))
+          return mSlots + index;
+      }
+
+      // An empty slot means the value would have been placed here
+      if (MatchEmpty(bits) != 0 || step > groupMask)
+        return nullptr;
+
+      group = (group + step) & groupMask;
+    }
+  }
+
+  // The first empty or deleted slot along a hash's probe sequence. The table
+  // is never full so there always is one.
+  size_type FindOpenSlot(size_t hash) const
+  {
+    size_type groupMask = mCapacity / cGroupWidth - 1;
+    size_type group = FirstGroup(hash);
+    for (size_type step = 1;; ++step)
+    {
+      size_type groupStart = group * cGroupWidth;
+      u64 match = MatchOpen(LoadGroup(groupStart));
+      if (match != 0)
+        return groupStart + FirstMatch(match);
+
+      group = (group + step) & groupMask;
+    }
+  }
+
+  // The values and control bytes share one allocation.
+  void AllocateTable(size_type capacity)
+  {
+    byte* memory = (byte*)mAllocator.Allocate(TableBytes(capacity));
+    mSlots = (ValueType*)memory;
+    mControl = memory + capacity * sizeof(ValueType);
+    memset(mControl, cControlEmpty, capacity);
+    mCapacity = capacity;
+    mDeleted = 0;
+  }
+
+  void DestructTableValues()
+  {
+    for (size_type i = 0; i < mCapacity; ++i)
+    {
+      // call the destructor on all the value types
+      if ((mControl[i] & cControlEmpty) == 0)
+        mSlots[i].~ValueType();
+
+      mControl[i] = cControlEmpty;
+    }
+  }
+};
+
+} // namespace Plasma
@@ -0,0 +1,166 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+namespace Memory
+{
+
+// Arenas created through GetFrameArena start small and grow to fit the
+// largest frame they've seen.
+const size_t cDefaultFrameArenaSize = 64 * 1024;
+// Grown buffers are rounded up to this so a slowly growing frame doesn't
+// reallocate every time.
+const size_t cFrameArenaGrowSize = 64 * 1024;
+
+FrameArena* FrameArena::sFirstArena = nullptr;
+
+FrameArena::FrameArena(cstr name, Graph* parent, size_t bytesPerFrame) : Graph(name, parent)
+{
+  ErrorIf(parent == nullptr,
+          "Frame arena needs a parent node "
+          "otherwise it will not be deallocated.");
+
+  for (uint i = 0; i < 2; ++i)
+  {
+    Buffer& buffer = mBuffers[i];
+    buffer.mMemory = (byte*)plAllocate(bytesPerFrame);
+    buffer.mCapacity = bytesPerFrame;
+    buffer.mUsed = 0;
+    buffer.mAllocations = 0;
+    DeltaDedicated(bytesPerFrame);
+  }
+
+  mCurrent = 0;
+  mPeakFrameBytes = 0;
+
+  mNextArena = sFirstArena;
+  sFirstArena = this;
+}
+
+FrameArena::~FrameArena()
+{
+  CleanUp();
+
+  FrameArena** link = &sFirstArena;
+  while (*link != this)
+    link = &(*link)->mNextArena;
+  *link = mNextArena;
+}
+
+MemPtr FrameArena::Allocate(size_t numberOfBytes)
+{
+  size_t size = (numberOfBytes + cAlignment - 1) & ~(cAlignment - 1);
+  Buffer& buffer = mBuffers[mCurrent];
+  buffer.mAllocations.FetchAdd(1);
+
+  size_t start = (size_t)buffer.mUsed.FetchAdd((s64)size);
+  if (start + size <= buffer.mCapacity)
+    return buffer.mMemory + start;
+
+  return AllocateOverflow(buffer, size);
+}
+
+void FrameArena::Deallocate(MemPtr /*ptr*/, size_t /*numberOfBytes*/)
+{
+  // Memory is released all at once when the buffer is recycled
+}
+
+void FrameArena::Print(size_t tabs, size_t flags)
+{
+  PrintHelper(tabs, flags, "FrameArena");
+}
+
+void FrameArena::CleanUp()
+{
+  for (uint i = 0; i < 2; ++i)
+  {
+    Buffer& buffer = mBuffers[i];
+    for (uint j = 0; j < buffer.mOverflow.Size(); ++j)
+      plDeallocate(buffer.mOverflow[j]);
+    buffer.mOverflow.Deallocate();
+
+    plDeallocate(buffer.mMemory);
+    mData.BytesDedicated -= buffer.mCapacity;
+    buffer.mMemory = nullptr;
+    buffer.mCapacity = 0;
+    buffer.mUsed = 0;
+    buffer.mAllocations = 0;
+  }
+}
+
+void FrameArena::NextFrame()
+{
+  // Publish how much the frame that just ended used
+  Buffer& finished = mBuffers[mCurrent];
+  MemCounterType frameBytes = (MemCounterType)finished.mUsed.Load();
+  MemCounterType frameAllocations = (MemCounterType)finished.mAllocations.Load();
+  mPeakFrameBytes = Math::Max(mPeakFrameBytes, frameBytes);
+  mData.Allocations += frameAllocations;
+  mData.Active = frameAllocations;
+  mData.BytesAllocated = frameBytes;
+  mData.PeakAllocated = mPeakFrameBytes;
+
+  // The other buffer belongs to the frame before last, nobody can be using it
+  mCurrent = 1 - mCurrent;
+  ResetBuffer(mBuffers[mCurrent]);
+}
+
+void FrameArena::NextFrameAll()
+{
+  ZoneScoped;
+  for (FrameArena* arena = sFirstArena; arena != nullptr; arena = arena->mNextArena)
+    arena->NextFrame();
+}
+
+MemPtr FrameArena::AllocateOverflow(Buffer& buffer, size_t numberOfBytes)
+{
+  byte* memory = (byte*)plAllocate(numberOfBytes);
+  mOverflowLock.Lock();
+  buffer.mOverflow.PushBack(memory);
+  mOverflowLock.Unlock();
+  return memory;
+}
+
+void FrameArena::ResetBuffer(Buffer& buffer)
+{
+  for (uint i = 0; i < buffer.mOverflow.Size(); ++i)
+    plDeallocate(buffer.mOverflow[i]);
+  buffer.mOverflow.Clear();
+
+  // If the buffer overflowed grow it so the whole frame fits next time
+  size_t used = (size_t)buffer.mUsed.Load();
+  if (used > buffer.mCapacity)
+  {
+    size_t capacity = (used + cFrameArenaGrowSize - 1) / cFrameArenaGrowSize * cFrameArenaGrowSize;
+    plDeallocate(buffer.mMemory);
+    buffer.mMemory = (byte*)plAllocate(capacity);
+    DeltaDedicated(capacity - buffer.mCapacity);
+    buffer.mCapacity = capacity;
+  }
+#ifdef PlasmaDebug
+  else
+  {
+    // 0xFAFAFAFA is our own byte pattern used to show that we deallocated the
+    // memory, but have not yet released it to the os
+    memset(buffer.mMemory, 0xFA, used);
+  }
+#endif
+
+  buffer.mUsed = 0;
+  buffer.mAllocations = 0;
+}
+
+FrameArena* GetFrameArena(Graph* heap)
+{
+  for (FrameArena* arena = FrameArena::sFirstArena; arena != nullptr; arena = arena->mNextArena)
+  {
+    if (arena->mParent == heap)
+      return arena;
+  }
+
+  return new FrameArena("Frame", heap, cDefaultFrameArenaSize);
+}
+
+} // namespace Memory
+} // namespace Plasma
@@ -0,0 +1,102 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+namespace Memory
+{
+
+/// A linear (bump pointer) allocator for memory that only lives for a frame.
+/// The arena is double buffered: memory allocated during a frame stays valid
+/// through the end of the next frame, then the whole buffer is reset at once
+/// by NextFrame. Deallocate does nothing, so containers can use the arena
+/// freely as long as they are gone before their memory is recycled.
+/// Allocation is lock-free and can happen from any thread, but NextFrame must
+/// only be called when no other thread is allocating (the engine calls it at
+/// the start of each frame). Allocations that don't fit in the buffer fall
+/// back to the system heap and the buffer is grown to fit on its next reset.
+class PlasmaShared FrameArena : public Graph
+{
+public:
+  /// Every allocation is aligned to this many bytes.
+  static const size_t cAlignment = 16;
+
+  FrameArena(cstr name, Graph* parent, size_t bytesPerFrame);
+  ~FrameArena();
+
+  MemPtr Allocate(size_t numberOfBytes);
+  void Deallocate(MemPtr ptr, size_t numberOfBytes);
+  void Print(size_t tabs, size_t flags);
+  void CleanUp();
+
+  /// Recycles the older buffer and makes it the one allocated from. Memory
+  /// allocated before the previous call to NextFrame is no longer valid.
+  void NextFrame();
+
+  /// Advances every frame arena that has been created.
+  static void NextFrameAll();
+
+private:
+  friend FrameArena* GetFrameArena(Graph* heap);
+
+  struct Buffer
+  {
+    byte* mMemory;
+    size_t mCapacity;
+    /// Bytes requested this frame, including ones that didn't fit and went to
+    /// the overflow list.
+    Atomic<s64> mUsed;
+    Atomic<s64> mAllocations;
+    Array<byte*> mOverflow;
+  };
+
+  MemPtr AllocateOverflow(Buffer& buffer, size_t numberOfBytes);
+  void ResetBuffer(Buffer& buffer);
+
+  Buffer mBuffers[2];
+  uint mCurrent;
+  /// Guards the overflow lists.
+  ThreadLock mOverflowLock;
+  MemCounterType mPeakFrameBytes;
+
+  /// Every arena is linked together so they can all be reset each frame.
+  FrameArena* mNextArena;
+  static FrameArena* sFirstArena;
+};
+
+/// Returns the frame arena belonging to a node in the memory graph (usually a
+/// heap), creating it the first time. Must be called from the main thread.
+PlasmaShared FrameArena* GetFrameArena(Graph* heap);
+
+} // namespace Memory
+
+/// Allocator for containers whose memory only needs to last for the current
+/// frame (or the one after it), such as temporary arrays built during an
+/// update. Freeing is a no-op and the memory is reclaimed in bulk each frame.
+class PlasmaShared FrameAllocator : public Memory::StandardMemory
+{
+public:
+  FrameAllocator() : mNode(Memory::GetFrameArena(Memory::GetGlobalHeap()))
+  {
+  }
+
+  FrameAllocator(Memory::Graph* heap) : mNode(Memory::GetFrameArena(heap))
+  {
+  }
+
+  FrameAllocator(Memory::FrameArena* arena) : mNode(arena)
+  {
+  }
+
+  MemPtr Allocate(size_t numberOfBytes)
+  {
+    return mNode->Allocate(numberOfBytes);
+  }
+  void Deallocate(MemPtr ptr, size_t numberOfBytes)
+  {
+    mNode->Deallocate(ptr, numberOfBytes);
+  }
+  Memory::FrameArena* mNode;
+};
+
+} // namespace Plasma
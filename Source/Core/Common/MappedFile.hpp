@@ -0,0 +1,43 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+/// A read only view of an entire file. On platforms that support it the file is
+/// memory mapped, so pages are only read from disk when they're first touched
+/// and the memory is shared (through the OS file cache) with every other
+/// process that maps the same file. Otherwise the whole file is read into
+/// memory when it's opened, so the data can be used the same way either way.
+class PlasmaShared MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+
+  /// Maps the whole file (fails if the file can't be opened or is empty).
+  bool Open(Status& status, StringParam filePath);
+
+  /// Unmaps the file (safe to call more than once). Any pointers into the data
+  /// are invalid after this.
+  void Close();
+
+  /// Is the file currently open?
+  bool IsOpen();
+
+  /// Whether the data is a mapping of the file rather than a copy of it.
+  bool IsMapped();
+
+  /// The contents of the file (never write to this, mapped pages are read only).
+  const byte* GetData();
+
+  /// Size of the file in bytes.
+  size_t GetSize();
+
+private:
+  byte* mData;
+  size_t mSize;
+  bool mMapped;
+};
+
+} // namespace Plasma
@@ -0,0 +1,53 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// How many chunks each thread should get so that uneven elements still
+// balance out across the threads.
+const size_t cParallelChunksPerThread = 4;
+
+ParallelDispatcher::DispatchFunction ParallelDispatcher::sDispatchFunction = nullptr;
+size_t ParallelDispatcher::sThreadCount = 1;
+
+void ParallelDispatcher::SetDispatchFunction(DispatchFunction function, size_t threadCount)
+{
+  sDispatchFunction = function;
+  sThreadCount = (function != nullptr) ? Math::Max(threadCount, (size_t)1) : 1;
+}
+
+bool ParallelDispatcher::IsParallel()
+{
+  return ThreadingEnabled && sDispatchFunction != nullptr;
+}
+
+size_t ParallelDispatcher::GetThreadCount()
+{
+  return IsParallel() ? sThreadCount : 1;
+}
+
+size_t ParallelDispatcher::GetChunkSize(size_t size, size_t grainSize)
+{
+  grainSize = Math::Max(grainSize, (size_t)1);
+  if (!IsParallel())
+    return Math::Max(size, grainSize);
+
+  size_t targetChunks = sThreadCount * cParallelChunksPerThread;
+  size_t chunkSize = (size + targetChunks - 1) / targetChunks;
+  return Math::Max(chunkSize, grainSize);
+}
+
+void ParallelDispatcher::Dispatch(ChunkFunction function, void* userData, size_t chunkCount)
+{
+  if (!IsParallel())
+  {
+    for (size_t i = 0; i < chunkCount; ++i)
+      function(userData, i);
+    return;
+  }
+
+  sDispatchFunction(function, userData, chunkCount);
+}
+
+} // namespace Plasma
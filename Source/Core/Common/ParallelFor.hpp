@@ -0,0 +1,74 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+/// Hands the chunks of a parallel loop to a thread pool. Common has no thread
+/// pool of its own so one is installed by the engine (the JobSystem). Without
+/// one every parallel loop runs serially on the calling thread.
+class PlasmaShared ParallelDispatcher
+{
+public:
+  typedef void (*ChunkFunction)(void* userData, size_t chunkIndex);
+  /// Must call the chunk function once for each index in [0, chunkCount) and
+  /// only return once every chunk is done.
+  typedef void (*DispatchFunction)(ChunkFunction function, void* userData, size_t chunkCount);
+
+  /// Installs (or removes, with null) the thread pool. The thread count
+  /// includes the calling thread.
+  static void SetDispatchFunction(DispatchFunction function, size_t threadCount);
+  static bool IsParallel();
+  static size_t GetThreadCount();
+
+  /// Picks how many elements each chunk of a loop over size elements gets. Aims
+  /// for a few chunks per thread but never goes below the grain size.
+  static size_t GetChunkSize(size_t size, size_t grainSize);
+
+  static void Dispatch(ChunkFunction function, void* userData, size_t chunkCount);
+
+private:
+  static DispatchFunction sDispatchFunction;
+  static size_t sThreadCount;
+};
+
+template <typename RangeType, typename Function>
+struct ParallelForContext
+{
+  static void RunChunk(void* userData, size_t chunkIndex)
+  {
+    ParallelForContext* context = static_cast<ParallelForContext*>(userData);
+    size_t start = chunkIndex * context->mChunkSize;
+    size_t end = Math::Min(start + context->mChunkSize, (size_t)context->mRange.Size());
+    for (size_t i = start; i < end; ++i)
+      context->mFunction(context->mRange[i]);
+  }
+
+  RangeType mRange;
+  size_t mChunkSize;
+  Function mFunction;
+};
+
+/// Calls function(element) for every element of a random access range (such
+/// as an Array's range). The range is split into chunks of at least grainSize
+/// elements that may run on separate threads, so the function must be safe to
+/// call on different elements at the same time. Returns once every element is
+/// done. Runs serially when threading is disabled or there is only one chunk.
+template <typename RangeType, typename Function>
+void ParallelFor(RangeType range, size_t grainSize, Function function)
+{
+  size_t size = range.Size();
+  size_t chunkSize = ParallelDispatcher::GetChunkSize(size, grainSize);
+  if (size <= chunkSize)
+  {
+    for (size_t i = 0; i < size; ++i)
+      function(range[i]);
+    return;
+  }
+
+  ParallelForContext<RangeType, Function> context = {range, chunkSize, function};
+  size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+  ParallelDispatcher::Dispatch(&ParallelForContext<RangeType, Function>::RunChunk, &context, chunkCount);
+}
+
+} // namespace Plasma
@@ -283,6 +283,13 @@
 #  define PlasmaNoInline
 #endif
 
+// PlasmaSse2 is defined when every processor the target can run on has SSE2
+// (always true for x64). Code written against <emmintrin.h> must be guarded on
+// it and keep a scalar fallback for the other targets.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define PlasmaSse2
+#endif
+
 #define PlasmaNoImportExport
 
 #if defined(PlasmaImportDll)
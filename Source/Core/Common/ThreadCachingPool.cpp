@@ -0,0 +1,383 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+namespace Memory
+{
+
+// Size of the direct mapped lookup in front of each thread's cache list. Pools
+// whose ids collide only cost a search of the list, no cache is ever dropped.
+const size_t cRecentCacheCount = 16;
+
+// Depot stacks pack the magazine pointer into the low 48 bits and a counter
+// that changes on every push and pop into the high 16 bits. The counter keeps
+// a stale pop from succeeding after the same magazine was popped and pushed
+// again (the ABA problem). Magazines are never freed while the pool is alive
+// so reading a stale magazine's next pointer is always safe.
+const u64 cDepotPointerMask = (u64(1) << 48) - 1;
+const u64 cDepotTagIncrement = u64(1) << 48;
+
+// Guards the link between pools and the thread caches: creating a cache, a
+// thread exiting and a pool being destroyed. A spin lock since pools are often
+// created during static initialization and it's rarely taken.
+SpinLock ThreadCacheLock;
+
+/// Every pool cache the current thread has.
+struct ThreadCacheList
+{
+  ThreadCacheList()
+  {
+    memset(mRecent, 0, sizeof(mRecent));
+  }
+
+  // Hands the magazines back to the pools when the thread exits
+  ~ThreadCacheList()
+  {
+    ThreadCacheLock.Lock();
+    for (uint i = 0; i < mCaches.Size(); ++i)
+    {
+      ThreadCachingPool::ThreadCache* cache = mCaches[i];
+      if (cache->mPool != nullptr)
+        cache->mPool->ReleaseThreadCache(cache);
+      plDeallocate(cache);
+    }
+    ThreadCacheLock.Unlock();
+  }
+
+  ThreadCachingPool::ThreadCache* Find(s32 poolId)
+  {
+    for (uint i = 0; i < mCaches.Size(); ++i)
+    {
+      if (mCaches[i]->mPoolId == poolId)
+        return mCaches[i];
+    }
+    return nullptr;
+  }
+
+  // Frees the caches of pools that have been destroyed. The thread cache lock
+  // must be held.
+  void RemoveDestroyedPools()
+  {
+    for (uint i = 0; i < mCaches.Size();)
+    {
+      if (mCaches[i]->mPool == nullptr)
+      {
+        plDeallocate(mCaches[i]);
+        mCaches.EraseAt(i);
+        memset(mRecent, 0, sizeof(mRecent));
+      }
+      else
+      {
+        ++i;
+      }
+    }
+  }
+
+  ThreadCachingPool::ThreadCache* mRecent[cRecentCacheCount];
+  Array<ThreadCachingPool::ThreadCache*> mCaches;
+};
+
+// A real thread_local instead of PlasmaThreadLocal so the list is destroyed
+// when its thread exits
+thread_local ThreadCacheList CurrentThreadCaches;
+
+// Pool ids are never reused so a thread can't find a destroyed pool's cache.
+// Plain zero initialized storage since pools are often created during static
+// initialization.
+volatile s32 LastThreadCachingPoolId = 0;
+
+ThreadCachingPool::ThreadCachingPool(cstr name, Graph* parent, size_t blockSize, size_t blocksPerPage) :
+    Graph(name, parent)
+{
+  ErrorIf(parent == nullptr,
+          "Memory pool needs a parent node "
+          "otherwise it will not be deallocated.");
+  mBlockSize = blockSize;
+  mBlocksPerPage = blocksPerPage;
+  mPageSize = blockSize * blocksPerPage;
+  mPoolId = AtomicPreIncrement(&LastThreadCachingPoolId);
+  mFullMagazines = 0;
+  mEmptyMagazines = 0;
+  mAllocations = 0;
+  mActive = 0;
+  mPeakActive = 0;
+  mPublishingStats = 0;
+}
+
+ThreadCachingPool::~ThreadCachingPool()
+{
+  CleanUp();
+}
+
+MemPtr ThreadCachingPool::Allocate(size_t numberOfBytes)
+{
+  ErrorIf(numberOfBytes > mBlockSize, "Allocation is large than block size.");
+  ThreadCache* cache = GetThreadCache();
+
+  if (cache->mLoaded->mCount == 0)
+  {
+    if (cache->mPrevious->mCount != 0)
+    {
+      Swap(cache->mLoaded, cache->mPrevious);
+    }
+    else
+    {
+      // Both magazines are empty so trade one for a full magazine
+      PushDepot(mEmptyMagazines, cache->mPrevious);
+      cache->mPrevious = cache->mLoaded;
+      cache->mLoaded = GetFullMagazine();
+      FlushStats(cache);
+    }
+  }
+
+  ++cache->mAllocations;
+  ++cache->mActive;
+  Magazine* magazine = cache->mLoaded;
+  return magazine->mBlocks[--magazine->mCount];
+}
+
+void ThreadCachingPool::Deallocate(MemPtr ptr, size_t /*numberOfBytes*/)
+{
+  // It should be safe to delete null pointers
+  if (ptr == nullptr)
+    return;
+
+#ifdef PlasmaDebug
+  // 0xFAFAFAFA is our own byte pattern used to show that we deallocated the
+  // memory, but have not yet released it to the os
+  memset(ptr, 0xFA, mBlockSize);
+#endif
+
+  ThreadCache* cache = GetThreadCache();
+
+  if (cache->mLoaded->mCount == cMagazineSize)
+  {
+    if (cache->mPrevious->mCount != cMagazineSize)
+    {
+      Swap(cache->mLoaded, cache->mPrevious);
+    }
+    else
+    {
+      // Both magazines are full so trade one for an empty magazine
+      PushDepot(mFullMagazines, cache->mPrevious);
+      cache->mPrevious = cache->mLoaded;
+      cache->mLoaded = GetEmptyMagazine();
+      FlushStats(cache);
+    }
+  }
+
+  --cache->mActive;
+  Magazine* magazine = cache->mLoaded;
+  magazine->mBlocks[magazine->mCount++] = ptr;
+}
+
+void ThreadCachingPool::Print(size_t tabs, size_t flags)
+{
+  PrintHelper(tabs, flags, "ThreadCachingPool");
+}
+
+void ThreadCachingPool::CleanUp()
+{
+  // No other thread should be using the pool anymore, so gather up the
+  // statistics that haven't been flushed yet. The caches belong to their
+  // threads, which free them when they exit.
+  ThreadCacheLock.Lock();
+  s64 active = mActive.Load();
+  for (uint i = 0; i < mThreadCaches.Size(); ++i)
+  {
+    active += mThreadCaches[i]->mActive;
+    mThreadCaches[i]->mPool = nullptr;
+  }
+  mThreadCaches.Deallocate();
+  ThreadCacheLock.Unlock();
+  ErrorIf(active != 0, "Failed to release all memory from pool %s", Name.c_str());
+
+  for (uint i = 0; i < mPages.Size(); ++i)
+    plDeallocate(mPages[i]);
+  mPages.Deallocate();
+
+  for (uint i = 0; i < mMagazines.Size(); ++i)
+    plDeallocate(mMagazines[i]);
+  mMagazines.Deallocate();
+
+  mFullMagazines = 0;
+  mEmptyMagazines = 0;
+}
+
+ThreadCachingPool::ThreadCache* ThreadCachingPool::GetThreadCache()
+{
+  ThreadCacheList& list = CurrentThreadCaches;
+  ThreadCache*& recent = list.mRecent[mPoolId % cRecentCacheCount];
+  if (recent != nullptr && recent->mPoolId == mPoolId)
+    return recent;
+
+  ThreadCache* cache = list.Find(mPoolId);
+  if (cache == nullptr)
+  {
+    ThreadCacheLock.Lock();
+    list.RemoveDestroyedPools();
+    cache = CreateThreadCache();
+    list.mCaches.PushBack(cache);
+    ThreadCacheLock.Unlock();
+  }
+
+  recent = cache;
+  return cache;
+}
+
+ThreadCachingPool::ThreadCache* ThreadCachingPool::CreateThreadCache()
+{
+  // The thread cache lock must be held
+  mLock.Lock();
+  ThreadCache* cache = (ThreadCache*)plAllocate(sizeof(ThreadCache));
+  cache->mLoaded = CreateMagazine();
+  cache->mPrevious = CreateMagazine();
+  mLock.Unlock();
+
+  cache->mAllocations = 0;
+  cache->mActive = 0;
+  cache->mPool = this;
+  cache->mPoolId = mPoolId;
+  mThreadCaches.PushBack(cache);
+  return cache;
+}
+
+void ThreadCachingPool::ReleaseThreadCache(ThreadCache* cache)
+{
+  // Partially filled magazines go on the full stack. Allocating only needs a
+  // magazine to have blocks, not to be completely full.
+  Magazine* magazines[] = {cache->mLoaded, cache->mPrevious};
+  for (uint i = 0; i < 2; ++i)
+  {
+    if (magazines[i]->mCount == 0)
+      PushDepot(mEmptyMagazines, magazines[i]);
+    else
+      PushDepot(mFullMagazines, magazines[i]);
+  }
+
+  FlushStats(cache);
+  mThreadCaches.EraseValue(cache);
+  cache->mPool = nullptr;
+}
+
+ThreadCachingPool::Magazine* ThreadCachingPool::GetFullMagazine()
+{
+  for (;;)
+  {
+    if (Magazine* magazine = PopDepot(mFullMagazines))
+      return magazine;
+    AllocatePage();
+  }
+}
+
+ThreadCachingPool::Magazine* ThreadCachingPool::GetEmptyMagazine()
+{
+  if (Magazine* magazine = PopDepot(mEmptyMagazines))
+    return magazine;
+
+  mLock.Lock();
+  Magazine* magazine = CreateMagazine();
+  mLock.Unlock();
+  return magazine;
+}
+
+ThreadCachingPool::Magazine* ThreadCachingPool::CreateMagazine()
+{
+  // The lock must be held
+  Magazine* magazine = (Magazine*)plAllocate(sizeof(Magazine));
+  magazine->mNext = nullptr;
+  magazine->mCount = 0;
+  mMagazines.PushBack(magazine);
+  return magazine;
+}
+
+void ThreadCachingPool::AllocatePage()
+{
+  mLock.Lock();
+
+  // Another thread may have refilled the depot while we waited on the lock
+  if (((u64)mFullMagazines.Load() & cDepotPointerMask) != 0)
+  {
+    mLock.Unlock();
+    return;
+  }
+
+  // Allocate a new page of memory and divide it into
+  // blocks that are each placed in a full magazine.
+  DeltaDedicated(mPageSize);
+  byte* memoryPage = (byte*)plAllocate(mPageSize);
+  mPages.PushBack(memoryPage);
+
+  size_t block = 0;
+  while (block < mBlocksPerPage)
+  {
+    Magazine* magazine = PopDepot(mEmptyMagazines);
+    if (magazine == nullptr)
+      magazine = CreateMagazine();
+
+    for (; block < mBlocksPerPage && magazine->mCount < cMagazineSize; ++block)
+      magazine->mBlocks[magazine->mCount++] = memoryPage + mBlockSize * block;
+    PushDepot(mFullMagazines, magazine);
+  }
+
+  mLock.Unlock();
+}
+
+void ThreadCachingPool::FlushStats(ThreadCache* cache)
+{
+  mAllocations.FetchAdd(cache->mAllocations);
+  s64 active = mActive.FetchAdd(cache->mActive) + cache->mActive;
+  cache->mAllocations = 0;
+  cache->mActive = 0;
+
+  s64 peak = mPeakActive.Load();
+  while (active > peak && !mPeakActive.CompareExchange(active, peak))
+    peak = mPeakActive.Load();
+
+  // Only one thread writes the graph's stats at a time. Anyone else can skip
+  // it since the next flush will publish their counts.
+  if (!mPublishingStats.CompareExchange(1, 0))
+    return;
+
+  // Frees on one thread can be flushed before the allocations they match on
+  // another thread, so the active count can briefly dip below zero
+  MemCounterType activeBlocks = (MemCounterType)Math::Max(mActive.Load(), (s64)0);
+  mData.Allocations = (MemCounterType)mAllocations.Load();
+  mData.Active = activeBlocks;
+  mData.BytesAllocated = activeBlocks * mBlockSize;
+  mData.PeakAllocated = (MemCounterType)mPeakActive.Load() * mBlockSize;
+  mPublishingStats.Store(0);
+}
+
+void ThreadCachingPool::PushDepot(Atomic<s64>& depot, Magazine* magazine)
+{
+  for (;;)
+  {
+    u64 head = (u64)depot.Load();
+    magazine->mNext = (Magazine*)(uintptr_t)(head & cDepotPointerMask);
+    u64 tag = (head & ~cDepotPointerMask) + cDepotTagIncrement;
+    u64 newHead = tag | (u64)(uintptr_t)magazine;
+    if (depot.CompareExchange((s64)newHead, (s64)head))
+      return;
+  }
+}
+
+ThreadCachingPool::Magazine* ThreadCachingPool::PopDepot(Atomic<s64>& depot)
+{
+  for (;;)
+  {
+    u64 head = (u64)depot.Load();
+    Magazine* magazine = (Magazine*)(uintptr_t)(head & cDepotPointerMask);
+    if (magazine == nullptr)
+      return nullptr;
+
+    u64 tag = (head & ~cDepotPointerMask) + cDepotTagIncrement;
+    u64 newHead = tag | (u64)(uintptr_t)magazine->mNext;
+    if (depot.CompareExchange((s64)newHead, (s64)head))
+      return magazine;
+  }
+}
+
+} // namespace Memory
+} // namespace Plasma
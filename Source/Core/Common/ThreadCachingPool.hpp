@@ -0,0 +1,122 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+namespace Memory
+{
+
+/// A fixed size block allocator like Pool that can be used from any thread.
+/// Each thread keeps two small magazines (arrays) of free blocks, so most
+/// allocations and frees don't touch any shared state. When a thread's
+/// magazines run empty or full it trades a whole magazine with a lock-free
+/// global depot. A lock is only taken to allocate new pages and the first time
+/// a thread uses the pool. Statistics are batched per thread and published to
+/// the memory graph when magazines are traded. When a thread exits its
+/// magazines go back to the depot so their blocks can be used by other threads.
+class ThreadCachingPool : public Graph
+{
+public:
+  /// How many blocks each magazine holds.
+  static const size_t cMagazineSize = 32;
+
+  struct Magazine
+  {
+    Magazine* mNext;
+    size_t mCount;
+    MemPtr mBlocks[cMagazineSize];
+  };
+
+  /// The magazines and unpublished statistics of a single thread. Owned by
+  /// the thread, which frees it when it exits.
+  struct ThreadCache
+  {
+    Magazine* mLoaded;
+    Magazine* mPrevious;
+    s64 mAllocations;
+    s64 mActive;
+    /// Null once the pool has been destroyed.
+    ThreadCachingPool* mPool;
+    s32 mPoolId;
+  };
+
+  ThreadCachingPool(cstr name, Graph* parent, size_t blockSize, size_t blocksPerPage);
+  ~ThreadCachingPool();
+
+  static void* operator new(size_t size)
+  {
+    return malloc(size);
+  }
+  static void operator delete(void* pMem, size_t size)
+  {
+    free(pMem);
+  }
+
+  template <typename type>
+  type* AllocateType();
+  template <typename type>
+  void DeallocateType(type* instance);
+  MemPtr Allocate(size_t numberOfBytes);
+  void Deallocate(MemPtr ptr, size_t numberOfBytes);
+  void Print(size_t tabs, size_t flags);
+  void CleanUp();
+
+  /// Gives an exiting thread's magazines and statistics back to the pool.
+  /// The thread cache lock must be held.
+  void ReleaseThreadCache(ThreadCache* cache);
+
+private:
+  ThreadCache* GetThreadCache();
+  ThreadCache* CreateThreadCache();
+  /// Returns a full magazine from the depot, allocating a page if needed.
+  Magazine* GetFullMagazine();
+  /// Returns an empty magazine from the depot, creating one if needed.
+  Magazine* GetEmptyMagazine();
+  Magazine* CreateMagazine();
+  void AllocatePage();
+  /// Moves a thread's statistics into the pool and the memory graph.
+  void FlushStats(ThreadCache* cache);
+
+  static void PushDepot(Atomic<s64>& depot, Magazine* magazine);
+  static Magazine* PopDepot(Atomic<s64>& depot);
+
+  size_t mBlockSize;
+  size_t mBlocksPerPage;
+  size_t mPageSize;
+  /// Identifies this pool's cache in each thread's cache list.
+  s32 mPoolId;
+
+  /// Lock-free stacks of magazines (see PushDepot).
+  Atomic<s64> mFullMagazines;
+  Atomic<s64> mEmptyMagazines;
+
+  /// Guards pages and magazine creation.
+  ThreadLock mLock;
+  Array<byte*> mPages;
+  Array<Magazine*> mMagazines;
+  /// Caches of the threads using this pool, guarded by the thread cache lock.
+  Array<ThreadCache*> mThreadCaches;
+
+  Atomic<s64> mAllocations;
+  Atomic<s64> mActive;
+  Atomic<s64> mPeakActive;
+  Atomic<s32> mPublishingStats;
+};
+
+template <typename type>
+type* ThreadCachingPool::AllocateType()
+{
+  MemPtr memory = Allocate(sizeof(type));
+  type* object = new (memory) type();
+  return object;
+}
+
+template <typename type>
+void ThreadCachingPool::DeallocateType(type* instance)
+{
+  instance->~type();
+  Deallocate(instance, sizeof(type));
+}
+
+} // namespace Memory
+} // namespace Plasma
@@ -74,6 +74,9 @@ PlasmaShared unsigned int GetDoubleClickTimeMs();
 // Get the memory status of the Os.
 PlasmaShared void GetMemoryStatus(MemoryInfo& memoryInfo);
 
+// Get how many threads the hardware can run at once (logical processors).
+PlasmaShared uint GetHardwareThreadCount();
+
 // Get an Environmental variable
 PlasmaShared String GetEnvironmentalVariable(StringParam variable);
 
@@ -90,10 +90,20 @@ void DataBuilder::Rename(StringParam newName)
   Name = newName;
 }
 
+bool DataBuilder::BuildsBinaryData()
+{
+  return LoaderType == "Level" || LoaderType == "Cog" || LoaderType == "Space" || LoaderType == "GameSession";
+}
+
 bool DataBuilder::NeedsBuilding(BuildOptions& options)
 {
   String destFile = FilePath::Combine(options.OutputPath, GetOutputFile());
   String sourceFile = FilePath::Combine(options.SourcePath, mOwner->Filename);
+
+  // Binary data is never the same size as the text it was built from
+  if (BuildsBinaryData())
+    return CheckFileAndMeta(options, sourceFile, destFile);
+
   return CheckFileMetaAndSize(options, sourceFile, destFile);
 }
 
@@ -101,6 +111,13 @@ void DataBuilder::BuildContent(BuildOptions& buildOptions)
 {
   String destFile = FilePath::Combine(buildOptions.OutputPath, GetOutputFile());
   String sourceFile = FilePath::Combine(buildOptions.SourcePath, mOwner->Filename);
+
+  if (BuildsBinaryData())
+  {
+    BuildBinaryData(buildOptions, sourceFile, destFile);
+    return;
+  }
+
   bool fileCopied = CopyFile(destFile, sourceFile);
 
   if (!fileCopied)
@@ -112,6 +129,57 @@ void DataBuilder::BuildContent(BuildOptions& buildOptions)
   SetFileToCurrentTime(destFile);
 }
 
+void DataBuilder::BuildBinaryData(BuildOptions& buildOptions, StringParam sourceFile, StringParam destFile)
+{
+  String text = ReadFileIntoString(sourceFile);
+
+  Timer timer;
+  timer.Update();
+
+  Status status;
+  Array<byte> binary;
+  BinaryDataTreeWriter::ConvertText(status, text, sourceFile, binary);
+  if (status.Failed())
+  {
+    buildOptions.Failure = true;
+    buildOptions.Message = status.Message;
+    return;
+  }
+
+  double convertTime = timer.UpdateAndGetTime();
+
+  // Load the binary back to make sure it's good, and so we can compare how
+  // long it takes to load against parsing the text
+  DataTreeLoader loader;
+  loader.mIgnoreDataInheritance = true;
+  loader.OpenBuffer(status, StringRange((cstr)binary.Data(), (cstr)binary.Data() + binary.Size()), sourceFile);
+  if (status.Failed())
+  {
+    buildOptions.Failure = true;
+    buildOptions.Message = status.Message;
+    return;
+  }
+
+  double loadTime = timer.UpdateAndGetTime() - convertTime;
+
+  if (WriteToFile(destFile.c_str(), binary.Data(), binary.Size()) != binary.Size())
+  {
+    buildOptions.Failure = true;
+    buildOptions.Message = String::Format("Failed to write data file %s", destFile.c_str());
+    return;
+  }
+
+  SetFileToCurrentTime(destFile);
+
+  PlasmaPrintFilter(Filter::ResourceFilter,
+                    "Built binary data '%s' (%d to %d bytes, parsing text %.2fms, loading binary %.2fms)\n",
+                    Name.c_str(),
+                    (int)text.SizeInBytes(),
+                    (int)binary.Size(),
+                    convertTime * 1000.0,
+                    loadTime * 1000.0);
+}
+
 void DataBuilder::BuildListing(ResourceListing& listing)
 {
   String destFile = GetOutputFile();
@@ -31,6 +31,10 @@ public:
 
   String GetOutputFile();
 
+  /// Whether the output file is a binary data tree rather than a copy of the
+  /// text (only done for levels and archetypes, which can be large).
+  bool BuildsBinaryData();
+
   // BuilderComponent Interface
   void Generate(ContentInitializer& initializer) override;
   void Serialize(Serializer& stream) override;
@@ -39,6 +43,9 @@ public:
   bool NeedsBuilding(BuildOptions& options) override;
   void BuildContent(BuildOptions& buildOptions) override;
   void BuildListing(ResourceListing& listing) override;
+
+private:
+  void BuildBinaryData(BuildOptions& buildOptions, StringParam sourceFile, StringParam destFile);
 };
 
 } // namespace Plasma
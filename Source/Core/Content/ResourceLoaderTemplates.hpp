@@ -38,13 +38,28 @@ public:
   {
     ResourceType* resource = new ResourceType();
     resource->mContentItem = entry.mLibrarySource;
+    if (LoadFromDataBlock(*resource, entry.Block, defaultFormat))
+    {
+      if (entry.mBuilder)
+        resource->FilterTag = entry.mBuilder->GetTag();
 
-    LoadFromDataBlock(*resource, entry.Block, defaultFormat);
-    resource->Initialize();
-
-    ResourceMananger::GetInstance()->AddResource(entry, resource);
+      resource->Name = entry.Name;
+      resource->Initialize();
+      ResourceMananger::GetInstance()->AddResource(entry, resource);
+      return resource;
+    }
+    else
+    {
+      delete resource;
+      return nullptr;
+    }
+  }
 
-    return resource;
+  bool CanLoadFromBlock() override
+  {
+    // Binary data is read directly out of the block, text data is parsed into a
+    // tree either way so there's nothing to gain from packing it
+    return defaultFormat == DataFileFormat::Binary;
   }
 
   void ReloadFromFile(Resource* resourceToReload, ResourceEntry& entry) override
@@ -180,6 +195,11 @@ public:
     return newResource;
   }
 
+  bool CanLoadFromBlock() override
+  {
+    return true;
+  }
+
   void ReloadFromFile(Resource* resource, ResourceEntry& entry) override
   {
     ResourceType* newResource = (ResourceType*)resource;
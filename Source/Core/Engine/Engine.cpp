@@ -162,9 +162,14 @@ void Engine::Update()
 
     PL::gTracker->ClearDeletedObjects();
 
+    // Anything allocated from a frame arena two frames ago is no longer in use
+    Memory::FrameArena::NextFrameAll();
+
     PL::gJobs->RunJobsTimeSliced();
     PL::gDispatch->DispatchEvents();
 
+    PL::gResources->UpdateStreaming();
+
     LoadPendingLevels();
 
     // Update every system and tell each one how much
@@ -236,6 +236,8 @@ LightningDefineStaticLibrary(EngineLibrary)
   LightningInitializeType(ResourcePackageDisplay);
   LightningInitializeType(ResourcePackage);
   LightningInitializeType(ResourceLibrary);
+  LightningInitializeType(PackedResourceFile);
+  LightningInitializeType(PendingResourceLoad);
 
   LightningInitializeType(CogPath);
 
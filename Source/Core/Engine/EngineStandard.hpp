@@ -60,6 +60,7 @@ private:
 #include "Space.hpp"
 #include "DocumentResource.hpp"
 #include "LightningResource.hpp"
+#include "PackedResources.hpp"
 #include "ResourceLibrary.hpp"
 #include "JobSystem.hpp"
 #include "EngineEvents.hpp"
@@ -70,6 +71,7 @@ private:
 #include "Game.hpp"
 #include "Factory.hpp"
 #include "ArchetypeRebuilder.hpp"
+#include "ResourceStreaming.hpp"
 #include "ResourceSystem.hpp"
 #include "ResourcePropertyOperations.hpp"
 #include "ErrorContext.hpp"
@@ -36,6 +36,153 @@ namespace PL
 JobSystem* gJobs = nullptr;
 }
 
+// Hardware threads not given to task workers: the main thread (which runs tasks
+// itself while it waits) and the audio mix thread.
+const uint cReservedHardwareThreads = 2;
+// How many times an idle task worker looks for work before it sleeps.
+const uint cTaskWorkerSpinCount = 64;
+
+// The task queue owned by the current thread, or -1 if it doesn't own one.
+PlasmaThreadLocal int TaskQueueIndex = -1;
+
+TaskCounter::TaskCounter(TaskCounter* parent) : mPending(0), mParent(parent)
+{
+}
+
+bool TaskCounter::IsDone() const
+{
+  return mPending.Load() == 0;
+}
+
+void TaskCounter::Add(s32 count)
+{
+  // The parent only needs to know when we go from done to not done
+  if (mPending.FetchAdd(count) == 0 && mParent != nullptr)
+    mParent->Add(1);
+}
+
+bool TaskCounter::Finish()
+{
+  // The waiting thread may destroy the counter as soon as it's done, so nothing
+  // on it can be touched after the last decrement
+  TaskCounter* parent = mParent;
+  if (mPending.FetchAdd(-1) != 1)
+    return false;
+
+  if (parent != nullptr)
+    parent->Finish();
+  return true;
+}
+
+/// A fixed size work-stealing deque (Chase-Lev). Only the owning thread may
+/// push and pop from the bottom, any thread may steal from the top.
+class TaskDeque
+{
+public:
+  static const s64 cCapacity = 4096;
+
+  TaskDeque() : mTop(0), mBottom(0)
+  {
+  }
+
+  // Returns false if the queue is full.
+  bool Push(const Task& task)
+  {
+    s64 bottom = mBottom.Load();
+    s64 top = mTop.Load();
+    if (bottom - top >= cCapacity)
+      return false;
+
+    mTasks[bottom & (cCapacity - 1)] = task;
+    mBottom.Store(bottom + 1);
+    return true;
+  }
+
+  bool Pop(Task& task)
+  {
+    s64 bottom = mBottom.Load() - 1;
+    mBottom.Store(bottom);
+    s64 top = mTop.Load();
+
+    if (top > bottom)
+    {
+      // Empty, restore the bottom
+      mBottom.Store(top);
+      return false;
+    }
+
+    task = mTasks[bottom & (cCapacity - 1)];
+    if (top != bottom)
+      return true;
+
+    // This was the last task, so race any thieves for it
+    bool won = mTop.CompareExchange(top + 1, top) != 0;
+    mBottom.Store(top + 1);
+    return won;
+  }
+
+  bool Steal(Task& task)
+  {
+    s64 top = mTop.Load();
+    s64 bottom = mBottom.Load();
+    if (top >= bottom)
+      return false;
+
+    task = mTasks[top & (cCapacity - 1)];
+    return mTop.CompareExchange(top + 1, top) != 0;
+  }
+
+private:
+  Atomic<s64> mTop;
+  Atomic<s64> mBottom;
+  Task mTasks[cCapacity];
+};
+
+/// Shared state for the tasks running the chunks of one parallel loop.
+struct ParallelChunkContext
+{
+  /// Runs chunks until there are none left to take.
+  void RunChunks()
+  {
+    for (;;)
+    {
+      s32 index = mNextChunk.FetchAdd(1);
+      if (index >= (s32)mChunkCount)
+        return;
+      mFunction(mUserData, (size_t)index);
+    }
+  }
+
+  ParallelDispatcher::ChunkFunction mFunction;
+  void* mUserData;
+  size_t mChunkCount;
+  Atomic<s32> mNextChunk;
+};
+
+void RunParallelChunks(void* context)
+{
+  static_cast<ParallelChunkContext*>(context)->RunChunks();
+}
+
+/// Runs ParallelFor loops on the task scheduler. One task per thread pulls
+/// chunks so uneven chunks balance themselves out.
+void DispatchParallelChunks(ParallelDispatcher::ChunkFunction function, void* userData, size_t chunkCount)
+{
+  ParallelChunkContext context;
+  context.mFunction = function;
+  context.mUserData = userData;
+  context.mChunkCount = chunkCount;
+  context.mNextChunk = 0;
+
+  size_t taskCount = Math::Min(chunkCount, (size_t)PL::gJobs->GetTaskThreadCount()) - 1;
+  TaskCounter counter;
+  for (size_t i = 0; i < taskCount; ++i)
+    PL::gJobs->AddTask(&RunParallelChunks, &context, &counter);
+
+  context.RunChunks();
+  PL::gJobs->WaitFor(counter);
+}
+
 JobSystem::JobSystem()
 {
   if (ThreadingEnabled)
@@ -48,6 +195,34 @@ JobSystem::JobSystem()
       Thread& thread = *mWorkers[i];
       thread.Initialize(&Thread::ObjectEntryCreator<JobSystem, &JobSystem::WorkerThreadEntry>, this, "Background");
     }
+
+    // Always keep at least one worker so waiting threads have someone to run
+    // their tasks on single and dual core machines
+    uint hardwareThreads = Os::GetHardwareThreadCount();
+    uint taskWorkerCount = 1;
+    if (hardwareThreads > cReservedHardwareThreads + 1)
+      taskWorkerCount = hardwareThreads - cReservedHardwareThreads;
+
+    // The job system is created on the main thread which gets the first queue
+    mTaskQueues.Resize(taskWorkerCount + 1);
+    mWaitSignals.Resize(taskWorkerCount + 1);
+    for (uint i = 0; i < mTaskQueues.Size(); ++i)
+    {
+      mTaskQueues[i] = new TaskDeque();
+      mWaitSignals[i] = new Semaphore();
+    }
+    TaskQueueIndex = 0;
+    mNextTaskQueue = 1;
+
+    mTaskWorkers.Resize(taskWorkerCount);
+    for (uint i = 0; i < mTaskWorkers.Size(); ++i)
+    {
+      mTaskWorkers[i] = new Thread();
+      Thread& thread = *mTaskWorkers[i];
+      thread.Initialize(&Thread::ObjectEntryCreator<JobSystem, &JobSystem::TaskWorkerThreadEntry>, this, "Task");
+    }
+
+    ParallelDispatcher::SetDispatchFunction(&DispatchParallelChunks, GetTaskThreadCount());
   }
 }
 
@@ -85,6 +260,21 @@ JobSystem::~JobSystem()
 
   // Delete all threads.
   DeleteObjectsInContainer(mWorkers);
+
+  // Any tasks still queued are dropped, whoever added them should have waited
+  ParallelDispatcher::SetDispatchFunction(nullptr, 1);
+  mShuttingDown = true;
+  for (uint i = 0; i < mTaskWorkers.Size(); ++i)
+  {
+    mPendingTaskSignals.FetchAdd(1);
+    mTaskSignal.Increment();
+  }
+  for (uint i = 0; i < mTaskWorkers.Size(); ++i)
+    mTaskWorkers[i]->WaitForCompletion();
+  DeleteObjectsInContainer(mTaskWorkers);
+  DeleteObjectsInContainer(mTaskQueues);
+  DeleteObjectsInContainer(mWaitSignals);
+  TaskQueueIndex = -1;
 }
 
 Job* JobSystem::GetNextJob()
@@ -194,4 +384,210 @@ void JobSystem::JobComplete(Job* job)
     RunJob(job);
 }
 
+void JobSystem::AddTask(TaskFunction function, void* userData, TaskCounter* counter)
+{
+  Task task;
+  task.mFunction = function;
+  task.mUserData = userData;
+  task.mCounter = counter;
+
+  if (!ThreadingEnabled)
+  {
+    function(userData);
+    return;
+  }
+
+  if (counter != nullptr)
+    counter->Add(1);
+
+  if (TaskQueueIndex >= 0)
+  {
+    // If our queue is full just do the work now
+    if (!mTaskQueues[TaskQueueIndex]->Push(task))
+    {
+      RunTask(task);
+      return;
+    }
+  }
+  else
+  {
+    mSharedTaskLock.Lock();
+    mSharedTasks.PushBack(task);
+    mSharedTaskCount.FetchAdd(1);
+    mSharedTaskLock.Unlock();
+  }
+
+  // Only pay for the semaphore when someone is actually asleep, and post at
+  // most once per sleeping worker so unused posts can't build up
+  s32 pendingSignals = mPendingTaskSignals.Load();
+  while (pendingSignals < mSleepingTaskWorkers.Load())
+  {
+    if (mPendingTaskSignals.CompareExchange(pendingSignals + 1, pendingSignals) != 0)
+    {
+      mTaskSignal.Increment();
+      break;
+    }
+    pendingSignals = mPendingTaskSignals.Load();
+  }
+  // Waiting threads help with new work too
+  WakeWaitingThreads();
+}
+
+void JobSystem::WaitFor(TaskCounter& counter)
+{
+  // Threads without a task queue (such as Job threads) only create a signal if
+  // they actually have to sleep
+  Semaphore* ownedSignal = nullptr;
+
+  // Help with any pending work instead of blocking
+  while (!counter.IsDone())
+  {
+    if (RunOneTask())
+      continue;
+
+    Semaphore* signal = ownedSignal;
+    if (TaskQueueIndex >= 0)
+      signal = mWaitSignals[TaskQueueIndex];
+    else if (signal == nullptr)
+      signal = ownedSignal = new Semaphore();
+
+    mWaitLock.Lock();
+    mWaitingThreads.PushBack(signal);
+    mWaitingThreadCount.FetchAdd(1);
+    mWaitLock.Unlock();
+
+    // Check again now that we're registered. Anything that finished or was
+    // added before we registered was missed, anything after will wake us.
+    Task task;
+    bool foundTask = false;
+    if (counter.IsDone() || (foundTask = GetNextTask(task)))
+    {
+      // Unregister before running the task, since it may wait itself. If we
+      // were already woken the signal has to be consumed so it doesn't wake
+      // the next wait early.
+      if (!RemoveWaitingThread(signal))
+        signal->WaitAndDecrement();
+      if (foundTask)
+        RunTask(task);
+      continue;
+    }
+
+    signal->WaitAndDecrement();
+  }
+
+  delete ownedSignal;
+}
+
+uint JobSystem::GetTaskThreadCount()
+{
+  return mTaskWorkers.Size() + 1;
+}
+
+OsInt JobSystem::TaskWorkerThreadEntry()
+{
+  TaskQueueIndex = mNextTaskQueue.FetchAdd(1);
+
+  uint idleCount = 0;
+  while (!mShuttingDown.Load())
+  {
+    if (RunOneTask())
+    {
+      idleCount = 0;
+      continue;
+    }
+
+    if (++idleCount < cTaskWorkerSpinCount)
+      continue;
+
+    // Mark ourselves asleep before the last check so a task added after the
+    // check always sees us and signals
+    mSleepingTaskWorkers.FetchAdd(1);
+    if (!RunOneTask() && !mShuttingDown.Load())
+    {
+      mTaskSignal.WaitAndDecrement();
+      mPendingTaskSignals.FetchAdd(-1);
+    }
+    mSleepingTaskWorkers.FetchAdd(-1);
+    idleCount = 0;
+  }
+
+  TaskQueueIndex = -1;
+  return 0;
+}
+
+bool JobSystem::GetNextTask(Task& task)
+{
+  int queueIndex = TaskQueueIndex;
+  if (queueIndex >= 0 && mTaskQueues[queueIndex]->Pop(task))
+    return true;
+
+  // Avoid taking the lock in the common case where nothing is shared
+  if (mSharedTaskCount.Load() > 0)
+  {
+    mSharedTaskLock.Lock();
+    bool found = !mSharedTasks.Empty();
+    if (found)
+    {
+      task = mSharedTasks.Back();
+      mSharedTasks.PopBack();
+      mSharedTaskCount.FetchAdd(-1);
+    }
+    mSharedTaskLock.Unlock();
+    if (found)
+      return true;
+  }
+
+  // Steal starting after our own queue so thieves spread out
+  uint queueCount = mTaskQueues.Size();
+  uint start = (uint)(queueIndex + 1);
+  for (uint i = 0; i < queueCount; ++i)
+  {
+    uint victim = (start + i) % queueCount;
+    if ((int)victim != queueIndex && mTaskQueues[victim]->Steal(task))
+      return true;
+  }
+  return false;
+}
+
+bool JobSystem::RunOneTask()
+{
+  Task task;
+  if (!GetNextTask(task))
+    return false;
+
+  RunTask(task);
+  return true;
+}
+
+void JobSystem::RunTask(Task& task)
+{
+  task.mFunction(task.mUserData);
+  if (task.mCounter != nullptr && task.mCounter->Finish())
+    WakeWaitingThreads();
+}
+
+void JobSystem::WakeWaitingThreads()
+{
+  // Avoid taking the lock in the common case where nobody is waiting
+  if (mWaitingThreadCount.Load() == 0)
+    return;
+
+  mWaitLock.Lock();
+  for (uint i = 0; i < mWaitingThreads.Size(); ++i)
+    mWaitingThreads[i]->Increment();
+  mWaitingThreads.Clear();
+  mWaitingThreadCount.Store(0);
+  mWaitLock.Unlock();
+}
+
+bool JobSystem::RemoveWaitingThread(Semaphore* signal)
+{
+  mWaitLock.Lock();
+  bool found = mWaitingThreads.EraseValue(signal);
+  if (found)
+    mWaitingThreadCount.FetchAdd(-1);
+  mWaitLock.Unlock();
+  return found;
+}
+
 } // namespace Plasma
@@ -46,6 +46,41 @@ private:
   size_t mRunCount;
 };
 
+/// A lightweight unit of work for the task scheduler. Unlike a Job a task is
+/// just a function and its data, so it can be issued thousands of times per
+/// frame without allocating or reference counting.
+typedef void (*TaskFunction)(void* userData);
+
+/// Counts the unfinished tasks of a group so that a thread can wait on them.
+/// A counter may have a parent, which is not done until all of its children
+/// are done. Must outlive every task that was added with it.
+class TaskCounter
+{
+public:
+  TaskCounter(TaskCounter* parent = nullptr);
+
+  /// Whether all tasks (and child counters) added to this counter have run.
+  bool IsDone() const;
+
+  /// Called by the JobSystem when tasks are added and finished. Finish returns
+  /// true when it finished the last task of this counter.
+  void Add(s32 count);
+  bool Finish();
+
+private:
+  Atomic<s32> mPending;
+  TaskCounter* mParent;
+};
+
+struct Task
+{
+  TaskFunction mFunction;
+  void* mUserData;
+  TaskCounter* mCounter;
+};
+
+class TaskDeque;
+
 class JobSystem : public EventObject
 {
 public:
@@ -66,6 +101,20 @@ public:
 
   bool AreAllJobsCompleted();
 
+  // Adds a task to the work-stealing scheduler (can be called from any
+  // thread). Tasks added from a task worker or the main thread go to that
+  // thread's own queue, idle workers steal from the other queues. When
+  // threading is disabled the task is run immediately.
+  void AddTask(TaskFunction function, void* userData, TaskCounter* counter);
+  // Runs pending tasks on the calling thread until the counter is done. When
+  // there is nothing to run the thread sleeps until a counter finishes or a
+  // task is added.
+  void WaitFor(TaskCounter& counter);
+  // How many threads (including the calling one) can run tasks at once.
+  uint GetTaskThreadCount();
+
+  OsInt TaskWorkerThreadEntry();
+
 private:
   // Takes a job from the job queue and runs it.
   // If no jobs are available, this will return false.
@@ -82,6 +131,37 @@ private:
   Semaphore mJobCounter;
   Job* GetNextJob();
   friend class Job;
+
+  // Pops from our own queue, then the shared queue, then steals from others.
+  bool GetNextTask(Task& task);
+  bool RunOneTask();
+  void RunTask(Task& task);
+
+  // Wakes every thread sleeping in WaitFor so it can check its counter again.
+  void WakeWaitingThreads();
+  // Returns false if the thread was already woken (its signal is pending).
+  bool RemoveWaitingThread(Semaphore* signal);
+
+  // One queue per task worker plus one for the main thread (index 0).
+  Array<TaskDeque*> mTaskQueues;
+  Array<Thread*> mTaskWorkers;
+  // Tasks added from threads that don't own a queue (such as Job threads).
+  ThreadLock mSharedTaskLock;
+  Array<Task> mSharedTasks;
+  Atomic<s32> mSharedTaskCount;
+  Semaphore mTaskSignal;
+  Atomic<s32> mSleepingTaskWorkers;
+  // Posts to mTaskSignal that no worker has taken yet.
+  Atomic<s32> mPendingTaskSignals;
+  // Threads sleeping in WaitFor. Each has its own semaphore so a wake can't be
+  // taken by a different sleeper. One per task queue, other threads make their
+  // own when they need to sleep.
+  ThreadLock mWaitLock;
+  Array<Semaphore*> mWaitingThreads;
+  Atomic<s32> mWaitingThreadCount;
+  Array<Semaphore*> mWaitSignals;
+  Atomic<s32> mNextTaskQueue;
+  Atomic<bool> mShuttingDown;
 };
 
 namespace PL
@@ -48,6 +48,15 @@ BoundType* LightningCompileEvent::GetReplacingType(BoundType* oldType)
   return nullptr;
 }
 
+// Parses the scripts of a resource library (run on worker threads)
+struct PreParseScriptsFunctor
+{
+  void operator()(ResourceLibrary* resourceLibrary) const
+  {
+    resourceLibrary->mScriptProject.PreParse(EvaluationMode::Project);
+  }
+};
+
 // Lightning Manager
 LightningManager::LightningManager() :
     mVersion(0),
@@ -84,6 +93,8 @@ void LightningManager::InternalCompile()
     return;
   mShouldAttemptCompile = false;
 
+  PreParseScripts();
+
   forRange (ResourceLibrary* resourceLibrary, PL::gResources->LoadedResourceLibraries.Values())
   {
     if (resourceLibrary->CompileScripts(mPendingLibraries) == false)
@@ -131,6 +142,9 @@ void LightningManager::InternalCompile()
     mPendingFragmentProjectLibrary = nullptr;
   }
 
+  // Anything that cached a member lookup on the old types has to look it up again
+  Lightning::InlineCacheGeneration::Invalidate();
+
   this->DispatchEvent(Events::ScriptsCompiledPatch, &compileEvent);
   this->DispatchEvent(Events::ScriptsCompiledPostPatch, &compileEvent);
 
@@ -141,6 +155,36 @@ void LightningManager::InternalCompile()
   mLastCompileResult = CompileResult::CompilationSucceeded;
 }
 
+void LightningManager::PreParseScripts()
+{
+  // Tokenizing and parsing don't depend on any other library, so we do it for
+  // every library that needs its scripts compiled all at once, spread across
+  // worker threads. Type checking and code generation create types and call
+  // into the rest of the engine, so they still happen on this thread in
+  // dependency order (see ResourceLibrary::CompileScripts)
+  Array<ResourceLibrary*> librariesToParse;
+  forRange (ResourceLibrary* resourceLibrary, PL::gResources->LoadedResourceLibraries.Values())
+  {
+    if (resourceLibrary->mSwapScript.mCompileStatus != LightningCompileStatus::Modified)
+      continue;
+
+    resourceLibrary->LoadScriptProject();
+
+    // Error handlers aren't thread safe, so errors are held until we're back
+    resourceLibrary->mScriptProject.DeferErrors = true;
+    librariesToParse.PushBack(resourceLibrary);
+  }
+
+  PreParseScriptsFunctor preParse;
+  ParallelFor(librariesToParse.All(), 1, preParse);
+
+  forRange (ResourceLibrary* resourceLibrary, librariesToParse.All())
+  {
+    resourceLibrary->mScriptProject.DeferErrors = false;
+    resourceLibrary->mScriptProject.SendDeferredErrors();
+  }
+}
+
 void LightningManager::OnEngineUpdate(UpdateEvent* event)
 {
   InternalCompile();
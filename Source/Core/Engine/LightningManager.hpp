@@ -52,6 +52,10 @@ public:
   /// Compiles all Scripts and Fragments.
   void InternalCompile();
 
+  /// Tokenizes and parses the scripts of every library that needs compiling
+  /// on worker threads, ahead of the (serial) type checking.
+  void PreParseScripts();
+
   // If dirtied we attempt to compile every engine update (checks dirty flag)
   void OnEngineUpdate(UpdateEvent* event);
 
@@ -0,0 +1,186 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// Bump this whenever the layout changes (packed files are written when a
+// project is exported, so old ones are never loaded by mistake)
+static const u32 cPackedResourceFileVersion = 1;
+
+// Every packed file starts with these bytes
+static const byte cPackedResourceFileMagic[] = {'P', 'R', 'P', 'K'};
+
+struct PackedResourceHeader
+{
+  byte mMagic[4];
+  u32 mVersion;
+  u32 mResourceCount;
+  u32 mAlignment;
+};
+
+// The header is followed by one of these for every resource
+struct PackedResourceTableEntry
+{
+  u64 mResourceId;
+  u64 mOffset;
+  u64 mSize;
+};
+
+static u64 AlignPackedOffset(u64 offset)
+{
+  u64 alignment = PackedResourceFile::cAlignment;
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+const String PackedResourceFile::cExtension = ".packdata";
+
+LightningDefineType(PackedResourceFile, builder, type)
+{
+}
+
+bool PackedResourceFile::Write(Status& status, StringParam filePath, Array<ResourceEntry>& entries)
+{
+  // Lay out the whole file first so the table can be written up front
+  Array<PackedResourceTableEntry> table;
+  table.Resize(entries.Size());
+
+  u64 offset = sizeof(PackedResourceHeader) + sizeof(PackedResourceTableEntry) * table.Size();
+  for (size_t i = 0; i < entries.Size(); ++i)
+  {
+    ResourceEntry& entry = entries[i];
+    offset = AlignPackedOffset(offset);
+
+    PackedResourceTableEntry& tableEntry = table[i];
+    tableEntry.mResourceId = entry.mResourceId.mValue;
+    tableEntry.mOffset = offset;
+    tableEntry.mSize = GetFileSize(entry.FullPath);
+    offset += tableEntry.mSize;
+  }
+
+  File file;
+  if (!file.Open(filePath, FileMode::Write, FileAccessPattern::Sequential, FileShare::Unspecified, &status))
+  {
+    if (status.Succeeded())
+      status.SetFailed(String::Format("Failed to open '%s' for writing", filePath.c_str()));
+    return false;
+  }
+
+  PackedResourceHeader header;
+  memcpy(header.mMagic, cPackedResourceFileMagic, sizeof(header.mMagic));
+  header.mVersion = cPackedResourceFileVersion;
+  header.mResourceCount = (u32)table.Size();
+  header.mAlignment = (u32)cAlignment;
+  file.Write((byte*)&header, sizeof(header));
+  file.Write((byte*)table.Data(), sizeof(PackedResourceTableEntry) * table.Size());
+
+  u64 written = sizeof(PackedResourceHeader) + sizeof(PackedResourceTableEntry) * table.Size();
+  byte padding[cAlignment] = {0};
+  for (size_t i = 0; i < entries.Size(); ++i)
+  {
+    PackedResourceTableEntry& tableEntry = table[i];
+    file.Write(padding, (size_t)(tableEntry.mOffset - written));
+    written = tableEntry.mOffset;
+
+    size_t size = 0;
+    byte* data = ReadFileIntoMemory(entries[i].FullPath.c_str(), size);
+    if (size != tableEntry.mSize || (data == nullptr && size != 0))
+    {
+      if (data != nullptr)
+        plDeallocate(data);
+      status.SetFailed(String::Format("Failed to read '%s' while packing resources", entries[i].FullPath.c_str()));
+      return false;
+    }
+
+    if (data != nullptr)
+    {
+      file.Write(data, size);
+      plDeallocate(data);
+    }
+    written += size;
+  }
+
+  return true;
+}
+
+bool PackedResourceFile::Open(Status& status, StringParam filePath)
+{
+  mBlocks.Clear();
+  if (!mFile.Open(status, filePath))
+    return false;
+
+  const byte* data = mFile.GetData();
+  u64 fileSize = mFile.GetSize();
+
+  PackedResourceHeader header;
+  if (fileSize < sizeof(header))
+  {
+    status.SetFailed(String::Format("Packed resource file '%s' is truncated", filePath.c_str()));
+    mFile.Close();
+    return false;
+  }
+
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.mMagic, cPackedResourceFileMagic, sizeof(header.mMagic)) != 0 ||
+      header.mVersion != cPackedResourceFileVersion || header.mAlignment != cAlignment)
+  {
+    status.SetFailed(String::Format("'%s' is not a supported packed resource file", filePath.c_str()));
+    mFile.Close();
+    return false;
+  }
+
+  u64 tableEnd = sizeof(header) + sizeof(PackedResourceTableEntry) * (u64)header.mResourceCount;
+  if (fileSize < tableEnd)
+  {
+    status.SetFailed(String::Format("Packed resource file '%s' is truncated", filePath.c_str()));
+    mFile.Close();
+    return false;
+  }
+
+  const PackedResourceTableEntry* table = (const PackedResourceTableEntry*)(data + sizeof(header));
+  for (u32 i = 0; i < header.mResourceCount; ++i)
+  {
+    const PackedResourceTableEntry& tableEntry = table[i];
+    if (tableEntry.mOffset < tableEnd || tableEntry.mSize > fileSize - tableEntry.mOffset)
+    {
+      status.SetFailed(String::Format("Packed resource file '%s' is corrupt", filePath.c_str()));
+      mBlocks.Clear();
+      mFile.Close();
+      return false;
+    }
+
+    // Mapped pages are read only, but DataBlock doesn't have a const version
+    DataBlock block((byte*)data + tableEntry.mOffset, (size_t)tableEntry.mSize);
+    mBlocks.Insert(ResourceId(tableEntry.mResourceId), block);
+  }
+
+  return true;
+}
+
+bool PackedResourceFile::OpenUnpacked(Status& status, StringParam filePath, ResourceId resourceId)
+{
+  mBlocks.Clear();
+  if (!mFile.Open(status, filePath))
+    return false;
+
+  DataBlock block((byte*)mFile.GetData(), mFile.GetSize());
+  mBlocks.Insert(resourceId, block);
+  return true;
+}
+
+bool PackedResourceFile::FindBlock(ResourceId resourceId, DataBlock& blockOut)
+{
+  DataBlock* block = mBlocks.FindPointer(resourceId);
+  if (block == nullptr)
+    return false;
+
+  blockOut = *block;
+  return true;
+}
+
+size_t PackedResourceFile::GetResourceCount()
+{
+  return mBlocks.Size();
+}
+
+} // namespace Plasma
@@ -0,0 +1,51 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+class ResourceEntry;
+
+/// The data of every resource in a package whose loader can load from memory,
+/// packed into one file that sits next to the package (the package file itself
+/// still lists every resource). Each resource starts on an aligned offset, so
+/// the file can be mapped and loaders can read their data straight out of the
+/// mapping instead of reading each file into a buffer first. Since the mapping
+/// is shared through the OS file cache, every process running the same content
+/// on a machine shares the same physical pages.
+class PackedResourceFile : public ReferenceCountedObject
+{
+public:
+  LightningDeclareType(PackedResourceFile, TypeCopyMode::ReferenceType);
+
+  /// Extension of packed files (the file is named after the package).
+  static const String cExtension;
+
+  /// Where every resource's data starts is aligned to this many bytes.
+  static const u64 cAlignment = 64;
+
+  /// Writes the file of every entry into one packed file. The full path of
+  /// every entry must be set.
+  static bool Write(Status& status, StringParam filePath, Array<ResourceEntry>& entries);
+
+  /// Maps the packed file and reads its table of resources.
+  bool Open(Status& status, StringParam filePath);
+
+  /// Maps a single resource's file that wasn't packed, so it can be loaded
+  /// the same way as a packed resource.
+  bool OpenUnpacked(Status& status, StringParam filePath, ResourceId resourceId);
+
+  /// Gets where the given resource's data is in the mapping. Returns false if
+  /// the resource wasn't packed. The block is valid for as long as this object
+  /// is alive and must never be written to.
+  bool FindBlock(ResourceId resourceId, DataBlock& blockOut);
+
+  /// How many resources were packed.
+  size_t GetResourceCount();
+
+private:
+  MappedFile mFile;
+  HashMap<ResourceId, DataBlock> mBlocks;
+};
+
+} // namespace Plasma
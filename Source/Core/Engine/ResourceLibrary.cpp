@@ -67,6 +67,9 @@ void ResourceEntry::Serialize(Serializer& stream)
   SerializeName(Type);
   SerializeName(Name);
   SerializeName(Location);
+  // Streamed packages only load a resource once every resource with a lower
+  // load order is loaded
+  SerializeNameDefault(LoadOrder, 0u);
 }
 
 Plasma::ResourceTemplate* ResourceEntry::GetResourceTemplate()
@@ -378,6 +381,8 @@ void ResourceLibrary::Unload()
   Resources.Clear();
   sLibraryUnloading = false;
 
+  mPackedResources = nullptr;
+
   // Remove ourself as dependents on our dependencies
   forRange (ResourceLibrary* dependency, Dependencies.All())
     dependency->Dependents.EraseValue(this);
@@ -536,6 +541,25 @@ bool ResourceLibrary::CompileScripts(HashSet<ResourceLibrary*>& modifiedLibrarie
   // By this point, we've already compiled all our dependencies
   PlasmaPrint("  Compiling %s Scripts\n", this->Name.c_str());
 
+  // The LightningManager may have already loaded and parsed our scripts (on
+  // another thread), in which case the compile picks up from there
+  if (mScriptProject.IsPreParsed() == false)
+    LoadScriptProject();
+
+  mSwapScript.mPendingLibrary = mScriptProject.Compile(this->Name, dependencies, EvaluationMode::Project);
+
+  if (mSwapScript.mPendingLibrary != nullptr)
+  {
+    modifiedLibrariesOut.Insert(this);
+    mSwapScript.mCompileStatus = LightningCompileStatus::Compiled;
+    return true;
+  }
+
+  return false;
+}
+
+void ResourceLibrary::LoadScriptProject()
+{
   // Clear the project out since it may have files from before
   mScriptProject.Clear();
 
@@ -548,17 +572,6 @@ bool ResourceLibrary::CompileScripts(HashSet<ResourceLibrary*>& modifiedLibrarie
     if (script->GetResourceTemplate() == nullptr)
       mScriptProject.AddCodeFromString(script->mText, script->GetOrigin(), script);
   }
-
-  mSwapScript.mPendingLibrary = mScriptProject.Compile(this->Name, dependencies, EvaluationMode::Project);
-
-  if (mSwapScript.mPendingLibrary != nullptr)
-  {
-    modifiedLibrariesOut.Insert(this);
-    mSwapScript.mCompileStatus = LightningCompileStatus::Compiled;
-    return true;
-  }
-
-  return false;
 }
 
 bool ResourceLibrary::CompileFragments(HashSet<ResourceLibrary*>& modifiedLibraries)
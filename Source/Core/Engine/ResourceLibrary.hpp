@@ -78,6 +78,10 @@ public:
   // Loading from Data.
   DataBlock Block;
 
+  // When the block is in a packed resource file, keeps the mapping alive for
+  // anything that holds onto the block after loading.
+  HandleOf<PackedResourceFile> BlockOwner;
+
   // Only available when the editor is active.
   ContentItem* mLibrarySource;
   BuilderComponent* mBuilder;
@@ -190,6 +194,9 @@ public:
   bool CompileFragments(HashSet<ResourceLibrary*>& modifiedLibrariesOut);
   bool CompilePlugins(HashSet<ResourceLibrary*>& modifiedLibrariesOut);
 
+  // Fills out the script project with all of our (non-template) scripts
+  void LoadScriptProject();
+
   void OnScriptProjectPreParser(ParseEvent* e);
   void OnScriptProjectPostSyntaxer(ParseEvent* e);
 
@@ -236,6 +243,10 @@ public:
   // Resources in this library alive.
   Array<HandleOf<Resource>> Resources;
 
+  // The packed data of our resources, if the package was exported with it
+  // (the resources themselves may keep it alive for longer).
+  HandleOf<PackedResourceFile> mPackedResources;
+
   // When a Resource is added, we want to do something special for scripts and
   // fragments. Unfortunately, we don't know those types in the Engine project.
   // These should be set during the Graphics and LightningScript project
@@ -202,6 +202,12 @@ public:
   {
     return nullptr;
   }
+  // Whether LoadFromBlock reads the resource out of the block (resources with
+  // loaders that do are packed into one file when a project is exported)
+  virtual bool CanLoadFromBlock()
+  {
+    return false;
+  }
 };
 
 // Manager Setup
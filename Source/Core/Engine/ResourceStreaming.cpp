@@ -0,0 +1,613 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// How long the main thread spends loading streamed resources each frame.
+const double cDefaultStreamingFrameBudget = 0.004;
+
+// How many resources can be read ahead of the main thread loading them.
+const uint cMaxStreamingReadAhead = 256;
+
+// Pages are touched at this stride to page in mapped data.
+const size_t cStreamingPageSize = 4096;
+
+/// A resource queued by a PendingResourceLoad.
+class StreamedResource
+{
+public:
+  StreamedResource() :
+      mEntry(nullptr),
+      mLoad(nullptr),
+      mPriority(ResourceStreamPriority::Normal),
+      mSequence(0),
+      mUnpackedFile(nullptr),
+      mFindReferences(false)
+  {
+  }
+
+  ~StreamedResource()
+  {
+    // Only set if the resource was read but never loaded
+    delete mUnpackedFile;
+  }
+
+  ResourceEntry* mEntry;
+  // Kept alive by the streamer until every resource in it is done
+  PendingResourceLoad* mLoad;
+  ResourceStreamPriority::Enum mPriority;
+  uint mSequence;
+
+  // The reader maps the file of a resource that wasn't packed. A raw pointer so
+  // that no handles are made on the reader thread, it's owned by the main
+  // thread once the resource has been read.
+  PackedResourceFile* mUnpackedFile;
+
+  // Levels and archetypes find the resources they reference when they're read
+  bool mFindReferences;
+  Array<ResourceId> mReferences;
+};
+
+/// Reads the resources queued in the streamer.
+class ResourceReadJob : public Job
+{
+public:
+  ResourceReadJob(ResourceStreamer* streamer) : mStreamer(streamer)
+  {
+  }
+
+  void Execute() override
+  {
+    mStreamer->ReadQueued();
+  }
+
+  ResourceStreamer* mStreamer;
+};
+
+static bool IsHigherPriority(StreamedResource* left, StreamedResource* right)
+{
+  if (left->mPriority != right->mPriority)
+    return left->mPriority > right->mPriority;
+  if (left->mEntry->LoadOrder != right->mEntry->LoadOrder)
+    return left->mEntry->LoadOrder < right->mEntry->LoadOrder;
+  return left->mSequence < right->mSequence;
+}
+
+// The queues of streamed resources are binary heaps with the highest priority
+// resource at the front
+static void SiftDown(Array<StreamedResource*>& queue, uint index)
+{
+  StreamedResource* resource = queue[index];
+  uint size = queue.Size();
+  for (;;)
+  {
+    uint child = index * 2 + 1;
+    if (child >= size)
+      break;
+    if (child + 1 < size && IsHigherPriority(queue[child + 1], queue[child]))
+      ++child;
+    if (!IsHigherPriority(queue[child], resource))
+      break;
+
+    queue[index] = queue[child];
+    index = child;
+  }
+  queue[index] = resource;
+}
+
+static void PushResource(Array<StreamedResource*>& queue, StreamedResource* resource)
+{
+  uint index = queue.Size();
+  queue.PushBack(resource);
+  while (index != 0)
+  {
+    uint parent = (index - 1) / 2;
+    if (!IsHigherPriority(resource, queue[parent]))
+      break;
+
+    queue[index] = queue[parent];
+    index = parent;
+  }
+  queue[index] = resource;
+}
+
+static StreamedResource* PopResource(Array<StreamedResource*>& queue)
+{
+  StreamedResource* resource = queue[0];
+  queue[0] = queue.Back();
+  queue.PopBack();
+  if (!queue.Empty())
+    SiftDown(queue, 0);
+  return resource;
+}
+
+static void PushResources(Array<StreamedResource*>& queue, Array<StreamedResource*>& resources)
+{
+  forRange (StreamedResource* resource, resources.All())
+    PushResource(queue, resource);
+  resources.Clear();
+}
+
+// Restores the order of a queue after priorities were changed
+static void SortQueue(Array<StreamedResource*>& queue)
+{
+  for (uint i = queue.Size() / 2; i > 0; --i)
+    SiftDown(queue, i - 1);
+}
+
+static int GetHexDigitValue(byte c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+// Resource references are written as a 16 digit hex id followed by ':' and the
+// resource's name, which is the same in text and binary data files
+static void FindResourceReferences(DataBlock block, Array<ResourceId>& referencesOut)
+{
+  u64 id = 0;
+  uint digitCount = 0;
+  for (size_t i = 0; i < block.Size; ++i)
+  {
+    byte c = block.Data[i];
+    int value = GetHexDigitValue(c);
+    if (value >= 0)
+    {
+      id = (id << 4) | (u64)value;
+      ++digitCount;
+      continue;
+    }
+
+    if (c == ':' && digitCount == cHex64Size)
+      referencesOut.PushBack(ResourceId(id));
+
+    id = 0;
+    digitCount = 0;
+  }
+}
+
+// Reads a byte from every page so the data is read from disk on this thread
+// rather than when the resource is loaded
+static void TouchPages(DataBlock block)
+{
+  volatile byte sum = 0;
+  for (size_t i = 0; i < block.Size; i += cStreamingPageSize)
+    sum += block.Data[i];
+}
+
+static bool IsLevelOrArchetype(StringParam loaderType)
+{
+  return loaderType == "Level" || loaderType == "Cog" || loaderType == "Space" || loaderType == "GameSession";
+}
+
+LightningDefineType(PendingResourceLoad, builder, type)
+{
+}
+
+PendingResourceLoad::PendingResourceLoad() : mFinishedCount(0), mLowestLoadOrder(0), mResourcesAdded(false)
+{
+}
+
+bool PendingResourceLoad::IsDone()
+{
+  return mFinishedCount == mResources.Size();
+}
+
+float PendingResourceLoad::GetProgress()
+{
+  if (mResources.Empty())
+    return 1.0f;
+  return (float)mFinishedCount / (float)mResources.Size();
+}
+
+ResourceLibrary* PendingResourceLoad::GetLibrary()
+{
+  return mLibrary;
+}
+
+void PendingResourceLoad::ResourceFinished(uint loadOrder)
+{
+  ++mFinishedCount;
+
+  uint* unfinished = mUnfinishedPerLoadOrder.FindPointer(loadOrder);
+  ErrorIf(unfinished == nullptr || *unfinished == 0, "Finished a resource that wasn't streaming");
+  if (--(*unfinished) != 0)
+    return;
+
+  mUnfinishedPerLoadOrder.Erase(loadOrder);
+
+  // Resources of the next load order can now be loaded
+  mLowestLoadOrder = uint(-1);
+  forRange (uint order, mUnfinishedPerLoadOrder.Keys())
+    mLowestLoadOrder = Math::Min(mLowestLoadOrder, order);
+}
+
+ResourceStreamer::ResourceStreamer() :
+    mFrameBudget(cDefaultStreamingFrameBudget),
+    mUnblockQueued(false),
+    mReadCount(0),
+    mReading(false),
+    mCancelled(false),
+    mNextSequence(0)
+{
+}
+
+ResourceStreamer::~ResourceStreamer()
+{
+  CancelAll();
+}
+
+void ResourceStreamer::Add(PendingResourceLoad* load, ResourceStreamPriority::Enum priority)
+{
+  load->mLowestLoadOrder = uint(-1);
+
+  mLock.Lock();
+  forRange (ResourceEntry& entry, load->mResources.All())
+  {
+    StreamedResource* resource = new StreamedResource();
+    resource->mEntry = &entry;
+    resource->mLoad = load;
+    resource->mPriority = priority;
+    resource->mSequence = mNextSequence++;
+
+    // Levels and archetypes are read first, so that what they reference is
+    // known as early as possible
+    resource->mFindReferences = IsLevelOrArchetype(entry.Type);
+    if (resource->mFindReferences && priority < ResourceStreamPriority::High)
+      resource->mPriority = ResourceStreamPriority::High;
+
+    ++load->mUnfinishedPerLoadOrder[entry.LoadOrder];
+    load->mLowestLoadOrder = Math::Min(load->mLowestLoadOrder, entry.LoadOrder);
+
+    mStreaming.Insert(entry.mResourceId, resource);
+    PushResource(mQueued, resource);
+  }
+  mLock.Unlock();
+
+  mLoads.PushBack(load);
+}
+
+void ResourceStreamer::Update()
+{
+  if (mLoads.Empty())
+    return;
+
+  ZoneScoped;
+  ProfileScopeFunction();
+
+  mLock.Lock();
+  PushResources(mReady, mRead);
+  bool startReading = !mReading && (!mQueued.Empty() || !mBlockedQueued.Empty());
+  if (startReading)
+    mReading = true;
+  mLock.Unlock();
+
+  if (startReading)
+    PL::gJobs->AddJob(new ResourceReadJob(this));
+
+  Timer timer;
+  do
+  {
+    StreamedResource* resource = TakeNextReady();
+    if (resource == nullptr)
+      break;
+
+    Finish(resource);
+  } while (timer.UpdateAndGetTime() < mFrameBudget);
+
+  // Loads are finished in the order they were started
+  for (uint i = 0; i < mLoads.Size();)
+  {
+    PendingResourceLoad* load = mLoads[i];
+    ResourceLibrary* library = load->mLibrary;
+
+    // Anything that registers resources in batches (such as graphics with
+    // materials) does so when it's told resources were loaded
+    if (load->mResourcesAdded && library != nullptr)
+    {
+      load->mResourcesAdded = false;
+
+      ResourceEvent event;
+      event.Name = library->Name;
+      event.EventResourceLibrary = library;
+      PL::gResources->DispatchEvent(Events::ResourcesLoaded, &event);
+    }
+
+    if (load->IsDone())
+    {
+      FinishLoad(load);
+      mLoads.EraseAt(i);
+    }
+    else
+    {
+      ++i;
+    }
+  }
+}
+
+bool ResourceStreamer::PrepareLevel(Level* level)
+{
+  if (mStreaming.Empty() || level == nullptr)
+    return true;
+
+  Array<ResourceId> toVisit;
+  GetLevelReferences(level, toVisit);
+
+  bool ready = true;
+  bool raisedPriority = false;
+  HashSet<ResourceId> visited;
+
+  mLock.Lock();
+  while (!toVisit.Empty())
+  {
+    ResourceId resourceId = toVisit.Back();
+    toVisit.PopBack();
+    if (!visited.Insert(resourceId))
+      continue;
+
+    if (StreamedResource* resource = mStreaming.FindValue(resourceId, nullptr))
+    {
+      raisedPriority |= resource->mPriority != ResourceStreamPriority::NextLevel;
+      resource->mPriority = ResourceStreamPriority::NextLevel;
+      ready = false;
+    }
+
+    // Archetypes the level uses are followed to what they use. Ones that are
+    // still streaming are followed once they've been read.
+    if (Array<ResourceId>* references = mReferences.FindPointer(resourceId))
+      toVisit.Append(references->All());
+  }
+
+  if (raisedPriority)
+  {
+    SortQueue(mQueued);
+    SortQueue(mBlockedQueued);
+    SortQueue(mReady);
+  }
+  mLock.Unlock();
+
+  return ready;
+}
+
+bool ResourceStreamer::IsStreaming()
+{
+  return !mLoads.Empty();
+}
+
+void ResourceStreamer::CancelAll()
+{
+  mLock.Lock();
+  mCancelled = true;
+  bool reading = mReading;
+  mLock.Unlock();
+
+  // Wait for the reader to finish the resource it's reading (without threading
+  // the reader only runs on this thread, so it can't be in the middle of one)
+  if (ThreadingEnabled && reading)
+    mReaderStopped.WaitAndDecrement();
+
+  mLock.Lock();
+  DeleteObjectsInContainer(mStreaming);
+  mQueued.Clear();
+  mBlockedQueued.Clear();
+  mUnblockQueued = false;
+  mRead.Clear();
+  mReadCount = 0;
+  mCancelled = false;
+  mLock.Unlock();
+
+  mReady.Clear();
+  mBlockedReady.Clear();
+  mLoads.Clear();
+  mReferences.Clear();
+}
+
+void ResourceStreamer::ReadQueued()
+{
+  Timer timer;
+  for (;;)
+  {
+    mLock.Lock();
+    StreamedResource* resource = mCancelled ? nullptr : TakeNextQueued();
+    if (resource == nullptr)
+    {
+      mReading = false;
+      // CancelAll is waiting on us if it saw us reading
+      if (mCancelled && ThreadingEnabled)
+        mReaderStopped.Increment();
+      mLock.Unlock();
+      return;
+    }
+    mLock.Unlock();
+
+    Read(resource);
+
+    mLock.Lock();
+    mRead.PushBack(resource);
+    ++mReadCount;
+
+    // Without threading this runs on the main thread, so it only gets a slice
+    // of the frame (it's started again next frame)
+    if (!ThreadingEnabled && timer.UpdateAndGetTime() >= mFrameBudget)
+    {
+      mReading = false;
+      mLock.Unlock();
+      return;
+    }
+    mLock.Unlock();
+  }
+}
+
+StreamedResource* ResourceStreamer::TakeNextQueued()
+{
+  if (mUnblockQueued)
+  {
+    PushResources(mQueued, mBlockedQueued);
+    mUnblockQueued = false;
+  }
+
+  // Once enough resources are waiting to be loaded, only read the ones that can
+  // be loaded right away. Otherwise the read ahead could fill up with resources
+  // waiting on a lower load order that hasn't been read yet.
+  if (mReadCount < cMaxStreamingReadAhead)
+  {
+    bool takeBlocked = !mBlockedQueued.Empty() && (mQueued.Empty() || IsHigherPriority(mBlockedQueued[0], mQueued[0]));
+    if (takeBlocked)
+      return PopResource(mBlockedQueued);
+    if (!mQueued.Empty())
+      return PopResource(mQueued);
+    return nullptr;
+  }
+
+  while (!mQueued.Empty())
+  {
+    StreamedResource* resource = PopResource(mQueued);
+    if (resource->mEntry->LoadOrder <= resource->mLoad->mLowestLoadOrder)
+      return resource;
+
+    PushResource(mBlockedQueued, resource);
+  }
+  return nullptr;
+}
+
+StreamedResource* ResourceStreamer::TakeNextReady()
+{
+  while (!mReady.Empty())
+  {
+    StreamedResource* resource = PopResource(mReady);
+    if (resource->mEntry->LoadOrder <= resource->mLoad->mLowestLoadOrder)
+      return resource;
+
+    // Queued again once its package finishes a load order
+    mBlockedReady.PushBack(resource);
+  }
+  return nullptr;
+}
+
+void ResourceStreamer::Read(StreamedResource* resource)
+{
+  ZoneScoped;
+  ResourceEntry& entry = *resource->mEntry;
+
+  // Packed resources already point into their package's mapping
+  DataBlock block = entry.Block;
+  if (block.Data == nullptr)
+  {
+    // If the file can't be mapped it's loaded from the file on the main thread,
+    // which reports any errors
+    Status status;
+    PackedResourceFile* file = new PackedResourceFile();
+    if (file->OpenUnpacked(status, entry.FullPath, entry.mResourceId))
+    {
+      file->FindBlock(entry.mResourceId, block);
+      resource->mUnpackedFile = file;
+    }
+    else
+    {
+      delete file;
+    }
+  }
+
+  TouchPages(block);
+
+  if (resource->mFindReferences)
+    FindResourceReferences(block, resource->mReferences);
+}
+
+void ResourceStreamer::Finish(StreamedResource* resource)
+{
+  ZoneScoped;
+  ResourceEntry& entry = *resource->mEntry;
+  PendingResourceLoad* load = resource->mLoad;
+  ProfileScopeFunctionArgs(entry.Name);
+
+  if (resource->mUnpackedFile != nullptr)
+  {
+    HandleOf<PackedResourceFile> unpackedFile = resource->mUnpackedFile;
+    resource->mUnpackedFile = nullptr;
+    unpackedFile->FindBlock(entry.mResourceId, entry.Block);
+    entry.BlockOwner = unpackedFile;
+  }
+
+  // The library may have been unloaded while its resources were streaming
+  if (ResourceLibrary* library = load->mLibrary)
+  {
+    Status entryStatus;
+    HandleOf<Resource> loaded = PL::gResources->LoadEntry(entryStatus, entry);
+    if (entryStatus.Failed())
+    {
+      load->mStatus.SetFailed(BuildString(load->mStatus.Message, entryStatus.Message, "\n"));
+    }
+    else if (loaded)
+    {
+      library->Add(loaded, false);
+      load->mResourcesAdded = true;
+    }
+  }
+
+  entry.Block = DataBlock();
+  entry.BlockOwner = nullptr;
+
+  if (!resource->mReferences.Empty())
+    mReferences[entry.mResourceId] = resource->mReferences;
+
+  uint lowestLoadOrder = load->mLowestLoadOrder;
+
+  mLock.Lock();
+  --mReadCount;
+  mStreaming.Erase(entry.mResourceId);
+  load->ResourceFinished(entry.LoadOrder);
+  bool finishedLoadOrder = load->mLowestLoadOrder != lowestLoadOrder;
+  if (finishedLoadOrder)
+    mUnblockQueued = true;
+  mLock.Unlock();
+
+  // Resources that were waiting on that load order may be loadable now
+  if (finishedLoadOrder)
+    PushResources(mReady, mBlockedReady);
+
+  delete resource;
+}
+
+void ResourceStreamer::FinishLoad(PendingResourceLoad* load)
+{
+  ResourceLibrary* library = load->mLibrary;
+  if (library == nullptr)
+    return;
+
+  if (load->mStatus.Failed())
+    load->mStatus.Message = BuildString("Resource package failed to load. \n", load->mStatus.Message);
+
+  ResourceEvent event;
+  event.Name = library->Name;
+  event.Path = library->Location;
+  event.EventResourceLibrary = library;
+  PL::gResources->DispatchEvent(Events::PackagedFinished, &event);
+
+  PlasmaPrintFilter(Filter::DefaultFilter, "Streamed Resource Package '%s'\n", library->Name.c_str());
+}
+
+void ResourceStreamer::GetLevelReferences(Level* level, Array<ResourceId>& referencesOut)
+{
+  Array<ResourceId>* references = mReferences.FindPointer(level->mResourceId);
+  if (references == nullptr)
+  {
+    // The level wasn't streamed in, so find what it references now
+    references = &mReferences[level->mResourceId];
+
+    Status status;
+    MappedFile file;
+    if (file.Open(status, level->GetLoadPath()))
+      FindResourceReferences(DataBlock((byte*)file.GetData(), file.GetSize()), *references);
+  }
+
+  referencesOut.Append(references->All());
+}
+
+} // namespace Plasma
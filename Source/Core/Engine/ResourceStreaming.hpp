@@ -0,0 +1,139 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+class Level;
+class ResourceLoader;
+class StreamedResource;
+
+/// How soon a streamed resource is needed. Resources are read and loaded in
+/// order of priority, then by load order, then in the order they were queued.
+DeclareEnum4(ResourceStreamPriority,
+             // Load when nothing else is waiting.
+             Low,
+             Normal,
+             High,
+             // A level waiting to be loaded needs the resource.
+             NextLevel);
+
+/// A resource package being loaded in the background (see
+/// ResourceSystem::LoadPackageAsync). The library is created right away and
+/// each resource is added to it as soon as it's loaded.
+class PendingResourceLoad : public ReferenceCountedObject
+{
+public:
+  LightningDeclareType(PendingResourceLoad, TypeCopyMode::ReferenceType);
+
+  PendingResourceLoad();
+
+  /// Whether every resource in the package has been loaded (or failed to).
+  bool IsDone();
+
+  /// How much of the package has been loaded, from 0 to 1.
+  float GetProgress();
+
+  /// The library the resources are loaded into.
+  ResourceLibrary* GetLibrary();
+
+  /// Failed if any resource failed to load. Only complete once done.
+  Status mStatus;
+
+private:
+  friend class ResourceStreamer;
+  friend class ResourceSystem;
+
+  /// Called when a resource of the given load order is done.
+  void ResourceFinished(uint loadOrder);
+
+  HandleOf<ResourceLibrary> mLibrary;
+  ResourceListing mResources;
+  uint mFinishedCount;
+
+  // Resources are only loaded once every resource with a lower load order is,
+  // since they may reference those resources when they're loaded
+  HashMap<uint, uint> mUnfinishedPerLoadOrder;
+  uint mLowestLoadOrder;
+
+  // Whether any resource was added since the last ResourcesLoaded event
+  bool mResourcesAdded;
+};
+
+/// Streams in the resources of packages that are loaded asynchronously. A job
+/// reads the data of every queued resource (mapping and paging it in) on a
+/// worker thread, then the main thread loads the resources that were read
+/// (creating and registering them) for a limited amount of time every frame.
+class ResourceStreamer
+{
+public:
+  ResourceStreamer();
+  ~ResourceStreamer();
+
+  /// Queues every resource of the load. Resources that are loaded from a
+  /// packed file must already have their block set.
+  void Add(PendingResourceLoad* load, ResourceStreamPriority::Enum priority);
+
+  /// Loads resources that have been read until the frame budget is used.
+  /// Should be called once a frame on the main thread.
+  void Update();
+
+  /// Raises the priority of every streaming resource that the level (or any
+  /// archetype it uses) references. Returns true if none of them are still
+  /// streaming, meaning the level can be loaded.
+  bool PrepareLevel(Level* level);
+
+  /// Whether there are any resources still streaming in.
+  bool IsStreaming();
+
+  /// Stops streaming and drops every resource that hasn't been loaded.
+  void CancelAll();
+
+  /// Called on a worker thread to read queued resources.
+  void ReadQueued();
+
+  /// How long the main thread can spend loading resources each frame.
+  double mFrameBudget;
+
+private:
+  StreamedResource* TakeNextQueued();
+  StreamedResource* TakeNextReady();
+  void Read(StreamedResource* resource);
+  void Finish(StreamedResource* resource);
+  void FinishLoad(PendingResourceLoad* load);
+  void GetLevelReferences(Level* level, Array<ResourceId>& referencesOut);
+
+  // Locks everything shared with the reader
+  ThreadLock mLock;
+  // Waiting to be read (a heap, see IsHigherPriority)
+  Array<StreamedResource*> mQueued;
+  // Skipped while the read ahead was full because they can't be loaded until a
+  // lower load order is (a heap as well)
+  Array<StreamedResource*> mBlockedQueued;
+  // Set when a load order finishes, so blocked resources are queued again
+  bool mUnblockQueued;
+  // Read and waiting to be loaded on the main thread
+  Array<StreamedResource*> mRead;
+  // How many resources have been read but not loaded
+  uint mReadCount;
+  bool mReading;
+  bool mCancelled;
+  // Incremented when the reader stops after being cancelled
+  Semaphore mReaderStopped;
+
+  // Everything below is only used on the main thread
+
+  // Read and waiting to be loaded (a heap)
+  Array<StreamedResource*> mReady;
+  // Read, but waiting on a lower load order to be loaded
+  Array<StreamedResource*> mBlockedReady;
+  HashMap<ResourceId, StreamedResource*> mStreaming;
+  Array<HandleOf<PendingResourceLoad>> mLoads;
+  uint mNextSequence;
+
+  // The resources referenced by levels and archetypes, so that everything a
+  // level needs can be found before it's loaded
+  HashMap<ResourceId, Array<ResourceId>> mReferences;
+};
+
+} // namespace Plasma
@@ -153,6 +153,100 @@ ResourceLibrary* ResourceSystem::LoadPackage(Status& status, ResourcePackage* pa
   event.Path = package->Location;
   DispatchEvent(Events::PackagedStarted, &event);
 
+  ResourceLibrary* resourceLibrary = CreateLibrary(package);
+
+  LoadIntoLibrary(status, resourceLibrary, package, false);
+
+  event.EventResourceLibrary = resourceLibrary;
+  DispatchEvent(Events::PackagedFinished, &event);
+
+  float time = (float)timer.UpdateAndGetTime();
+  PlasmaPrintFilter(Filter::DefaultFilter, "Loaded Resource Package '%s' in %.2fs\n", package->Name.c_str(), time);
+
+  return resourceLibrary;
+}
+
+HandleOf<PendingResourceLoad> ResourceSystem::LoadPackageFileAsync(StringParam fileName,
+                                                                   ResourceStreamPriority::Enum priority)
+{
+  ResourcePackage package;
+  package.Load(fileName);
+  package.Location = FilePath::GetDirectoryPath(fileName);
+  return LoadPackageAsync(&package, priority);
+}
+
+HandleOf<PendingResourceLoad> ResourceSystem::LoadPackageAsync(ResourcePackage* package,
+                                                               ResourceStreamPriority::Enum priority)
+{
+  ZoneScoped;
+  ProfileScopeFunctionArgs(package->Name);
+  PushErrorContextObject("Loading", package);
+
+  HandleOf<PendingResourceLoad> load = new PendingResourceLoad();
+
+  ResourceLibrary* currentSet = LoadedResourceLibraries.FindValue(package->Name, nullptr);
+  if (currentSet)
+  {
+    PlasmaPrintFilter(Filter::DefaultFilter, "Resource Package Already Loaded '%s'...\n", package->Name.c_str());
+    load->mLibrary = currentSet;
+    return load;
+  }
+
+  PlasmaPrintFilter(Filter::DefaultFilter, "Streaming Resource Package '%s'...\n", package->Name.c_str());
+
+  ResourceEvent event;
+  event.Name = package->Name;
+  event.Path = package->Location;
+  DispatchEvent(Events::PackagedStarted, &event);
+
+  ResourceLibrary* resourceLibrary = CreateLibrary(package);
+  load->mLibrary = resourceLibrary;
+
+  BoundType* documentType = LightningTypeId(LightningDocumentResource);
+  BoundType* libraryType = LightningTypeId(LightningLibraryResource);
+
+  PackedResourceFile* packedResources = resourceLibrary->mPackedResources;
+  forRange (ResourceEntry& entry, package->Resources.All())
+  {
+    entry.mLibrary = resourceLibrary;
+    entry.FullPath = FilePath::Combine(package->Location, entry.Location);
+
+    // The library's scripts are compiled whenever one is added, so they're all
+    // loaded now instead of being compiled over and over as they stream in
+    ResourceManager* manager = GetResourceManager(entry.Type);
+    if (manager != nullptr && (manager->mResourceType->IsA(documentType) || manager->mResourceType->IsA(libraryType)))
+    {
+      Status entryStatus;
+      HandleOf<Resource> resource = LoadEntry(entryStatus, entry);
+      if (entryStatus.Failed())
+        load->mStatus.SetFailed(BuildString(load->mStatus.Message, entryStatus.Message, "\n"));
+      else if (resource)
+        resourceLibrary->Add(resource, false);
+      continue;
+    }
+
+    load->mResources.PushBack(entry);
+    ResourceEntry& streamedEntry = load->mResources.Back();
+    if (packedResources != nullptr && packedResources->FindBlock(entry.mResourceId, streamedEntry.Block))
+      streamedEntry.BlockOwner = packedResources;
+  }
+
+  mStreamer.Add(load, priority);
+  return load;
+}
+
+void ResourceSystem::UpdateStreaming()
+{
+  mStreamer.Update();
+}
+
+bool ResourceSystem::PrepareLevel(Level* level)
+{
+  return mStreamer.PrepareLevel(level);
+}
+
+ResourceLibrary* ResourceSystem::CreateLibrary(ResourcePackage* package)
+{
   // METAREFACTOR this is the worst way to handle this, but it works until we
   // get true dependencies. Find the last resource library (assuming we load
   // Core first, then others) and pretend we're always dependent upon the
@@ -172,13 +266,29 @@ ResourceLibrary* ResourceSystem::LoadPackage(Status& status, ResourcePackage* pa
   if (lastResourceLibrary != nullptr)
     resourceLibrary->AddDependency(lastResourceLibrary);
 
-  LoadIntoLibrary(status, resourceLibrary, package, false);
-
-  event.EventResourceLibrary = resourceLibrary;
-  DispatchEvent(Events::PackagedFinished, &event);
-
-  float time = (float)timer.UpdateAndGetTime();
-  PlasmaPrintFilter(Filter::DefaultFilter, "Loaded Resource Package '%s' in %.2fs\n", package->Name.c_str(), time);
+  // Exported packages have the data of most of their resources packed into one
+  // file, which we map so those resources load straight out of the mapping
+  String packedFile = FilePath::CombineWithExtension(package->Location, package->Name, PackedResourceFile::cExtension);
+  if (!package->Location.Empty() && FileExists(packedFile))
+  {
+    Status packedStatus;
+    PackedResourceFile* packedResources = new PackedResourceFile();
+    resourceLibrary->mPackedResources = packedResources;
+    if (packedResources->Open(packedStatus, packedFile))
+    {
+      PlasmaPrintFilter(Filter::ResourceFilter,
+                        "Mapped %d packed resources from '%s'\n",
+                        (int)packedResources->GetResourceCount(),
+                        packedFile.c_str());
+    }
+    else
+    {
+      // Resources that were packed will fail to load, but the rest of the
+      // package can still be loaded from its files
+      PlasmaPrint("%s\n", packedStatus.Message.c_str());
+      resourceLibrary->mPackedResources = nullptr;
+    }
+  }
 
   return resourceLibrary;
 }
@@ -216,6 +326,9 @@ void ResourceSystem::ReloadPackage(ResourceLibrary* resourceLibrary, ResourcePac
 
 void ResourceSystem::UnloadAll()
 {
+  // Anything still streaming in is dropped
+  mStreamer.CancelAll();
+
   // Unload all libraries. We want to unload libraries that no one depends on
   // first
   while (!LoadedResourceLibraries.Empty())
@@ -292,8 +405,17 @@ void ResourceSystem::LoadIntoLibrary(Status& status,
 
     entry.FullPath = FilePath::Combine(resourcePackage->Location, entry.Location);
 
+    PackedResourceFile* packedResources = resourceLibrary->mPackedResources;
+    if (packedResources != nullptr && packedResources->FindBlock(entry.mResourceId, entry.Block))
+      entry.BlockOwner = packedResources;
+
     Status entryStatus;
     HandleOf<Resource> resource = LoadEntry(entryStatus, entry);
+
+    // The package may be kept around, so don't leave it pointing at the mapping
+    entry.Block = DataBlock();
+    entry.BlockOwner = nullptr;
+
     if (!entryStatus)
     {
       continue;
@@ -342,6 +464,17 @@ HandleOf<Resource> ResourceSystem::LoadEntry(Status& status, ResourceEntry& elem
 
   ErrorContextResourceEntry loadingResourceContext(&element);
 
+  // Replace legacy type with Cog
+  if (element.Type == "LevelSettings")
+    element.Type = "Cog";
+
+  ResourceLoader* loader = mLoaderMap.FindValue(element.Type, nullptr);
+
+  // Resources that were packed are loaded from the packed data (their files
+  // may not have been exported at all)
+  if (loader != nullptr && element.Block.Data != nullptr && loader->CanLoadFromBlock())
+    return loader->LoadFromBlock(element);
+
   if (!FileExists(element.FullPath))
   {
     String errMsg = String::Format("Resource file '%s' does not exist.", element.FullPath.c_str());
@@ -350,14 +483,9 @@ HandleOf<Resource> ResourceSystem::LoadEntry(Status& status, ResourceEntry& elem
     return nullptr;
   }
 
-  // Replace legacy type with Cog
-  if (element.Type == "LevelSettings")
-    element.Type = "Cog";
-
-  LoaderRange range = mLoaderMap.Find(element.Type);
-  if (!range.Empty())
+  if (loader != nullptr)
   {
-    HandleOf<Resource> newResource = range.Front().second->LoadFromFile(element);
+    HandleOf<Resource> newResource = loader->LoadFromFile(element);
     // ideally we'd do a check here, but some resources don't load anything
     // (fragments)
     return newResource;
@@ -6,6 +6,7 @@ namespace Plasma
 class ResourceManager;
 class ResourceLoader;
 class ResourceEvent;
+class Level;
 
 namespace Events
 {
@@ -49,6 +50,22 @@ public:
   // Load a resource package
   ResourceLibrary* LoadPackage(Status& status, ResourcePackage* package);
 
+  // Start loading a resource package in the background. The resource library
+  // is created right away and each resource is added to it once it's loaded.
+  HandleOf<PendingResourceLoad> LoadPackageAsync(ResourcePackage* package,
+                                                 ResourceStreamPriority::Enum priority = ResourceStreamPriority::Normal);
+
+  // Start loading a resource package file in the background.
+  HandleOf<PendingResourceLoad> LoadPackageFileAsync(StringParam fileName,
+                                                     ResourceStreamPriority::Enum priority = ResourceStreamPriority::Normal);
+
+  // Load resources that have finished streaming in (once a frame).
+  void UpdateStreaming();
+
+  // Stream in what the level needs before anything else. Returns true if
+  // nothing it needs is still streaming in.
+  bool PrepareLevel(Level* level);
+
   // Reload all resource in package into resource library.
   void ReloadPackage(ResourceLibrary* resourceLibrary, ResourcePackage* package);
 
@@ -102,6 +119,12 @@ public:
   LoaderMapType mLoaderMap;
 
   Array<ResourceManager*> mResourceManagers;
+
+  ResourceStreamer mStreamer;
+
+private:
+  // Create the library for a package and map its packed resources.
+  ResourceLibrary* CreateLibrary(ResourcePackage* package);
 };
 
 namespace PL
@@ -718,7 +718,16 @@ void Space::LoadLevel(Level* level)
     return;
   }
 
-  if (!mLevelLoaded)
+  // Resources the level uses may still be streaming in, in which case they're
+  // streamed in before anything else and the level waits for them
+  bool resourcesReady = PL::gResources->PrepareLevel(level);
+
+  if (!mLevelLoaded && !resourcesReady)
+  {
+    PlasmaPrintFilter(Filter::DefaultFilter, "Loading level '%s' once its resources are loaded.\n", level->Name.c_str());
+    mPendingLevel = level;
+  }
+  else if (!mLevelLoaded)
   {
     PlasmaPrintFilter(Filter::DefaultFilter, "Loading level '%s' directly.\n", level->Name.c_str());
 
@@ -746,6 +755,9 @@ void Space::LoadPendingLevel()
 {
   if (Level* level = mPendingLevel)
   {
+    if (!PL::gResources->PrepareLevel(level))
+      return;
+
     LoadLevelAdditive(level);
     mPendingLevel = nullptr;
   }
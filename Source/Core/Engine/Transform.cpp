@@ -793,26 +793,32 @@ Vec3 Transform::ClampTranslation(Space* space, Cog* owner, Vec3 translation)
   bool wasClamped = false;
   Vec3 t = Math::DebugClamp(translation, Vec3(-maxTranslation), Vec3(maxTranslation), wasClamped);
 
-  // if anything was clamped and we haven't already
-  // had a bad object then we'll print a message
-  if (wasClamped && space->mInvalidObjectPositionOccurred == false)
-  {
-    // we only want to display an error message once, however if
-    // we're in editor we want to display the error message every time.
-    if (!space->IsEditorMode())
-      space->mInvalidObjectPositionOccurred = true;
-
-    String objName = owner->GetDescription();
-    String errStr = String::Format("Translation was set beyond the range of [%g, %g] on object %s. "
-                                   "The translation will be clamped to this range.",
-                                   -maxTranslation,
-                                   maxTranslation,
-                                   objName.c_str());
-    DoNotifyWarning("Setting Invalid Translation", errStr);
-  }
+  if (wasClamped)
+    NotifyClampedTranslation(space, owner);
   return t;
 }
 
+void Transform::NotifyClampedTranslation(Space* space, Cog* owner)
+{
+  // if we haven't already had a bad object then we'll print a message
+  if (space == nullptr || space->mInvalidObjectPositionOccurred)
+    return;
+
+  // we only want to display an error message once, however if
+  // we're in editor we want to display the error message every time.
+  if (!space->IsEditorMode())
+    space->mInvalidObjectPositionOccurred = true;
+
+  real maxTranslation = space->mMaxObjectPosition;
+  String objName = owner->GetDescription();
+  String errStr = String::Format("Translation was set beyond the range of [%g, %g] on object %s. "
+                                 "The translation will be clamped to this range.",
+                                 -maxTranslation,
+                                 maxTranslation,
+                                 objName.c_str());
+  DoNotifyWarning("Setting Invalid Translation", errStr);
+}
+
 void Transform::OnDestroy(uint flags /*= 0*/)
 {
   Cog* owner = GetOwner();
@@ -159,6 +159,9 @@ public:
   /// Clamps a translation value between the max values on the space.
   /// This will display a notification if any value was clamped.
   static Vec3 ClampTranslation(Space* space, Cog* owner, Vec3 translation);
+  /// Displays the notification for a translation that was clamped (only once
+  /// per space outside of the editor). Must be called on the main thread.
+  static void NotifyClampedTranslation(Space* space, Cog* owner);
 
   Transform* TransformParent;
 
@@ -0,0 +1,289 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// Every binary data tree starts with these bytes. Text data files start with
+// whitespace, an attribute, or an identifier, so the leading null can never be
+// mistaken for one.
+static const byte cBinaryDataTreeMagic[] = {0, 'P', 'D', 'T'};
+
+// Bump this whenever the layout changes (old binary files are rebuilt from the
+// text files when content is built)
+static const uint cBinaryDataTreeFormatVersion = 1;
+
+bool IsBinaryDataTree(StringRange data)
+{
+  if (data.SizeInBytes() < sizeof(cBinaryDataTreeMagic))
+    return false;
+  return memcmp(data.Data(), cBinaryDataTreeMagic, sizeof(cBinaryDataTreeMagic)) == 0;
+}
+
+// Binary Data Tree Writer
+void BinaryDataTreeWriter::Write(DataNode* fileRoot, uint fileVersion, bool patchRequired, Array<byte>& output)
+{
+  BinaryDataTreeWriter writer(output);
+  writer.GatherStrings(fileRoot);
+
+  writer.WriteBytes(cBinaryDataTreeMagic, sizeof(cBinaryDataTreeMagic));
+  writer.WriteUint(cBinaryDataTreeFormatVersion);
+  writer.WriteUint(fileVersion);
+  writer.WriteUint(patchRequired ? 1 : 0);
+
+  // The string table comes first so every string is created before any node
+  writer.WriteUint(writer.mStrings.Size());
+  forRange (String& string, writer.mStrings.All())
+  {
+    writer.WriteUint(string.SizeInBytes());
+    writer.WriteBytes(string.Data(), string.SizeInBytes());
+  }
+
+  writer.WriteNode(fileRoot);
+}
+
+bool BinaryDataTreeWriter::ConvertText(Status& status, StringRange text, StringParam source, Array<byte>& output)
+{
+  // The loader is only needed for attributes that don't belong to any node
+  DataTreeLoader loader;
+  DataTreeContext context;
+  context.Filename = source;
+  context.Loader = &loader;
+
+  uint fileVersion = GetFileVersion(text);
+  if (fileVersion == DataVersion::Legacy)
+  {
+    status.SetFailed(String::Format("'%s' is in the legacy data format", source.c_str()));
+    return false;
+  }
+
+  DataNode fileRoot(DataNodeType::Object, nullptr);
+  DataTreeParser::BuildTree(context, text, &fileRoot);
+
+  if (context.Error || fileRoot.mChildren.Empty())
+  {
+    String message = context.Message.Empty() ? String("Failed to parse root element.") : context.Message;
+    status.SetFailed(String::Format("Failed to parse '%s': %s", source.c_str(), message.c_str()),
+                     ParseErrorCodes::ParsingError);
+    return false;
+  }
+
+  Write(&fileRoot, fileVersion, context.PatchRequired, output);
+  return true;
+}
+
+BinaryDataTreeWriter::BinaryDataTreeWriter(Array<byte>& output) : mOutput(output)
+{
+}
+
+uint BinaryDataTreeWriter::InternString(StringParam string)
+{
+  uint* foundIndex = mStringIndices.FindPointer(string);
+  if (foundIndex != nullptr)
+    return *foundIndex;
+
+  uint index = mStrings.Size();
+  mStrings.PushBack(string);
+  mStringIndices.Insert(string, index);
+  return index;
+}
+
+void BinaryDataTreeWriter::GatherStrings(DataNode* node)
+{
+  InternString(node->mTypeName);
+  InternString(node->mPropertyName);
+  InternString(node->mTextValue);
+  InternString(node->mInheritedFromId);
+
+  forRange (DataAttribute& attribute, node->mAttributes.All())
+  {
+    InternString(attribute.mName);
+    InternString(attribute.mValue);
+  }
+
+  forRange (DataNode& child, node->GetChildren())
+    GatherStrings(&child);
+}
+
+void BinaryDataTreeWriter::WriteNode(DataNode* node)
+{
+  WriteUint(node->mNodeType);
+  WriteUint(node->mFlags.U32Field);
+  WriteUint(node->mPatchState);
+  WriteUint(mStringIndices[node->mTypeName]);
+  WriteUint(mStringIndices[node->mPropertyName]);
+  WriteUint(mStringIndices[node->mTextValue]);
+  WriteUint(mStringIndices[node->mInheritedFromId]);
+
+  u64 uniqueNodeId = node->mUniqueNodeId.mValue;
+  WriteBytes(&uniqueNodeId, sizeof(uniqueNodeId));
+
+  WriteUint(node->mAttributes.Size());
+  forRange (DataAttribute& attribute, node->mAttributes.All())
+  {
+    WriteUint(mStringIndices[attribute.mName]);
+    WriteUint(mStringIndices[attribute.mValue]);
+  }
+
+  WriteUint(node->GetNumberOfChildren());
+  forRange (DataNode& child, node->GetChildren())
+    WriteNode(&child);
+}
+
+void BinaryDataTreeWriter::WriteUint(uint value)
+{
+  WriteBytes(&value, sizeof(value));
+}
+
+void BinaryDataTreeWriter::WriteBytes(const void* data, size_t size)
+{
+  const byte* bytes = (const byte*)data;
+  mOutput.Insert(mOutput.End(), bytes, bytes + size);
+}
+
+// Binary Data Tree Parser
+bool BinaryDataTreeParser::BuildTree(DataTreeContext& context, StringRange data, uint* fileVersion, DataNode* fileRoot)
+{
+  BinaryDataTreeParser parser(context, data);
+  return parser.Parse(fileVersion, fileRoot);
+}
+
+BinaryDataTreeParser::BinaryDataTreeParser(DataTreeContext& context, StringRange data) :
+    mContext(context),
+    mPosition((const byte*)data.Data()),
+    mEnd((const byte*)data.Data() + data.SizeInBytes())
+{
+}
+
+bool BinaryDataTreeParser::Parse(uint* fileVersion, DataNode* fileRoot)
+{
+  byte magic[sizeof(cBinaryDataTreeMagic)];
+  if (!ReadBytes(magic, sizeof(magic)) || memcmp(magic, cBinaryDataTreeMagic, sizeof(magic)) != 0)
+    return Fail("Not a binary data tree");
+
+  uint formatVersion = 0;
+  if (!ReadUint(formatVersion) || formatVersion != cBinaryDataTreeFormatVersion)
+    return Fail("Unsupported binary data tree version (the content needs to be rebuilt)");
+
+  uint patchRequired = 0;
+  if (!ReadUint(*fileVersion) || !ReadUint(patchRequired))
+    return false;
+  mContext.PatchRequired = (patchRequired != 0);
+
+  // Each string is allocated once here, and every node that uses it shares it
+  uint stringCount = 0;
+  if (!ReadUint(stringCount))
+    return false;
+
+  mStrings.Reserve(stringCount);
+  for (uint i = 0; i < stringCount; ++i)
+  {
+    uint size = 0;
+    if (!ReadUint(size) || size > (uint)(mEnd - mPosition))
+      return Fail("Unexpected end of file");
+
+    mStrings.PushBack(String((cstr)mPosition, size));
+    mPosition += size;
+  }
+
+  // The file root was written like any other node (its type is always Object)
+  uint rootType = 0;
+  if (!ReadUint(rootType))
+    return false;
+  return ReadNode(fileRoot);
+}
+
+bool BinaryDataTreeParser::ReadNode(DataNode* node)
+{
+  uint flags = 0;
+  uint patchState = 0;
+  if (!ReadUint(flags) || !ReadUint(patchState))
+    return false;
+
+  if (patchState >= PatchState::Size)
+    return Fail("Invalid patch state");
+
+  node->mFlags.U32Field = flags;
+  node->mPatchState = (PatchState::Enum)patchState;
+
+  if (!ReadString(node->mTypeName) || !ReadString(node->mPropertyName) || !ReadString(node->mTextValue) ||
+      !ReadString(node->mInheritedFromId))
+    return false;
+
+  u64 uniqueNodeId = 0;
+  if (!ReadBytes(&uniqueNodeId, sizeof(uniqueNodeId)))
+    return false;
+  node->mUniqueNodeId = uniqueNodeId;
+
+  uint attributeCount = 0;
+  if (!ReadUint(attributeCount))
+    return false;
+
+  for (uint i = 0; i < attributeCount; ++i)
+  {
+    DataAttribute& attribute = node->mAttributes.PushBack();
+    if (!ReadString(attribute.mName) || !ReadString(attribute.mValue))
+      return false;
+  }
+
+  uint childCount = 0;
+  if (!ReadUint(childCount))
+    return false;
+
+  for (uint i = 0; i < childCount; ++i)
+  {
+    uint nodeType = 0;
+    if (!ReadUint(nodeType))
+      return false;
+
+    if (nodeType >= DataNodeType::Size)
+      return Fail("Invalid node type");
+
+    DataNode* child = new DataNode((DataNodeType::Enum)nodeType, node);
+    if (!ReadNode(child))
+      return false;
+  }
+
+  return true;
+}
+
+bool BinaryDataTreeParser::ReadString(String& string)
+{
+  uint index = 0;
+  if (!ReadUint(index))
+    return false;
+
+  if (index >= mStrings.Size())
+    return Fail("Invalid string index");
+
+  string = mStrings[index];
+  return true;
+}
+
+bool BinaryDataTreeParser::ReadUint(uint& value)
+{
+  return ReadBytes(&value, sizeof(value));
+}
+
+bool BinaryDataTreeParser::ReadBytes(void* data, size_t size)
+{
+  if (size > (size_t)(mEnd - mPosition))
+    return Fail("Unexpected end of file");
+
+  memcpy(data, mPosition, size);
+  mPosition += size;
+  return true;
+}
+
+bool BinaryDataTreeParser::Fail(cstr message)
+{
+  // Only the first error is reported, everything after it is a consequence
+  if (!mContext.Error)
+  {
+    mContext.Error = true;
+    mContext.Message = String::Format("Binary data tree '%s': %s", mContext.Filename.c_str(), message);
+  }
+  return false;
+}
+
+} // namespace Plasma
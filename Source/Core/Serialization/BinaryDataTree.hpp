@@ -0,0 +1,68 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+class DataNode;
+struct DataTreeContext;
+
+/// Returns whether or not the given file data is a binary data tree.
+bool IsBinaryDataTree(StringRange data);
+
+// Binary Data Tree Writer
+/// Writes a data tree in a compact binary form. Every type name, property
+/// name, value, and attribute is stored once in a string table and referenced
+/// by index, so loading doesn't tokenize anything and nodes share a single
+/// allocation for each unique string. Binary data trees are produced when
+/// content is built, the text format is still what the editor loads and saves.
+class BinaryDataTreeWriter
+{
+public:
+  /// Writes the file root and everything under it.
+  static void Write(DataNode* fileRoot, uint fileVersion, bool patchRequired, Array<byte>& output);
+
+  /// Parses a text data file and writes it as a binary data tree. Inherited
+  /// data is not resolved, the binary data tree is patched when it's loaded
+  /// just like the text would have been.
+  static bool ConvertText(Status& status, StringRange text, StringParam source, Array<byte>& output);
+
+private:
+  BinaryDataTreeWriter(Array<byte>& output);
+
+  uint InternString(StringParam string);
+  void GatherStrings(DataNode* node);
+  void WriteNode(DataNode* node);
+  void WriteUint(uint value);
+  void WriteBytes(const void* data, size_t size);
+
+  HashMap<String, uint> mStringIndices;
+  Array<String> mStrings;
+  Array<byte>& mOutput;
+};
+
+// Binary Data Tree Parser
+class BinaryDataTreeParser
+{
+public:
+  /// Builds the tree that was written by the BinaryDataTreeWriter under the
+  /// given file root.
+  static bool BuildTree(DataTreeContext& context, StringRange data, uint* fileVersion, DataNode* fileRoot);
+
+private:
+  BinaryDataTreeParser(DataTreeContext& context, StringRange data);
+
+  bool Parse(uint* fileVersion, DataNode* fileRoot);
+  bool ReadNode(DataNode* node);
+  bool ReadString(String& string);
+  bool ReadUint(uint& value);
+  bool ReadBytes(void* data, size_t size);
+  bool Fail(cstr message);
+
+  DataTreeContext& mContext;
+  const byte* mPosition;
+  const byte* mEnd;
+  Array<String> mStrings;
+};
+
+} // namespace Plasma
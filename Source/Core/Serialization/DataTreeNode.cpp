@@ -877,23 +877,32 @@ bool ReadDataSet(
   parseContext.Filename = source;
   parseContext.Loader = loader;
 
-  // Load the data tree with the correct parser
-  *fileVersion = GetFileVersion(data);
-
-  if (*fileVersion == DataVersion::Legacy)
+  // Binary data trees were built from text when the content was built, and
+  // store the version of the text they were built from
+  if (IsBinaryDataTree(data))
   {
-    // Legacy format only supported a single root
-    DataNode* root = LegacyDataTreeParser::BuildTree(parseContext, data);
-    if (root == nullptr)
-    {
-      status.SetFailed("Failed to parse legacy file format");
-      return false;
-    }
-    root->AttachTo(fileRoot);
+    BinaryDataTreeParser::BuildTree(parseContext, data, fileVersion, fileRoot);
   }
   else
   {
-    DataTreeParser::BuildTree(parseContext, data, fileRoot);
+    // Load the data tree with the correct parser
+    *fileVersion = GetFileVersion(data);
+
+    if (*fileVersion == DataVersion::Legacy)
+    {
+      // Legacy format only supported a single root
+      DataNode* root = LegacyDataTreeParser::BuildTree(parseContext, data);
+      if (root == nullptr)
+      {
+        status.SetFailed("Failed to parse legacy file format");
+        return false;
+      }
+      root->AttachTo(fileRoot);
+    }
+    else
+    {
+      DataTreeParser::BuildTree(parseContext, data, fileRoot);
+    }
   }
 
   // Failed to read file
@@ -210,6 +210,9 @@ public:
   Guid mUniqueNodeId;
 };
 
+/// Returns the data version of a text data file.
+uint GetFileVersion(StringRange fileData);
+
 bool ReadDataSet(Status& status,
                  StringRange data,
                  StringParam source,
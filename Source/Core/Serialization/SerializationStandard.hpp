@@ -32,6 +32,7 @@ public:
 #include "Binary.hpp"
 #include "DataTreeNode.hpp"
 #include "DataTree.hpp"
+#include "BinaryDataTree.hpp"
 #include "Simple.hpp"
 #include "DefaultSerializer.hpp"
 #include "Tokenizer.hpp"
@@ -44,6 +44,7 @@ public:
   virtual void CastFrustum(CastDataParam data, ProxyCastResults& results);
 
   virtual void RegisterCollisions();
+  virtual bool QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended);
 
   virtual void Cleanup(){};
 
@@ -51,33 +52,57 @@ public:
   void QueryCallback(void* thisProxy, void* otherProxy);
 
 protected:
+  typedef FlatHashSet<NodePointerPair> PairSet;
+  typedef FlatHashSet<void*> NodeSet;
+  typedef Array<void*> NodeArray;
+  typedef HashMap<void*, NodeArray> NodePairMap;
+
+  /// Finds the pairs of only the moved nodes and drops their old pairs that
+  /// no longer overlap.
   void SingleObjectQuery();
-  void PartialTreeQuery();
+  /// Rebuilds every pair by querying the tree against itself.
   void FullTreeQuery();
 
   /// Converts the internal HashSet into the array.
   void FillOutResults(ClientPairArray& results);
 
+  /// Adds a pair between the query node and everything overlapping the aabb.
   void AddQueryResult(Aabb& aabb);
+  /// Adds a pair to the cache, recording it as begun if it's new.
+  void AddPair(const NodePointerPair& pair);
+  /// Removes a cached pair, recording it as ended.
+  void RemovePair(const NodePointerPair& pair);
+  /// Removes every cached pair involving one of the given nodes.
+  void RemovePairs(NodeSet& nodes);
+  /// Adds/removes each node in the pair to the other's list of pairs.
+  void LinkPair(const NodePointerPair& pair);
+  void UnlinkPair(const NodePointerPair& pair);
+  ClientPair GetClientPair(const NodePointerPair& pair);
 
   TreeType mTree;
   /// The proxy currently being queried. Used to avoid self pairs.
   NodeType* mQueryNode;
 
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
-  /// The proxies that have been inserted/updated since the last query.
-  /// We only need to return pairs where at least 1 object is moving.
-  // Array<NodeType*> mNodesToQuery;
-
-  typedef HashSet<NodePointerPair> PairSet;
+  /// Every pair of proxies whose fat aabbs overlap. The pairs are kept between
+  /// updates and only the pairs of proxies that moved are recomputed, so the
+  /// cost of an update scales with how much moved rather than the proxy count.
   PairSet mPairs;
-
+  /// The nodes each node is paired with, so a moved or removed node's pairs
+  /// can be found without walking every pair. A node with no pairs may be
+  /// missing.
+  NodePairMap mNodePairs;
+  /// The proxies that were created or left their fat aabb since the last
+  /// update. We only need to look for new pairs where one of them moved.
+  NodeSet mMovedNodes;
+  BroadPhasePairDeltas<NodePointerPair, void*> mDeltas;
+
+  /// SingleObject always updates incrementally and FullTree always queries
+  /// the whole tree. PartialTree picks based on how many proxies moved.
   BaseDAabbTreeSelfQuery::Enum mSelfQueryPolicy;
 
-  // remove later or something...
-  uint mSingleObjectCountQuery;
-  uint mBuildTreeObjectCountQuery;
+  /// With PartialTree, the whole tree is queried once more than
+  /// 1 / mFullTreeMovedRatio of the proxies have moved.
+  uint mFullTreeMovedRatio;
 };
 
 } // namespace Plasma
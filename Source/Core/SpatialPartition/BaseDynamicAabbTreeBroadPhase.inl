@@ -7,14 +7,12 @@ template <typename TreeType>
 BaseDynamicAabbTreeBroadPhase<TreeType>::BaseDynamicAabbTreeBroadPhase()
 {
   HeapAllocator allocator(mHeap);
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
-  // mNodesToQuery.SetAllocator(allocator);
   mPairs.SetAllocator(allocator);
+  mMovedNodes.SetAllocator(allocator);
 
-  mSelfQueryPolicy = BaseDAabbTreeSelfQuery::FullTree;
-  mSingleObjectCountQuery = 20;
-  mBuildTreeObjectCountQuery = static_cast<uint>(-1);
+  mQueryNode = nullptr;
+  mSelfQueryPolicy = BaseDAabbTreeSelfQuery::PartialTree;
+  mFullTreeMovedRatio = 4;
 }
 
 template <typename TreeType>
@@ -38,11 +36,7 @@ template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::CreateProxy(BroadPhaseProxy& proxy, BroadPhaseData& data)
 {
   mTree.CreateProxy(proxy, data);
-  NodeType* node = static_cast<NodeType*>(proxy.ToVoidPointer());
-
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
-  // mNodesToQuery.PushBack(node);
+  mMovedNodes.Insert(proxy.ToVoidPointer());
 }
 
 template <typename TreeType>
@@ -59,40 +53,41 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::CreateProxies(BroadPhaseObjectArra
 template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::RemoveProxy(BroadPhaseProxy& proxy)
 {
+  // The node is deleted with the proxy and the memory could be reused by the
+  // next node created, so its pairs have to be removed now
+  NodeSet removedNodes;
+  removedNodes.Insert(proxy.ToVoidPointer());
+  RemovePairs(removedNodes);
+
   // remove from the tree
   mTree.RemoveProxy(proxy);
-
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
-
-  // also have to see if the item was on our query array, if so
-  // we have to remove it
-  // typename Array<NodeType*>::range range = mNodesToQuery.All();
-  // for(; !range.Empty(); range.PopFront())
-  //{
-  //  if(range.Front() == proxy.ToVoidPointer())
-  //  {
-  //    mNodesToQuery.Erase(&range.Front());
-  //    return;
-  //  }
-  //}
 }
 
 template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::RemoveProxies(ProxyHandleArray& proxies)
 {
+  // Remove the pairs of every proxy in one pass
+  NodeSet removedNodes;
+  removedNodes.Reserve(proxies.Size());
   ProxyHandleArray::range range = proxies.All();
   for (; !range.Empty(); range.PopFront())
-    SelfType::RemoveProxy(*range.Front());
+    removedNodes.Insert(range.Front()->ToVoidPointer());
+  RemovePairs(removedNodes);
+
+  for (range = proxies.All(); !range.Empty(); range.PopFront())
+    mTree.RemoveProxy(*range.Front());
 }
 
 template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::UpdateProxy(BroadPhaseProxy& proxy, BroadPhaseData& data)
 {
+  // The tree only re-inserts a node (and changes its fat aabb) when the new
+  // aabb leaves the old fat aabb. Nothing else can change the node's pairs.
+  NodeType* node = static_cast<NodeType*>(proxy.ToVoidPointer());
+  Aabb oldAabb = node->mAabb;
   mTree.UpdateProxy(proxy, data);
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
-  // mNodesToQuery.PushBack(static_cast<NodeType*>(proxy.ToVoidPointer()));
+  if (node->mAabb.mMin != oldAabb.mMin || node->mAabb.mMax != oldAabb.mMax)
+    mMovedNodes.Insert(node);
 }
 
 template <typename TreeType>
@@ -173,32 +168,33 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::CastFrustum(CastDataParam data, Pr
 template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::RegisterCollisions()
 {
-  mPairs.Clear();
-
-  FullTreeQuery();
-
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
-
-  // if(mSelfQueryPolicy == BaseDAabbTreeSelfQuery::SingleObject)
-  //  SingleObjectQuery();
-  // else if(mSelfQueryPolicy == BaseDAabbTreeSelfQuery::FullTree)
-  //  FullTreeQuery();
-  // else if(mSelfQueryPolicy == BaseDAabbTreeSelfQuery::PartialTree)
-  //{
-  //  if(mNodesToQuery.Size() < mSingleObjectCountQuery)
-  //    SingleObjectQuery();
-  //  else if(mNodesToQuery.Size() < mBuildTreeObjectCountQuery)
-  //    PartialTreeQuery();
-  //  else
-  //    FullTreeQuery();
-  //}
-  //
-  // mNodesToQuery.Clear();
+  if (mSelfQueryPolicy == BaseDAabbTreeSelfQuery::SingleObject)
+    SingleObjectQuery();
+  else if (mSelfQueryPolicy == BaseDAabbTreeSelfQuery::FullTree)
+    FullTreeQuery();
+  else if (mSelfQueryPolicy == BaseDAabbTreeSelfQuery::PartialTree)
+  {
+    // Once enough of the tree has moved, querying the tree against itself is
+    // quicker than hundreds of individual queries
+    if (mMovedNodes.Size() * mFullTreeMovedRatio < mTree.GetTotalProxyCount())
+      SingleObjectQuery();
+    else
+      FullTreeQuery();
+  }
+
+  mMovedNodes.Clear();
+  mDeltas.Publish();
 
   mTree.Rebalance(4);
 }
 
+template <typename TreeType>
+bool BaseDynamicAabbTreeBroadPhase<TreeType>::QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended)
+{
+  mDeltas.Query(begun, ended);
+  return true;
+}
+
 template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::QueryCallback(void* thisProxy, void* otherProxy)
 {
@@ -209,68 +205,74 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::QueryCallback(void* thisProxy, voi
   // we need a unique key for our hash. So use the proxies
   //(also the node pointers) in the pair. When we need the client data,
   // we can retrieve the pair and therefore client data.
+  // (Only used by the full tree query, which finds the deltas afterwards)
   mPairs.Insert(NodePointerPair(thisProxy, otherProxy));
 }
 
 template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::SingleObjectQuery()
 {
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
+  if (mMovedNodes.Empty())
+    return;
 
-  // typename Array<NodeType*>::range range = mNodesToQuery.All();
-  // for(; !range.Empty(); range.PopFront())
-  //{
-  //  mQueryNode = range.Front();
-  //  AddQueryResult(mQueryNode->mAabb);
-  //}
-  // mQueryNode = nullptr;
-}
+  // Drop the pairs of moved nodes that have separated
+  typename NodeSet::range nodeRange = mMovedNodes.All();
+  for (; !nodeRange.Empty(); nodeRange.PopFront())
+  {
+    NodeType* node = static_cast<NodeType*>(nodeRange.Front());
+    NodeArray* otherNodes = mNodePairs.FindPointer(node);
+    if (otherNodes == nullptr)
+      continue;
 
-template <typename TreeType>
-void BaseDynamicAabbTreeBroadPhase<TreeType>::PartialTreeQuery()
-{
-  // Temporarily Disabled: Leaks in the editor because nothing cleans up
-  // mNodesToQuery
-
-  // Querying a tree against a tree is far quicker than
-  // performing hundreds of individual queries. However, using ourself
-  // will not take advantage of sleeping (only need to query moving objects).
-  // Therefore, with small enough sets, it should be quicker to build
-  // a new temporary tree with only the nodes we need to query and
-  // query that tree against ourselves.
-  // BroadPhaseProxy proxy;
-  // TreeType queryTree;
-  // typename Array<NodeType*>::range range = mNodesToQuery.All();
-  // for(; !range.Empty(); range.PopFront())
-  //{
-  //  mQueryNode = range.Front();
-  //  BroadPhaseData data;
-  //  data.mAabb = mQueryNode->mAabb;
-  //  data.mClientData = mQueryNode->mClientData;
-  //  queryTree.CreateProxy(proxy,data);
-  //}
-  //
-  // mTree.QuerySelfTree(this);
+    // Removing a pair moves the last node into its slot, so walk backwards
+    for (uint i = otherNodes->Size(); i > 0; --i)
+    {
+      NodeType* otherNode = static_cast<NodeType*>((*otherNodes)[i - 1]);
+      if (!node->mAabb.Overlap(otherNode->mAabb))
+        RemovePair(NodePointerPair(node, otherNode));
+    }
+  }
+
+  // Then find everything the moved nodes now overlap
+  for (nodeRange = mMovedNodes.All(); !nodeRange.Empty(); nodeRange.PopFront())
+  {
+    mQueryNode = static_cast<NodeType*>(nodeRange.Front());
+    AddQueryResult(mQueryNode->mAabb);
+  }
+  mQueryNode = nullptr;
 }
 
 template <typename TreeType>
 void BaseDynamicAabbTreeBroadPhase<TreeType>::FullTreeQuery()
 {
-  mTree.QuerySelfTree(this);
+  // Requery everything into an empty set, then compare against the old pairs
+  // to find what changed
+  PairSet oldPairs;
+  oldPairs.Swap(mPairs);
+  mPairs.Reserve(oldPairs.Size());
 
-  // TreeType::SelfQueryRange range = mTree.QuerySelf();
-  // for(; !range.Empty(); range.PopFront())
-  //{
-  //  TreeType::SelfQueryRange::NodePair& pair = range.proxyFront();
+  mTree.QuerySelfTree(this);
 
-  //  //we need to somehow prevent duplicates, so we are using a set. However,
-  //  //we need a unique key for our hash. So use the proxies
-  //  //(also the node pointers) in the pair. When we need the client data,
-  //  //we can retrieve the pair and therefore client data.
+  typename PairSet::range pairRange = mPairs.All();
+  for (; !pairRange.Empty(); pairRange.PopFront())
+  {
+    NodePointerPair& pair = pairRange.Front();
+    if (!oldPairs.Contains(pair))
+    {
+      LinkPair(pair);
+      mDeltas.Begin(pair, GetClientPair(pair));
+    }
+  }
 
-  //  mPairs.Insert(NodePointerPair(pair.first,pair.second));
-  //}
+  for (pairRange = oldPairs.All(); !pairRange.Empty(); pairRange.PopFront())
+  {
+    NodePointerPair& pair = pairRange.Front();
+    if (!mPairs.Contains(pair))
+    {
+      UnlinkPair(pair);
+      mDeltas.End(pair, GetClientPair(pair));
+    }
+  }
 }
 
 template <typename TreeType>
@@ -281,13 +283,7 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::FillOutResults(ClientPairArray& re
   // onto the array
   typename PairSet::range pairRange = mPairs.All();
   for (; !pairRange.Empty(); pairRange.PopFront())
-  {
-    NodeType *node1, *node2;
-    NodePointerPair& pair = pairRange.Front();
-    pair.Convert(node1, node2);
-    results.PushBack(ClientPair(node1->mClientData, node2->mClientData));
-  }
-  mPairs.Clear();
+    results.PushBack(GetClientPair(pairRange.Front()));
 }
 
 template <typename TreeType>
@@ -305,8 +301,83 @@ void BaseDynamicAabbTreeBroadPhase<TreeType>::AddQueryResult(Aabb& aabb)
     //(also the node pointers) in the pair. When we need the client data,
     // we can retrieve the pair and therefore client data.
 
-    mPairs.Insert(NodePointerPair(proxy1, proxy2));
+    AddPair(NodePointerPair(proxy1, proxy2));
   }
 }
 
+template <typename TreeType>
+void BaseDynamicAabbTreeBroadPhase<TreeType>::AddPair(const NodePointerPair& pair)
+{
+  if (mPairs.Insert(pair))
+  {
+    LinkPair(pair);
+    mDeltas.Begin(pair, GetClientPair(pair));
+  }
+}
+
+template <typename TreeType>
+void BaseDynamicAabbTreeBroadPhase<TreeType>::RemovePair(const NodePointerPair& pair)
+{
+  mDeltas.End(pair, GetClientPair(pair));
+  UnlinkPair(pair);
+  mPairs.Erase(pair);
+}
+
+template <typename TreeType>
+void BaseDynamicAabbTreeBroadPhase<TreeType>::RemovePairs(NodeSet& nodes)
+{
+  typename NodeSet::range nodeRange = nodes.All();
+  for (; !nodeRange.Empty(); nodeRange.PopFront())
+  {
+    void* node = nodeRange.Front();
+    mMovedNodes.Erase(node);
+
+    NodeArray* otherNodes = mNodePairs.FindPointer(node);
+    if (otherNodes == nullptr)
+      continue;
+
+    while (!otherNodes->Empty())
+      RemovePair(NodePointerPair(node, otherNodes->Back()));
+    mNodePairs.Erase(node);
+  }
+}
+
+template <typename TreeType>
+void BaseDynamicAabbTreeBroadPhase<TreeType>::LinkPair(const NodePointerPair& pair)
+{
+  mNodePairs[pair.mNodes[0]].PushBack(pair.mNodes[1]);
+  mNodePairs[pair.mNodes[1]].PushBack(pair.mNodes[0]);
+}
+
+template <typename TreeType>
+void BaseDynamicAabbTreeBroadPhase<TreeType>::UnlinkPair(const NodePointerPair& pair)
+{
+  for (uint i = 0; i < 2; ++i)
+  {
+    NodeArray* otherNodes = mNodePairs.FindPointer(pair.mNodes[i]);
+    if (otherNodes == nullptr)
+      continue;
+
+    // Order doesn't matter, so swap the last node into the removed slot
+    void* otherNode = pair.mNodes[1 - i];
+    for (uint j = otherNodes->Size(); j > 0; --j)
+    {
+      if ((*otherNodes)[j - 1] == otherNode)
+      {
+        (*otherNodes)[j - 1] = otherNodes->Back();
+        otherNodes->PopBack();
+        break;
+      }
+    }
+  }
+}
+
+template <typename TreeType>
+ClientPair BaseDynamicAabbTreeBroadPhase<TreeType>::GetClientPair(const NodePointerPair& pair)
+{
+  NodeType* node1 = static_cast<NodeType*>(pair.mNodes[0]);
+  NodeType* node2 = static_cast<NodeType*>(pair.mNodes[1]);
+  return ClientPair(node1->mClientData, node2->mClientData);
+}
+
 } // namespace Plasma
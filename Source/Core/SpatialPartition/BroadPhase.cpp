@@ -112,6 +112,11 @@ void IBroadPhase::RegisterCollisions()
   ErrorIf(true, "RegisterCollisions function not implemented on BroadPhase %s", LightningGetDerivedType()->Name.c_str());
 }
 
+bool IBroadPhase::QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended)
+{
+  return false;
+}
+
 void IBroadPhase::Cleanup()
 {
   ErrorIf(true, "Cleanup function not implemented on BroadPhase %s", LightningGetDerivedType()->Name.c_str());
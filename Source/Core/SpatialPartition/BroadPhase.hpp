@@ -74,6 +74,11 @@ public:
 
   /// Computes all the collision pairs of objects already in the BroadPhase.
   virtual void RegisterCollisions();
+  /// Appends the pairs that started and stopped overlapping during the last
+  /// RegisterCollisions (including pairs ended by removing a proxy before it).
+  /// Only BroadPhases that keep their pairs between updates report anything,
+  /// and they return true so callers know the deltas are complete.
+  virtual bool QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended);
 
   /// Resets the BroadPhase after each update loop.
   virtual void Cleanup();
@@ -174,6 +174,11 @@ void BroadPhasePackage::RegisterCollisions()
   mBroadPhases[BroadPhase::Dynamic]->RegisterCollisions();
 }
 
+bool BroadPhasePackage::QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended)
+{
+  return mBroadPhases[BroadPhase::Dynamic]->QueryPairDeltas(begun, ended);
+}
+
 void BroadPhasePackage::Cleanup()
 {
   mBroadPhases[BroadPhase::Dynamic]->Cleanup();
@@ -92,6 +92,10 @@ public:
 
   /// Computes all the collision pairs of objects already in the BroadPhase
   virtual void RegisterCollisions();
+  /// The pairs that started and stopped overlapping in the dynamic broad phase
+  /// during the last RegisterCollisions. Returns false if it doesn't keep its
+  /// pairs (SelfQuery has to be used instead).
+  virtual bool QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended);
 
   /// Resets the BroadPhase after each update loop.
   virtual void Cleanup();
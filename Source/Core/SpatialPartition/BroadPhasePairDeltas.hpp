@@ -0,0 +1,123 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+/// Collects the pairs that started and stopped overlapping in a BroadPhase that
+/// keeps its pairs around between updates. A pair that begins and ends (or ends
+/// and begins again) before the changes are published cancels out, so only the
+/// net changes are reported. The key type must uniquely identify a pair. If a
+/// key ends and begins again with different client data (a proxy was removed and
+/// its key reused) both the old pair ending and the new one beginning are kept.
+template <typename KeyType, typename ClientDataType>
+class BroadPhasePairDeltas
+{
+public:
+  typedef BaseClientPair<ClientDataType> ClientPairType;
+  typedef Array<ClientPairType> ClientPairArrayType;
+
+  /// Records that a pair started overlapping.
+  void Begin(const KeyType& key, const ClientPairType& pair)
+  {
+    Record(key, pair, true);
+  }
+
+  /// Records that a pair stopped overlapping (or one of its proxies was
+  /// removed).
+  void End(const KeyType& key, const ClientPairType& pair)
+  {
+    Record(key, pair, false);
+  }
+
+  /// Moves the changes recorded so far into the published lists, replacing
+  /// whatever was published before. Called once per update by the BroadPhase.
+  void Publish()
+  {
+    mBegunPairs.Clear();
+    mEndedPairs.Clear();
+
+    typename ChangeMap::range range = mChanges.All();
+    for (; !range.Empty(); range.PopFront())
+    {
+      Change& change = range.Front().second;
+      if (change.mEnded)
+        mEndedPairs.PushBack(change.mEndedPair);
+      if (change.mBegun)
+        mBegunPairs.PushBack(change.mBegunPair);
+    }
+    mChanges.Clear();
+  }
+
+  /// Appends the changes from the last Publish.
+  void Query(ClientPairArrayType& begun, ClientPairArrayType& ended)
+  {
+    begun.Append(mBegunPairs.All());
+    ended.Append(mEndedPairs.All());
+  }
+
+  void Clear()
+  {
+    mChanges.Clear();
+    mBegunPairs.Clear();
+    mEndedPairs.Clear();
+  }
+
+private:
+  /// The net change to one key. A key can only end then begin (never begin
+  /// then end) with different client data.
+  struct Change
+  {
+    ClientPairType mEndedPair;
+    ClientPairType mBegunPair;
+    bool mEnded;
+    bool mBegun;
+  };
+  typedef HashMap<KeyType, Change> ChangeMap;
+
+  void Record(const KeyType& key, const ClientPairType& pair, bool begun)
+  {
+    Change* change = mChanges.FindPointer(key);
+    if (change == nullptr)
+    {
+      Change& newChange = mChanges[key];
+      newChange.mEnded = !begun;
+      newChange.mBegun = begun;
+      if (begun)
+        newChange.mBegunPair = pair;
+      else
+        newChange.mEndedPair = pair;
+      return;
+    }
+
+    if (begun)
+    {
+      // Beginning the same pair that ended cancels out
+      if (change->mEnded && !change->mBegun && SamePair(change->mEndedPair, pair))
+      {
+        mChanges.Erase(key);
+        return;
+      }
+      change->mBegun = true;
+      change->mBegunPair = pair;
+    }
+    else if (change->mBegun)
+    {
+      // Ending the pair that began cancels that out (leaving any earlier end)
+      change->mBegun = false;
+      if (!change->mEnded)
+        mChanges.Erase(key);
+    }
+  }
+
+  static bool SamePair(const ClientPairType& pair1, const ClientPairType& pair2)
+  {
+    return pair1.mClientData[0] == pair2.mClientData[0] && pair1.mClientData[1] == pair2.mClientData[1];
+  }
+
+  ChangeMap mChanges;
+  ClientPairArrayType mBegunPairs;
+  ClientPairArrayType mEndedPairs;
+};
+
+} // namespace Plasma
@@ -457,6 +457,14 @@ void BroadPhaseTracker::RegisterCollisions()
   }
 }
 
+bool BroadPhaseTracker::QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended)
+{
+  BroadPhaseVec& broadPhases = mBroadPhases[BroadPhase::Dynamic];
+  if (broadPhases.Empty())
+    return false;
+  return broadPhases[0]->mBroadPhase->QueryPairDeltas(begun, ended);
+}
+
 /// Resets the BroadPhase after each update loop.
 void BroadPhaseTracker::Cleanup()
 {
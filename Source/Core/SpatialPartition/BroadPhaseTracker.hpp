@@ -124,6 +124,9 @@ public:
 
   /// Computes all the collision pairs of objects already in the BroadPhase
   virtual void RegisterCollisions();
+  /// Reports the deltas of the first dynamic broad phase since every
+  /// broad phase should agree on the pairs.
+  virtual bool QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended);
 
   /// Resets the BroadPhase after each update loop.
   virtual void Cleanup();
@@ -22,6 +22,7 @@ public:
   typedef Array<DataObjectType> DataObjectArray;
   typedef Array<EndPointType> EndPointArray;
   typedef HashSet<uint> BoxSet;
+  typedef Array<BaseClientPair<ClientDataType>> ClientPairArrayType;
 
   Sap();
   Sap(PairManagerType* pairManager);
@@ -50,6 +51,12 @@ public:
   /// Returns a range to self pair intersections.
   SapPairRange<ClientDataType> QuerySelf();
 
+  /// Pairs are found as the endpoints move, so this just publishes the pairs
+  /// that began and ended since the last call.
+  void PublishPairDeltas();
+  /// Appends the pair changes from the last PublishPairDeltas.
+  void QueryPairDeltas(ClientPairArrayType& begun, ClientPairArrayType& ended);
+
   void Clear();
 
   void Draw(int level, uint debugDrawFlags);
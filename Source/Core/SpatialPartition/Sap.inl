@@ -212,6 +212,18 @@ SapPairRange<ClientDataType> Sap<ClientDataType>::QuerySelf()
   return SapPairRange<ClientDataType>(mPairManager);
 }
 
+template <typename ClientDataType>
+void Sap<ClientDataType>::PublishPairDeltas()
+{
+  mPairManager->GetDeltas().Publish();
+}
+
+template <typename ClientDataType>
+void Sap<ClientDataType>::QueryPairDeltas(ClientPairArrayType& begun, ClientPairArrayType& ended)
+{
+  mPairManager->GetDeltas().Query(begun, ended);
+}
+
 template <typename ClientDataType>
 void Sap<ClientDataType>::Clear()
 {
@@ -113,6 +113,14 @@ void SapBroadPhase::CastFrustum(CastDataParam castData, ProxyCastResults& result
 
 void SapBroadPhase::RegisterCollisions()
 {
+  // Pairs are already up to date from the proxy updates
+  mSap.PublishPairDeltas();
+}
+
+bool SapBroadPhase::QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended)
+{
+  mSap.QueryPairDeltas(begun, ended);
+  return true;
 }
 
 } // namespace Plasma
@@ -37,6 +37,7 @@ public:
   virtual void CastFrustum(CastDataParam data, ProxyCastResults& results);
 
   virtual void RegisterCollisions();
+  virtual bool QueryPairDeltas(ClientPairArray& begun, ClientPairArray& ended);
 
   virtual void Cleanup(){};
 
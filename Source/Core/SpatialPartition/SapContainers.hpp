@@ -8,6 +8,8 @@ namespace Plasma
 /// incremental updates. This pair manager is designed for use with multi-Sap
 /// which means it keeps a reference count for each Sap that has an overlap.
 /// This pair manager requires that the ClientDataType has a hasher.
+/// Pairs are kept between updates, so the pairs that start and stop
+/// overlapping are also recorded as deltas.
 template <typename ClientDataType>
 class SapPairManager
 {
@@ -16,6 +18,7 @@ public:
   typedef BaseClientPair<ClientDataType> ClientPairType;
   typedef Pair<uint, ClientPairType> ReferencedPair;
   typedef HashMap<PairId, ReferencedPair> PairMap;
+  typedef BroadPhasePairDeltas<PairId, ClientDataType> PairDeltas;
 
   typedef typename PairMap::range range;
 
@@ -47,6 +50,7 @@ public:
     {
       ClientPairType pair(data1, data2);
       mPairs.Insert(index, ReferencedPair(1, pair));
+      mDeltas.Begin(index, pair);
     }
     // Else, increment the reference count.
     else
@@ -72,7 +76,10 @@ public:
 
     // Erase the pair if theres only one reference left
     if (r.Front().second.first == 1)
+    {
+      mDeltas.End(index, r.Front().second.second);
       mPairs.Erase(index);
+    }
     // Else, decrement the count
     else
       --r.Front().second.first;
@@ -82,6 +89,9 @@ public:
   {
     // Remove all the pairs that were stored.
     // This class owns no new'ed data, so nothing needs to be deleted.
+    range r = mPairs.All();
+    for (; !r.Empty(); r.PopFront())
+      mDeltas.End(r.Front().first, r.Front().second.second);
     mPairs.Clear();
   }
 
@@ -90,8 +100,14 @@ public:
     return mPairs.All();
   }
 
+  PairDeltas& GetDeltas()
+  {
+    return mDeltas;
+  }
+
 private:
   PairMap mPairs;
+  PairDeltas mDeltas;
 };
 
 /// An endpoint is used to store a min/max value of an Aabb on an axis.
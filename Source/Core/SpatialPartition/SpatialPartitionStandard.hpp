@@ -22,6 +22,7 @@ public:
 
 // Project includes
 #include "BroadPhaseProxy.hpp"
+#include "BroadPhasePairDeltas.hpp"
 #include "ProxyCast.hpp"
 #include "BroadPhase.hpp"
 #include "SimpleCastCallbacks.hpp"
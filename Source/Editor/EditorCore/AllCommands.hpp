@@ -14,5 +14,6 @@ void BindCreationCommands(Cog* configCog, CommandManager* commands);
 void BindPhysicsTestCommands(Cog* configCog, CommandManager* commands);
 void BindDocumentationCommands(Cog* config, CommandManager* commands);
 void BindContentCommands(Cog* configCog, CommandManager* commands);
+void BindBenchmarkCommands(Cog* config, CommandManager* commands);
 
 } // namespace Plasma
@@ -0,0 +1,348 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// How many times each benchmark is run (we report the fastest run so that a
+// one off stall, like the first run paging code in, doesn't count)
+static const size_t cBenchmarkRuns = 9;
+
+// Small scripts that each lean on one part of the virtual machine: jumps and
+// integer math, real math, and calls. Run them before and after changing the
+// virtual machine or the opcode optimizer to see what the change bought.
+static cstr cScriptBenchmarkCode = "class ScriptBenchmark\n"
+                                   "{\n"
+                                   "  [Static]\n"
+                                   "  function IntegerLoop() : Integer\n"
+                                   "  {\n"
+                                   "    var sum = 0;\n"
+                                   "    for (var i = 0; i < 1000000; i += 1)\n"
+                                   "    {\n"
+                                   "      sum += (i * 3 + 1) % 7;\n"
+                                   "      if (sum > 100000)\n"
+                                   "        sum -= 100000;\n"
+                                   "    }\n"
+                                   "    return sum;\n"
+                                   "  }\n"
+                                   "\n"
+                                   "  [Static]\n"
+                                   "  function RealLoop() : Integer\n"
+                                   "  {\n"
+                                   "    var x = 0.0;\n"
+                                   "    for (var i = 0; i < 1000000; i += 1)\n"
+                                   "    {\n"
+                                   "      x = x * 0.5 + 1.25;\n"
+                                   "      if (x > 2.0)\n"
+                                   "        x -= 0.5;\n"
+                                   "    }\n"
+                                   "    return (x * 1000.0) as Integer;\n"
+                                   "  }\n"
+                                   "\n"
+                                   "  [Static]\n"
+                                   "  function Fib(n : Integer) : Integer\n"
+                                   "  {\n"
+                                   "    if (n < 2)\n"
+                                   "      return n;\n"
+                                   "    return ScriptBenchmark.Fib(n - 1) + ScriptBenchmark.Fib(n - 2);\n"
+                                   "  }\n"
+                                   "\n"
+                                   "  [Static]\n"
+                                   "  function Calls() : Integer\n"
+                                   "  {\n"
+                                   "    return ScriptBenchmark.Fib(24);\n"
+                                   "  }\n"
+                                   "}\n";
+
+// The static functions in ScriptBenchmark that are timed
+static cstr cScriptBenchmarks[] = {"IntegerLoop", "RealLoop", "Calls"};
+
+void BenchmarkScripts(Editor* editor)
+{
+  // Compile into a library and state of our own so nothing in the project
+  // (components, timeouts, the debugger) is timed along with the benchmarks
+  Project project;
+  Module dependencies;
+  project.AddCodeFromString(cScriptBenchmarkCode, "ScriptBenchmark");
+  LibraryRef library = project.Compile("ScriptBenchmark", dependencies, EvaluationMode::Project);
+  if (library == nullptr)
+  {
+    PlasmaPrint("The script benchmarks failed to compile\n");
+    return;
+  }
+
+  dependencies.PushBack(library);
+  ExecutableState* state = dependencies.Link();
+  BoundType* benchmarkType = library->BoundTypes.FindValue("ScriptBenchmark", nullptr);
+
+  PlasmaPrint("Script benchmarks (fastest of %d runs):\n", (int)cBenchmarkRuns);
+  size_t benchmarkCount = sizeof(cScriptBenchmarks) / sizeof(cScriptBenchmarks[0]);
+  for (size_t i = 0; i < benchmarkCount; ++i)
+  {
+    cstr name = cScriptBenchmarks[i];
+    Function* function =
+        benchmarkType->FindFunction(name, Array<Type*>(), LightningTypeId(int), FindMemberOptions::Static);
+
+    double fastest = Math::DoublePositiveMax();
+    int result = 0;
+    for (size_t run = 0; run < cBenchmarkRuns; ++run)
+    {
+      Timer timer;
+      ExceptionReport report;
+      Call call(function, state);
+      call.Invoke(report);
+      double seconds = timer.UpdateAndGetTime();
+
+      if (report.HasThrownExceptions())
+      {
+        PlasmaPrint("  %s threw an exception\n", name);
+        break;
+      }
+
+      result = call.Get<int>(Call::Return);
+      fastest = Math::Min(fastest, seconds);
+    }
+
+    PlasmaPrint("  %-12s %8.2f ms (result %d)\n", name, fastest * 1000.0, result);
+  }
+
+  delete state;
+}
+
+// A scene of box towers standing on a static ground. Towers don't touch, so
+// each one is its own island
+struct SolverBenchmarkScene
+{
+  uint Towers;
+  uint Width;
+  uint Height;
+};
+
+// From one big island to many small ones, so we can see where the threaded
+// solver starts (or stops) paying for its phases and barriers
+static const SolverBenchmarkScene cSolverBenchmarkScenes[] = {
+    {1, 4, 8}, {1, 8, 16}, {4, 8, 16}, {16, 2, 8}, {16, 4, 8}, {64, 2, 4}};
+
+// The towers are stepped for a while before timing so they've settled into
+// their resting contacts
+static const uint cSolverWarmUpSteps = 30;
+static const uint cSolverTimedSteps = 60;
+static const float cSolverTimeStep = 1.0f / 60.0f;
+
+// Builds a scene in a space of its own and steps it with the given solver.
+// Returns the average seconds per step, along with how many islands and
+// contacts were being solved at the end.
+static double RunSolverBenchmark(const SolverBenchmarkScene& scene,
+                                 PhysicsSolverType::Enum solverType,
+                                 uint& islandsOut,
+                                 uint& contactsOut)
+{
+  Space* space = PL::gFactory->CreateSpace(CoreArchetypes::DefaultSpace, CreationFlags::Default, nullptr);
+  PhysicsSpace* physicsSpace = space->has(PhysicsSpace);
+
+  HandleOf<PhysicsSolverConfig> config = physicsSpace->GetPhysicsSolverConfig()->RuntimeClone();
+  config->SetSolverType(solverType);
+  physicsSpace->SetPhysicsSolverConfig(config);
+
+  // Lay the towers out in a square grid with a gap between them
+  uint towersPerRow = 1;
+  while (towersPerRow * towersPerRow < scene.Towers)
+    ++towersPerRow;
+  float towerSpacing = (float)scene.Width + 2.0f;
+  float groundSize = towerSpacing * (float)towersPerRow;
+
+  Array<Cog*> cogs;
+  Vec3 groundCenter(groundSize * 0.5f, -0.5f, groundSize * 0.5f);
+  Cog* ground = space->CreateAt(CoreArchetypes::Cube, groundCenter, Vec3(groundSize, 1.0f, groundSize));
+  ground->has(RigidBody)->SetDynamicState(RigidBodyDynamicState::Static);
+  cogs.PushBack(ground);
+
+  for (uint tower = 0; tower < scene.Towers; ++tower)
+  {
+    Vec3 origin((float)(tower % towersPerRow), 0.0f, (float)(tower / towersPerRow));
+    origin *= towerSpacing;
+    origin += Vec3(1.5f, 0.5f, 1.5f);
+
+    for (uint y = 0; y < scene.Height; ++y)
+    {
+      for (uint x = 0; x < scene.Width; ++x)
+      {
+        for (uint z = 0; z < scene.Width; ++z)
+        {
+          Cog* box = space->CreateAt(CoreArchetypes::Cube, origin + Vec3((float)x, (float)y, (float)z));
+          // Sleeping towers aren't solved at all, which would hide the solver
+          box->has(RigidBody)->SetAllowSleep(false);
+          cogs.PushBack(box);
+        }
+      }
+    }
+  }
+
+  UpdateEvent updateEvent(cSolverTimeStep, cSolverTimeStep, 0.0f, 0.0f);
+  for (uint i = 0; i < cSolverWarmUpSteps; ++i)
+    physicsSpace->SystemLogicUpdate(&updateEvent);
+
+  Timer timer;
+  for (uint i = 0; i < cSolverTimedSteps; ++i)
+    physicsSpace->SystemLogicUpdate(&updateEvent);
+  double seconds = timer.UpdateAndGetTime() / (double)cSolverTimedSteps;
+
+  // Every contact is counted by both of its colliders
+  uint contactCount = 0;
+  for (size_t i = 0; i < cogs.Size(); ++i)
+    contactCount += cogs[i]->has(Collider)->GetContactCount();
+
+  islandsOut = physicsSpace->GetIslandCount();
+  contactsOut = contactCount / 2;
+
+  space->Destroy();
+  return seconds;
+}
+
+void BenchmarkPhysicsSolvers(Editor* editor)
+{
+  PlasmaPrint("Physics solver benchmark (ms per step, average of %d steps, %d task threads):\n",
+              (int)cSolverTimedSteps,
+              (int)PL::gJobs->GetTaskThreadCount());
+  PlasmaPrint("  islands  contacts     basic  threaded  speedup\n");
+
+  size_t sceneCount = sizeof(cSolverBenchmarkScenes) / sizeof(cSolverBenchmarkScenes[0]);
+  for (size_t i = 0; i < sceneCount; ++i)
+  {
+    const SolverBenchmarkScene& scene = cSolverBenchmarkScenes[i];
+
+    uint islands = 0;
+    uint contacts = 0;
+    double basic = RunSolverBenchmark(scene, PhysicsSolverType::Basic, islands, contacts);
+    double threaded = RunSolverBenchmark(scene, PhysicsSolverType::Threaded, islands, contacts);
+
+    PlasmaPrint("  %7d  %8d  %8.3f  %8.3f  %6.2fx\n",
+                (int)islands,
+                (int)contacts,
+                basic * 1000.0,
+                threaded * 1000.0,
+                basic / threaded);
+  }
+}
+
+// The filters are handed blocks of this many frames, close to what the mix
+// asks its nodes for at low latency
+static const unsigned cSoundBenchmarkBlockFrames = 512;
+// Mono, stereo, 5.1 and 7.1
+static const unsigned cSoundBenchmarkChannels[] = {1, 2, 6, 8};
+// The convolver is given a one second impulse response, like a small reverb
+static const unsigned cSoundBenchmarkImpulseFrames = AudioConstants::cSystemSampleRate;
+
+// Runs one second of interleaved audio through a filter, a block at a time.
+// Returns the seconds spent, which is also the share of a core the filter
+// needs for every second that is mixed.
+template <typename FilterType>
+static double TimeSoundFilter(FilterType& filter, const Array<float>& input, Array<float>& output, unsigned channels)
+{
+  unsigned blockSamples = cSoundBenchmarkBlockFrames * channels;
+  unsigned totalSamples = AudioConstants::cSystemSampleRate * channels;
+
+  Timer timer;
+  for (unsigned i = 0; i + blockSamples <= totalSamples; i += blockSamples)
+    filter.ProcessBuffer(input.Data() + i, output.Data() + i, channels, blockSamples);
+  return timer.UpdateAndGetTime();
+}
+
+static double RunLowPassBenchmark(const Array<float>& input, Array<float>& output, unsigned channels)
+{
+  LowPassFilter filter;
+  filter.SetCutoffFrequency(1000.0f);
+  return TimeSoundFilter(filter, input, output, channels);
+}
+
+static double RunHighPassBenchmark(const Array<float>& input, Array<float>& output, unsigned channels)
+{
+  HighPassFilter filter;
+  filter.SetCutoffFrequency(1000.0f);
+  return TimeSoundFilter(filter, input, output, channels);
+}
+
+static double RunBandPassBenchmark(const Array<float>& input, Array<float>& output, unsigned channels)
+{
+  BandPassFilter filter;
+  return TimeSoundFilter(filter, input, output, channels);
+}
+
+// The convolver only takes one channel, so every channel gets its own, fed
+// from the start of the input
+static double RunConvolutionBenchmark(const Array<float>& input, Array<float>& output, unsigned channels)
+{
+  FFTConvolver convolvers[AudioConstants::cMaxChannels];
+  for (unsigned i = 0; i < channels; ++i)
+    convolvers[i].Initialize(cSoundBenchmarkBlockFrames, input.Data(), cSoundBenchmarkImpulseFrames);
+
+  Timer timer;
+  for (unsigned i = 0; i + cSoundBenchmarkBlockFrames <= AudioConstants::cSystemSampleRate;
+       i += cSoundBenchmarkBlockFrames)
+  {
+    for (unsigned channel = 0; channel < channels; ++channel)
+      convolvers[channel].ProcessBuffer(input.Data() + i, output.Data() + i, cSoundBenchmarkBlockFrames);
+  }
+  return timer.UpdateAndGetTime();
+}
+
+typedef double (*SoundBenchmarkFunction)(const Array<float>& input, Array<float>& output, unsigned channels);
+
+struct SoundBenchmark
+{
+  cstr Name;
+  SoundBenchmarkFunction Function;
+};
+
+// The filters behind the LowPassNode, HighPassNode and BandPassNode, and the
+// partitioned convolver
+static const SoundBenchmark cSoundBenchmarks[] = {{"LowPass", RunLowPassBenchmark},
+                                                  {"HighPass", RunHighPassBenchmark},
+                                                  {"BandPass", RunBandPassBenchmark},
+                                                  {"Convolution", RunConvolutionBenchmark}};
+
+void BenchmarkSoundFilters(Editor* editor)
+{
+  // Noise for every channel, enough for one second at the most channels
+  unsigned maxSamples = AudioConstants::cSystemSampleRate * AudioConstants::cMaxChannels;
+  Array<float> input(maxSamples);
+  Array<float> output(maxSamples);
+  Math::Random random;
+  for (unsigned i = 0; i < maxSamples; ++i)
+    input[i] = random.FloatRange(-1.0f, 1.0f);
+
+  PlasmaPrint("Sound filter benchmark (%% of one core per mixed second, fastest of %d runs, %d frame blocks):\n",
+              (int)cBenchmarkRuns,
+              (int)cSoundBenchmarkBlockFrames);
+  PlasmaPrint("  %-12s", "channels");
+  size_t channelCounts = sizeof(cSoundBenchmarkChannels) / sizeof(cSoundBenchmarkChannels[0]);
+  for (size_t i = 0; i < channelCounts; ++i)
+    PlasmaPrint("  %7d", (int)cSoundBenchmarkChannels[i]);
+  PlasmaPrint("\n");
+
+  size_t benchmarkCount = sizeof(cSoundBenchmarks) / sizeof(cSoundBenchmarks[0]);
+  for (size_t i = 0; i < benchmarkCount; ++i)
+  {
+    const SoundBenchmark& benchmark = cSoundBenchmarks[i];
+    PlasmaPrint("  %-12s", benchmark.Name);
+
+    for (size_t j = 0; j < channelCounts; ++j)
+    {
+      double fastest = Math::DoublePositiveMax();
+      for (size_t run = 0; run < cBenchmarkRuns; ++run)
+        fastest = Math::Min(fastest, benchmark.Function(input, output, cSoundBenchmarkChannels[j]));
+
+      PlasmaPrint("  %6.3f%%", fastest * 100.0);
+    }
+    PlasmaPrint("\n");
+  }
+}
+
+void BindBenchmarkCommands(Cog* config, CommandManager* commands)
+{
+  commands->AddCommand("BenchmarkScripts", BindCommandFunction(BenchmarkScripts), true);
+  commands->AddCommand("BenchmarkPhysicsSolvers", BindCommandFunction(BenchmarkPhysicsSolvers), true);
+  commands->AddCommand("BenchmarkSoundFilters", BindCommandFunction(BenchmarkSoundFilters), true);
+}
+
+} // namespace Plasma
@@ -261,6 +261,66 @@ void EndTracing(Editor* editor)
   new SimpleSaveFileDialog(compressedData, "Save a trace", "Trace Zip File", "*.zip", "zip", defaultFileName);
 }
 
+// Samples the script call stack while running (see BeginScriptProfiling)
+static Lightning::SamplingProfiler sScriptProfiler;
+
+void BeginScriptProfiling(Editor* editor)
+{
+  sScriptProfiler.Clear();
+  sScriptProfiler.Attach(ExecutableState::CallingState);
+}
+
+void EndScriptProfiling(Editor* editor)
+{
+  if (!sScriptProfiler.IsAttached())
+    return;
+
+  sScriptProfiler.Detach();
+
+  Array<Lightning::FunctionSamples> functions;
+  sScriptProfiler.GetFunctionSamples(functions);
+
+  // Print the most expensive functions so there's something to look at without
+  // a flame graph tool
+  const size_t cMaxFunctionsPrinted = 10;
+  size_t sampleCount = sScriptProfiler.GetSampleCount();
+  PlasmaPrint("Script profile (%d samples):\n", (int)sampleCount);
+  for (size_t i = 0; i < functions.Size() && i < cMaxFunctionsPrinted; ++i)
+  {
+    Lightning::FunctionSamples& function = functions[i];
+    PlasmaPrint("  %5.1f%% self %5.1f%% total  %s\n",
+                100.0f * function.SelfSamples / sampleCount,
+                100.0f * function.TotalSamples / sampleCount,
+                function.Name.c_str());
+  }
+
+  // Collapsed stacks can be turned into a flame graph by most profiling tools
+  String stacks = sScriptProfiler.GetCollapsedStacks();
+  ProjectSettings* project = PL::gEditor->mProject.has(ProjectSettings);
+  String defaultFileName = BuildString(project->ProjectName, "-", GetTimeAndDateStamp(), ".folded");
+  new SimpleSaveFileDialog(
+      stacks, "Save a script profile", "Collapsed Stacks File", "*.folded", "folded", defaultFileName);
+}
+
+// Prints the types that script allocated the most heap objects of, which is
+// where to look when script is churning through memory
+void PrintScriptHeapAllocations(Editor* editor)
+{
+  Array<Lightning::HeapTypeCounts> types;
+  ExecutableState::CallingState->HeapObjects->GetAllocatedTypes(types);
+
+  const size_t cMaxTypesPrinted = 20;
+  PlasmaPrint("Script heap allocations (%d types):\n", (int)types.Size());
+  for (size_t i = 0; i < types.Size() && i < cMaxTypesPrinted; ++i)
+  {
+    Lightning::HeapTypeCounts& counts = types[i];
+    PlasmaPrint("  %10d allocated %10d alive  %s\n",
+                (int)counts.Allocations,
+                (int)counts.LiveObjects,
+                counts.Type->Name.c_str());
+  }
+}
+
 void SetupGraphCommands(Cog* configCog, CommandManager* commands)
 {
   commands->AddCommand("EnableDebugging", BindCommandFunction(EnableDebugging), true);
@@ -272,6 +332,9 @@ void SetupGraphCommands(Cog* configCog, CommandManager* commands)
   commands->AddCommand("Graph", BindCommandFunction(AddGraph), true);
   commands->AddCommand("BeginTracing", BindCommandFunction(BeginTracing), true);
   commands->AddCommand("EndTracing", BindCommandFunction(EndTracing), true);
+  commands->AddCommand("BeginScriptProfiling", BindCommandFunction(BeginScriptProfiling), true);
+  commands->AddCommand("EndScriptProfiling", BindCommandFunction(EndScriptProfiling), true);
+  commands->AddCommand("PrintScriptHeapAllocations", BindCommandFunction(PrintScriptHeapAllocations), true);
 }
 
 } // namespace Plasma
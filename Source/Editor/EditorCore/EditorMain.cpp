@@ -973,6 +973,7 @@ void CreateEditor(OsWindow* mainWindow, StringParam projectFile, StringParam new
   BindDocumentationCommands(config, commands);
   BindProjectCommands(config, commands);
   BindContentCommands(config, commands);
+  BindBenchmarkCommands(config, commands);
 
   // Listen to the resource system if any unhandled exception or syntax error
   // occurs
@@ -134,6 +134,10 @@ void CopyLibraryOut(StringParam outputDirectory, ContentLibrary* library, bool s
   BoundType* LightningPluginSourceType = LightningTypeId(LightningPluginSource);
   BoundType* lightningPluginLibraryType = LightningTypeId(LightningPluginLibrary);
 
+  // Resources whose loaders can load from memory are packed into one file
+  // instead of being copied, so the game can map them
+  ResourceListing packedEntries;
+
   int itemsDone = 0;
   float librarySize = (float)library->GetContentItems().Size();
 
@@ -165,11 +169,41 @@ void CopyLibraryOut(StringParam outputDirectory, ContentLibrary* library, bool s
       if (!FileExists(source))
         continue;
 
+      ResourceLoader* loader = PL::gResources->mLoaderMap.FindValue(entry.Type, nullptr);
+      if (loader != nullptr && loader->CanLoadFromBlock())
+      {
+        entry.FullPath = source;
+        packedEntries.PushBack(entry);
+        continue;
+      }
+
       String destination = FilePath::Combine(libraryOutputPath, fileName);
       CopyFile(destination, source);
       PL::gEngine->LoadingUpdate("Copying", fileName, "", ProgressType::Normal, float(itemsDone) / librarySize);
     }
   }
+
+  // Never leave the packed file from a previous export behind
+  String packedFile =
+      FilePath::CombineWithExtension(libraryOutputPath, library->Name, PackedResourceFile::cExtension);
+  if (FileExists(packedFile))
+    DeleteFile(packedFile);
+
+  if (!packedEntries.Empty())
+  {
+    PL::gEngine->LoadingUpdate("Packing", library->Name, "", ProgressType::Normal, 1.0f);
+
+    Status status;
+    if (!PackedResourceFile::Write(status, packedFile, packedEntries))
+    {
+      // Without the packed file the game loads every file individually, so
+      // copy the files we were going to pack
+      DoNotifyWarning("Export", status.Message);
+      DeleteFile(packedFile);
+      forRange (ResourceEntry& entry, packedEntries.All())
+        CopyFile(FilePath::Combine(libraryOutputPath, entry.Location), entry.FullPath);
+    }
+  }
 }
 
 void CopyLibraryOut(StringParam outputDirectory, StringParam name, bool skipTemplates)
@@ -5,6 +5,27 @@
 namespace Plasma
 {
 
+static void SetTextureData(Texture* texture, TextureHeader& header, MipHeader* mipHeaders, byte* imageData)
+{
+  // Pull size off of top level
+  texture->mWidth = mipHeaders->mWidth;
+  texture->mHeight = mipHeaders->mHeight;
+
+  texture->mMipCount = header.mMipCount;
+  texture->mTotalDataSize = header.mTotalDataSize;
+  texture->mMipHeaders = mipHeaders;
+  texture->mImageData = imageData;
+
+  texture->mType = (TextureType::Enum)header.mType;
+  texture->mFormat = (TextureFormat::Enum)header.mFormat;
+  texture->mCompression = (TextureCompression::Enum)header.mCompression;
+  texture->mAddressingX = (TextureAddressing::Enum)header.mAddressingX;
+  texture->mAddressingY = (TextureAddressing::Enum)header.mAddressingY;
+  texture->mFiltering = (TextureFiltering::Enum)header.mFiltering;
+  texture->mAnisotropy = (TextureAnisotropy::Enum)header.mAnisotropy;
+  texture->mMipMapping = (TextureMipMapping::Enum)header.mMipMapping;
+}
+
 void LoadTexture(StringParam filename, Texture* texture)
 {
   texture->mFormat = TextureFormat::None;
@@ -56,23 +77,55 @@ void LoadTexture(StringParam filename, Texture* texture)
     return;
   }
 
-  // Pull size off of top level
-  texture->mWidth = mipHeaders->mWidth;
-  texture->mHeight = mipHeaders->mHeight;
+  SetTextureData(texture, header, mipHeaders, imageData);
+}
 
-  texture->mMipCount = header.mMipCount;
-  texture->mTotalDataSize = header.mTotalDataSize;
-  texture->mMipHeaders = mipHeaders;
-  texture->mImageData = imageData;
+static bool ReadTextureHeader(DataBlock block, size_t& position, TextureHeader& header)
+{
+  if (block.Size - position < sizeof(TextureHeader))
+    return false;
 
-  texture->mType = (TextureType::Enum)header.mType;
-  texture->mFormat = (TextureFormat::Enum)header.mFormat;
-  texture->mCompression = (TextureCompression::Enum)header.mCompression;
-  texture->mAddressingX = (TextureAddressing::Enum)header.mAddressingX;
-  texture->mAddressingY = (TextureAddressing::Enum)header.mAddressingY;
-  texture->mFiltering = (TextureFiltering::Enum)header.mFiltering;
-  texture->mAnisotropy = (TextureAnisotropy::Enum)header.mAnisotropy;
-  texture->mMipMapping = (TextureMipMapping::Enum)header.mMipMapping;
+  memcpy(&header, block.Data + position, sizeof(TextureHeader));
+  position += sizeof(TextureHeader);
+  return header.mFileId == TextureFileId;
+}
+
+void LoadTexture(DataBlock block, Texture* texture)
+{
+  texture->mFormat = TextureFormat::None;
+  texture->mMipHeaders = nullptr;
+  texture->mImageData = nullptr;
+  texture->mTotalDataSize = 0;
+
+  size_t position = 0;
+  TextureHeader header;
+  if (!ReadTextureHeader(block, position, header))
+    return;
+
+  // Same fallback as loading from a file
+  if (header.mCompression != TextureCompression::None && PL::gRenderer->mDriverSupport.mTextureCompression == false)
+  {
+    size_t dataSizeToSkip = header.mMipCount * sizeof(MipHeader) + header.mTotalDataSize;
+    if (block.Size - position < dataSizeToSkip)
+      return;
+
+    position += dataSizeToSkip;
+    if (!ReadTextureHeader(block, position, header))
+      return;
+  }
+
+  size_t mipHeadersSize = header.mMipCount * sizeof(MipHeader);
+  if (block.Size - position < mipHeadersSize + header.mTotalDataSize)
+    return;
+
+  // The image data is flipped in place for some renderers and the renderer
+  // frees it once it's uploaded, so it can't point into the block
+  MipHeader* mipHeaders = new MipHeader[header.mMipCount];
+  byte* imageData = new byte[header.mTotalDataSize];
+  memcpy(mipHeaders, block.Data + position, mipHeadersSize);
+  memcpy(imageData, block.Data + position + mipHeadersSize, header.mTotalDataSize);
+
+  SetTextureData(texture, header, mipHeaders, imageData);
 }
 
 HandleOf<Resource> TextureLoader::LoadFromFile(ResourceEntry& entry)
@@ -92,7 +145,15 @@ void TextureLoader::ReloadFromFile(Resource* resource, ResourceEntry& entry)
 
 HandleOf<Resource> TextureLoader::LoadFromBlock(ResourceEntry& entry)
 {
-  return nullptr;
+  Texture* texture = new Texture();
+  LoadTexture(entry.Block, texture);
+  TextureManager::GetInstance()->AddResource(entry, texture);
+  return texture;
+}
+
+bool TextureLoader::CanLoadFromBlock()
+{
+  return true;
 }
 
 } // namespace Plasma
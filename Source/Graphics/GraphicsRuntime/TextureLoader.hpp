@@ -11,6 +11,7 @@ public:
   HandleOf<Resource> LoadFromFile(ResourceEntry& entry) override;
   void ReloadFromFile(Resource* resource, ResourceEntry& entry) override;
   HandleOf<Resource> LoadFromBlock(ResourceEntry& entry) override;
+  bool CanLoadFromBlock() override;
 };
 
 } // namespace Plasma
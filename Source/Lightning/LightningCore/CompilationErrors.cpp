@@ -25,7 +25,8 @@ CompilationErrors::CompilationErrors() :
     UserData(nullptr),
     WasError(false),
     IgnoreMultipleErrors(true),
-    TolerantMode(false)
+    TolerantMode(false),
+    DeferErrors(false)
 {
 }
 
@@ -80,8 +81,12 @@ void CompilationErrors::RaiseArgs(const CodeLocation& location,
   // expected
   errorDetails.ExactError = BuildString(errorDetails.ExactError, extra);
 
-  // Send the event and let everyone receive it
-  EventSend(this, Events::CompilationError, &errorDetails);
+  // Send the event and let everyone receive it (or hold onto it until the owner
+  // asks for it to be sent)
+  if (this->DeferErrors)
+    this->DeferredErrors.PushBack(errorDetails);
+  else
+    EventSend(this, Events::CompilationError, &errorDetails);
 
   // If the error was an internal error, then break here
   if (errorCode == ErrorCode::InternalError)
@@ -133,4 +138,11 @@ void CompilationErrors::Raise(
   // Finish reading variable arguments
   va_end(argList);
 }
+
+void CompilationErrors::SendDeferredErrors()
+{
+  for (size_t i = 0; i < this->DeferredErrors.Size(); ++i)
+    EventSend(this, Events::CompilationError, &this->DeferredErrors[i]);
+  this->DeferredErrors.Clear();
+}
 } // namespace Lightning
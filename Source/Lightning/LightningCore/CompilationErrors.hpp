@@ -64,6 +64,9 @@ public:
   // Print out an error message
   void Raise(const CodeLocation& location, int errorCode, ...);
 
+  // Sends out any errors that were stored while 'DeferErrors' was set
+  void SendDeferredErrors();
+
   // A pointer to any data the user wants to attach
   mutable const void* UserData;
 
@@ -85,6 +88,12 @@ public:
   // If this is set, errors will be reported but ignored (which allows parsing
   // and syntaxing to continue)
   bool TolerantMode;
+
+  // If this is set, errors are stored rather than sent right away. This is used
+  // when compiling on another thread, since the handlers of the error event
+  // generally aren't thread safe (see SendDeferredErrors)
+  bool DeferErrors;
+  Array<ErrorEvent> DeferredErrors;
 };
 } // namespace Lightning
 
@@ -294,6 +294,7 @@ ExecutableState* ExecutableState::CallingState = nullptr;
 ExecutableState::ExecutableState() :
     UserData(nullptr),
     EnableDebugEvents(false),
+    Profiler(nullptr),
     PatchId(0),
     StackSize(DefaultStackSize),
     OverflowStackSize(DefaultStackSize),
@@ -303,6 +304,7 @@ ExecutableState::ExecutableState() :
     AllocatingType(nullptr),
     UniqueIdScopeCounter(1),
     TimeoutSeconds(0),
+    TimeoutCheckCountdown(TimeoutCheckInterval),
     HitStackOverflow(false)
 {
   LightningErrorIfNotStarted(ExecutableState);
@@ -351,6 +353,10 @@ ExecutableState::~ExecutableState()
   // We should always have the base frame
   ErrorIf(this->StackFrames.Size() == 0, "Base frame should always exist (this is bad)");
 
+  // Don't leave the profiler pointing at us
+  if (this->Profiler != nullptr)
+    this->Profiler->Detach();
+
   // In general no objects should still be existing by this point in time unless
   // the user allocated and stored handles to objects, especially non-reference
   // counted objects
@@ -518,6 +524,16 @@ PerFrameData* ExecutableState::PushFrame(byte* frame, Function* function)
     abort();
   }
 
+  // If this is the first call being made into the state, the time since the
+  // last check was spent outside of Lightning (in the host, or idle between
+  // calls) so throw it away instead of charging it to timeouts or the profiler
+  // Note: This must be done before we push the stack frame below
+  if (this->IsInCallStack() == false)
+  {
+    this->TimeoutTimer.GetAndUpdateTicks();
+    this->TimeoutTimer.Reset();
+  }
+
   // If this is the first call being made into the state and we have a default
   // timeout set Note: This must be done before we push the stack frame below
   if (this->TimeoutSeconds != 0 && this->IsInCallStack() == false)
@@ -1069,10 +1085,16 @@ void ExecutableState::ForcePatchLibrary(LibraryParam newLibrary)
                "go outside! What do we do in that case though... fail patching?");
 
       // Loop through all heap objects and check if any of them are the old type
-      LightningForEach (const byte* object, this->HeapObjects->LiveObjects)
+      Array<HeapSlot>& heapSlots = this->HeapObjects->Slots;
+      for (size_t slotIndex = 0; slotIndex < heapSlots.Size(); ++slotIndex)
       {
+        // Skip free slots
+        if (heapSlots[slotIndex].Header == nullptr)
+          continue;
+
         // Just behind the allocated object is the header
-        ObjectHeader& header = *(ObjectHeader*)(object - sizeof(ObjectHeader));
+        ObjectHeader& header = *heapSlots[slotIndex].Header;
+        const byte* object = ((byte*)&header) + sizeof(ObjectHeader);
 
         // Remember, we only compare names, which means the oldHeapType can
         // actually be different than oldType This is especially true after
@@ -1085,8 +1107,14 @@ void ExecutableState::ForcePatchLibrary(LibraryParam newLibrary)
         if (oldHeapType->Name != newTypeOrNull->Name)
           continue;
 
-        // Update the type on the slot's header
+        // Update the type on the slot's header (and move the object over to
+        // the new type's counts)
         header.Type = newTypeOrNull;
+        --this->HeapObjects->TypeCounts[oldHeapType].LiveObjects;
+        HeapTypeCounts& newCounts = this->HeapObjects->TypeCounts[newHeapType];
+        newCounts.Type = newHeapType;
+        ++newCounts.Allocations;
+        ++newCounts.LiveObjects;
 
         // Create a temporary buffer to copy all the values from the old heap
         // type over
@@ -1548,6 +1576,11 @@ bool ExecutableState::ThrowExceptionOnTimeout(ExceptionReport& report)
   // Reset the timer so the the timer always returns us 'time passed since last
   // check'
   this->TimeoutTimer.Reset();
+  this->TimeoutCheckCountdown = TimeoutCheckInterval;
+
+  // Every check is a chance for the profiler to take a sample
+  if (this->Profiler != nullptr)
+    this->Profiler->AddTicks(this, ticksSinceLastCheck);
 
   // Early out if we don't have any timeouts to abide by
   if (this->Timeouts.Empty())
@@ -485,6 +485,20 @@ public:
   // otherwise
   bool ThrowExceptionOnTimeout(ExceptionReport& report);
 
+  // Reading the clock costs more than most of the loops the virtual machine
+  // guards, so jumps and calls only run the timeout check (which is also where
+  // the profiler samples) once every this many times
+  static const size_t TimeoutCheckInterval = 256;
+
+  // Runs ThrowExceptionOnTimeout once every TimeoutCheckInterval calls
+  // Returns true if we threw a timeout exception, false otherwise
+  bool CheckTimeout(ExceptionReport& report)
+  {
+    if (--this->TimeoutCheckCountdown != 0)
+      return false;
+    return this->ThrowExceptionOnTimeout(report);
+  }
+
   // Gets the latest exception report via the thread local 'CallingState'
   static ExceptionReport& GetCallingReport();
 
@@ -578,6 +592,9 @@ public:
   // Enables debug events (opcode step, enter/exit function, etc)
   bool EnableDebugEvents;
 
+  // The profiler sampling this state, if any (see SamplingProfiler::Attach)
+  SamplingProfiler* Profiler;
+
   // Maps old functions to the new functions they were patched with (only if any
   // library was patched in the state)
   HashMap<Function*, Function*> PatchedFunctions;
@@ -693,6 +710,9 @@ public:
   // This value is only used when we enter the first function on the call stack
   size_t TimeoutSeconds;
 
+  // How many more jumps or calls until CheckTimeout reads the clock
+  size_t TimeoutCheckCountdown;
+
   // The stack data used by the executable state
   // This is the base of the stack, NOT the current stack
   // Note that the stack is of a fixed size, and should never be reallocated
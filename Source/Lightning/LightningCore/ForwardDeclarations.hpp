@@ -110,6 +110,7 @@ class RelativeJumpOpcode;
 class Resolver;
 class ReturnNode;
 class RootNode;
+class SamplingProfiler;
 class ScopeNode;
 class ScriptingEnginePrivateData;
 class SendsEvent;
@@ -213,6 +213,10 @@ public:
   // All overriding functions are also marked as virtual
   bool IsVirtual;
 
+  // For virtual functions, the overriding function we found on each of the
+  // last few derived types this function was called on
+  InlineCache<Function> OverrideCache;
+
   // All the constants used in this function (only used for compiled functions)
   DestructibleBuffer Constants;
 
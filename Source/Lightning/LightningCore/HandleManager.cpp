@@ -192,10 +192,30 @@ bool HandleManager::GetNativeTypeFullyConstructed(const Handle& handle)
   return true;
 }
 
-HeapManager::HeapManager(ExecutableState* state) : HandleManager(state)
+HeapSlab::HeapSlab() : FreeBlocks(nullptr)
 {
-  // Initialize the counter to plasma
-  this->UidCount = 0;
+}
+
+HeapTypeCounts::HeapTypeCounts() : Type(nullptr), Allocations(0), LiveObjects(0)
+{
+}
+
+// Sorts types by how many heap objects were allocated (most first)
+static bool HeapAllocationsGreater(const HeapTypeCounts& lhs, const HeapTypeCounts& rhs)
+{
+  return lhs.Allocations > rhs.Allocations;
+}
+
+HeapManager::HeapManager(ExecutableState* state) : HandleManager(state), FreeSlot(HeapSlotNone), LiveObjectCount(0)
+{
+}
+
+HeapManager::~HeapManager()
+{
+  ErrorIf(this->LiveObjectCount != 0, "All objects should have been deleted before the HeapManager is destroyed");
+
+  for (size_t i = 0; i < this->Pages.Size(); ++i)
+    Plasma::plDeallocate(this->Pages[i].Memory);
 }
 
 String HeapManager::GetName()
@@ -208,30 +228,28 @@ byte* HeapManager::HandleToObject(const Handle& handle)
 {
   HeapHandleData& data = *(HeapHandleData*)handle.Data;
 
-  // The pointer to the object is just after the header
-  byte* object = ((byte*)data.Header) + sizeof(ObjectHeader);
-
-  // First check if the object is even live
-  if (this->LiveObjects.Contains(object) == false)
+  // If the generation of the slot doesn't match (the object was deleted and
+  // the slot may have been reused) then this handle is no longer valid
+  if (data.Slot >= this->Slots.Size())
     return nullptr;
 
-  // If the unique-ids for that slot don't match (it was reused)
-  // then we return null since this handle is no longer valid
-  if (data.UniqueId != data.Header->UniqueId)
+  HeapSlot& slot = this->Slots[data.Slot];
+  if (slot.Generation != data.Generation || slot.Header == nullptr)
     return nullptr;
 
-  // The object must be valid!
-  return object;
+  // The pointer to the object is just after the header
+  return ((byte*)slot.Header) + sizeof(ObjectHeader);
 }
 
 void HeapManager::Allocate(BoundType* type, Handle& handleToInitialize, size_t customFlags)
 {
   // Create a buffer that's the size of the object we'd like to allocate
-  // At the beginning of the buffer, we put the object slot pointer so that
-  // 'ObjectToHandle' can recreate a handle via the slot data pointer
+  // At the beginning of the buffer, we put the object header so that
+  // 'ObjectToHandle' can recreate a handle via the slot it points at
   size_t objectSize = type->GetAllocatedSize();
   size_t fullSize = sizeof(ObjectHeader) + objectSize + HeapManagerExtraPatchSize;
-  byte* memory = (byte*)Plasma::plAllocate(fullSize);
+  size_t blockSize = 0;
+  byte* memory = this->AllocateBlock(fullSize, blockSize);
 
   // If the memory failed to allocate, early out
   if (memory == nullptr)
@@ -241,22 +259,43 @@ void HeapManager::Allocate(BoundType* type, Handle& handleToInitialize, size_t c
     return;
   }
 
-  // Make sure we mark this as a live object
-  byte* object = memory + sizeof(ObjectHeader);
-  this->LiveObjects.Insert(object);
-
   // All primitives should support being plasmaed out
   memset(memory, 0, fullSize);
 
-  // Store a pointer back to the slot on the memory itself
+  // Grab a free slot (or grow the table)
+  unsigned slotIndex = this->FreeSlot;
+  if (slotIndex != HeapSlotNone)
+  {
+    this->FreeSlot = this->Slots[slotIndex].NextFree;
+  }
+  else
+  {
+    slotIndex = (unsigned)this->Slots.Size();
+    HeapSlot& newSlot = this->Slots.PushBack();
+    newSlot.Generation = 0;
+  }
+
   ObjectHeader& header = *(ObjectHeader*)memory;
   header.Type = type;
-  header.UniqueId = this->UidCount;
+  header.Slot = slotIndex;
   header.ReferenceCount = 1;
   header.Flags = (HeapObjectFlags::Enum)customFlags;
+  header.BlockSize = (unsigned)blockSize;
 
-  // Increment the unique ID counter
-  ++this->UidCount;
+  HeapSlot& slot = this->Slots[slotIndex];
+  slot.Header = &header;
+  slot.NextFree = HeapSlotNone;
+
+  ++this->LiveObjectCount;
+  HeapTypeCounts& counts = this->TypeCounts[type];
+  counts.Type = type;
+  ++counts.Allocations;
+  ++counts.LiveObjects;
+
+  // If the object is too big for a slab, we need to remember it so that
+  // 'ObjectToHandle' knows it came from us
+  if (blockSize > HeapSlabMaxBlockSize)
+    this->LargeObjects.Insert(memory + sizeof(ObjectHeader));
 
   // If specified, we won't do reference counting on this handle
   // This means the only way to destroy the handle is via delete
@@ -267,7 +306,8 @@ void HeapManager::Allocate(BoundType* type, Handle& handleToInitialize, size_t c
   // user data portion
   HeapHandleData& data = *(HeapHandleData*)handleToInitialize.Data;
   data.Header = &header;
-  data.UniqueId = header.UniqueId;
+  data.Slot = slotIndex;
+  data.Generation = slot.Generation;
 }
 
 void HeapManager::ObjectToHandle(const byte* object, BoundType* type, Handle& handleToInitialize)
@@ -280,7 +320,8 @@ void HeapManager::ObjectToHandle(const byte* object, BoundType* type, Handle& ha
   }
 
   // First, check if this object was even allocated through us
-  if (this->LiveObjects.Contains(object) == false)
+  ObjectHeader* foundHeader = this->FindLiveHeader(object);
+  if (foundHeader == nullptr)
   {
     // Since the object that was passed in isn't managed by us, the only valid
     // way to get a handle to it is to use the pointer manager Most likely this
@@ -298,7 +339,7 @@ void HeapManager::ObjectToHandle(const byte* object, BoundType* type, Handle& ha
   }
 
   // Just behind the allocated object is the header
-  ObjectHeader& header = *(ObjectHeader*)(object - sizeof(ObjectHeader));
+  ObjectHeader& header = *foundHeader;
 
   // If specified, we won't do reference counting on this handle
   // This means the only way to destroy the handle is via delete
@@ -311,7 +352,8 @@ void HeapManager::ObjectToHandle(const byte* object, BoundType* type, Handle& ha
   // user data portion
   HeapHandleData& data = *(HeapHandleData*)handleToInitialize.Data;
   data.Header = &header;
-  data.UniqueId = header.UniqueId;
+  data.Slot = header.Slot;
+  data.Generation = this->Slots[header.Slot].Generation;
 }
 
 void HeapManager::DeleteAll(ExecutableState* state)
@@ -326,16 +368,19 @@ void HeapManager::DeleteAll(ExecutableState* state)
   // Leak detection includes the stack frame of who allocated it
   // as well as all those still referencing it
 
-  while (this->LiveObjects.Empty() == false)
+  // Deleting an object can delete others, but never allocates, so the slot
+  // table won't grow while we walk it
+  for (size_t i = 0; i < this->Slots.Size(); ++i)
   {
-    // Just get the first object and attempt to free it
-    const byte* object = this->LiveObjects.All().Front();
+    ObjectHeader* header = this->Slots[i].Header;
+    if (header == nullptr)
+      continue;
 
-    // Just behind the allocated object is the header
-    ObjectHeader& header = *(ObjectHeader*)(object - sizeof(ObjectHeader));
+    // The object is just after the header
+    const byte* object = ((byte*)header) + sizeof(ObjectHeader);
 
     // Create a temporary handle to point at the object
-    Handle handle(object, header.Type, this);
+    Handle handle(object, header->Type, this);
 
     // Send out an event letting the user know that a memory leak occurred
     MemoryLeakEvent toSend;
@@ -344,30 +389,36 @@ void HeapManager::DeleteAll(ExecutableState* state)
     EventSend(state, Events::MemoryLeak, &toSend);
 
     // Delete the object forcibly
-    // Note that this Delete should call HeapManager::Delete, which will remove
-    // this from LiveObjects!
+    // Note that this Delete should call HeapManager::Delete, which will free
+    // the slot!
     bool deleted = handle.Delete();
     ErrorIf(deleted != true,
             "Delete on the handle returned that the object was not deleted (it "
             "always should be deletable)");
   }
 
-  ErrorIf(this->LiveObjects.Empty() == false, "All objects should be cleared by this point");
+  ErrorIf(this->LiveObjectCount != 0, "All objects should be cleared by this point");
 }
 
 void HeapManager::Delete(const Handle& handle)
 {
   // Get the associated slot
   HeapHandleData& data = *(HeapHandleData*)handle.Data;
+  ObjectHeader* header = data.Header;
 
-  // The pointer to the object is just after the header
-  byte* object = ((byte*)data.Header) + sizeof(ObjectHeader);
+  // Free the slot and bump its generation so that any handles still pointing
+  // at it become null
+  HeapSlot& slot = this->Slots[header->Slot];
+  slot.Header = nullptr;
+  ++slot.Generation;
+  slot.NextFree = this->FreeSlot;
+  this->FreeSlot = header->Slot;
 
-  // Remove the object from the list of live objects
-  this->LiveObjects.Erase(object);
+  --this->LiveObjectCount;
+  --this->TypeCounts[header->Type].LiveObjects;
 
-  // Delete the data in the slot and null it out
-  Plasma::plDeallocate(data.Header);
+  // Give the memory back to its slab
+  this->DeallocateBlock(header);
 }
 
 bool HeapManager::CanDelete(const Handle& handle)
@@ -415,6 +466,122 @@ bool HeapManager::GetNativeTypeFullyConstructed(const Handle& handle)
   return (data.Header->Flags & HeapObjectFlags::NativeFullyConstructed) != 0;
 }
 
+ObjectHeader* HeapManager::FindLiveHeader(const byte* object)
+{
+  const byte* memory = object - sizeof(ObjectHeader);
+  ObjectHeader* header = nullptr;
+
+  // Binary search for the last page that starts at or before the memory
+  size_t begin = 0;
+  size_t end = this->Pages.Size();
+  while (begin < end)
+  {
+    size_t middle = begin + (end - begin) / 2;
+    if (this->Pages[middle].Memory <= memory)
+      begin = middle + 1;
+    else
+      end = middle;
+  }
+
+  if (begin != 0)
+  {
+    HeapSlabPage& page = this->Pages[begin - 1];
+    size_t offset = (size_t)(memory - page.Memory);
+
+    // The object has to be at the start of one of the page's blocks
+    if (offset < page.Size && offset % page.BlockSize == 0)
+      header = (ObjectHeader*)memory;
+  }
+
+  if (header == nullptr && this->LargeObjects.Contains(object))
+    header = (ObjectHeader*)memory;
+
+  if (header == nullptr)
+    return nullptr;
+
+  // The block could be free (or hold a different object), so it's only ours
+  // if its slot still points back at it
+  if (header->Slot >= this->Slots.Size() || this->Slots[header->Slot].Header != header)
+    return nullptr;
+
+  return header;
+}
+
+void HeapManager::GetAllocatedTypes(Array<HeapTypeCounts>& typesOut)
+{
+  typesOut.Append(this->TypeCounts.Values());
+  Sort(typesOut.All(), HeapAllocationsGreater);
+}
+
+byte* HeapManager::AllocateBlock(size_t fullSize, size_t& blockSizeOut)
+{
+  // Objects too large for a slab come straight from the general allocator
+  if (fullSize > HeapSlabMaxBlockSize)
+  {
+    blockSizeOut = fullSize;
+    return (byte*)Plasma::plAllocate(fullSize);
+  }
+
+  // Round up to the size class
+  size_t slabIndex = (fullSize - 1) / HeapSlabGranularity;
+  size_t blockSize = (slabIndex + 1) * HeapSlabGranularity;
+  blockSizeOut = blockSize;
+
+  HeapSlab& slab = this->Slabs[slabIndex];
+  if (slab.FreeBlocks == nullptr)
+    this->AllocatePage(slab, blockSize);
+
+  byte* block = slab.FreeBlocks;
+  if (block != nullptr)
+    slab.FreeBlocks = *(byte**)block;
+  return block;
+}
+
+void HeapManager::DeallocateBlock(ObjectHeader* header)
+{
+  size_t blockSize = header->BlockSize;
+  byte* block = (byte*)header;
+
+  if (blockSize > HeapSlabMaxBlockSize)
+  {
+    this->LargeObjects.Erase(block + sizeof(ObjectHeader));
+    Plasma::plDeallocate(block);
+    return;
+  }
+
+  HeapSlab& slab = this->Slabs[blockSize / HeapSlabGranularity - 1];
+  *(byte**)block = slab.FreeBlocks;
+  slab.FreeBlocks = block;
+}
+
+void HeapManager::AllocatePage(HeapSlab& slab, size_t blockSize)
+{
+  size_t blocksPerPage = HeapSlabPageSize / blockSize;
+  size_t pageSize = blocksPerPage * blockSize;
+  byte* memory = (byte*)Plasma::plAllocate(pageSize);
+  if (memory == nullptr)
+    return;
+
+  // Keep the pages sorted by address
+  size_t index = 0;
+  while (index < this->Pages.Size() && this->Pages[index].Memory < memory)
+    ++index;
+
+  HeapSlabPage page;
+  page.Memory = memory;
+  page.Size = pageSize;
+  page.BlockSize = blockSize;
+  this->Pages.InsertAt(index, page);
+
+  // Push the blocks on in reverse so we hand them out in address order
+  for (size_t i = blocksPerPage; i > 0; --i)
+  {
+    byte* block = memory + (i - 1) * blockSize;
+    *(byte**)block = slab.FreeBlocks;
+    slab.FreeBlocks = block;
+  }
+}
+
 StackManager::StackManager(ExecutableState* state) : HandleManager(state)
 {
 }
@@ -243,9 +243,15 @@ class PlasmaShared ObjectHeader
 {
 public:
   BoundType* Type;
-  Uid UniqueId;
+
+  // The index of the object's slot in the HeapManager's slot table
+  unsigned Slot;
+
   unsigned ReferenceCount;
   HeapObjectFlags::Enum Flags;
+
+  // The size of the memory block the object lives in (including this header)
+  unsigned BlockSize;
 };
 
 // The structure of our heap handle's inner data
@@ -255,12 +261,84 @@ public:
   // This is the pointer to the header of the object
   // which we implicitly allocate behind every object
   ObjectHeader* Header;
-  Uid UniqueId;
+
+  // The slot the object was given and the generation of the slot at the time
+  // (the generation changes when the object is deleted, so an old handle will
+  // no longer match even if the slot gets reused)
+  unsigned Slot;
+  unsigned Generation;
 };
 static_assert(sizeof(HeapHandleData) <= HandleUserDataSize,
               "The HeapHandleData class must fit within Handle::Data (make "
               "handle Data bigger)");
 
+// An entry in the HeapManager's slot table
+class PlasmaShared HeapSlot
+{
+public:
+  // The object in the slot, or null if the slot is free
+  ObjectHeader* Header;
+
+  // Incremented every time the object in the slot is deleted
+  unsigned Generation;
+
+  // When the slot is free, the next free slot (or HeapSlotNone)
+  unsigned NextFree;
+};
+
+// Marks the end of the free slot list
+const unsigned HeapSlotNone = (unsigned)-1;
+
+// Heap objects are carved out of pages of fixed size blocks, with one slab per
+// size class (every HeapSlabGranularity bytes up to HeapSlabMaxBlockSize).
+// Anything larger goes straight to the general allocator. Pages are kept until
+// the HeapManager is destroyed, since scripts tend to allocate the same kinds
+// of objects over and over
+const size_t HeapSlabGranularity = 64;
+const size_t HeapSlabMaxBlockSize = 4096;
+const size_t HeapSlabCount = HeapSlabMaxBlockSize / HeapSlabGranularity;
+const size_t HeapSlabPageSize = 64 * 1024;
+
+// A size class of heap objects
+class PlasmaShared HeapSlab
+{
+public:
+  // Constructor
+  HeapSlab();
+
+  // An intrusive singly linked list of free blocks (the first bytes of every
+  // free block point at the next free block)
+  byte* FreeBlocks;
+};
+
+// A page of blocks allocated for a slab
+class PlasmaShared HeapSlabPage
+{
+public:
+  byte* Memory;
+  size_t Size;
+  size_t BlockSize;
+};
+
+// How many heap objects of exactly one type (not including derived types) a
+// state has allocated. These are just for finding types that churn through a
+// lot of heap objects
+class PlasmaShared HeapTypeCounts
+{
+public:
+  // Constructor
+  HeapTypeCounts();
+
+  // The type of the objects
+  BoundType* Type;
+
+  // How many objects were allocated over the state's lifetime
+  size_t Allocations;
+
+  // How many of those objects are still alive
+  size_t LiveObjects;
+};
+
 // This setting is potentially dangerous!!!
 // Currently we add an extra amount to the end of every allocation to support
 // patching and adding fields If the value were entirely allocated by us (and
@@ -294,17 +372,52 @@ public:
   void SetNativeTypeFullyConstructed(const Handle& handle, bool value) override;
   bool GetNativeTypeFullyConstructed(const Handle& handle) override;
 
-  // A unique ID counter (so we can Assign objects unique IDs...)
-  Uid UidCount;
-
-  // When we validate a handle, we first check if the object is live (this is
-  // NOT a pointer to the header) Because a completely different object could
-  // have been allocated in the exact same place (pointer) then we also have to
-  // check the version stored in the handle against the version in the object's
-  // header If the pointer given to 'ObjectToHandle' does not exist here, we
-  // implicitly allocate a new object and invoke the copy constructor on the
-  // object
-  HashSet<const byte*> LiveObjects;
+  // Destructor (frees all the slab pages)
+  ~HeapManager();
+
+  // Gets the header of an object that we allocated and that is still alive
+  // (or null if the pointer did not come from us). If the pointer given to
+  // 'ObjectToHandle' does not come from us, we implicitly allocate a new object
+  // and invoke the copy constructor on the object
+  ObjectHeader* FindLiveHeader(const byte* object);
+
+  // Gets the counts for every type that has had heap objects allocated in this
+  // state, sorted by the number of allocations (most first)
+  void GetAllocatedTypes(Array<HeapTypeCounts>& typesOut);
+
+  // Every object we allocated, indexed by the slot stored in the handle and
+  // object header. Validating a handle is just a bounds check and comparing
+  // the generation stored in the handle against the slot's generation
+  Array<HeapSlot> Slots;
+
+  // The first free slot (or HeapSlotNone)
+  unsigned FreeSlot;
+
+  // The number of objects that are currently alive
+  size_t LiveObjectCount;
+
+  // Allocation counts for each type we allocated. These are kept per state
+  // (rather than on the type) since types like those in the core library are
+  // shared by every state, and states can run on different threads
+  HashMap<BoundType*, HeapTypeCounts> TypeCounts;
+
+private:
+  // Allocate and free the memory for an object (including its header)
+  byte* AllocateBlock(size_t fullSize, size_t& blockSizeOut);
+  void DeallocateBlock(ObjectHeader* header);
+
+  // Allocates a new page for the given slab
+  void AllocatePage(HeapSlab& slab, size_t blockSize);
+
+  // One slab per size class
+  HeapSlab Slabs[HeapSlabCount];
+
+  // Every page the slabs allocated, sorted by address so we can find the
+  // page that an arbitrary pointer lies in
+  Array<HeapSlabPage> Pages;
+
+  // Objects too large for a slab (pointers to the object, not the header)
+  HashSet<const byte*> LargeObjects;
 };
 
 // The structure of our stack handle's inner data
@@ -0,0 +1,19 @@
+// MIT Licensed (see LICENSE.md).
+
+#include "Precompiled.hpp"
+
+namespace Lightning
+{
+// Starts at one so that a cache that was never filled is always out of date
+static size_t CurrentInlineCacheGeneration = 1;
+
+size_t InlineCacheGeneration::Get()
+{
+  return CurrentInlineCacheGeneration;
+}
+
+void InlineCacheGeneration::Invalidate()
+{
+  ++CurrentInlineCacheGeneration;
+}
+} // namespace Lightning
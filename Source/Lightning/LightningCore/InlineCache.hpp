@@ -0,0 +1,103 @@
+// MIT Licensed (see LICENSE.md).
+
+#pragma once
+#ifndef LIGHTNING_INLINE_CACHE_HPP
+#  define LIGHTNING_INLINE_CACHE_HPP
+
+namespace Lightning
+{
+// Every inline cache remembers the generation it was filled in, and empties
+// itself when the generation moves on. The generation is bumped whenever types
+// can go away or change (a library is destroyed, or scripts are recompiled and
+// patched in), so a cache never hands back a member of a type that was freed
+// (and whose memory may now belong to a different type)
+class PlasmaShared InlineCacheGeneration
+{
+public:
+  // Gets the current generation
+  static size_t Get();
+
+  // Invalidates every inline cache
+  static void Invalidate();
+};
+
+// Remembers the result of looking up a member by name (FindFunction,
+// FindProperty, GetProperty...) for the last few types seen at one call site.
+// A name lookup hashes the name and walks the base classes every time, which
+// adds up when the same call happens every frame or inside a script loop. A
+// failed lookup (null) is cached too, since call sites that check for optional
+// functions (like 'DebugDraw') mostly fail. Like the rest of the type system,
+// caches are not thread safe and should only be used by the thread running
+// script.
+template <typename MemberType, size_t Ways = 4>
+class InlineCache
+{
+public:
+  // Constructor
+  InlineCache() : Generation(0), Count(0), Next(0)
+  {
+  }
+
+  // Finds the member we cached for a type, and returns false if we haven't
+  // seen the type (the member may be null if the last lookup failed)
+  bool Find(const BoundType* type, MemberType*& memberOut)
+  {
+    if (this->Generation != InlineCacheGeneration::Get())
+    {
+      this->Clear();
+      return false;
+    }
+
+    for (size_t i = 0; i < this->Count; ++i)
+    {
+      if (this->Types[i] == type)
+      {
+        memberOut = this->Members[i];
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Caches the member that a lookup returned for a type (once we've seen more
+  // types than we have room for, the oldest entry is replaced)
+  void Insert(const BoundType* type, MemberType* member)
+  {
+    size_t generation = InlineCacheGeneration::Get();
+    if (this->Generation != generation)
+    {
+      this->Clear();
+      this->Generation = generation;
+    }
+
+    size_t index = this->Next;
+    this->Types[index] = type;
+    this->Members[index] = member;
+    this->Next = (index + 1) % Ways;
+
+    if (this->Count < Ways)
+      ++this->Count;
+  }
+
+  // Forgets every cached type
+  void Clear()
+  {
+    this->Count = 0;
+    this->Next = 0;
+  }
+
+private:
+  // The generation the entries were cached in
+  size_t Generation;
+
+  // How many entries are in use, and which entry gets replaced next
+  size_t Count;
+  size_t Next;
+
+  // The types we've seen and the member we found on each
+  const BoundType* Types[Ways];
+  MemberType* Members[Ways];
+};
+} // namespace Lightning
+
+#endif
@@ -43,6 +43,16 @@
               LightningEnumValue(AssignmentBitwiseOr##Type) LightningEnumValue(AssignmentBitwiseXor##Type)                     \
                   LightningEnumValue(AssignmentBitwiseAnd##Type)
 
+// Comparisons fused with the conditional jump that reads their result (only
+// generated by the OpcodeOptimizer)
+#define LightningCompareJumpInstructions(Type)                                                                             \
+  LightningEnumValue(IfFalseTestLessThan##Type) LightningEnumValue(IfTrueTestLessThan##Type)                                    \
+      LightningEnumValue(IfFalseTestLessThanOrEqualTo##Type) LightningEnumValue(IfTrueTestLessThanOrEqualTo##Type)             \
+          LightningEnumValue(IfFalseTestGreaterThan##Type) LightningEnumValue(IfTrueTestGreaterThan##Type)                     \
+              LightningEnumValue(IfFalseTestGreaterThanOrEqualTo##Type) LightningEnumValue(IfTrueTestGreaterThanOrEqualTo##Type) \
+                  LightningEnumValue(IfFalseTestInequality##Type) LightningEnumValue(IfTrueTestInequality##Type)               \
+                      LightningEnumValue(IfFalseTestEquality##Type) LightningEnumValue(IfTrueTestEquality##Type)
+
 // Core instructions
 LightningEnumValue(InvalidInstruction)
 
@@ -135,3 +145,6 @@ LightningEnumValue(InvalidInstruction)
                                                                                                                 AnyDynamicMemberGet)
                                                                                                                 LightningEnumValue(
                                                                                                                     AnyDynamicMemberSet)
+
+    // Fused comparison and jump instructions
+    LightningCompareJumpInstructions(Integer) LightningCompareJumpInstructions(Real)
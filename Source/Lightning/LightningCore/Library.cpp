@@ -1401,6 +1401,9 @@ LibraryRef LibraryBuilder::CreateLibrary()
   // generated
   this->GenerateGetSetFields();
 
+  // Reused for every function so its buffers only get allocated once
+  OpcodeOptimizer optimizer;
+
   // We need to create all the bound functions
   for (size_t i = 0; i < library->OwnedFunctions.Size(); ++i)
   {
@@ -1414,10 +1417,17 @@ LibraryRef LibraryBuilder::CreateLibrary()
     function->CompactedOpcode.Resize(function->OpcodeBuilder.RelativeSize());
     function->OpcodeBuilder.RelativeCompact(function->CompactedOpcode.Data());
 
+#if LightningOptimizeOpcode
+    // Remove redundant copies and fuse common instruction pairs
+    optimizer.Optimize(function);
+#endif
+
     // Add the function to the library so it can be looked up
     function->SourceLibrary = library.Object;
   }
 
+  library->OptimizerStats = optimizer.Stats;
+
   // Create a range to iterate through all the named types
   BoundTypeValueRange boundTypes = this->BoundTypes.Values();
 
@@ -1620,6 +1630,9 @@ Library::~Library()
   if (ExecutableState::CallingState != nullptr)
     ExecutableState::CallingState->ClearStaticFieldsFromLibrary(this);
 
+  // Our types are about to be deleted, so nothing may keep looking them up
+  InlineCacheGeneration::Invalidate();
+
   // First, release all components
   this->ClearComponents();
 
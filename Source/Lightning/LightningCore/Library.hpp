@@ -156,6 +156,10 @@ public:
   // If we loaded a plugin that created this library (otherwise null)
   Plugin* Plugin;
 
+  // What the OpcodeOptimizer did to this library's functions (used to measure
+  // how much opcode the optimizer removes)
+  OpcodeOptimizerStats OptimizerStats;
+
 private:
   // Constructor
   Library();
@@ -4,4 +4,11 @@
 #ifndef LIGHTNING_LOCAL_BUILD_HPP
 #  define LIGHTNING_LOCAL_BUILD_HPP
 
+// Whether compiled functions are run through the OpcodeOptimizer. Define this
+// as 0 to execute opcode exactly as the CodeGenerator emitted it (useful when
+// debugging code generation or comparing the two).
+#  ifndef LightningOptimizeOpcode
+#    define LightningOptimizeOpcode 1
+#  endif
+
 #endif
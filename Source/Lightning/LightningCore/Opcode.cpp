@@ -469,6 +469,19 @@ void GenerateDebugInstructionInfo(Array<DebugInstruction>& debugOut)
     LightningOperand(info.WriteOperands, ConversionOpcode, Output, toPrimitive, true);
   }
 
+  // [CompareRelativeGoToOpcode]
+  {
+    for (size_t i = Instruction::IfFalseTestLessThanInteger; i <= Instruction::IfTrueTestEqualityReal; ++i)
+    {
+      DebugPrimitive::Enum primitive =
+          (i < Instruction::IfFalseTestLessThanReal) ? DebugPrimitive::Integer : DebugPrimitive::Real;
+      DebugInstruction& info = debugOut[i];
+      LightningOperand(info.ReadOperands, CompareRelativeGoToOpcode, Left, primitive, false);
+      LightningOperand(info.ReadOperands, CompareRelativeGoToOpcode, Right, primitive, false);
+      info.OpcodeOffsets.PushBack(PlasmaOffsetOf(CompareRelativeGoToOpcode, JumpOffset));
+    }
+  }
+
   // [CopyOpcode]
   {
     Instruction::Enum instructions[] = {Instruction::CopyInteger,
@@ -201,6 +201,15 @@ public:
   ByteCodeOffset JumpOffset;
 };
 
+// Opcode for a comparison fused with the if-instruction that reads its result
+class PlasmaShared CompareRelativeGoToOpcode : public Opcode
+{
+public:
+  Operand Left;
+  Operand Right;
+  ByteCodeOffset JumpOffset;
+};
+
 // Opcode for the prep for function call instruction
 class PlasmaShared PrepForFunctionCallOpcode : public Opcode
 {
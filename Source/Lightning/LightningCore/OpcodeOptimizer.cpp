@@ -0,0 +1,1454 @@
+// MIT Licensed (see LICENSE.md).
+
+#include "Precompiled.hpp"
+
+namespace Lightning
+{
+// Used when a local is referenced by an 'OperandLocal' rather than an 'Operand'
+static const size_t cNotAnOperand = (size_t)-1;
+
+// Which opcode class an instruction uses
+namespace OpcodeLayout
+{
+enum Enum
+{
+  Unknown,
+  ArgumentFree,
+  Timeout,
+  ToHandle,
+  CreateStaticDelegate,
+  CreateInstanceDelegate,
+  If,
+  RelativeJump,
+  PrepForFunctionCall,
+  CreateType,
+  CreateLocalType,
+  CreatePropertyDelegate,
+  BeginStringBuilder,
+  EndStringBuilder,
+  AddToStringBuilder,
+  DeleteObject,
+  ThrowException,
+  TypeId,
+  BinaryRValue,
+  BinaryLValue,
+  UnaryRValue,
+  UnaryLValue,
+  Conversion,
+  AnyConversion,
+  DowncastConversion,
+  Copy,
+  CompareRelativeGoTo
+};
+}
+
+// Everything the optimizer needs to know about an instruction
+class InstructionInfo
+{
+public:
+  // Constructor
+  InstructionInfo() :
+      Layout(OpcodeLayout::Unknown),
+      Pure(false),
+      MayThrow(false),
+      InputSize(0),
+      RightSize(0),
+      OutputSize(0),
+      IfFalse(Instruction::InvalidInstruction),
+      IfTrue(Instruction::InvalidInstruction)
+  {
+  }
+
+  // The opcode class the instruction uses
+  OpcodeLayout::Enum Layout;
+
+  // A pure instruction does nothing but read its inputs and write its output,
+  // so it can be removed or have its output moved somewhere else
+  bool Pure;
+
+  // Whether the instruction can throw even when all of its operands are locals
+  // (such as a divide by zero)
+  bool MayThrow;
+
+  // The size of the left (or single) operand, the right operand, and the
+  // output (zero when the size is stored on the opcode itself)
+  size_t InputSize;
+  size_t RightSize;
+  size_t OutputSize;
+
+  // For comparisons, the instructions that fuse the comparison with an if
+  Instruction::Enum IfFalse;
+  Instruction::Enum IfTrue;
+};
+
+// A table of info for every instruction
+class InstructionInfoTable
+{
+public:
+  // Constructor
+  InstructionInfoTable();
+
+  // Sets the info for a single instruction
+  void Set(Instruction::Enum instruction,
+           OpcodeLayout::Enum layout,
+           bool pure,
+           bool mayThrow = false,
+           size_t inputSize = 0,
+           size_t rightSize = 0,
+           size_t outputSize = 0);
+
+  // The info indexed by instruction
+  InstructionInfo Infos[Instruction::Count];
+};
+
+void InstructionInfoTable::Set(Instruction::Enum instruction,
+                               OpcodeLayout::Enum layout,
+                               bool pure,
+                               bool mayThrow,
+                               size_t inputSize,
+                               size_t rightSize,
+                               size_t outputSize)
+{
+  InstructionInfo& info = this->Infos[instruction];
+  info.Layout = layout;
+  info.Pure = pure;
+  info.MayThrow = mayThrow;
+  info.InputSize = inputSize;
+  info.RightSize = rightSize;
+  info.OutputSize = outputSize;
+}
+
+// Note: These macros mirror those inside of InstructionEnum and VirtualMachine
+// (so every generated instruction gets its info)
+
+#define LightningCopyInfo(Type)                                                                                        \
+  Set(Instruction::Copy##Type, OpcodeLayout::Copy, true, false, sizeof(Type), sizeof(Type), sizeof(Type));
+
+#define LightningBinaryInfo(Type, RightType, ResultType, Name, MayThrow)                                               \
+  Set(Instruction::Name##Type,                                                                                         \
+      OpcodeLayout::BinaryRValue,                                                                                      \
+      true,                                                                                                            \
+      MayThrow,                                                                                                        \
+      sizeof(Type),                                                                                                    \
+      sizeof(RightType),                                                                                               \
+      sizeof(ResultType));
+
+#define LightningAssignmentInfo(Type, RightType, Name, MayThrow)                                                       \
+  Set(Instruction::Name##Type, OpcodeLayout::BinaryLValue, false, MayThrow, sizeof(Type), sizeof(RightType));
+
+#define LightningUnaryInfo(Type, Name)                                                                                 \
+  Set(Instruction::Name##Type, OpcodeLayout::UnaryRValue, true, false, sizeof(Type), 0, sizeof(Type));
+
+#define LightningIncrementInfo(Type, Name)                                                                             \
+  Set(Instruction::Name##Type, OpcodeLayout::UnaryLValue, false, false, sizeof(Type));
+
+#define LightningEqualityInfo(Type, ResultType)                                                                        \
+  LightningBinaryInfo(Type, Type, ResultType, TestInequality, false)                                                   \
+      LightningBinaryInfo(Type, Type, ResultType, TestEquality, false)
+
+#define LightningComparisonInfo(Type, ResultType)                                                                      \
+  LightningBinaryInfo(Type, Type, ResultType, TestLessThan, false)                                                     \
+      LightningBinaryInfo(Type, Type, ResultType, TestLessThanOrEqualTo, false)                                        \
+          LightningBinaryInfo(Type, Type, ResultType, TestGreaterThan, false)                                          \
+              LightningBinaryInfo(Type, Type, ResultType, TestGreaterThanOrEqualTo, false)
+
+#define LightningNumericInfo(Type)                                                                                     \
+  LightningCopyInfo(Type) LightningEqualityInfo(Type, Boolean) LightningUnaryInfo(Type, Negate)                        \
+      LightningIncrementInfo(Type, Increment) LightningIncrementInfo(Type, Decrement)                                  \
+          LightningBinaryInfo(Type, Type, Type, Add, false) LightningBinaryInfo(Type, Type, Type, Subtract, false)     \
+              LightningBinaryInfo(Type, Type, Type, Multiply, false)                                                   \
+                  LightningBinaryInfo(Type, Type, Type, Divide, true)                                                  \
+                      LightningBinaryInfo(Type, Type, Type, Modulo, true)                                              \
+                          LightningBinaryInfo(Type, Type, Type, Pow, false)                                            \
+                              LightningAssignmentInfo(Type, Type, AssignmentAdd, false)                                \
+                                  LightningAssignmentInfo(Type, Type, AssignmentSubtract, false)                       \
+                                      LightningAssignmentInfo(Type, Type, AssignmentMultiply, false)                   \
+                                          LightningAssignmentInfo(Type, Type, AssignmentDivide, true)                  \
+                                              LightningAssignmentInfo(Type, Type, AssignmentModulo, true)              \
+                                                  LightningAssignmentInfo(Type, Type, AssignmentPow, false)
+
+#define LightningScalarInfo(Type) LightningNumericInfo(Type) LightningComparisonInfo(Type, Boolean)
+
+#define LightningVectorInfo(VectorType, ScalarType, ComparisonType)                                                    \
+  LightningNumericInfo(VectorType) LightningComparisonInfo(VectorType, ComparisonType)                                 \
+      LightningBinaryInfo(VectorType, ScalarType, VectorType, ScalarMultiply, false)                                   \
+          LightningBinaryInfo(VectorType, ScalarType, VectorType, ScalarDivide, true)                                  \
+              LightningBinaryInfo(VectorType, ScalarType, VectorType, ScalarModulo, true)                              \
+                  LightningBinaryInfo(VectorType, ScalarType, VectorType, ScalarPow, false)                            \
+                      LightningAssignmentInfo(VectorType, ScalarType, AssignmentScalarMultiply, false)                 \
+                          LightningAssignmentInfo(VectorType, ScalarType, AssignmentScalarDivide, true)                \
+                              LightningAssignmentInfo(VectorType, ScalarType, AssignmentScalarModulo, true)            \
+                                  LightningAssignmentInfo(VectorType, ScalarType, AssignmentScalarPow, false)
+
+#define LightningIntegralInfo(Type)                                                                                    \
+  LightningUnaryInfo(Type, BitwiseNot) LightningBinaryInfo(Type, Type, Type, BitshiftLeft, false)                      \
+      LightningBinaryInfo(Type, Type, Type, BitshiftRight, false)                                                      \
+          LightningBinaryInfo(Type, Type, Type, BitwiseOr, false)                                                      \
+              LightningBinaryInfo(Type, Type, Type, BitwiseXor, false)                                                 \
+                  LightningBinaryInfo(Type, Type, Type, BitwiseAnd, false)                                             \
+                      LightningAssignmentInfo(Type, Type, AssignmentBitshiftLeft, false)                               \
+                          LightningAssignmentInfo(Type, Type, AssignmentBitshiftRight, false)                          \
+                              LightningAssignmentInfo(Type, Type, AssignmentBitwiseOr, false)                          \
+                                  LightningAssignmentInfo(Type, Type, AssignmentBitwiseXor, false)                     \
+                                      LightningAssignmentInfo(Type, Type, AssignmentBitwiseAnd, false)
+
+#define LightningConversionInfo(FromType, ToType)                                                                      \
+  Set(Instruction::Convert##FromType##To##ToType,                                                                      \
+      OpcodeLayout::Conversion,                                                                                        \
+      true,                                                                                                            \
+      false,                                                                                                           \
+      sizeof(FromType),                                                                                                \
+      0,                                                                                                               \
+      sizeof(ToType));
+
+#define LightningCompareJumpInfo(Type, Name)                                                                           \
+  Set(Instruction::IfFalse##Name##Type, OpcodeLayout::CompareRelativeGoTo, false, false, sizeof(Type), sizeof(Type));  \
+  Set(Instruction::IfTrue##Name##Type, OpcodeLayout::CompareRelativeGoTo, false, false, sizeof(Type), sizeof(Type));   \
+  this->Infos[Instruction::Name##Type].IfFalse = Instruction::IfFalse##Name##Type;                                     \
+  this->Infos[Instruction::Name##Type].IfTrue = Instruction::IfTrue##Name##Type;
+
+#define LightningCompareJumpInfos(Type)                                                                                \
+  LightningCompareJumpInfo(Type, TestLessThan) LightningCompareJumpInfo(Type, TestLessThanOrEqualTo)                   \
+      LightningCompareJumpInfo(Type, TestGreaterThan) LightningCompareJumpInfo(Type, TestGreaterThanOrEqualTo)         \
+          LightningCompareJumpInfo(Type, TestInequality) LightningCompareJumpInfo(Type, TestEquality)
+
+InstructionInfoTable::InstructionInfoTable()
+{
+  // Core instructions (anything not listed, such as the dynamic 'Any' members,
+  // stays unknown and makes us leave the function alone)
+  Set(Instruction::InternalDebugBreakpoint, OpcodeLayout::ArgumentFree, false);
+  Set(Instruction::ThrowException, OpcodeLayout::ThrowException, false);
+  Set(Instruction::PropertyDelegate, OpcodeLayout::CreatePropertyDelegate, false);
+  Set(Instruction::TypeId, OpcodeLayout::TypeId, false);
+  Set(Instruction::BeginTimeout, OpcodeLayout::Timeout, false);
+  Set(Instruction::EndTimeout, OpcodeLayout::ArgumentFree, false);
+  Set(Instruction::BeginScope, OpcodeLayout::ArgumentFree, false);
+  Set(Instruction::EndScope, OpcodeLayout::ArgumentFree, false);
+  Set(Instruction::ToHandle, OpcodeLayout::ToHandle, false);
+  Set(Instruction::BeginStringBuilder, OpcodeLayout::BeginStringBuilder, false);
+  Set(Instruction::EndStringBuilder, OpcodeLayout::EndStringBuilder, false);
+  Set(Instruction::AddToStringBuilder, OpcodeLayout::AddToStringBuilder, false);
+  Set(Instruction::CreateInstanceDelegate, OpcodeLayout::CreateInstanceDelegate, false);
+  Set(Instruction::CreateStaticDelegate, OpcodeLayout::CreateStaticDelegate, false);
+  Set(Instruction::IfFalseRelativeGoTo, OpcodeLayout::If, false);
+  Set(Instruction::IfTrueRelativeGoTo, OpcodeLayout::If, false);
+  Set(Instruction::RelativeGoTo, OpcodeLayout::RelativeJump, false);
+  Set(Instruction::Return, OpcodeLayout::ArgumentFree, false);
+  Set(Instruction::PrepForFunctionCall, OpcodeLayout::PrepForFunctionCall, false);
+  Set(Instruction::FunctionCall, OpcodeLayout::ArgumentFree, false);
+  Set(Instruction::NewObject, OpcodeLayout::CreateType, false);
+  Set(Instruction::LocalObject, OpcodeLayout::CreateLocalType, false);
+  Set(Instruction::DeleteObject, OpcodeLayout::DeleteObject, false);
+
+  // Primitive type instructions
+  LightningIntegralInfo(Byte);
+  LightningScalarInfo(Byte);
+  LightningIntegralInfo(Integer);
+  LightningScalarInfo(Integer);
+  LightningVectorInfo(Integer2, Integer, Boolean2);
+  LightningVectorInfo(Integer3, Integer, Boolean3);
+  LightningVectorInfo(Integer4, Integer, Boolean4);
+  LightningIntegralInfo(Integer2);
+  LightningIntegralInfo(Integer3);
+  LightningIntegralInfo(Integer4);
+  LightningScalarInfo(Real);
+  LightningVectorInfo(Real2, Real, Boolean2);
+  LightningVectorInfo(Real3, Real, Boolean3);
+  LightningVectorInfo(Real4, Real, Boolean4);
+  LightningScalarInfo(DoubleReal);
+  LightningIntegralInfo(DoubleInteger);
+  LightningScalarInfo(DoubleInteger);
+  LightningEqualityInfo(Boolean, Boolean);
+  LightningCopyInfo(Boolean);
+  LightningUnaryInfo(Boolean, LogicalNot);
+
+  // Handles, delegates, and anys are reference counted (and comparing anys can
+  // run user code) so none of their instructions are pure
+  size_t handle = sizeof(Handle);
+  size_t delegate = sizeof(Delegate);
+  size_t any = sizeof(Any);
+  size_t boolean = sizeof(Boolean);
+  Set(Instruction::TestInequalityHandle, OpcodeLayout::BinaryRValue, false, false, handle, handle, boolean);
+  Set(Instruction::TestEqualityHandle, OpcodeLayout::BinaryRValue, false, false, handle, handle, boolean);
+  Set(Instruction::TestInequalityDelegate, OpcodeLayout::BinaryRValue, false, false, delegate, delegate, boolean);
+  Set(Instruction::TestEqualityDelegate, OpcodeLayout::BinaryRValue, false, false, delegate, delegate, boolean);
+  Set(Instruction::TestInequalityAny, OpcodeLayout::BinaryRValue, false, false, any, any, boolean);
+  Set(Instruction::TestEqualityAny, OpcodeLayout::BinaryRValue, false, false, any, any, boolean);
+  Set(Instruction::CopyHandle, OpcodeLayout::Copy, false, false, handle, handle, handle);
+  Set(Instruction::CopyDelegate, OpcodeLayout::Copy, false, false, delegate, delegate, delegate);
+  Set(Instruction::CopyAny, OpcodeLayout::Copy, false, false, any, any, any);
+
+  // Values are just memory (their size is stored on the opcode)
+  Set(Instruction::TestInequalityValue, OpcodeLayout::BinaryRValue, true, false, 0, 0, boolean);
+  Set(Instruction::TestEqualityValue, OpcodeLayout::BinaryRValue, true, false, 0, 0, boolean);
+  Set(Instruction::CopyValue, OpcodeLayout::Copy, true);
+
+  LightningConversionInfo(Byte, Real);
+  LightningConversionInfo(Byte, Boolean);
+  LightningConversionInfo(Byte, Integer);
+  LightningConversionInfo(Byte, DoubleInteger);
+  LightningConversionInfo(Byte, DoubleReal);
+  LightningConversionInfo(Integer, Real);
+  LightningConversionInfo(Integer, Boolean);
+  LightningConversionInfo(Integer, Byte);
+  LightningConversionInfo(Integer, DoubleInteger);
+  LightningConversionInfo(Integer, DoubleReal);
+  LightningConversionInfo(Real, Integer);
+  LightningConversionInfo(Real, Boolean);
+  LightningConversionInfo(Real, Byte);
+  LightningConversionInfo(Real, DoubleInteger);
+  LightningConversionInfo(Real, DoubleReal);
+  LightningConversionInfo(Boolean, Integer);
+  LightningConversionInfo(Boolean, Real);
+  LightningConversionInfo(Boolean, Byte);
+  LightningConversionInfo(Boolean, DoubleInteger);
+  LightningConversionInfo(Boolean, DoubleReal);
+  LightningConversionInfo(DoubleInteger, Real);
+  LightningConversionInfo(DoubleInteger, Boolean);
+  LightningConversionInfo(DoubleInteger, Byte);
+  LightningConversionInfo(DoubleInteger, Integer);
+  LightningConversionInfo(DoubleInteger, DoubleReal);
+  LightningConversionInfo(DoubleReal, Real);
+  LightningConversionInfo(DoubleReal, Boolean);
+  LightningConversionInfo(DoubleReal, Byte);
+  LightningConversionInfo(DoubleReal, Integer);
+  LightningConversionInfo(DoubleReal, DoubleInteger);
+
+  LightningConversionInfo(Integer2, Real2);
+  LightningConversionInfo(Integer2, Boolean2);
+  LightningConversionInfo(Real2, Integer2);
+  LightningConversionInfo(Real2, Boolean2);
+  LightningConversionInfo(Boolean2, Integer2);
+  LightningConversionInfo(Boolean2, Real2);
+
+  LightningConversionInfo(Integer3, Real3);
+  LightningConversionInfo(Integer3, Boolean3);
+  LightningConversionInfo(Real3, Integer3);
+  LightningConversionInfo(Real3, Boolean3);
+  LightningConversionInfo(Boolean3, Integer3);
+  LightningConversionInfo(Boolean3, Real3);
+
+  LightningConversionInfo(Integer4, Real4);
+  LightningConversionInfo(Integer4, Boolean4);
+  LightningConversionInfo(Real4, Integer4);
+  LightningConversionInfo(Real4, Boolean4);
+  LightningConversionInfo(Boolean4, Integer4);
+  LightningConversionInfo(Boolean4, Real4);
+
+  // Conversions that allocate or check types
+  Set(Instruction::ConvertStringToStringRangeExtended, OpcodeLayout::Conversion, false, false, handle, 0, handle);
+  Set(Instruction::ConvertDowncast, OpcodeLayout::DowncastConversion, false, false, handle, 0, handle);
+  Set(Instruction::ConvertToAny, OpcodeLayout::AnyConversion, false);
+  Set(Instruction::ConvertFromAny, OpcodeLayout::AnyConversion, false);
+
+  // Fused comparison and jump instructions
+  LightningCompareJumpInfos(Integer);
+  LightningCompareJumpInfos(Real);
+}
+
+#undef LightningCopyInfo
+#undef LightningBinaryInfo
+#undef LightningAssignmentInfo
+#undef LightningUnaryInfo
+#undef LightningIncrementInfo
+#undef LightningEqualityInfo
+#undef LightningComparisonInfo
+#undef LightningNumericInfo
+#undef LightningScalarInfo
+#undef LightningVectorInfo
+#undef LightningIntegralInfo
+#undef LightningConversionInfo
+#undef LightningCompareJumpInfo
+#undef LightningCompareJumpInfos
+
+// Get the info for an instruction (the table is built the first time)
+static const InstructionInfo& GetInstructionInfo(Instruction::Enum instruction)
+{
+  static InstructionInfoTable table;
+  return table.Infos[instruction];
+}
+
+// Get the size of the opcode for a layout (or zero if we don't know it)
+static size_t GetOpcodeSize(OpcodeLayout::Enum layout)
+{
+  switch (layout)
+  {
+  case OpcodeLayout::ArgumentFree:
+    return sizeof(Opcode);
+  case OpcodeLayout::Timeout:
+    return sizeof(TimeoutOpcode);
+  case OpcodeLayout::ToHandle:
+    return sizeof(ToHandleOpcode);
+  case OpcodeLayout::CreateStaticDelegate:
+    return sizeof(CreateStaticDelegateOpcode);
+  case OpcodeLayout::CreateInstanceDelegate:
+    return sizeof(CreateInstanceDelegateOpcode);
+  case OpcodeLayout::If:
+    return sizeof(IfOpcode);
+  case OpcodeLayout::RelativeJump:
+    return sizeof(RelativeJumpOpcode);
+  case OpcodeLayout::PrepForFunctionCall:
+    return sizeof(PrepForFunctionCallOpcode);
+  case OpcodeLayout::CreateType:
+    return sizeof(CreateTypeOpcode);
+  case OpcodeLayout::CreateLocalType:
+    return sizeof(CreateLocalTypeOpcode);
+  case OpcodeLayout::CreatePropertyDelegate:
+    return sizeof(CreatePropertyDelegateOpcode);
+  case OpcodeLayout::BeginStringBuilder:
+    return sizeof(BeginStringBuilderOpcode);
+  case OpcodeLayout::EndStringBuilder:
+    return sizeof(EndStringBuilderOpcode);
+  case OpcodeLayout::AddToStringBuilder:
+    return sizeof(AddToStringBuilderOpcode);
+  case OpcodeLayout::DeleteObject:
+    return sizeof(DeleteObjectOpcode);
+  case OpcodeLayout::ThrowException:
+    return sizeof(ThrowExceptionOpcode);
+  case OpcodeLayout::TypeId:
+    return sizeof(TypeIdOpcode);
+  case OpcodeLayout::BinaryRValue:
+    return sizeof(BinaryRValueOpcode);
+  case OpcodeLayout::BinaryLValue:
+    return sizeof(BinaryLValueOpcode);
+  case OpcodeLayout::UnaryRValue:
+    return sizeof(UnaryRValueOpcode);
+  case OpcodeLayout::UnaryLValue:
+    return sizeof(UnaryLValueOpcode);
+  case OpcodeLayout::Conversion:
+    return sizeof(ConversionOpcode);
+  case OpcodeLayout::AnyConversion:
+    return sizeof(AnyConversionOpcode);
+  case OpcodeLayout::DowncastConversion:
+    return sizeof(DowncastConversionOpcode);
+  case OpcodeLayout::Copy:
+    return sizeof(CopyOpcode);
+  case OpcodeLayout::CompareRelativeGoTo:
+    return sizeof(CompareRelativeGoToOpcode);
+  default:
+    return 0;
+  }
+}
+
+// Get a pointer to the relative jump offset inside of a jump instruction's
+// opcode (or null if the instruction doesn't jump)
+static ByteCodeOffset* GetJumpOffset(byte* opcode, OpcodeLayout::Enum layout)
+{
+  switch (layout)
+  {
+  case OpcodeLayout::If:
+    return &((IfOpcode*)opcode)->JumpOffset;
+  case OpcodeLayout::RelativeJump:
+    return &((RelativeJumpOpcode*)opcode)->JumpOffset;
+  case OpcodeLayout::PrepForFunctionCall:
+    return &((PrepForFunctionCallOpcode*)opcode)->JumpOffsetIfStatic;
+  case OpcodeLayout::CompareRelativeGoTo:
+    return &((CompareRelativeGoToOpcode*)opcode)->JumpOffset;
+  default:
+    return nullptr;
+  }
+}
+
+// Whether two ranges of locals share any memory
+static bool Overlaps(OperandIndex localA, size_t sizeA, OperandIndex localB, size_t sizeB)
+{
+  return localA < (OperandIndex)(localB + sizeB) && localB < (OperandIndex)(localA + sizeA);
+}
+
+// Reading through a handle or a static can throw (or initialize the static), so
+// an instruction that does can never be removed
+static bool ReadsOnlyLocalsOrConstants(const Operand& operand)
+{
+  return operand.Type == OperandType::Local || operand.Type == OperandType::Constant;
+}
+
+// Read a constant out of a function's constant buffer
+template <typename T>
+static T ReadConstant(Function* function, const Operand& operand)
+{
+  return *(T*)function->Constants.GetElement(operand.HandleConstantLocal);
+}
+
+// Add a constant to a function's constant buffer and return its index
+template <typename T>
+static OperandIndex AddConstant(Function* function, const T& value)
+{
+  OperandIndex index;
+  function->AllocateConstant<T>(sizeof(T), index) = value;
+  return index;
+}
+
+OpcodeOptimizerStats::OpcodeOptimizerStats() :
+    InstructionsBefore(0),
+    InstructionsAfter(0),
+    ConstantsFolded(0),
+    CopiesRemoved(0),
+    BranchesFused(0),
+    DeadInstructionsRemoved(0)
+{
+}
+
+void OpcodeOptimizerStats::Add(const OpcodeOptimizerStats& other)
+{
+  this->InstructionsBefore += other.InstructionsBefore;
+  this->InstructionsAfter += other.InstructionsAfter;
+  this->ConstantsFolded += other.ConstantsFolded;
+  this->CopiesRemoved += other.CopiesRemoved;
+  this->BranchesFused += other.BranchesFused;
+  this->DeadInstructionsRemoved += other.DeadInstructionsRemoved;
+}
+
+void OpcodeOptimizer::Optimize(Function* function)
+{
+  // Native functions (and empty functions) have nothing to optimize
+  if (function->CompactedOpcode.Empty() || function->FunctionType == nullptr)
+    return;
+
+  this->Instructions.Clear();
+  this->Data.Clear();
+  this->References.Clear();
+  this->Variables.Clear();
+  this->AddressTaken.Clear();
+  this->FunctionStats = OpcodeOptimizerStats();
+
+  // If we don't understand every instruction then we can't safely move
+  // anything around
+  if (this->Decode(function) == false)
+    return;
+
+  this->GatherLocalRanges(function);
+
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+    this->GatherReferences(i);
+
+  // Walk forward through the instructions, each optimization only ever looks
+  // at an instruction and the one that runs right after it
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    if (this->Instructions[i].Removed)
+      continue;
+
+    // A folded instruction becomes a copy from a constant, which can then be
+    // propagated into whoever reads it
+    this->FoldConstants(function, i);
+
+    if (this->PropagateConstant(i))
+      continue;
+
+    if (this->FuseCompareJump(i))
+      continue;
+
+    // Forwarding can chain (a result copied through several temporaries)
+    while (this->ForwardCopy(i))
+    {
+    }
+  }
+
+  this->RemoveDeadInstructions();
+  this->Encode(function);
+
+  this->FunctionStats.InstructionsBefore = this->Instructions.Size();
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    if (this->Instructions[i].Removed == false)
+      ++this->FunctionStats.InstructionsAfter;
+  }
+  this->Stats.Add(this->FunctionStats);
+}
+
+void OpcodeOptimizer::Replace(OptimizerInstruction& instruction, const Opcode& opcode, size_t size)
+{
+  size_t dataOffset = this->Data.Size();
+  this->Data.Resize(dataOffset + size);
+  memcpy(this->Data.Data() + dataOffset, &opcode, size);
+
+  instruction.Instruction = (Instruction::Enum)opcode.Instruction;
+  instruction.DataOffset = dataOffset;
+  instruction.Size = size;
+}
+
+void OpcodeOptimizer::ReplaceWithConstantCopy(
+    size_t index, OperandIndex constant, OperandLocal output, size_t size, Instruction::Enum copyInstruction)
+{
+  OptimizerInstruction& instruction = this->Instructions[index];
+
+  CopyOpcode copy;
+#ifdef PlasmaDebug
+  copy.DebugOrigin = this->Get<Opcode>(instruction).DebugOrigin;
+#endif
+  copy.Instruction = copyInstruction;
+  copy.Source = Operand(constant, 0, OperandType::Constant);
+  copy.Destination = Operand(output);
+  copy.Size = size;
+  copy.Mode = CopyMode::Initialize;
+
+  this->Replace(instruction, copy, sizeof(copy));
+  this->GatherReferences(index);
+}
+
+bool OpcodeOptimizer::Decode(Function* function)
+{
+  byte* opcode = function->CompactedOpcode.Data();
+  size_t opcodeSize = function->CompactedOpcode.Size();
+
+  this->Data.Resize(opcodeSize);
+  memcpy(this->Data.Data(), opcode, opcodeSize);
+
+  size_t offset = 0;
+  while (offset < opcodeSize)
+  {
+    if (offset + sizeof(Opcode) > opcodeSize)
+      return false;
+
+    int instructionValue = ((Opcode*)(opcode + offset))->Instruction;
+    if (instructionValue <= Instruction::InvalidInstruction || instructionValue >= Instruction::Count)
+      return false;
+
+    Instruction::Enum instruction = (Instruction::Enum)instructionValue;
+    OpcodeLayout::Enum layout = GetInstructionInfo(instruction).Layout;
+    size_t size = GetOpcodeSize(layout);
+    if (size == 0 || offset + size > opcodeSize)
+      return false;
+
+    OptimizerInstruction& decoded = this->Instructions.PushBack();
+    decoded.Instruction = instruction;
+    decoded.OldOffset = offset;
+    decoded.NewOffset = 0;
+    decoded.DataOffset = offset;
+    decoded.Size = size;
+    decoded.JumpTarget = 0;
+    decoded.ReferencesStart = 0;
+    decoded.ReferencesCount = 0;
+    decoded.IsJump = false;
+    decoded.IsJumpTarget = false;
+    decoded.Removed = false;
+
+    // Jumps are relative to the start of the jump instruction
+    if (ByteCodeOffset* jumpOffset = GetJumpOffset(opcode + offset, layout))
+    {
+      long long target = (long long)offset + *jumpOffset;
+      if (target < 0 || target > (long long)opcodeSize)
+        return false;
+
+      decoded.IsJump = true;
+      decoded.JumpTarget = (size_t)target;
+    }
+
+    offset += size;
+  }
+
+  // Mark everything that gets jumped to (jumping to the very end is allowed)
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    OptimizerInstruction& instruction = this->Instructions[i];
+    if (instruction.IsJump == false || instruction.JumpTarget == opcodeSize)
+      continue;
+
+    size_t targetIndex = this->FindInstruction(instruction.JumpTarget);
+    if (targetIndex == this->Instructions.Size())
+      return false;
+
+    this->Instructions[targetIndex].IsJumpTarget = true;
+  }
+
+  return true;
+}
+
+size_t OpcodeOptimizer::FindInstruction(size_t oldOffset)
+{
+  // Instructions are decoded in order, so we can binary search them
+  size_t begin = 0;
+  size_t end = this->Instructions.Size();
+  while (begin < end)
+  {
+    size_t middle = begin + (end - begin) / 2;
+    size_t middleOffset = this->Instructions[middle].OldOffset;
+    if (middleOffset == oldOffset)
+      return middle;
+
+    if (middleOffset < oldOffset)
+      begin = middle + 1;
+    else
+      end = middle;
+  }
+
+  return this->Instructions.Size();
+}
+
+size_t OpcodeOptimizer::FindFallthrough(size_t index)
+{
+  // Skip anything we've already removed, but if anyone jumps to a removed
+  // instruction they will end up at the next one that we keep
+  for (size_t i = index + 1; i < this->Instructions.Size(); ++i)
+  {
+    OptimizerInstruction& instruction = this->Instructions[i];
+    if (instruction.IsJumpTarget)
+      break;
+
+    if (instruction.Removed == false)
+      return i;
+  }
+
+  return this->Instructions.Size();
+}
+
+void OpcodeOptimizer::GatherLocalRanges(Function* function)
+{
+  // The return, parameters, and this handle are shared with whoever calls us
+  LocalRange& parameters = this->Variables.PushBack();
+  parameters.Local = 0;
+  parameters.Size = function->FunctionType->TotalStackSizeExcludingThisHandle;
+  if (function->This != nullptr)
+    parameters.Size += sizeof(Handle);
+
+  // Keep every variable as it is so the debugger always sees the right values
+  for (size_t i = 0; i < function->Variables.Size(); ++i)
+  {
+    Variable* variable = function->Variables[i];
+    LocalRange& range = this->Variables.PushBack();
+    range.Local = variable->Local;
+    range.Size = variable->ResultType->GetCopyableSize();
+  }
+
+  // If a handle was created to a local then it can be changed behind our back
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    OptimizerInstruction& instruction = this->Instructions[i];
+    if (instruction.Instruction == Instruction::ToHandle)
+    {
+      ToHandleOpcode& op = this->Get<ToHandleOpcode>(instruction);
+      if (op.ToHandle.Type == OperandType::Local)
+      {
+        LocalRange& range = this->AddressTaken.PushBack();
+        range.Local = op.ToHandle.HandleConstantLocal;
+        range.Size = op.Type->Size;
+      }
+    }
+    else if (instruction.Instruction == Instruction::LocalObject)
+    {
+      CreateLocalTypeOpcode& op = this->Get<CreateLocalTypeOpcode>(instruction);
+      LocalRange& range = this->AddressTaken.PushBack();
+      range.Local = op.StackLocal;
+      range.Size = op.CreatedType->Size;
+    }
+  }
+}
+
+void OpcodeOptimizer::AddLocal(OperandIndex local, size_t size, size_t operandOffset, bool write)
+{
+  LocalReference& reference = this->References.PushBack();
+  reference.Local = local;
+  reference.Size = size;
+  reference.OperandOffset = operandOffset;
+  reference.Write = write;
+}
+
+void OpcodeOptimizer::AddOperand(const Operand& operand, size_t operandOffset, size_t size, bool write)
+{
+  // A field reads the handle that it goes through
+  if (operand.Type == OperandType::Field)
+    this->AddLocal(operand.HandleConstantLocal, sizeof(Handle), cNotAnOperand, false);
+  else if (operand.Type == OperandType::Local)
+    this->AddLocal(operand.HandleConstantLocal, size, operandOffset, write);
+}
+
+void OpcodeOptimizer::GatherReferences(size_t index)
+{
+  OptimizerInstruction& instruction = this->Instructions[index];
+  const InstructionInfo& info = GetInstructionInfo(instruction.Instruction);
+  byte* opcode = this->Data.Data() + instruction.DataOffset;
+
+  // Any references gathered before are left behind (they are no longer used)
+  instruction.ReferencesStart = this->References.Size();
+
+  switch (info.Layout)
+  {
+  case OpcodeLayout::ToHandle:
+  {
+    ToHandleOpcode& op = *(ToHandleOpcode*)opcode;
+    this->AddOperand(op.ToHandle, (byte*)&op.ToHandle - opcode, op.Type->Size, false);
+    this->AddLocal(op.SaveLocal, sizeof(Handle), cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::CreateStaticDelegate:
+  {
+    CreateStaticDelegateOpcode& op = *(CreateStaticDelegateOpcode*)opcode;
+    this->AddLocal(op.SaveLocal, sizeof(Delegate), cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::CreateInstanceDelegate:
+  {
+    CreateInstanceDelegateOpcode& op = *(CreateInstanceDelegateOpcode*)opcode;
+    this->AddOperand(op.ThisHandle, (byte*)&op.ThisHandle - opcode, sizeof(Handle), false);
+    this->AddLocal(op.SaveLocal, sizeof(Delegate), cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::If:
+  {
+    IfOpcode& op = *(IfOpcode*)opcode;
+    this->AddOperand(op.Condition, (byte*)&op.Condition - opcode, sizeof(Boolean), false);
+    break;
+  }
+
+  case OpcodeLayout::PrepForFunctionCall:
+  {
+    PrepForFunctionCallOpcode& op = *(PrepForFunctionCallOpcode*)opcode;
+    this->AddOperand(op.Delegate, (byte*)&op.Delegate - opcode, sizeof(Delegate), false);
+    break;
+  }
+
+  case OpcodeLayout::CreateType:
+  {
+    CreateTypeOpcode& op = *(CreateTypeOpcode*)opcode;
+    this->AddLocal(op.SaveHandleLocal, sizeof(Handle), cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::CreateLocalType:
+  {
+    CreateLocalTypeOpcode& op = *(CreateLocalTypeOpcode*)opcode;
+    this->AddLocal(op.SaveHandleLocal, sizeof(Handle), cNotAnOperand, true);
+    this->AddLocal(op.StackLocal, op.CreatedType->Size, cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::CreatePropertyDelegate:
+  {
+    CreatePropertyDelegateOpcode& op = *(CreatePropertyDelegateOpcode*)opcode;
+    this->AddLocal(op.SaveHandleLocal, sizeof(Handle), cNotAnOperand, true);
+    this->AddLocal(op.ThisHandleLocal, sizeof(Handle), cNotAnOperand, false);
+    break;
+  }
+
+  case OpcodeLayout::EndStringBuilder:
+  {
+    EndStringBuilderOpcode& op = *(EndStringBuilderOpcode*)opcode;
+    this->AddLocal(op.SaveStringHandleLocal, sizeof(Handle), cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::AddToStringBuilder:
+  {
+    AddToStringBuilderOpcode& op = *(AddToStringBuilderOpcode*)opcode;
+    this->AddOperand(op.Value, (byte*)&op.Value - opcode, op.TypeToConvert->GetCopyableSize(), false);
+    break;
+  }
+
+  case OpcodeLayout::DeleteObject:
+  {
+    // Deleting an object also clears the handle
+    DeleteObjectOpcode& op = *(DeleteObjectOpcode*)opcode;
+    this->AddOperand(op.Object, (byte*)&op.Object - opcode, sizeof(Handle), true);
+    break;
+  }
+
+  case OpcodeLayout::ThrowException:
+  {
+    ThrowExceptionOpcode& op = *(ThrowExceptionOpcode*)opcode;
+    this->AddOperand(op.Exception, (byte*)&op.Exception - opcode, sizeof(Handle), false);
+    break;
+  }
+
+  case OpcodeLayout::TypeId:
+  {
+    TypeIdOpcode& op = *(TypeIdOpcode*)opcode;
+    this->AddLocal(op.SaveTypeHandleLocal, sizeof(Handle), cNotAnOperand, true);
+    this->AddOperand(op.Expression, (byte*)&op.Expression - opcode, op.CompileTimeType->GetCopyableSize(), false);
+    break;
+  }
+
+  case OpcodeLayout::BinaryRValue:
+  {
+    // Value comparisons store the size of the value on the opcode
+    BinaryRValueOpcode& op = *(BinaryRValueOpcode*)opcode;
+    size_t leftSize = info.InputSize != 0 ? info.InputSize : op.Size;
+    size_t rightSize = info.RightSize != 0 ? info.RightSize : op.Size;
+    this->AddOperand(op.Left, (byte*)&op.Left - opcode, leftSize, false);
+    this->AddOperand(op.Right, (byte*)&op.Right - opcode, rightSize, false);
+    this->AddLocal(op.Output, info.OutputSize, cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::BinaryLValue:
+  {
+    BinaryLValueOpcode& op = *(BinaryLValueOpcode*)opcode;
+    this->AddOperand(op.Output, (byte*)&op.Output - opcode, info.InputSize, true);
+    this->AddOperand(op.Right, (byte*)&op.Right - opcode, info.RightSize, false);
+    break;
+  }
+
+  case OpcodeLayout::UnaryRValue:
+  {
+    UnaryRValueOpcode& op = *(UnaryRValueOpcode*)opcode;
+    this->AddOperand(op.SingleOperand, (byte*)&op.SingleOperand - opcode, info.InputSize, false);
+    this->AddLocal(op.Output, info.OutputSize, cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::UnaryLValue:
+  {
+    UnaryLValueOpcode& op = *(UnaryLValueOpcode*)opcode;
+    this->AddOperand(op.SingleOperand, (byte*)&op.SingleOperand - opcode, info.InputSize, true);
+    break;
+  }
+
+  case OpcodeLayout::Conversion:
+  case OpcodeLayout::DowncastConversion:
+  {
+    ConversionOpcode& op = *(ConversionOpcode*)opcode;
+    this->AddOperand(op.ToConvert, (byte*)&op.ToConvert - opcode, info.InputSize, false);
+    this->AddLocal(op.Output, info.OutputSize, cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::AnyConversion:
+  {
+    AnyConversionOpcode& op = *(AnyConversionOpcode*)opcode;
+    size_t relatedSize = op.RelatedType->GetCopyableSize();
+    bool toAny = (instruction.Instruction == Instruction::ConvertToAny);
+    this->AddOperand(op.ToConvert, (byte*)&op.ToConvert - opcode, toAny ? relatedSize : sizeof(Any), false);
+    this->AddLocal(op.Output, toAny ? sizeof(Any) : relatedSize, cNotAnOperand, true);
+    break;
+  }
+
+  case OpcodeLayout::Copy:
+  {
+    // Returns are read from (and parameters are written to) the frame of the
+    // function being called, not ours
+    CopyOpcode& op = *(CopyOpcode*)opcode;
+    if (op.Mode != CopyMode::FromReturn)
+      this->AddOperand(op.Source, (byte*)&op.Source - opcode, op.Size, false);
+    if (op.Mode != CopyMode::ToParameter)
+      this->AddOperand(op.Destination, (byte*)&op.Destination - opcode, op.Size, true);
+    break;
+  }
+
+  case OpcodeLayout::CompareRelativeGoTo:
+  {
+    CompareRelativeGoToOpcode& op = *(CompareRelativeGoToOpcode*)opcode;
+    this->AddOperand(op.Left, (byte*)&op.Left - opcode, info.InputSize, false);
+    this->AddOperand(op.Right, (byte*)&op.Right - opcode, info.RightSize, false);
+    break;
+  }
+
+  default:
+    break;
+  }
+
+  instruction.ReferencesCount = this->References.Size() - instruction.ReferencesStart;
+}
+
+size_t OpcodeOptimizer::CountReferences(OperandIndex local, size_t size)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    OptimizerInstruction& instruction = this->Instructions[i];
+    if (instruction.Removed)
+      continue;
+
+    for (size_t j = 0; j < instruction.ReferencesCount; ++j)
+    {
+      LocalReference& reference = this->References[instruction.ReferencesStart + j];
+      if (Overlaps(reference.Local, reference.Size, local, size))
+        ++count;
+    }
+  }
+  return count;
+}
+
+OpcodeOptimizer::LocalReference* OpcodeOptimizer::FindOtherReference(OperandIndex local,
+                                                                     size_t size,
+                                                                     size_t excludeIndex,
+                                                                     size_t& indexOut)
+{
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    OptimizerInstruction& instruction = this->Instructions[i];
+    if (instruction.Removed || i == excludeIndex)
+      continue;
+
+    for (size_t j = 0; j < instruction.ReferencesCount; ++j)
+    {
+      LocalReference& reference = this->References[instruction.ReferencesStart + j];
+      if (Overlaps(reference.Local, reference.Size, local, size))
+      {
+        indexOut = i;
+        return &reference;
+      }
+    }
+  }
+  return nullptr;
+}
+
+bool OpcodeOptimizer::IsAddressTaken(OperandIndex local, size_t size)
+{
+  for (size_t i = 0; i < this->AddressTaken.Size(); ++i)
+  {
+    LocalRange& range = this->AddressTaken[i];
+    if (Overlaps(range.Local, range.Size, local, size))
+      return true;
+  }
+  return false;
+}
+
+bool OpcodeOptimizer::IsTemporary(OperandIndex local, size_t size)
+{
+  if (size == 0)
+    return false;
+
+  for (size_t i = 0; i < this->Variables.Size(); ++i)
+  {
+    LocalRange& range = this->Variables[i];
+    if (Overlaps(range.Local, range.Size, local, size))
+      return false;
+  }
+
+  return this->IsAddressTaken(local, size) == false;
+}
+
+bool OpcodeOptimizer::GetPureOutput(OptimizerInstruction& instruction, OperandIndex& localOut, size_t& sizeOut)
+{
+  const InstructionInfo& info = GetInstructionInfo(instruction.Instruction);
+  if (info.Pure == false)
+    return false;
+
+  switch (info.Layout)
+  {
+  case OpcodeLayout::BinaryRValue:
+    localOut = this->Get<BinaryRValueOpcode>(instruction).Output;
+    sizeOut = info.OutputSize;
+    return true;
+
+  case OpcodeLayout::UnaryRValue:
+    localOut = this->Get<UnaryRValueOpcode>(instruction).Output;
+    sizeOut = info.OutputSize;
+    return true;
+
+  case OpcodeLayout::Conversion:
+    localOut = this->Get<ConversionOpcode>(instruction).Output;
+    sizeOut = info.OutputSize;
+    return true;
+
+  case OpcodeLayout::Copy:
+  {
+    CopyOpcode& op = this->Get<CopyOpcode>(instruction);
+    if (op.Destination.Type != OperandType::Local || op.Mode == CopyMode::ToParameter)
+      return false;
+
+    localOut = op.Destination.HandleConstantLocal;
+    sizeOut = op.Size;
+    return true;
+  }
+
+  default:
+    return false;
+  }
+}
+
+// Folds an operation on two constants (only if the condition holds, so
+// anything that would throw is left to throw at runtime)
+#define LightningFoldBinary(Name, ArgType, ResultType, condition, expression)                                          \
+  case Instruction::Name:                                                                                              \
+  {                                                                                                                    \
+    BinaryRValueOpcode& op = this->Get<BinaryRValueOpcode>(instruction);                                               \
+    ArgType left = ReadConstant<ArgType>(function, op.Left);                                                           \
+    ArgType right = ReadConstant<ArgType>(function, op.Right);                                                         \
+    if (!(condition))                                                                                                  \
+      return false;                                                                                                    \
+    ResultType result = (expression);                                                                                  \
+    OperandLocal output = op.Output;                                                                                   \
+    this->ReplaceWithConstantCopy(                                                                                     \
+        index, AddConstant(function, result), output, sizeof(ResultType), Instruction::Copy##ResultType);              \
+    break;                                                                                                             \
+  }
+
+#define LightningFoldUnary(Name, ArgType, expression)                                                                  \
+  case Instruction::Name:                                                                                              \
+  {                                                                                                                    \
+    UnaryRValueOpcode& op = this->Get<UnaryRValueOpcode>(instruction);                                                 \
+    ArgType operand = ReadConstant<ArgType>(function, op.SingleOperand);                                               \
+    ArgType result = (expression);                                                                                     \
+    OperandLocal output = op.Output;                                                                                   \
+    this->ReplaceWithConstantCopy(                                                                                     \
+        index, AddConstant(function, result), output, sizeof(ArgType), Instruction::Copy##ArgType);                    \
+    break;                                                                                                             \
+  }
+
+#define LightningFoldComparison(Type)                                                                                  \
+  LightningFoldBinary(TestLessThan##Type, Type, Boolean, true, left < right)                                           \
+      LightningFoldBinary(TestLessThanOrEqualTo##Type, Type, Boolean, true, left <= right)                             \
+          LightningFoldBinary(TestGreaterThan##Type, Type, Boolean, true, left > right)                                \
+              LightningFoldBinary(TestGreaterThanOrEqualTo##Type, Type, Boolean, true, left >= right)                  \
+                  LightningFoldBinary(TestInequality##Type, Type, Boolean, true, left != right)                        \
+                      LightningFoldBinary(TestEquality##Type, Type, Boolean, true, left == right)
+
+bool OpcodeOptimizer::FoldConstants(Function* function, size_t index)
+{
+  OptimizerInstruction& instruction = this->Instructions[index];
+  const InstructionInfo& info = GetInstructionInfo(instruction.Instruction);
+
+  // Only fold when every input is a constant
+  if (info.Layout == OpcodeLayout::BinaryRValue)
+  {
+    BinaryRValueOpcode& op = this->Get<BinaryRValueOpcode>(instruction);
+    if (op.Left.Type != OperandType::Constant || op.Right.Type != OperandType::Constant)
+      return false;
+  }
+  else if (info.Layout == OpcodeLayout::UnaryRValue)
+  {
+    UnaryRValueOpcode& op = this->Get<UnaryRValueOpcode>(instruction);
+    if (op.SingleOperand.Type != OperandType::Constant)
+      return false;
+  }
+  else
+  {
+    return false;
+  }
+
+  // Integer math is done unsigned so that overflow wraps the same way it does
+  // at runtime (rather than being undefined in the compiler)
+  switch (instruction.Instruction)
+  {
+    LightningFoldBinary(AddInteger, Integer, Integer, true, (Integer)((unsigned)left + (unsigned)right))
+    LightningFoldBinary(SubtractInteger, Integer, Integer, true, (Integer)((unsigned)left - (unsigned)right))
+    LightningFoldBinary(MultiplyInteger, Integer, Integer, true, (Integer)((unsigned)left * (unsigned)right))
+    LightningFoldBinary(DivideInteger, Integer, Integer, right != 0 && (right != -1 || left != INT_MIN), left / right)
+    LightningFoldBinary(ModuloInteger, Integer, Integer, right != 0 && (right != -1 || left != INT_MIN), left % right)
+    LightningFoldBinary(BitwiseOrInteger, Integer, Integer, true, left | right)
+    LightningFoldBinary(BitwiseXorInteger, Integer, Integer, true, left ^ right)
+    LightningFoldBinary(BitwiseAndInteger, Integer, Integer, true, left & right)
+    LightningFoldComparison(Integer)
+
+    LightningFoldBinary(AddReal, Real, Real, true, left + right)
+    LightningFoldBinary(SubtractReal, Real, Real, true, left - right)
+    LightningFoldBinary(MultiplyReal, Real, Real, true, left * right)
+    LightningFoldBinary(DivideReal, Real, Real, right != 0.0f, left / right)
+    LightningFoldComparison(Real)
+
+    LightningFoldBinary(TestInequalityBoolean, Boolean, Boolean, true, left != right)
+    LightningFoldBinary(TestEqualityBoolean, Boolean, Boolean, true, left == right)
+
+    LightningFoldUnary(NegateInteger, Integer, (Integer)(0u - (unsigned)operand))
+    LightningFoldUnary(BitwiseNotInteger, Integer, ~operand)
+    LightningFoldUnary(NegateReal, Real, -operand)
+    LightningFoldUnary(LogicalNotBoolean, Boolean, !operand)
+
+  default:
+    return false;
+  }
+
+  ++this->FunctionStats.ConstantsFolded;
+  return true;
+}
+
+#undef LightningFoldBinary
+#undef LightningFoldUnary
+#undef LightningFoldComparison
+
+bool OpcodeOptimizer::PropagateConstant(size_t index)
+{
+  // Look for a constant being copied into a temporary that is read only once
+  OptimizerInstruction& instruction = this->Instructions[index];
+  const InstructionInfo& info = GetInstructionInfo(instruction.Instruction);
+  if (info.Layout != OpcodeLayout::Copy || info.Pure == false)
+    return false;
+
+  CopyOpcode& op = this->Get<CopyOpcode>(instruction);
+  if (op.Source.Type != OperandType::Constant || op.Destination.Type != OperandType::Local)
+    return false;
+  if (op.Mode == CopyMode::ToParameter || op.Mode == CopyMode::FromReturn)
+    return false;
+
+  OperandIndex temporary = op.Destination.HandleConstantLocal;
+  size_t size = op.Size;
+  if (this->IsTemporary(temporary, size) == false || this->CountReferences(temporary, size) != 2)
+    return false;
+
+  // The only other reference has to be an operand reading the whole temporary
+  size_t readerIndex = 0;
+  LocalReference* reader = this->FindOtherReference(temporary, size, index, readerIndex);
+  if (reader == nullptr || reader->Write || reader->OperandOffset == cNotAnOperand)
+    return false;
+  if (reader->Local != temporary || reader->Size != size)
+    return false;
+
+  // Constants never change, so it doesn't matter where the reader is
+  OptimizerInstruction& readerInstruction = this->Instructions[readerIndex];
+  Operand& operand = *(Operand*)(this->Data.Data() + readerInstruction.DataOffset + reader->OperandOffset);
+  operand = op.Source;
+
+  instruction.Removed = true;
+  this->GatherReferences(readerIndex);
+  ++this->FunctionStats.CopiesRemoved;
+  return true;
+}
+
+bool OpcodeOptimizer::ForwardCopy(size_t index)
+{
+  // Look for a pure instruction writing to a temporary that is immediately
+  // copied somewhere else (and never touched again)
+  OptimizerInstruction& producer = this->Instructions[index];
+  OperandIndex temporary = 0;
+  size_t size = 0;
+  if (this->GetPureOutput(producer, temporary, size) == false)
+    return false;
+
+  size_t consumerIndex = this->FindFallthrough(index);
+  if (consumerIndex == this->Instructions.Size())
+    return false;
+
+  OptimizerInstruction& consumer = this->Instructions[consumerIndex];
+  const InstructionInfo& consumerInfo = GetInstructionInfo(consumer.Instruction);
+  if (consumerInfo.Layout != OpcodeLayout::Copy || consumerInfo.Pure == false)
+    return false;
+
+  CopyOpcode copy = this->Get<CopyOpcode>(consumer);
+  if (copy.Mode == CopyMode::FromReturn || copy.Source.Type != OperandType::Local)
+    return false;
+  if (copy.Source.HandleConstantLocal != temporary || copy.Size != size)
+    return false;
+  if (this->IsTemporary(temporary, size) == false || this->CountReferences(temporary, size) != 2)
+    return false;
+
+  const InstructionInfo& producerInfo = GetInstructionInfo(producer.Instruction);
+  if (producerInfo.Layout == OpcodeLayout::Copy)
+  {
+    // Two copies in a row become a single copy
+    CopyOpcode& first = this->Get<CopyOpcode>(producer);
+
+    // A return can only be copied into our own frame
+    if (first.Mode == CopyMode::FromReturn && copy.Mode == CopyMode::ToParameter)
+      return false;
+
+    // If both sides are in our frame they can't partially overlap (a memcpy
+    // onto itself is fine)
+    bool sameFrame = first.Mode != CopyMode::FromReturn && copy.Mode != CopyMode::ToParameter;
+    if (sameFrame && first.Source.Type == OperandType::Local && copy.Destination.Type == OperandType::Local)
+    {
+      OperandIndex source = first.Source.HandleConstantLocal;
+      OperandIndex destination = copy.Destination.HandleConstantLocal;
+      if (source != destination && Overlaps(source, size, destination, size))
+        return false;
+    }
+
+    first.Destination = copy.Destination;
+    if (first.Mode != CopyMode::FromReturn)
+      first.Mode = copy.Mode;
+  }
+  else
+  {
+    // Everything else can only write to a local in our frame, and nothing
+    // else can be looking at that local through a handle
+    if (copy.Mode == CopyMode::ToParameter || copy.Destination.Type != OperandType::Local)
+      return false;
+
+    OperandIndex destination = copy.Destination.HandleConstantLocal;
+    if (this->IsAddressTaken(destination, size))
+      return false;
+
+    // Some operations write their output one component at a time while still
+    // reading their inputs, so an input that partially overlaps the output
+    // would read a half written value (writing over the exact same input is
+    // safe, such as 'a = a + b')
+    for (size_t i = 0; i < producer.ReferencesCount; ++i)
+    {
+      LocalReference& input = this->References[producer.ReferencesStart + i];
+      if (input.Write || Overlaps(input.Local, input.Size, destination, size) == false)
+        continue;
+
+      if (input.Local != destination || input.Size != size)
+        return false;
+    }
+
+    switch (producerInfo.Layout)
+    {
+    case OpcodeLayout::BinaryRValue:
+      this->Get<BinaryRValueOpcode>(producer).Output = destination;
+      break;
+
+    case OpcodeLayout::UnaryRValue:
+      this->Get<UnaryRValueOpcode>(producer).Output = destination;
+      break;
+
+    case OpcodeLayout::Conversion:
+      this->Get<ConversionOpcode>(producer).Output = destination;
+      break;
+
+    default:
+      return false;
+    }
+  }
+
+  consumer.Removed = true;
+  this->GatherReferences(index);
+  ++this->FunctionStats.CopiesRemoved;
+  return true;
+}
+
+bool OpcodeOptimizer::FuseCompareJump(size_t index)
+{
+  // Look for a comparison into a temporary that is only read by the if
+  // instruction right after it
+  OptimizerInstruction& compare = this->Instructions[index];
+  const InstructionInfo& info = GetInstructionInfo(compare.Instruction);
+  if (info.IfFalse == Instruction::InvalidInstruction)
+    return false;
+
+  size_t branchIndex = this->FindFallthrough(index);
+  if (branchIndex == this->Instructions.Size())
+    return false;
+
+  OptimizerInstruction& branch = this->Instructions[branchIndex];
+  if (branch.Instruction != Instruction::IfFalseRelativeGoTo && branch.Instruction != Instruction::IfTrueRelativeGoTo)
+    return false;
+
+  BinaryRValueOpcode op = this->Get<BinaryRValueOpcode>(compare);
+  IfOpcode& ifOp = this->Get<IfOpcode>(branch);
+  if (ifOp.Condition.Type != OperandType::Local || ifOp.Condition.HandleConstantLocal != op.Output)
+    return false;
+  if (this->IsTemporary(op.Output, sizeof(Boolean)) == false || this->CountReferences(op.Output, sizeof(Boolean)) != 2)
+    return false;
+
+  // The fused instruction takes the place of the comparison and jumps to
+  // wherever the if did (offsets get fixed up when we encode)
+  CompareRelativeGoToOpcode fused;
+#ifdef PlasmaDebug
+  fused.DebugOrigin = op.DebugOrigin;
+#endif
+  fused.Instruction = (branch.Instruction == Instruction::IfTrueRelativeGoTo) ? info.IfTrue : info.IfFalse;
+  fused.Left = op.Left;
+  fused.Right = op.Right;
+  fused.JumpOffset = 0;
+
+  this->Replace(compare, fused, sizeof(fused));
+  compare.IsJump = true;
+  compare.JumpTarget = branch.JumpTarget;
+
+  branch.Removed = true;
+  this->GatherReferences(index);
+  ++this->FunctionStats.BranchesFused;
+  return true;
+}
+
+void OpcodeOptimizer::RemoveDeadInstructions()
+{
+  // Walk backwards so that removing a read can make the write before it dead
+  for (size_t i = this->Instructions.Size(); i > 0; --i)
+  {
+    size_t index = i - 1;
+    OptimizerInstruction& instruction = this->Instructions[index];
+    if (instruction.Removed)
+      continue;
+
+    const InstructionInfo& info = GetInstructionInfo(instruction.Instruction);
+    if (info.MayThrow)
+      continue;
+
+    OperandIndex output = 0;
+    size_t size = 0;
+    if (this->GetPureOutput(instruction, output, size) == false)
+      continue;
+
+    // The only reference to the output is this instruction writing it
+    if (this->IsTemporary(output, size) == false || this->CountReferences(output, size) != 1)
+      continue;
+
+    bool canRemove = false;
+    switch (info.Layout)
+    {
+    case OpcodeLayout::BinaryRValue:
+    {
+      BinaryRValueOpcode& op = this->Get<BinaryRValueOpcode>(instruction);
+      canRemove = ReadsOnlyLocalsOrConstants(op.Left) && ReadsOnlyLocalsOrConstants(op.Right);
+      break;
+    }
+
+    case OpcodeLayout::UnaryRValue:
+      canRemove = ReadsOnlyLocalsOrConstants(this->Get<UnaryRValueOpcode>(instruction).SingleOperand);
+      break;
+
+    case OpcodeLayout::Conversion:
+      canRemove = ReadsOnlyLocalsOrConstants(this->Get<ConversionOpcode>(instruction).ToConvert);
+      break;
+
+    case OpcodeLayout::Copy:
+    {
+      CopyOpcode& op = this->Get<CopyOpcode>(instruction);
+      canRemove = op.Mode != CopyMode::FromReturn && ReadsOnlyLocalsOrConstants(op.Source);
+      break;
+    }
+
+    default:
+      break;
+    }
+
+    if (canRemove)
+    {
+      instruction.Removed = true;
+      ++this->FunctionStats.DeadInstructionsRemoved;
+    }
+  }
+}
+
+void OpcodeOptimizer::Encode(Function* function)
+{
+  size_t oldSize = function->CompactedOpcode.Size();
+
+  // A removed instruction ends up at the same offset as the next instruction
+  // we keep, so anything that jumped to it will land there instead
+  size_t newSize = 0;
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    OptimizerInstruction& instruction = this->Instructions[i];
+    instruction.NewOffset = newSize;
+    if (instruction.Removed == false)
+      newSize += instruction.Size;
+  }
+
+  // Nothing changed, so leave the function's opcode alone
+  if (newSize == oldSize && this->Data.Size() == oldSize)
+    return;
+
+  Array<byte> compacted;
+  compacted.Resize(newSize);
+
+  HashMap<size_t, CodeLocation> locations;
+  Array<size_t> compactedIndices;
+
+  for (size_t i = 0; i < this->Instructions.Size(); ++i)
+  {
+    OptimizerInstruction& instruction = this->Instructions[i];
+    if (instruction.Removed)
+      continue;
+
+    byte* opcode = compacted.Data() + instruction.NewOffset;
+    memcpy(opcode, this->Data.Data() + instruction.DataOffset, instruction.Size);
+
+    // Point jumps at the new location of their target
+    if (instruction.IsJump)
+    {
+      size_t target = newSize;
+      if (instruction.JumpTarget != oldSize)
+        target = this->Instructions[this->FindInstruction(instruction.JumpTarget)].NewOffset;
+
+      OpcodeLayout::Enum layout = GetInstructionInfo(instruction.Instruction).Layout;
+      *GetJumpOffset(opcode, layout) = (ByteCodeOffset)((long long)target - (long long)instruction.NewOffset);
+    }
+
+    // Fused instructions keep the location of the instruction they replaced
+    CodeLocation* location = function->OpcodeLocationToCodeLocation.FindPointer(instruction.OldOffset);
+    if (location != nullptr)
+      locations.Insert(instruction.NewOffset, *location);
+
+    compactedIndices.PushBack(instruction.NewOffset);
+  }
+
+  function->CompactedOpcode.Swap(compacted);
+  function->OpcodeLocationToCodeLocation.Swap(locations);
+  function->OpcodeCompactedIndices.Swap(compactedIndices);
+}
+} // namespace Lightning
@@ -0,0 +1,190 @@
+// MIT Licensed (see LICENSE.md).
+
+#pragma once
+#ifndef LIGHTNING_OPCODE_OPTIMIZER_HPP
+#  define LIGHTNING_OPCODE_OPTIMIZER_HPP
+
+namespace Lightning
+{
+// Counts of what the optimizer did (summed over every function it ran on)
+class PlasmaShared OpcodeOptimizerStats
+{
+public:
+  // Constructor
+  OpcodeOptimizerStats();
+
+  // Adds the counts from another set of stats to ours
+  void Add(const OpcodeOptimizerStats& other);
+
+  // The number of instructions before and after optimization
+  size_t InstructionsBefore;
+  size_t InstructionsAfter;
+
+  // Operations on constants that were computed at compile time
+  size_t ConstantsFolded;
+
+  // Copies out of a temporary that were removed by writing the value directly
+  // to where it was being copied (or by reading a constant directly)
+  size_t CopiesRemoved;
+
+  // Comparisons that were fused with the conditional jump reading them
+  size_t BranchesFused;
+
+  // Instructions whose result was never read
+  size_t DeadInstructionsRemoved;
+};
+
+// A peephole optimizer that runs over a function's compacted opcode after code
+// generation. The CodeGenerator emits opcode straight from the syntax tree, so
+// expressions leave behind a lot of temporaries that are written once and then
+// immediately copied somewhere else. This pass only ever looks at temporaries
+// (never variables, so the debugger sees the same locals) and leaves a function
+// untouched if it finds an instruction it doesn't understand.
+class PlasmaShared OpcodeOptimizer
+{
+public:
+  // Optimizes the compacted opcode of a function in place, and fixes up the
+  // jumps and debug locations to match
+  void Optimize(Function* function);
+
+  // Totals for every function optimized so far
+  OpcodeOptimizerStats Stats;
+
+private:
+  // A decoded instruction
+  class OptimizerInstruction
+  {
+  public:
+    // The instruction, which may change if it gets folded or fused
+    Instruction::Enum Instruction;
+
+    // Where the instruction was and will be in the function's opcode
+    size_t OldOffset;
+    size_t NewOffset;
+
+    // Where the instruction's opcode lives in our own buffer, and its size
+    size_t DataOffset;
+    size_t Size;
+
+    // For jump instructions, the absolute (old) offset they jump to
+    size_t JumpTarget;
+
+    // The locals the instruction touches (a range of 'References')
+    size_t ReferencesStart;
+    size_t ReferencesCount;
+
+    // Whether the instruction jumps, and whether any jump goes to it
+    bool IsJump;
+    bool IsJumpTarget;
+
+    // Whether the instruction is being removed
+    bool Removed;
+  };
+
+  // A local (in our own stack frame) that an instruction reads or writes
+  class LocalReference
+  {
+  public:
+    OperandIndex Local;
+    size_t Size;
+
+    // Where the operand lives inside the opcode, or 'cNotAnOperand' if the
+    // local is an 'OperandLocal' (which can only ever be a local)
+    size_t OperandOffset;
+
+    // Whether the instruction writes to the local
+    bool Write;
+  };
+
+  // A range of locals
+  class LocalRange
+  {
+  public:
+    OperandIndex Local;
+    size_t Size;
+  };
+
+  // Returns the opcode of an instruction (in our buffer)
+  template <typename T>
+  T& Get(OptimizerInstruction& instruction)
+  {
+    return *(T*)(this->Data.Data() + instruction.DataOffset);
+  }
+
+  // Replaces an instruction's opcode with a different one (references returned
+  // by Get are no longer valid after this)
+  void Replace(OptimizerInstruction& instruction, const Opcode& opcode, size_t size);
+
+  // Replaces an instruction with a copy from a constant into a local
+  void ReplaceWithConstantCopy(size_t index,
+                               OperandIndex constant,
+                               OperandLocal output,
+                               size_t size,
+                               Instruction::Enum copyInstruction);
+
+  // Splits the function's opcode into instructions, or returns false if any
+  // instruction was unknown (or the opcode was malformed)
+  bool Decode(Function* function);
+
+  // Finds an instruction by its old offset (returns the instruction count if
+  // no instruction starts there)
+  size_t FindInstruction(size_t oldOffset);
+
+  // Finds the instruction that runs after the given one, which must not be
+  // jumped to from anywhere else (returns the instruction count if there is none)
+  size_t FindFallthrough(size_t index);
+
+  // Records the parameters, variables, and locals that have handles to them
+  void GatherLocalRanges(Function* function);
+
+  // Rebuilds the list of locals that an instruction touches (must be called
+  // whenever an instruction's operands change)
+  void GatherReferences(size_t index);
+  void AddOperand(const Operand& operand, size_t operandOffset, size_t size, bool write);
+  void AddLocal(OperandIndex local, size_t size, size_t operandOffset, bool write);
+
+  // Counts how many times a range of locals is touched by the instructions we
+  // are keeping, and finds the one reference that isn't from a given instruction
+  size_t CountReferences(OperandIndex local, size_t size);
+  LocalReference* FindOtherReference(OperandIndex local, size_t size, size_t excludeIndex, size_t& indexOut);
+
+  // Whether a range of locals is only ever used as a temporary (not a
+  // parameter or variable, and nothing holds its address)
+  bool IsTemporary(OperandIndex local, size_t size);
+  bool IsAddressTaken(OperandIndex local, size_t size);
+
+  // Gets the local that a pure instruction writes to (returns false if the
+  // instruction isn't pure or doesn't write to a local in our frame)
+  bool GetPureOutput(OptimizerInstruction& instruction, OperandIndex& localOut, size_t& sizeOut);
+
+  // The individual optimizations (each returns true if it changed something)
+  bool FoldConstants(Function* function, size_t index);
+  bool PropagateConstant(size_t index);
+  bool ForwardCopy(size_t index);
+  bool FuseCompareJump(size_t index);
+  void RemoveDeadInstructions();
+
+  // Writes the instructions back to the function
+  void Encode(Function* function);
+
+  // All the instructions in the function being optimized
+  Array<OptimizerInstruction> Instructions;
+
+  // The opcode for every instruction (including replacements)
+  Array<byte> Data;
+
+  // The locals touched by every instruction
+  Array<LocalReference> References;
+
+  // Locals that belong to parameters and variables
+  Array<LocalRange> Variables;
+
+  // Locals that a handle was created to
+  Array<LocalRange> AddressTaken;
+
+  // Stats for the function being optimized
+  OpcodeOptimizerStats FunctionStats;
+};
+} // namespace Lightning
+
+#endif
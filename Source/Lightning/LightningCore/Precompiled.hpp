@@ -261,7 +261,9 @@ String GetDocumentationCStringOrEmpty(cstr string);
 #  include "Members.hpp"
 #  include "Opcode.hpp"
 #  include "StringConstants.hpp"
+#  include "InlineCache.hpp"
 #  include "Function.hpp"
+#  include "OpcodeOptimizer.hpp"
 #  include "Type.hpp"
 #  include "MultiPrimitive.hpp"
 #  include "StringBuilderClass.hpp"
@@ -285,6 +287,7 @@ String GetDocumentationCStringOrEmpty(cstr string);
 #  include "HandleManager.hpp"
 #  include "Timer.hpp"
 #  include "ExecutableState.hpp"
+#  include "SamplingProfiler.hpp"
 #  include "Any.hpp"
 #  include "FilePathClass.hpp"
 #  include "StreamInterface.hpp"
@@ -202,13 +202,22 @@ CodeDefinition::CodeDefinition() :
 {
 }
 
-Project::Project() : UserData(nullptr), VariableUniqueIdCounter(0), CursorPosition(NoCursor)
+Project::Project() :
+    UserData(nullptr),
+    VariableUniqueIdCounter(0),
+    HasPreParsedTree(false),
+    PreParseSucceeded(false),
+    PreParsedEvaluation(EvaluationMode::Project),
+    CursorPosition(NoCursor)
 {
   LightningErrorIfNotStarted(Project);
 }
 
 void Project::AddCodeFromString(StringParam code, StringParam origin, void* codeUserData)
 {
+  // Any tree we parsed ahead of time no longer has all the code
+  this->ClearPreParse();
+
   // Add an entry to the list of all entries
   CodeEntry& entry = this->Entries.PushBack();
   entry.Code = code;
@@ -269,6 +278,34 @@ bool Project::AddCodeFromFile(StringParam fileName, void* codeUserData)
 void Project::Clear()
 {
   this->Entries.Clear();
+  this->ClearPreParse();
+}
+
+bool Project::PreParse(EvaluationMode::Enum evaluation)
+{
+  this->ClearPreParse();
+
+  this->PreParseSucceeded = this->CompileUncheckedSyntaxTree(this->PreParsedTree, this->PreParsedTokens, evaluation);
+  this->PreParsedEvaluation = evaluation;
+  this->HasPreParsedTree = true;
+  return this->PreParseSucceeded;
+}
+
+bool Project::IsPreParsed()
+{
+  return this->HasPreParsedTree;
+}
+
+void Project::ClearPreParse()
+{
+  if (this->HasPreParsedTree == false)
+    return;
+
+  // Swap with an empty tree so the parsed nodes get destroyed
+  SyntaxTree emptyTree;
+  this->PreParsedTree.Swap(emptyTree);
+  this->PreParsedTokens.Clear();
+  this->HasPreParsedTree = false;
 }
 
 bool Project::Tokenize(Array<UserToken>& tokensOut, Array<UserToken>& commentsOut)
@@ -429,6 +466,18 @@ bool Project::CompileUncheckedSyntaxTree(SyntaxTree& syntaxTreeOut,
                                          Array<UserToken>& tokensOut,
                                          EvaluationMode::Enum evaluation)
 {
+  // If the project was already parsed (possibly on another thread) then just
+  // hand out that tree (the variable-id counter is still wherever parsing
+  // left it)
+  if (this->HasPreParsedTree && this->PreParsedEvaluation == evaluation)
+  {
+    syntaxTreeOut.Swap(this->PreParsedTree);
+    tokensOut.Swap(this->PreParsedTokens);
+    this->ClearPreParse();
+    this->WasError = !this->PreParseSucceeded;
+    return this->PreParseSucceeded;
+  }
+
   // Reset the unique variable-id counter (ensures deterministic behavior)
   this->VariableUniqueIdCounter = 0;
 
@@ -270,6 +270,17 @@ public:
                                   Array<UserToken>& tokensOut,
                                   EvaluationMode::Enum evaluation);
 
+  // Tokenizes and parses the project ahead of time, so the next compile (with
+  // the same evaluation mode) can start at the syntaxer. Parsing only touches
+  // the project, so separate projects may be parsed on separate threads at the
+  // same time as long as 'DeferErrors' is set (the errors must be sent later
+  // on the thread that owns the project). Adding code or clearing the project
+  // throws the parsed tree away
+  bool PreParse(EvaluationMode::Enum evaluation);
+
+  // Whether there is a parsed tree waiting to be compiled
+  bool IsPreParsed();
+
   // Compiles the project into a checked syntax tree
   bool CompileCheckedSyntaxTree(SyntaxTree& syntaxTreeOut,
                                 LibraryBuilder& builder,
@@ -346,9 +357,19 @@ private:
   CompletionOverload& AddAutoCompleteOverload(AutoCompleteInfo& info, DelegateType* delegateType);
 
 private:
+  // Throws away any tree from PreParse
+  void ClearPreParse();
+
   // All the code that makes up this project
   Array<CodeEntry> Entries;
 
+  // The result of PreParse (waiting to be used by the next compile)
+  bool HasPreParsedTree;
+  bool PreParseSucceeded;
+  EvaluationMode::Enum PreParsedEvaluation;
+  SyntaxTree PreParsedTree;
+  Array<UserToken> PreParsedTokens;
+
   // A special constant that means we don't have a cursor
   static const size_t NoCursor = (size_t)-1;
 
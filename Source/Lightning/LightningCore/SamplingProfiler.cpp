@@ -0,0 +1,252 @@
+// MIT Licensed (see LICENSE.md).
+
+#include "Precompiled.hpp"
+
+namespace Lightning
+{
+// The node that every call stack starts from
+static const size_t RootStackNode = 0;
+
+FunctionSamples::FunctionSamples() : SelfSamples(0), TotalSamples(0)
+{
+}
+
+SamplingProfiler::StackNode::StackNode() : Parent(RootStackNode), SelfSamples(0)
+{
+}
+
+SamplingProfiler::SamplingProfiler() :
+    IntervalTicks(Timer::TicksPerSecond / 1000),
+    State(nullptr),
+    AccumulatedTicks(0),
+    Generation(InlineCacheGeneration::Get()),
+    SampleCount(0)
+{
+  // Some platforms have a very coarse clock, so never sample faster than it ticks
+  if (this->IntervalTicks <= 0)
+    this->IntervalTicks = 1;
+
+  this->Nodes.PushBack();
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+  this->Detach();
+}
+
+void SamplingProfiler::Attach(ExecutableState* state)
+{
+  ErrorIf(state->Profiler != nullptr && state->Profiler != this,
+          "Another profiler is already attached to this executable state");
+
+  this->Detach();
+  this->State = state;
+  this->AccumulatedTicks = 0;
+  state->Profiler = this;
+}
+
+void SamplingProfiler::Detach()
+{
+  if (this->State == nullptr)
+    return;
+
+  this->State->Profiler = nullptr;
+  this->State = nullptr;
+}
+
+bool SamplingProfiler::IsAttached()
+{
+  return this->State != nullptr;
+}
+
+void SamplingProfiler::Clear()
+{
+  this->Nodes.Clear();
+  this->Nodes.PushBack();
+  this->SampleCount = 0;
+  this->AccumulatedTicks = 0;
+}
+
+void SamplingProfiler::AddTicks(ExecutableState* state, long long ticks)
+{
+  this->AccumulatedTicks += ticks;
+  if (this->AccumulatedTicks < this->IntervalTicks)
+    return;
+
+  // If a lot of time passed since the last check (such as a long native call)
+  // the stack we're in gets every interval that went by, not just one
+  size_t count = (size_t)(this->AccumulatedTicks / this->IntervalTicks);
+  this->AccumulatedTicks -= (long long)count * this->IntervalTicks;
+  this->RecordSample(state, count);
+}
+
+size_t SamplingProfiler::GetSampleCount()
+{
+  return this->SampleCount;
+}
+
+void SamplingProfiler::RecordSample(ExecutableState* state, size_t count)
+{
+  // Once libraries have been patched or unloaded, functions may have been freed
+  // and their memory reused for other functions, so we have to stop looking
+  // nodes up by pointer (the nodes themselves stay, since they only hold names)
+  size_t generation = InlineCacheGeneration::Get();
+  if (this->Generation != generation)
+  {
+    for (size_t i = 0; i < this->Nodes.Size(); ++i)
+      this->Nodes[i].Children.Clear();
+    this->Generation = generation;
+  }
+
+  // The first frame is the base of the stack and never has a function
+  size_t node = RootStackNode;
+  for (size_t i = 0; i < state->StackFrames.Size(); ++i)
+  {
+    Function* function = state->StackFrames[i]->CurrentFunction;
+    if (function != nullptr)
+      node = this->FindOrAddNode(node, function);
+  }
+
+  // We were called without any function on the stack (which shouldn't happen,
+  // since only running code checks for timeouts)
+  if (node == RootStackNode)
+    return;
+
+  this->Nodes[node].SelfSamples += count;
+  this->SampleCount += count;
+}
+
+size_t SamplingProfiler::FindOrAddNode(size_t parent, Function* function)
+{
+  size_t* foundNode = this->Nodes[parent].Children.FindPointer(function);
+  if (foundNode != nullptr)
+    return *foundNode;
+
+  // Calling ToString is expensive, but it only happens the first time we see
+  // a call stack
+  size_t node = this->Nodes.Size();
+  StackNode& newNode = this->Nodes.PushBack();
+  newNode.Name = function->ToString();
+  newNode.Parent = parent;
+  this->Nodes[parent].Children.Insert(function, node);
+  return node;
+}
+
+void SamplingProfiler::GetStack(size_t node, Array<size_t>& stackOut)
+{
+  stackOut.Clear();
+  while (node != RootStackNode)
+  {
+    stackOut.PushBack(node);
+    node = this->Nodes[node].Parent;
+  }
+
+  Plasma::Reverse(stackOut.Begin(), stackOut.End());
+}
+
+String SamplingProfiler::GetCollapsedStacks()
+{
+  // The same call stack can show up more than once if it was seen both before
+  // and after a patch, so we merge them by name
+  HashMap<String, size_t> stackSamples;
+  Array<String> stackOrder;
+
+  Array<size_t> stack;
+  StringBuilder builder;
+  for (size_t i = 0; i < this->Nodes.Size(); ++i)
+  {
+    StackNode& node = this->Nodes[i];
+    if (node.SelfSamples == 0)
+      continue;
+
+    this->GetStack(i, stack);
+    builder.Deallocate();
+    for (size_t j = 0; j < stack.Size(); ++j)
+    {
+      if (j != 0)
+        builder.Append(';');
+      builder.Append(this->Nodes[stack[j]].Name);
+    }
+
+    String stackName = builder.ToString();
+    size_t* samples = stackSamples.FindPointer(stackName);
+    if (samples == nullptr)
+    {
+      stackSamples.Insert(stackName, node.SelfSamples);
+      stackOrder.PushBack(stackName);
+    }
+    else
+    {
+      *samples += node.SelfSamples;
+    }
+  }
+
+  StringBuilder output;
+  forRange (String& stackName, stackOrder.All())
+  {
+    output.Append(stackName);
+    output.AppendFormat(" %llu\n", (unsigned long long)stackSamples.FindValue(stackName, 0));
+  }
+  return output.ToString();
+}
+
+bool SamplingProfiler::SaveCollapsedStacks(StringParam fileName)
+{
+  String stacks = this->GetCollapsedStacks();
+  return Plasma::WriteToFile(fileName.c_str(), (const byte*)stacks.c_str(), stacks.SizeInBytes()) ==
+         stacks.SizeInBytes();
+}
+
+static bool SelfSamplesGreater(const FunctionSamples& left, const FunctionSamples& right)
+{
+  if (left.SelfSamples != right.SelfSamples)
+    return left.SelfSamples > right.SelfSamples;
+  return left.TotalSamples > right.TotalSamples;
+}
+
+void SamplingProfiler::GetFunctionSamples(Array<FunctionSamples>& functionsOut)
+{
+  functionsOut.Clear();
+
+  // Functions are merged by name for the same reason stacks are
+  HashMap<String, size_t> functionIndices;
+  HashSet<String> countedInSample;
+
+  Array<size_t> stack;
+  for (size_t i = 0; i < this->Nodes.Size(); ++i)
+  {
+    StackNode& node = this->Nodes[i];
+    if (node.SelfSamples == 0)
+      continue;
+
+    this->GetStack(i, stack);
+    countedInSample.Clear();
+    for (size_t j = 0; j < stack.Size(); ++j)
+    {
+      StackNode& stackNode = this->Nodes[stack[j]];
+
+      size_t index = functionIndices.FindValue(stackNode.Name, functionsOut.Size());
+      if (index == functionsOut.Size())
+      {
+        functionIndices.Insert(stackNode.Name, index);
+        functionsOut.PushBack().Name = stackNode.Name;
+      }
+
+      FunctionSamples& function = functionsOut[index];
+
+      // The last function on the stack is the one that was running
+      if (j == stack.Size() - 1)
+        function.SelfSamples += node.SelfSamples;
+
+      // Recursive functions only count once per stack
+      if (countedInSample.Contains(stackNode.Name) == false)
+      {
+        countedInSample.Insert(stackNode.Name);
+        function.TotalSamples += node.SelfSamples;
+      }
+    }
+  }
+
+  Sort(functionsOut.All(), SelfSamplesGreater);
+}
+} // namespace Lightning
@@ -0,0 +1,133 @@
+// MIT Licensed (see LICENSE.md).
+
+#pragma once
+#ifndef LIGHTNING_SAMPLING_PROFILER_HPP
+#  define LIGHTNING_SAMPLING_PROFILER_HPP
+
+namespace Lightning
+{
+// How much time was spent in a function, measured in samples
+class PlasmaShared FunctionSamples
+{
+public:
+  // Constructor
+  FunctionSamples();
+
+  // The function's name and signature (see Function::ToString)
+  String Name;
+
+  // Samples taken while the function itself was running
+  size_t SelfSamples;
+
+  // Samples taken while the function was anywhere on the call stack (counted
+  // once per sample, even when the function is recursive)
+  size_t TotalSamples;
+};
+
+// Periodically records the call stack of an executable state so we can see
+// where script time goes without instrumenting any scripts. The state already
+// reads the clock every few hundred jumps and calls to check timeouts, so
+// that's where we take samples: the only cost while attached is recording a
+// stack once per interval, and the only cost while detached is a null check.
+// Samples are taken on the thread running script, so nothing here needs to be
+// thread safe.
+// Only time spent inside the state is sampled: the clock is re-baselined each
+// time the host calls in, so the time between calls is never counted. Native
+// code called from script is counted when it returns to script.
+class PlasmaShared SamplingProfiler
+{
+public:
+  // Constructor
+  SamplingProfiler();
+
+  // Destructor (detaches from the state we're sampling)
+  ~SamplingProfiler();
+
+  // Starts sampling an executable state (only one profiler can be attached to
+  // a state at a time)
+  void Attach(ExecutableState* state);
+
+  // Stops sampling (the samples we recorded are kept)
+  void Detach();
+
+  // Whether we are currently sampling a state
+  bool IsAttached();
+
+  // Throws away every sample we recorded
+  void Clear();
+
+  // Called by the executable state with the time that passed since it last
+  // checked, and records a sample each time a full interval has gone by
+  void AddTicks(ExecutableState* state, long long ticks);
+
+  // The number of samples recorded
+  size_t GetSampleCount();
+
+  // Writes every recorded call stack in the 'collapsed stack' format read by
+  // flame graph tools: one line per stack with each function separated by a
+  // semicolon (outermost first), followed by a space and the sample count
+  String GetCollapsedStacks();
+
+  // Writes the collapsed stacks to a file (returns false if the file couldn't
+  // be written)
+  bool SaveCollapsedStacks(StringParam fileName);
+
+  // Gets the samples for every function that was seen, sorted by self samples
+  // (most expensive first)
+  void GetFunctionSamples(Array<FunctionSamples>& functionsOut);
+
+  // How many timer ticks (see Timer::TicksPerSecond) pass between samples
+  long long IntervalTicks;
+
+private:
+  // A function on a sampled call stack (stacks that start the same way share
+  // nodes, so each node is a unique call stack)
+  class StackNode
+  {
+  public:
+    // Constructor
+    StackNode();
+
+    // The name of the function (kept as a string because the function may be
+    // freed when its library is patched or unloaded)
+    String Name;
+
+    // The node of the function that called us (or 'RootStackNode')
+    size_t Parent;
+
+    // Samples that ended at this exact call stack
+    size_t SelfSamples;
+
+    // The nodes of functions we called, looked up by function. The pointers
+    // are only valid in the inline cache generation they were added in
+    HashMap<Function*, size_t> Children;
+  };
+
+  // Records the call stack of a state
+  void RecordSample(ExecutableState* state, size_t count);
+
+  // Finds the node for a function called from a parent, or creates it
+  size_t FindOrAddNode(size_t parent, Function* function);
+
+  // Builds the call stack for a node (outermost function first)
+  void GetStack(size_t node, Array<size_t>& stackOut);
+
+  // The state we're sampling
+  ExecutableState* State;
+
+  // Time passed since we last took a sample
+  long long AccumulatedTicks;
+
+  // The inline cache generation our function pointers are valid in
+  size_t Generation;
+
+  // Every unique call stack we have seen (the first node is the root, which
+  // holds no function)
+  Array<StackNode> Nodes;
+
+  // The total number of samples recorded
+  size_t SampleCount;
+};
+} // namespace Lightning
+
+#endif
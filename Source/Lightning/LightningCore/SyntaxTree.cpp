@@ -260,6 +260,14 @@ SyntaxTree::~SyntaxTree()
     delete token;
 }
 
+void SyntaxTree::Swap(SyntaxTree& other)
+{
+  Plasma::Swap(this->Root, other.Root);
+  Plasma::Swap(this->SingleExpressionScope, other.SingleExpressionScope);
+  Plasma::Swap(this->SingleExpressionIndex, other.SingleExpressionIndex);
+  this->InvalidTokens.Swap(other.InvalidTokens);
+}
+
 SyntaxType::SyntaxType() : ResolvedType(nullptr)
 {
 }
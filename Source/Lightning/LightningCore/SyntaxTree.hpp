@@ -33,6 +33,9 @@ public:
   // Destructor
   ~SyntaxTree();
 
+  // Trades contents with another tree (the nodes are not copied)
+  void Swap(SyntaxTree& other);
+
   // Get all the nodes at the given cursor position
   void GetNodesAtCursor(size_t cursorPosition, StringParam cursorOrigin, Array<SyntaxNode*>& nodesOut);
 
@@ -265,10 +265,21 @@ bool VirtualMachine::GenericIsZero<Real4>(const Real4& value)
   return value.x == 0.0f || value.y == 0.0f || value.z == 0.0f || value.w == 0.0f;
 }
 
+// The operand accessors and jump handlers below run inside ExecuteNext, which
+// is one very large function once every instruction is inlined into it. GCC
+// and Clang stop inlining into a function that size, which turns every
+// operand read into a call, so these are forced (PlasmaForceInline is only a
+// hint outside of MSVC)
+#if defined(__GNUC__) || defined(__clang__)
+#  define LightningDispatchInline inline __attribute__((always_inline))
+#else
+#  define LightningDispatchInline PlasmaForceInline
+#endif
+
 // Get a reference to a member variable (field), given the place in the
 // registers that the handle exists, and the member index...
 template <typename T>
-PlasmaForceInline T&
+LightningDispatchInline T&
 GetField(PerFrameData* stackFrame, PerFrameData* reportFrame, OperandIndex handleOperand, size_t memberOperand)
 {
   // Grab the handle to the object
@@ -293,7 +304,7 @@ GetField(PerFrameData* stackFrame, PerFrameData* reportFrame, OperandIndex handl
 
 // Get a particular constant from a function
 template <typename T>
-PlasmaForceInline T& GetConstant(Function* function, OperandIndex constantOperand)
+LightningDispatchInline T& GetConstant(Function* function, OperandIndex constantOperand)
 {
   // Make sure the value we're grabbing is inside the constant buffer (error
   // checking)
@@ -307,14 +318,14 @@ PlasmaForceInline T& GetConstant(Function* function, OperandIndex constantOperan
 
 // Get a particular local from a function
 template <typename T>
-PlasmaForceInline T& GetLocal(byte* frame, OperandIndex localOperand)
+LightningDispatchInline T& GetLocal(byte* frame, OperandIndex localOperand)
 {
   return *(T*)(frame + localOperand);
 }
 
 // Get a particular static from an operand
 template <typename T>
-PlasmaForceInline T& GetStatic(PerFrameData* stackFrame, PerFrameData* reportFrame, const Operand& operand)
+LightningDispatchInline T& GetStatic(PerFrameData* stackFrame, PerFrameData* reportFrame, const Operand& operand)
 {
   // Look for the static memory in a map of the fields on our state
   // Static fields are done per executable state, so they get wiped each time we
@@ -325,7 +336,7 @@ PlasmaForceInline T& GetStatic(PerFrameData* stackFrame, PerFrameData* reportFra
 
 // Get an operand (we don't know what type it is)
 template <typename T>
-PlasmaForceInline T& GetOperand(PerFrameData* stackFrame, PerFrameData* reportFrame, const Operand& operand)
+LightningDispatchInline T& GetOperand(PerFrameData* stackFrame, PerFrameData* reportFrame, const Operand& operand)
 {
   // Based on what kind of operand it is...
   switch (operand.Type)
@@ -358,11 +369,12 @@ PlasmaForceInline T& GetOperand(PerFrameData* stackFrame, PerFrameData* reportFr
 
 // Reusable code for the if opcodes
 template <Boolean IfTrue>
-PlasmaForceInline void IfHandler(PerFrameData* stackFrame, const Opcode& opcode)
+LightningDispatchInline void IfHandler(PerFrameData* stackFrame, const Opcode& opcode)
 {
   // Validate the timeout (this will throw an exception if we go beyond the time
-  // we need to) This only really needs to be ran in jumps
-  if (stackFrame->State->ThrowExceptionOnTimeout(*stackFrame->Report))
+  // we need to) This only really needs to be ran in jumps, and only reads the
+  // clock once every TimeoutCheckInterval times
+  if (stackFrame->State->CheckTimeout(*stackFrame->Report))
   {
     // Unwind our stack
     longjmp(stackFrame->ExceptionJump, ExceptionJumpResult);
@@ -388,6 +400,33 @@ PlasmaForceInline void IfHandler(PerFrameData* stackFrame, const Opcode& opcode)
   }
 }
 
+// Reusable code for the comparisons fused with an if opcode
+template <Boolean IfTrue>
+LightningDispatchInline void CompareRelativeGoToHandler(PerFrameData* stackFrame,
+                                                      const CompareRelativeGoToOpcode& op,
+                                                      Boolean result)
+{
+  // Validate the timeout just like the if opcode that this replaced
+  if (stackFrame->State->CheckTimeout(*stackFrame->Report))
+  {
+    // Unwind our stack
+    longjmp(stackFrame->ExceptionJump, ExceptionJumpResult);
+  }
+
+  // If the comparison evaluates to the value we jump on...
+  if (result == IfTrue)
+  {
+    // Move the instruction counter by the given offset
+    stackFrame->ProgramCounter += op.JumpOffset;
+  }
+  // Otherwise, we need to skip it
+  else
+  {
+    // Move the instruction counter past this opcode
+    stackFrame->ProgramCounter += sizeof(op);
+  }
+}
+
 PlasmaForceInline void CopyHandlerEx(
     PerFrameData* ourFrame, PerFrameData* topFrame, const byte*& sourceOut, byte*& destinationOut, const CopyOpcode& op)
 {
@@ -640,6 +679,22 @@ VirtualInstructionFn InstructionTable[Instruction::Count] = {0};
     }                                                                                                                  \
   }
 
+#define LightningCaseCompareRelativeGoTo(argType, operation, expression)                                                   \
+  LightningVirtualInstruction(IfFalse##operation##argType)                                                                 \
+  {                                                                                                                    \
+    const CompareRelativeGoToOpcode& op = (const CompareRelativeGoToOpcode&)opcode;                                    \
+    const argType& left = GetOperand<argType>(ourFrame, ourFrame, op.Left);                                            \
+    const argType& right = GetOperand<argType>(ourFrame, ourFrame, op.Right);                                          \
+    CompareRelativeGoToHandler<false>(ourFrame, op, expression);                                                       \
+  }                                                                                                                    \
+  LightningVirtualInstruction(IfTrue##operation##argType)                                                                  \
+  {                                                                                                                    \
+    const CompareRelativeGoToOpcode& op = (const CompareRelativeGoToOpcode&)opcode;                                    \
+    const argType& left = GetOperand<argType>(ourFrame, ourFrame, op.Left);                                            \
+    const argType& right = GetOperand<argType>(ourFrame, ourFrame, op.Right);                                          \
+    CompareRelativeGoToHandler<true>(ourFrame, op, expression);                                                        \
+  }
+
 // Note: These macros mirror those inside of InstructionEnum and Shared (for
 // generation of instructions)
 
@@ -651,6 +706,15 @@ VirtualInstructionFn InstructionTable[Instruction::Count] = {0};
   LightningCaseBinaryRValue(WithType, ResultType, TestInequality, output = left != right);                                 \
   LightningCaseBinaryRValue(WithType, ResultType, TestEquality, output = left == right);
 
+// Comparisons fused with a conditional jump
+#define LightningCompareJumpCases(WithType)                                                                                \
+  LightningCaseCompareRelativeGoTo(WithType, TestLessThan, left < right)                                                   \
+      LightningCaseCompareRelativeGoTo(WithType, TestLessThanOrEqualTo, left <= right)                                     \
+          LightningCaseCompareRelativeGoTo(WithType, TestGreaterThan, left > right)                                        \
+              LightningCaseCompareRelativeGoTo(WithType, TestGreaterThanOrEqualTo, left >= right)                          \
+                  LightningCaseCompareRelativeGoTo(WithType, TestInequality, left != right)                                \
+                      LightningCaseCompareRelativeGoTo(WithType, TestEquality, left == right)
+
 // Less and greater comparison
 #define LightningComparisonCases(WithType, ResultType)                                                                     \
   LightningCaseBinaryRValue(WithType, ResultType, TestLessThan, output = left < right);                                    \
@@ -895,8 +959,17 @@ LightningVirtualInstruction(CreateInstanceDelegate)
   if (op.BoundFunction->IsVirtual && op.CanBeVirtual && thisHandle.StoredType != nullptr)
   {
     // Find the function on our derived type that matches the signature / name
-    Function* function = thisHandle.StoredType->FindFunction(
-        op.BoundFunction->Name, op.BoundFunction->FunctionType, FindMemberOptions::None);
+    // (a virtual function tends to be called on the same few types, so we
+    // remember what we found for them)
+    Function* function = nullptr;
+    InlineCache<Function>& cache = op.BoundFunction->OverrideCache;
+    if (cache.Find(thisHandle.StoredType, function) == false)
+    {
+      function = thisHandle.StoredType->FindFunction(
+          op.BoundFunction->Name, op.BoundFunction->FunctionType, FindMemberOptions::None);
+      cache.Insert(thisHandle.StoredType, function);
+    }
+
     if (function != nullptr)
       delegate.BoundFunction = function;
     else
@@ -927,8 +1000,9 @@ LightningVirtualInstruction(IfTrueRelativeGoTo)
 LightningVirtualInstruction(RelativeGoTo)
 {
   // Validate the timeout (this will throw an exception if we go beyond the time
-  // we need to) This only really needs to be ran in jumps
-  if (state->ThrowExceptionOnTimeout(report))
+  // we need to) This only really needs to be ran in jumps, and only reads the
+  // clock once every TimeoutCheckInterval times
+  if (state->CheckTimeout(report))
   {
     // Jump out so we don't run any more code
     longjmp(ourFrame->ExceptionJump, ExceptionJumpResult);
@@ -949,8 +1023,9 @@ LightningVirtualInstruction(Return)
 LightningVirtualInstruction(PrepForFunctionCall)
 {
   // Validate the timeout (this will throw an exception if we go beyond the time
-  // we need to) This only really needs to be ran in jumps
-  if (state->ThrowExceptionOnTimeout(report))
+  // we need to) This only really needs to be ran in jumps, and only reads the
+  // clock once every TimeoutCheckInterval times
+  if (state->CheckTimeout(report))
   {
     // Jump out so we don't run any more code
     longjmp(ourFrame->ExceptionJump, ExceptionJumpResult);
@@ -1534,6 +1609,8 @@ LightningCaseConversion(Boolean4,
                     output = Integer4((Integer)value.x, (Integer)value.y, (Integer)value.z, (Integer)value.w));
 LightningCaseConversion(Boolean4, Real4, output = Real4((Real)value.x, (Real)value.y, (Real)value.z, (Real)value.w));
 
+LightningCompareJumpCases(Integer) LightningCompareJumpCases(Real)
+
 void VirtualMachine::InitializeJumpTable()
 {
 #define LightningEnumValue(Name) InstructionTable[Instruction::Name] = &Instruction##Name;
@@ -1541,6 +1618,15 @@ void VirtualMachine::InitializeJumpTable()
 #undef LightningEnumValue
 }
 
+// Instructions that can run other code, which may turn on debug events (such
+// as a debugger attaching). Once that happens the rest of the function has to
+// run in the debug loop.
+static inline bool CanEnableDebugEvents(Instruction::Enum instruction)
+{
+  return instruction == Instruction::FunctionCall || instruction == Instruction::NewObject ||
+         instruction == Instruction::LocalObject || instruction == Instruction::DeleteObject;
+}
+
 void VirtualMachine::ExecuteNext(Call& call, ExceptionReport& report)
 {
   // Since we do a raw copy, we always tell the caller to ignore debug checking
@@ -1574,9 +1660,63 @@ void VirtualMachine::ExecuteNext(Call& call, ExceptionReport& report)
   LightningLastRunningFunction = ourFrame->CurrentFunction;
   LightningLastRunningOpcodeLength = ourFrame->CurrentFunction->CompactedOpcode.Size();
 
-  // Loop through all the opcodes in the function
-  // We don't need to check for the end since the return opcode will exit this
-  // function
+  // Debug events are sent around every instruction, so they get a loop of
+  // their own and the common case doesn't pay for them
+  if (state->EnableDebugEvents)
+    goto DebugLoop;
+
+  // The handlers are called directly (rather than through the InstructionTable)
+  // so the compiler can inline them into the dispatch. We don't need to check
+  // for the end since the return opcode will exit this function.
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    // Direct threaded dispatch: each handler jumps straight to the next
+    // instruction's handler, which gives the branch predictor a separate
+    // indirect jump per instruction instead of one shared jump
+    static void* const cDispatchLabels[Instruction::Count] = {
+#  define LightningEnumValue(Name) &&Dispatch##Name,
+#  include "InstructionsEnum.inl"
+#  undef LightningEnumValue
+    };
+
+    goto* cDispatchLabels[((const Opcode*)(compactedOpcode + programCounter))->Instruction];
+
+#  define LightningEnumValue(Name)                                                                                         \
+  Dispatch##Name:                                                                                                      \
+  {                                                                                                                    \
+    const Opcode& opcode = *(const Opcode*)(compactedOpcode + programCounter);                                         \
+    Instruction##Name(state, call, report, programCounter, ourFrame, opcode);                                          \
+    if (Instruction::Name == Instruction::Return)                                                                      \
+      return;                                                                                                          \
+    if (CanEnableDebugEvents(Instruction::Name) && state->EnableDebugEvents)                                           \
+      goto DebugLoop;                                                                                                  \
+    goto* cDispatchLabels[((const Opcode*)(compactedOpcode + programCounter))->Instruction];                           \
+  }
+#  include "InstructionsEnum.inl"
+#  undef LightningEnumValue
+#else
+    LightningLoop
+    {
+      const Opcode& opcode = *(const Opcode*)(compactedOpcode + programCounter);
+      switch (opcode.Instruction)
+      {
+#  define LightningEnumValue(Name)                                                                                         \
+  case Instruction::Name:                                                                                              \
+    Instruction##Name(state, call, report, programCounter, ourFrame, opcode);                                          \
+    break;
+#  include "InstructionsEnum.inl"
+#  undef LightningEnumValue
+      }
+
+      if (opcode.Instruction == Instruction::Return)
+        return;
+      if (CanEnableDebugEvents((Instruction::Enum)opcode.Instruction) && state->EnableDebugEvents)
+        goto DebugLoop;
+    }
+#endif
+  }
+
+DebugLoop:
   LightningLoop
   {
     // Grab the current opcode that we're executing
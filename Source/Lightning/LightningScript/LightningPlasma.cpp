@@ -182,12 +182,18 @@ void LightningComponent::ScriptInitialize(CogInitializer& initializer)
     BoundType* cogInit = LightningTypeId(CogInitializer);
     ErrorIf(cogInit == nullptr, "Could not get the cog initializer type!");
 
-    // This should be cached possibly on the BoundType userdata, or as a meta
-    // component... but that might be slower than just looking it up
-    Array<Type*> params;
-    params.PushBack(cogInit);
+    // Every instance of a script type looks up the same function, so we cache
+    // it per type (the cache is cleared when scripts are recompiled)
     static String FunctionName("Initialize");
-    Function* function = thisType->FindFunction(FunctionName, params, core.VoidType, FindMemberOptions::None);
+    static Lightning::InlineCache<Function> FunctionCache;
+    Function* function = nullptr;
+    if (FunctionCache.Find(thisType, function) == false)
+    {
+      Array<Type*> params;
+      params.PushBack(cogInit);
+      function = thisType->FindFunction(FunctionName, params, core.VoidType, FindMemberOptions::None);
+      FunctionCache.Insert(thisType, function);
+    }
 
     if (function != nullptr)
     {
@@ -207,7 +213,13 @@ void LightningComponent::OnDestroy(uint flags)
 
   Core& core = Core::GetInstance();
   static String FunctionName("Destroyed");
-  Function* function = thisType->FindFunction(FunctionName, Array<Type*>(), core.VoidType, FindMemberOptions::None);
+  static Lightning::InlineCache<Function> FunctionCache;
+  Function* function = nullptr;
+  if (FunctionCache.Find(thisType, function) == false)
+  {
+    function = thisType->FindFunction(FunctionName, Array<Type*>(), core.VoidType, FindMemberOptions::None);
+    FunctionCache.Insert(thisType, function);
+  }
 
   if (function != nullptr)
   {
@@ -230,8 +242,14 @@ void LightningComponent::DebugDraw()
 
   Lightning::Core& core = Lightning::Core::GetInstance();
   static String FunctionName("DebugDraw");
-  Lightning::Function* function =
-      thisType->FindFunction(FunctionName, Array<Lightning::Type*>(), core.VoidType, Lightning::FindMemberOptions::None);
+  static Lightning::InlineCache<Lightning::Function> FunctionCache;
+  Lightning::Function* function = nullptr;
+  if (FunctionCache.Find(thisType, function) == false)
+  {
+    function = thisType->FindFunction(
+        FunctionName, Array<Lightning::Type*>(), core.VoidType, Lightning::FindMemberOptions::None);
+    FunctionCache.Insert(thisType, function);
+  }
 
   // Do not want to re-invoke Component's DebugDraw, will not find
   // LightningComponent's DebugDraw because it is not bound Still want find to look
@@ -83,6 +83,7 @@ void BasicSolver::Clear()
 {
   ClearFragmentList(mJoints);
   ClearFragmentList(mContacts);
+  mContactBatches.Clear();
 }
 
 void BasicSolver::UpdateData()
@@ -92,7 +93,14 @@ void BasicSolver::UpdateData()
   MoleculeWalker molecules(mMolecules.Data(), sizeof(ConstraintMolecule), 0);
 
   UpdateDataFragmentList(mJoints, molecules);
+
+  MoleculeWalker contactMolecules = molecules;
   UpdateDataFragmentList(mContacts, molecules);
+
+  // Pack the contacts after their molecules are computed so each lane
+  // starts from the same data the scalar path would use
+  if (UseContactBatches())
+    BuildContactBatches(mContacts, contactMolecules, mContactBatches);
 }
 
 void BasicSolver::WarmStart()
@@ -114,6 +122,11 @@ void BasicSolver::SolveVelocities()
   // solve all of the velocity constraints the given number of times
   for (uint i = 0; i < GetSolverIterationCount(); ++i)
     IterateVelocities(i);
+
+  // The batches accumulate their impulses separately, store them back so
+  // commit can cache them for warm starting
+  if (UseContactBatches())
+    CommitContactBatches(mContactBatches);
 }
 
 void BasicSolver::IterateVelocities(uint iteration)
@@ -121,7 +134,10 @@ void BasicSolver::IterateVelocities(uint iteration)
   MoleculeWalker molecules(mMolecules.Data(), sizeof(ConstraintMolecule), 0);
 
   IterateVelocitiesFragmentList(mJoints, molecules, iteration);
-  IterateVelocitiesFragmentList(mContacts, molecules, iteration);
+  if (UseContactBatches())
+    SolveContactBatches(mContactBatches);
+  else
+    IterateVelocitiesFragmentList(mContacts, molecules, iteration);
 }
 
 void BasicSolver::SolvePositions()
@@ -170,6 +186,11 @@ void BasicSolver::BatchEvents()
   BatchEventsFragmentList(mJoints);
 }
 
+bool BasicSolver::UseContactBatches() const
+{
+  return mSolverConfig->mSubType == PhysicsSolverSubType::SimdBatchSolving;
+}
+
 void BasicSolver::DrawJoints(uint debugFlag)
 {
   DrawJointsFragmentList(mJoints);
@@ -40,6 +40,9 @@ public:
   void DrawJoints(uint debugFlags);
 
 private:
+  /// Whether contacts are solved in simd batches instead of one at a time.
+  bool UseContactBatches() const;
+
   typedef InList<Joint, &Joint::SolverLink> JointList;
   typedef InList<Contact, &Contact::SolverLink> ContactList;
   typedef Array<ConstraintMolecule> MoleculeList;
@@ -48,6 +51,7 @@ private:
   ContactList mContacts;
   uint mConstraintCount;
   MoleculeList mMolecules;
+  ContactBatchArray mContactBatches;
 };
 
 } // namespace Physics
@@ -123,12 +123,14 @@ void CommitVelocities(Collider* obj0, Collider* obj1, JointVelocity& velocities)
   RigidBody* body0 = obj0->GetActiveBody();
   RigidBody* body1 = obj1->GetActiveBody();
 
-  if (body0)
+  // Static and kinematic bodies are never changed by solving but can be shared
+  // by islands that are solved on different threads, so don't write to them.
+  if (body0 && body0->IsDynamic())
   {
     body0->mVelocity = velocities.Linear[0];
     body0->mAngularVelocity = velocities.Angular[0];
   }
-  if (body1)
+  if (body1 && body1->IsDynamic())
   {
     body1->mVelocity = velocities.Linear[1];
     body1->mAngularVelocity = velocities.Angular[1];
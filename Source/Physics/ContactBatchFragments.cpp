@@ -0,0 +1,334 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+#if defined(PlasmaSse2)
+#  include <emmintrin.h>
+#endif
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+/// How many of the most recent batches are checked for a free lane before a
+/// new batch is started. Keeps batch building linear in the contact count.
+const uint cContactBatchSearchWindow = 8;
+
+bool BatchContainsDynamicBody(ContactBatch& batch, RigidBody* body)
+{
+  // Static and kinematic bodies are only read while solving so any number of
+  // lanes can share them.
+  if (body == nullptr || !body->IsDynamic())
+    return false;
+
+  for (uint lane = 0; lane < batch.mLaneCount; ++lane)
+  {
+    if (batch.mBodies[0][lane] == body || batch.mBodies[1][lane] == body)
+      return true;
+  }
+  return false;
+}
+
+ContactBatch& FindContactBatch(ContactBatchArray& batches, RigidBody* body0, RigidBody* body1)
+{
+  uint batchCount = batches.Size();
+  uint start = batchCount > cContactBatchSearchWindow ? batchCount - cContactBatchSearchWindow : 0;
+  for (uint i = start; i < batchCount; ++i)
+  {
+    ContactBatch& batch = batches[i];
+    if (batch.mLaneCount == cContactBatchLanes)
+      continue;
+    if (BatchContainsDynamicBody(batch, body0) || BatchContainsDynamicBody(batch, body1))
+      continue;
+    return batch;
+  }
+
+  ContactBatch& batch = batches.PushBack();
+  memset(&batch, 0, sizeof(ContactBatch));
+  return batch;
+}
+
+void SetBatchLane(ContactBatchRow& row, uint lane, ConstraintMolecule& mol, JointMass& masses)
+{
+  for (uint body = 0; body < 2; ++body)
+  {
+    Vec3 linearImpulse = masses.mInvMass[body].Apply(mol.mJacobian.Linear[body]);
+    Vec3 angularImpulse = Math::Transform(masses.InverseInertia[body], mol.mJacobian.Angular[body]);
+    for (uint axis = 0; axis < 3; ++axis)
+    {
+      row.mLinear[body][axis][lane] = mol.mJacobian.Linear[body][axis];
+      row.mAngular[body][axis][lane] = mol.mJacobian.Angular[body][axis];
+      row.mLinearImpulse[body][axis][lane] = linearImpulse[axis];
+      row.mAngularImpulse[body][axis][lane] = angularImpulse[axis];
+    }
+  }
+
+  row.mMass[lane] = mol.mMass;
+  row.mBias[lane] = mol.mBias;
+  row.mGamma[lane] = mol.mGamma;
+  row.mImpulse[lane] = mol.mImpulse;
+  row.mMolecules[lane] = &mol;
+}
+
+void BuildContactBatches(InList<Contact, &Contact::SolverLink>& contacts,
+                         MoleculeWalker& molecules,
+                         ContactBatchArray& batches)
+{
+  batches.Clear();
+
+  InList<Contact, &Contact::SolverLink>::range range = contacts.All();
+  for (; !range.Empty(); range.PopFront())
+  {
+    Contact& contact = range.Front();
+    RigidBody* body0 = contact.GetCollider(0)->GetActiveBody();
+    RigidBody* body1 = contact.GetCollider(1)->GetActiveBody();
+    JointMass masses;
+    JointHelpers::GetMasses(contact.GetCollider(0), contact.GetCollider(1), masses);
+
+    uint contactCount = contact.GetContactCount();
+    real frictionRatio = contact.mManifold->DynamicFriction / contactCount;
+    for (uint i = 0; i < contactCount; ++i)
+    {
+      ContactBatch& batch = FindContactBatch(batches, body0, body1);
+      uint lane = batch.mLaneCount;
+
+      for (uint row = 0; row < 3; ++row)
+        SetBatchLane(batch.mRows[row], lane, molecules[row], masses);
+      batch.mFrictionRatio[lane] = frictionRatio;
+      batch.mBodies[0][lane] = body0;
+      batch.mBodies[1][lane] = body1;
+      ++batch.mLaneCount;
+
+      molecules += 3;
+    }
+  }
+}
+
+/// The velocities of both bodies for every lane in a batch, indexed by
+/// [body][axis][lane].
+struct ContactBatchVelocities
+{
+  real mLinear[2][3][cContactBatchLanes];
+  real mAngular[2][3][cContactBatchLanes];
+};
+
+void GatherBatchVelocities(ContactBatch& batch, ContactBatchVelocities& velocities)
+{
+  memset(&velocities, 0, sizeof(ContactBatchVelocities));
+  for (uint body = 0; body < 2; ++body)
+  {
+    for (uint lane = 0; lane < batch.mLaneCount; ++lane)
+    {
+      RigidBody* rigidBody = batch.mBodies[body][lane];
+      if (rigidBody == nullptr)
+        continue;
+
+      for (uint axis = 0; axis < 3; ++axis)
+      {
+        velocities.mLinear[body][axis][lane] = rigidBody->mVelocity[axis];
+        velocities.mAngular[body][axis][lane] = rigidBody->mAngularVelocity[axis];
+      }
+    }
+  }
+}
+
+void ScatterBatchVelocities(ContactBatch& batch, ContactBatchVelocities& velocities)
+{
+  for (uint body = 0; body < 2; ++body)
+  {
+    for (uint lane = 0; lane < batch.mLaneCount; ++lane)
+    {
+      // Same as the regular commit, never write to static/kinematic bodies
+      RigidBody* rigidBody = batch.mBodies[body][lane];
+      if (rigidBody == nullptr || !rigidBody->IsDynamic())
+        continue;
+
+      for (uint axis = 0; axis < 3; ++axis)
+      {
+        rigidBody->mVelocity[axis] = velocities.mLinear[body][axis][lane];
+        rigidBody->mAngularVelocity[axis] = velocities.mAngular[body][axis][lane];
+      }
+    }
+  }
+}
+
+#if defined(PlasmaSse2)
+
+// All four lanes of a batch are solved at once with one lane per contact point.
+// This is the same math as the scalar version below, written in the same order
+// so both produce the same results.
+static_assert(cContactBatchLanes == 4, "The sse contact solver expects one lane per float in a register.");
+
+__m128 SolveBatchRowSse(ContactBatchRow& row,
+                        __m128 linear[2][3],
+                        __m128 angular[2][3],
+                        __m128 minImpulse,
+                        __m128 maxImpulse)
+{
+  // compute JV for all lanes
+  __m128 cDot = _mm_setzero_ps();
+  for (uint body = 0; body < 2; ++body)
+  {
+    for (uint axis = 0; axis < 3; ++axis)
+    {
+      cDot = _mm_add_ps(cDot, _mm_mul_ps(_mm_loadu_ps(row.mLinear[body][axis]), linear[body][axis]));
+      cDot = _mm_add_ps(cDot, _mm_mul_ps(_mm_loadu_ps(row.mAngular[body][axis]), angular[body][axis]));
+    }
+  }
+
+  // add in the bias and gamma then get the mass weighted lambda
+  __m128 oldImpulse = _mm_loadu_ps(row.mImpulse);
+  cDot = _mm_add_ps(cDot, _mm_loadu_ps(row.mBias));
+  cDot = _mm_add_ps(cDot, _mm_mul_ps(_mm_loadu_ps(row.mGamma), oldImpulse));
+  __m128 lambda = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(_mm_loadu_ps(row.mMass), cDot));
+
+  // clamp within the limits to get the new impulse
+  __m128 impulse = _mm_max_ps(minImpulse, _mm_min_ps(_mm_add_ps(oldImpulse, lambda), maxImpulse));
+  lambda = _mm_sub_ps(impulse, oldImpulse);
+  _mm_storeu_ps(row.mImpulse, impulse);
+
+  // apply the impulse to the velocities
+  for (uint body = 0; body < 2; ++body)
+  {
+    for (uint axis = 0; axis < 3; ++axis)
+    {
+      __m128 linearImpulse = _mm_loadu_ps(row.mLinearImpulse[body][axis]);
+      __m128 angularImpulse = _mm_loadu_ps(row.mAngularImpulse[body][axis]);
+      linear[body][axis] = _mm_add_ps(linear[body][axis], _mm_mul_ps(linearImpulse, lambda));
+      angular[body][axis] = _mm_add_ps(angular[body][axis], _mm_mul_ps(angularImpulse, lambda));
+    }
+  }
+
+  return impulse;
+}
+
+void SolveContactBatch(ContactBatch& batch)
+{
+  ContactBatchVelocities velocities;
+  GatherBatchVelocities(batch, velocities);
+
+  __m128 linear[2][3];
+  __m128 angular[2][3];
+  for (uint body = 0; body < 2; ++body)
+  {
+    for (uint axis = 0; axis < 3; ++axis)
+    {
+      linear[body][axis] = _mm_loadu_ps(velocities.mLinear[body][axis]);
+      angular[body][axis] = _mm_loadu_ps(velocities.mAngular[body][axis]);
+    }
+  }
+
+  __m128 normalImpulse =
+      SolveBatchRowSse(batch.mRows[0], linear, angular, _mm_setzero_ps(), _mm_set1_ps(Math::PositiveMax()));
+
+  // the friction bounds depend on the normal impulse just computed
+  __m128 frictionMax = _mm_mul_ps(_mm_loadu_ps(batch.mFrictionRatio), normalImpulse);
+  __m128 frictionMin = _mm_sub_ps(_mm_setzero_ps(), frictionMax);
+  SolveBatchRowSse(batch.mRows[1], linear, angular, frictionMin, frictionMax);
+  SolveBatchRowSse(batch.mRows[2], linear, angular, frictionMin, frictionMax);
+
+  for (uint body = 0; body < 2; ++body)
+  {
+    for (uint axis = 0; axis < 3; ++axis)
+    {
+      _mm_storeu_ps(velocities.mLinear[body][axis], linear[body][axis]);
+      _mm_storeu_ps(velocities.mAngular[body][axis], angular[body][axis]);
+    }
+  }
+
+  ScatterBatchVelocities(batch, velocities);
+}
+
+#else
+
+void SolveBatchRow(ContactBatchRow& row,
+                   ContactBatchVelocities& velocities,
+                   const real minImpulse[cContactBatchLanes],
+                   const real maxImpulse[cContactBatchLanes])
+{
+  // Same math as the simd version one lane at a time. Kept in the same layout
+  // so the compiler can still vectorize it when allowed to.
+  for (uint lane = 0; lane < cContactBatchLanes; ++lane)
+  {
+    real cDot = real(0.0);
+    for (uint body = 0; body < 2; ++body)
+    {
+      for (uint axis = 0; axis < 3; ++axis)
+      {
+        cDot += row.mLinear[body][axis][lane] * velocities.mLinear[body][axis][lane];
+        cDot += row.mAngular[body][axis][lane] * velocities.mAngular[body][axis][lane];
+      }
+    }
+
+    real oldImpulse = row.mImpulse[lane];
+    cDot += row.mBias[lane];
+    cDot += row.mGamma[lane] * oldImpulse;
+    real lambda = -row.mMass[lane] * cDot;
+
+    real impulse = Math::Clamp(oldImpulse + lambda, minImpulse[lane], maxImpulse[lane]);
+    lambda = impulse - oldImpulse;
+    row.mImpulse[lane] = impulse;
+
+    for (uint body = 0; body < 2; ++body)
+    {
+      for (uint axis = 0; axis < 3; ++axis)
+      {
+        velocities.mLinear[body][axis][lane] += row.mLinearImpulse[body][axis][lane] * lambda;
+        velocities.mAngular[body][axis][lane] += row.mAngularImpulse[body][axis][lane] * lambda;
+      }
+    }
+  }
+}
+
+void SolveContactBatch(ContactBatch& batch)
+{
+  ContactBatchVelocities velocities;
+  GatherBatchVelocities(batch, velocities);
+
+  real minImpulse[cContactBatchLanes];
+  real maxImpulse[cContactBatchLanes];
+  for (uint lane = 0; lane < cContactBatchLanes; ++lane)
+  {
+    minImpulse[lane] = real(0.0);
+    maxImpulse[lane] = Math::PositiveMax();
+  }
+  SolveBatchRow(batch.mRows[0], velocities, minImpulse, maxImpulse);
+
+  // the friction bounds depend on the normal impulse just computed
+  for (uint lane = 0; lane < cContactBatchLanes; ++lane)
+  {
+    maxImpulse[lane] = batch.mFrictionRatio[lane] * batch.mRows[0].mImpulse[lane];
+    minImpulse[lane] = -maxImpulse[lane];
+  }
+  SolveBatchRow(batch.mRows[1], velocities, minImpulse, maxImpulse);
+  SolveBatchRow(batch.mRows[2], velocities, minImpulse, maxImpulse);
+
+  ScatterBatchVelocities(batch, velocities);
+}
+
+#endif
+
+void SolveContactBatches(ContactBatchArray& batches)
+{
+  for (uint i = 0; i < batches.Size(); ++i)
+    SolveContactBatch(batches[i]);
+}
+
+void CommitContactBatches(ContactBatchArray& batches)
+{
+  for (uint i = 0; i < batches.Size(); ++i)
+  {
+    ContactBatch& batch = batches[i];
+    for (uint row = 0; row < 3; ++row)
+    {
+      ContactBatchRow& batchRow = batch.mRows[row];
+      for (uint lane = 0; lane < batch.mLaneCount; ++lane)
+        batchRow.mMolecules[lane]->mImpulse = batchRow.mImpulse[lane];
+    }
+  }
+}
+
+} // namespace Physics
+
+} // namespace Plasma
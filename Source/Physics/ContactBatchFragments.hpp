@@ -0,0 +1,60 @@
+// MIT Licensed (see LICENSE.md).
+#pragma once
+
+namespace Plasma
+{
+
+namespace Physics
+{
+
+/// How many contact points are solved at once by one contact batch.
+const uint cContactBatchLanes = 4;
+
+/// One constraint row (normal, friction 0 or friction 1) for every contact
+/// point in a batch. Stored as a structure of arrays so that each component
+/// fills one simd register across all lanes.
+struct ContactBatchRow
+{
+  // Indexed by [body][axis][lane].
+  real mLinear[2][3][cContactBatchLanes];
+  real mAngular[2][3][cContactBatchLanes];
+  // The jacobian pre-multiplied by the inverse mass/inertia of each body.
+  real mLinearImpulse[2][3][cContactBatchLanes];
+  real mAngularImpulse[2][3][cContactBatchLanes];
+
+  real mMass[cContactBatchLanes];
+  real mBias[cContactBatchLanes];
+  real mGamma[cContactBatchLanes];
+  real mImpulse[cContactBatchLanes];
+
+  ConstraintMolecule* mMolecules[cContactBatchLanes];
+};
+
+/// Up to cContactBatchLanes contact points that are solved together. No two
+/// lanes in a batch share a dynamic body so the lanes can be solved in
+/// parallel without racing on a body's velocity. Unused lanes are left zeroed
+/// so they produce no impulse.
+struct ContactBatch
+{
+  ContactBatchRow mRows[3];
+  real mFrictionRatio[cContactBatchLanes];
+  RigidBody* mBodies[2][cContactBatchLanes];
+  uint mLaneCount;
+};
+
+typedef Array<ContactBatch> ContactBatchArray;
+
+/// Packs the already updated contact molecules into batches. The walker
+/// should point at the first contact's molecules.
+void BuildContactBatches(InList<Contact, &Contact::SolverLink>& contacts,
+                         MoleculeWalker& molecules,
+                         ContactBatchArray& batches);
+/// Runs one velocity iteration over every contact batch.
+void SolveContactBatches(ContactBatchArray& batches);
+/// Writes the accumulated impulses of each lane back to its molecules so the
+/// regular contact commit can store them for warm starting.
+void CommitContactBatches(ContactBatchArray& batches);
+
+} // namespace Physics
+
+} // namespace Plasma
@@ -6,12 +6,12 @@ namespace Plasma
 
 namespace Physics
 {
-Memory::Pool* sContactPool = nullptr;
+Memory::ThreadCachingPool* sContactPool = nullptr;
 
 ContactManager::ContactManager()
 {
   if (sContactPool == nullptr)
-    sContactPool = new Memory::Pool("Contacts", Memory::GetNamedHeap("Physics"), sizeof(Contact), 1000);
+    sContactPool = new Memory::ThreadCachingPool("Contacts", Memory::GetNamedHeap("Physics"), sizeof(Contact), 1000);
   mContactPool = sContactPool;
   mSpace = nullptr;
 }
@@ -37,7 +37,7 @@ private:
   typedef InList<Contact, &Contact::SolverLink> ContactList;
   ContactList mContactsToDestroy;
 
-  Memory::Pool* mContactPool;
+  Memory::ThreadCachingPool* mContactPool;
 };
 
 /// Checks if a contact already exists for a given manifold. Returns nullptr
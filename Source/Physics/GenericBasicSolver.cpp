@@ -242,7 +242,9 @@ void GenericBasicSolver::ConstraintObjectData::ApplyImpulse(Vec3Param linear, Ve
 
 void GenericBasicSolver::ConstraintObjectData::CommitVelocities()
 {
-  if (Body)
+  // Static and kinematic bodies are never changed by solving but can be shared
+  // by islands that are solved on different threads, so don't write to them.
+  if (Body && Body->IsDynamic())
   {
     Body->mVelocity = Velocity;
     Body->mAngularVelocity = AngularVelocity;
@@ -79,7 +79,7 @@ private:
 
   EntryArray mEntries;
   ObjectArray mObjects;
-  HashMap<RigidBody*, uint> mLookupMap;
+  FlatHashMap<RigidBody*, uint> mLookupMap;
 
   uint mEntryCount;
 };
@@ -16,8 +16,8 @@ size_t GetMaxSolverSize()
   return Math::Max(basicSolver, Math::Max(normalSolver, basicGenericSolver));
 }
 
-Memory::Pool* IConstraintSolver::sPool =
-    new Memory::Pool("Solvers", Memory::GetNamedHeap("Physics"), GetMaxSolverSize(), 512);
+Memory::ThreadCachingPool* IConstraintSolver::sPool =
+    new Memory::ThreadCachingPool("Solvers", Memory::GetNamedHeap("Physics"), GetMaxSolverSize(), 512);
 
 ImplementOverloadedNewWithAllocator(IConstraintSolver, IConstraintSolver::sPool);
 
@@ -20,7 +20,7 @@ struct Manifold;
 class IConstraintSolver
 {
 public:
-  static Memory::Pool* sPool;
+  static Memory::ThreadCachingPool* sPool;
 
   OverloadedNew();
 
@@ -167,13 +167,19 @@ void Integration::IntegrateRk2Velocity(RigidBody* body, real dt)
 }
 
 void Integration::IntegrateRk2Position(RigidBody* body, real dt)
+{
+  if (IntegrateRk2PositionThreaded(body, dt))
+    Transform::NotifyClampedTranslation(body->GetSpace(), body->GetOwner());
+}
+
+bool Integration::IntegrateRk2PositionThreaded(RigidBody* body, real dt)
 {
   Vec3 newVelocity = body->mVelocity;
   newVelocity = Math::MultiplyAdd(newVelocity, body->mInvMass.Apply(body->mForceAccumulator), dt * real(.5));
   newVelocity *= dt;
   Vec3 newRotation = body->mAngularVelocity;
 
-  body->UpdateCenterMass(newVelocity);
+  bool wasClamped = body->UpdateCenterMassThreaded(newVelocity);
 
   /*Collider* collider = body->GetCollider();
   Mat3 orientationMatrix = body->mOrientationMat;
@@ -188,6 +194,7 @@ void Integration::IntegrateRk2Position(RigidBody* body, real dt)
   Quat Qw(newRotation.x, newRotation.y, newRotation.z, real(0.0));
   Orientation = (Qw * Orientation) * real(0.5) * dt;
   body->UpdateOrientation(Orientation);
+  return wasClamped;
 }
 
 Vec3 Integration::VelocityApproximation(Vec3Param startPosition, Vec3Param endPosition, real dt)
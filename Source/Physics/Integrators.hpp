@@ -26,6 +26,10 @@ struct Integration
   static void IntegrateRk2(RigidBody* body, real dt);
   static void IntegrateRk2Velocity(RigidBody* body, real dt);
   static void IntegrateRk2Position(RigidBody* body, real dt);
+  /// Same as IntegrateRk2Position but only touches the body, so different
+  /// bodies can be integrated at the same time. Returns true if the body's
+  /// position was clamped, which the caller must report on the main thread.
+  static bool IntegrateRk2PositionThreaded(RigidBody* body, real dt);
 
   static Vec3 VelocityApproximation(Vec3Param startPosition, Vec3Param endPosition, real dt);
   static Vec3 AngularVelocityApproximation(QuatParam startRotation, QuatParam endRotation, real dt);
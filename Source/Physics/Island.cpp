@@ -7,7 +7,8 @@ namespace Plasma
 namespace Physics
 {
 
-Memory::Pool* Island::sPool = new Memory::Pool("Islands", Memory::GetNamedHeap("Physics"), sizeof(Island), 4096);
+Memory::ThreadCachingPool* Island::sPool =
+    new Memory::ThreadCachingPool("Islands", Memory::GetNamedHeap("Physics"), sizeof(Island), 4096);
 
 void* Island::operator new(size_t size)
 {
@@ -166,6 +167,21 @@ void Island::Solve(real dt, bool allowSleeping, uint debugFlags)
   UpdateSleep(dt, allowSleeping, debugFlags);
 }
 
+void Island::SolveConstraints(real dt)
+{
+  CommitConstraints();
+  mSolver->UpdateData();
+  mSolver->WarmStart();
+  mSolver->SolveVelocities();
+  mSolver->Commit();
+}
+
+void Island::FinishSolve(real dt, bool allowSleeping, uint debugFlags)
+{
+  mSolver->BatchEvents();
+  UpdateSleep(dt, allowSleeping, debugFlags);
+}
+
 void Island::SolvePositions(real dt)
 {
   mSolver->SolvePositions();
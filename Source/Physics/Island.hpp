@@ -20,7 +20,7 @@ class IConstraintSolver;
 class Island
 {
 public:
-  static Memory::Pool* sPool;
+  static Memory::ThreadCachingPool* sPool;
   static void* operator new(size_t size);
   static void operator delete(void* pMem, size_t size);
 
@@ -38,6 +38,13 @@ public:
   void IntegratePosition(real dt);
   void CommitConstraints();
   void Solve(real dt, bool allowSleeping, uint debugFlags);
+  /// Solves the velocity constraints without sending any events or updating
+  /// sleeping. Only touches this island's bodies, so it is safe to call from a
+  /// worker thread while other islands are being solved.
+  void SolveConstraints(real dt);
+  /// Batches constraint events and updates sleeping after SolveConstraints.
+  /// Must be called from the main thread.
+  void FinishSolve(real dt, bool allowSleeping, uint debugFlags);
   void SolvePositions(real dt);
   void UpdateSleep(real dt, bool allowSleeping, uint debugFlags);
   /// Helper function to mark everything as not on an island.
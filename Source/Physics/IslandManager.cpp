@@ -9,6 +9,10 @@ namespace Physics
 
 typedef Array<Collider*, HeapAllocator> ColliderStack;
 
+// The most tasks used to solve islands in one step (not counting the calling
+// thread, which also solves islands).
+const uint cMaxIslandSolveTasks = 8;
+
 void AddTreeToStack(Collider* collider, ColliderStack& stack)
 {
   // if any collider in a tree is marked as on an island,
@@ -388,10 +392,86 @@ void IslandManager::Solve(real dt, bool allowSleeping, uint debugFlags)
     return;
   }
 
-  // solve all of the islands.
+  if (!ThreadingEnabled || mIslandCount <= 1)
+  {
+    // solve all of the islands.
+    IslandList::range islandRange = mIslands.All();
+    for (; !islandRange.Empty(); islandRange.PopFront())
+      islandRange.Front().Solve(dt, allowSleeping, debugFlags);
+    return;
+  }
+
+  SolveIslandsThreaded(dt, allowSleeping, debugFlags);
+}
+
+/// Sorts islands so that the ones with the most work are scheduled first.
+bool IslandSizeSorter(Island* lhs, Island* rhs)
+{
+  uint lhsSize = lhs->ContactCount + lhs->JointCount;
+  uint rhsSize = rhs->ContactCount + rhs->JointCount;
+  return lhsSize > rhsSize;
+}
+
+/// Shared state for all of the tasks solving islands in one step.
+struct IslandSolveContext
+{
+  /// Solves islands until there are none left to take.
+  void SolveIslands()
+  {
+    for (;;)
+    {
+      s32 index = mNextIsland.FetchAdd(1);
+      if (index >= (s32)mIslands.Size())
+        return;
+      mIslands[index]->SolveConstraints(mDt);
+    }
+  }
+
+  Array<Island*> mIslands;
+  Atomic<s32> mNextIsland;
+  real mDt;
+};
+
+/// Task entry that pulls islands from the shared context.
+void SolveIslandsTask(void* context)
+{
+  ZoneScopedN("SolveIslandsTask");
+  static_cast<IslandSolveContext*>(context)->SolveIslands();
+}
+
+void IslandManager::SolveIslandsThreaded(real dt, bool allowSleeping, uint debugFlags)
+{
+  IslandSolveContext context;
+  context.mIslands.SetAllocator(HeapAllocator(mSpace->mHeap));
+  context.mIslands.Reserve(mIslandCount);
+  context.mDt = dt;
+
   IslandList::range islandRange = mIslands.All();
   for (; !islandRange.Empty(); islandRange.PopFront())
-    islandRange.Front().Solve(dt, allowSleeping, debugFlags);
+    context.mIslands.PushBack(&islandRange.Front());
+
+  // Start the largest islands first so one big pile doesn't end up
+  // running alone at the end of the step.
+  Sort(context.mIslands.All(), IslandSizeSorter);
+
+  // Islands share no dynamic bodies so they can all be solved at once. Every
+  // task (and this thread) takes the next unsolved island until none are left.
+  // The threaded solver issues its own tasks from inside an island, which is
+  // fine since waiting on them runs other pending tasks instead of blocking.
+  uint taskCount = Math::Min((uint)context.mIslands.Size() - 1, cMaxIslandSolveTasks);
+  TaskCounter counter;
+  for (uint i = 0; i < taskCount; ++i)
+    PL::gJobs->AddTask(&SolveIslandsTask, &context, &counter);
+
+  context.SolveIslands();
+  PL::gJobs->WaitFor(counter);
+
+  // Events and sleeping touch state outside of an island (event lists, object
+  // destruction from snapping, debug drawing), so they're done here in island
+  // order once every island has been solved.
+  islandRange = mIslands.All();
+  for (; !islandRange.Empty(); islandRange.PopFront())
+    islandRange.Front().FinishSolve(dt, allowSleeping, debugFlags);
 }
 
 void IslandManager::SolvePositions(real dt)
@@ -30,6 +30,9 @@ public:
   void BuildIslands(ColliderList& colliders);
   void PostProcessIslands();
   void Solve(real dt, bool allowSleeping, uint debugFlags);
+  /// Solves the islands concurrently on the task scheduler, then sends events and
+  /// updates sleeping on the calling thread.
+  void SolveIslandsThreaded(real dt, bool allowSleeping, uint debugFlags);
   void SolvePositions(real dt);
   void Draw(uint flags);
 
@@ -38,7 +38,7 @@ struct Manifold
 {
   Manifold();
 
-  static Memory::Pool* sManifoldPool;
+  static Memory::ThreadCachingPool* sManifoldPool;
   OverloadedNew();
 
   ManifoldPoint GetPoint(uint index);
@@ -16,8 +16,9 @@ DeclareEnum2(PhysicsSolverPositionCorrection, Baumgarte, PostStabilization);
 /// correction method.</param>
 DeclareEnum3(ConstraintPositionCorrection, Baumgarte, PostStabilization, Inherit);
 /// What kind of solver technique to use for position correction. Mainly for
-/// testing.
-DeclareEnum2(PhysicsSolverSubType, BasicSolving, BlockSolving);
+/// testing. SimdBatchSolving block solves positions and also solves contact
+/// velocities in simd batches of several contact points at once.
+DeclareEnum3(PhysicsSolverSubType, BasicSolving, BlockSolving, SimdBatchSolving);
 /// How to compute the tangents for a contact point. Mainly for testing.
 DeclareEnum3(PhysicsContactTangentTypes, OrthonormalTangents, VelocityTangents, RandomTangents);
 
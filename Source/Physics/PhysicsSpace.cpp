@@ -695,10 +695,57 @@ void PhysicsSpace::IterateTimestep(real dt)
   PushBroadPhaseQueue();
 }
 
+// The fewest bodies integrated by one chunk of a parallel integration loop.
+const size_t cIntegrationGrainSize = 64;
+
+/// Integrates the velocity of one awake body. Only touches the body itself so
+/// it is safe to run on any thread.
+struct IntegrateVelocityFunctor
+{
+  void operator()(RigidBody* body)
+  {
+    if (!body->GetStatic())
+      Physics::Integration::IntegrateVelocity(body, mDt);
+
+    body->mForceAccumulator.ZeroOut();
+    body->mTorqueAccumulator.ZeroOut();
+  }
+
+  real mDt;
+};
+
+/// A body being integrated and whether its position had to be clamped.
+struct IntegratedBody
+{
+  RigidBody* mBody;
+  bool mTranslationClamped;
+};
+
+/// Integrates the position of one body and updates its sleep timer. The
+/// integration update and any clamp warning are handled afterwards on the
+/// calling thread since they touch the space's shared state.
+struct IntegratePositionFunctor
+{
+  void operator()(IntegratedBody& entry)
+  {
+    // Same as Integration::IntegratePosition minus GenerateIntegrationUpdate
+    entry.mTranslationClamped = Physics::Integration::IntegrateRk2PositionThreaded(entry.mBody, mDt);
+    // Attempt to sleep the body.
+    entry.mBody->UpdateSleepTimer(mDt);
+  }
+
+  real mDt;
+};
+
 void PhysicsSpace::IntegrateBodiesVelocity(real dt)
 {
+  Array<RigidBody*> awakeBodies;
+  awakeBodies.SetAllocator(HeapAllocator(mHeap));
+
   RigidBodyList::range range = mRigidBodies.All();
 
+  // Effects can call out to user code and moving asleep bodies changes the
+  // lists, so this part stays on this thread
   while (!range.Empty())
   {
     RigidBody& body = range.Front();
@@ -719,30 +766,39 @@ void PhysicsSpace::IntegrateBodiesVelocity(real dt)
       continue;
     }
 
-    if (!body.GetStatic())
-      Physics::Integration::IntegrateVelocity(&body, dt);
-
-    body.mForceAccumulator.ZeroOut();
-    body.mTorqueAccumulator.ZeroOut();
+    awakeBodies.PushBack(&body);
   }
+
+  IntegrateVelocityFunctor integrate = {dt};
+  ParallelFor(awakeBodies.All(), cIntegrationGrainSize, integrate);
 }
 
 void PhysicsSpace::IntegrateBodiesPosition(real dt)
 {
-  RigidBodyList::range range = mRigidBodies.All();
+  Array<IntegratedBody> bodies;
+  bodies.SetAllocator(HeapAllocator(mHeap));
 
-  while (!range.Empty())
+  RigidBodyList::range range = mRigidBodies.All();
+  for (; !range.Empty(); range.PopFront())
   {
     RigidBody& body = range.Front();
-
     if (!body.GetStatic())
     {
-      Physics::Integration::IntegratePosition(&body, dt);
-      // Attempt to sleep the body.
-      body.UpdateSleepTimer(dt);
+      IntegratedBody& entry = bodies.PushBack();
+      entry.mBody = &body;
+      entry.mTranslationClamped = false;
     }
+  }
 
-    range.PopFront();
+  IntegratePositionFunctor integrate = {dt};
+  ParallelFor(bodies.All(), cIntegrationGrainSize, integrate);
+
+  for (uint i = 0; i < bodies.Size(); ++i)
+  {
+    RigidBody* body = bodies[i].mBody;
+    if (bodies[i].mTranslationClamped)
+      Transform::NotifyClampedTranslation(body->GetSpace(), body->GetOwner());
+    body->GenerateIntegrationUpdate();
   }
 }
 
@@ -776,8 +832,17 @@ void PhysicsSpace::BroadPhase()
   }
 
   mBroadPhase->RegisterCollisions();
-  // Query the dynamic broad phase
-  mBroadPhase->SelfQuery(mPossiblePairs);
+  // Query the dynamic broad phase. If it keeps its pairs we only have to apply
+  // what changed since the last update.
+  ClientPairArray begunPairs, endedPairs;
+  if (mBroadPhase->QueryPairDeltas(begunPairs, endedPairs))
+    UpdateDynamicPairs(begunPairs, endedPairs);
+  else
+  {
+    ClearDynamicPairs();
+    mBroadPhase->SelfQuery(mDynamicPairs);
+  }
+  mPossiblePairs.Append(mDynamicPairs.All());
   // Query the static broad phase
   mBroadPhase->BatchQuery(dataArray, mPossiblePairs);
 
@@ -786,50 +851,172 @@ void PhysicsSpace::BroadPhase()
     Sort(mPossiblePairs.All(), &ClientPairSorter);
 }
 
+void PhysicsSpace::UpdateDynamicPairs(ClientPairArray& begun, ClientPairArray& ended)
+{
+  // Remove the ended pairs by moving the last pair into their slot
+  for (uint i = 0; i < ended.Size(); ++i)
+  {
+    ClientPair& pair = ended[i];
+    NodePointerPair key(pair.mClientData[0], pair.mClientData[1]);
+    uint* index = mDynamicPairIndices.FindPointer(key);
+    if (index == nullptr)
+      continue;
+
+    uint removedIndex = *index;
+    mDynamicPairIndices.Erase(key);
+
+    ClientPair& lastPair = mDynamicPairs.Back();
+    if (removedIndex != mDynamicPairs.Size() - 1)
+    {
+      mDynamicPairs[removedIndex] = lastPair;
+      mDynamicPairIndices[NodePointerPair(lastPair.mClientData[0], lastPair.mClientData[1])] = removedIndex;
+    }
+    mDynamicPairs.PopBack();
+  }
+
+  for (uint i = 0; i < begun.Size(); ++i)
+  {
+    ClientPair& pair = begun[i];
+    NodePointerPair key(pair.mClientData[0], pair.mClientData[1]);
+    if (mDynamicPairIndices.ContainsKey(key))
+      continue;
+
+    mDynamicPairIndices.Insert(key, mDynamicPairs.Size());
+    mDynamicPairs.PushBack(pair);
+  }
+}
+
+void PhysicsSpace::ClearDynamicPairs()
+{
+  mDynamicPairs.Clear();
+  mDynamicPairIndices.Clear();
+}
+
+// The minimum number of broad phase pairs a narrow phase task will test. Below
+// this the cost of dispatching a task outweighs the collision tests.
+const uint cNarrowPhasePairsPerTask = 256;
+// The maximum number of chunks the narrow phase is split into.
+const uint cMaxNarrowPhaseTasks = 32;
+
+/// The results of running the narrow phase over a contiguous range of broad
+/// phase pairs. Each chunk owns its manifolds so chunks can be tested on
+/// separate threads and then merged back in pair order.
+struct NarrowPhaseChunk
+{
+  /// A pair that collided and the range of manifolds it generated.
+  struct Collision
+  {
+    uint mPairIndex;
+    uint mManifoldStart;
+    uint mManifoldEnd;
+  };
+
+  void Collide()
+  {
+    for (uint pairIndex = mStart; pairIndex < mEnd; ++pairIndex)
+    {
+      ClientPair& clientPair = (*mPairs)[pairIndex];
+      Collider* collider1 = static_cast<Collider*>(clientPair.mClientData[0]);
+      Collider* collider2 = static_cast<Collider*>(clientPair.mClientData[1]);
+      // Convert the proxy to a collider
+      ColliderPair pair(collider1, collider2);
+
+      // Test for collision, throwing away any partial results on failure
+      uint manifoldStart = mManifolds.Size();
+      if (!mCollisionManager->TestCollision(pair, mManifolds))
+      {
+        mManifolds.Resize(manifoldStart);
+        continue;
+      }
+
+      Collision& collision = mCollisions.PushBack();
+      collision.mPairIndex = pairIndex;
+      collision.mManifoldStart = manifoldStart;
+      collision.mManifoldEnd = mManifolds.Size();
+    }
+  }
+
+  uint mStart;
+  uint mEnd;
+  ClientPairArray* mPairs;
+  Physics::CollisionManager* mCollisionManager;
+  Physics::ManifoldArray mManifolds;
+  Array<Collision, FrameAllocator> mCollisions;
+};
+
+/// Task entry that runs the narrow phase for one chunk of pairs.
+void CollideNarrowPhaseChunk(void* chunk)
+{
+  ZoneScopedN("NarrowPhaseTask");
+  static_cast<NarrowPhaseChunk*>(chunk)->Collide();
+}
+
 void PhysicsSpace::NarrowPhase()
 {
   ZoneScopedN("NarrowPhase");
   ProfileScopeTree("NarrowPhase", "Iteration", Color::Salmon);
 
   HeapAllocator allocator(mHeap);
-  Physics::ManifoldArray tempManifolds;
-  tempManifolds.SetAllocator(allocator);
+  // The chunk bookkeeping is thrown away by the end of the step
+  FrameAllocator frameAllocator(mHeap);
+
+  // Split the pairs into contiguous chunks. When there are few pairs (or no
+  // threads) everything ends up in one chunk that is run on this thread.
+  uint size = mPossiblePairs.Size();
+  uint chunkCount = 1;
+  if (ThreadingEnabled)
+    chunkCount = Math::Clamp(size / cNarrowPhasePairsPerTask, 1u, cMaxNarrowPhaseTasks);
+  uint pairsPerChunk = (size + chunkCount - 1) / chunkCount;
+
+  Array<NarrowPhaseChunk, FrameAllocator> chunks;
+  chunks.SetAllocator(frameAllocator);
+  chunks.Resize(chunkCount);
+  for (uint i = 0; i < chunkCount; ++i)
+  {
+    NarrowPhaseChunk& chunk = chunks[i];
+    chunk.mStart = Math::Min(i * pairsPerChunk, size);
+    chunk.mEnd = Math::Min(chunk.mStart + pairsPerChunk, size);
+    chunk.mPairs = &mPossiblePairs;
+    chunk.mCollisionManager = mCollisionManager;
+    chunk.mManifolds.SetAllocator(allocator);
+    chunk.mCollisions.SetAllocator(frameAllocator);
+  }
+
+  // Hand every chunk but the first to the task scheduler and test the first
+  // chunk here while the workers run. The chunks array cannot be resized until
+  // all tasks have finished.
+  TaskCounter counter;
+  for (uint i = 1; i < chunkCount; ++i)
+    PL::gJobs->AddTask(&CollideNarrowPhaseChunk, &chunks[i], &counter);
+
+  chunks[0].Collide();
+  PL::gJobs->WaitFor(counter);
 
   Array<NodePointerPair> Collisions;
   Collisions.SetAllocator(allocator);
 
-  uint size = mPossiblePairs.Size();
-  for (unsigned pairIndex = 0; pairIndex < size; ++pairIndex)
+  // Merge the chunks in pair order. The chunks are contiguous ranges of the
+  // (possibly sorted) pair list so the contacts are added in exactly the same
+  // order as testing every pair serially, which keeps determinism intact.
+  for (uint chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
   {
-    ClientPair* clientPair = &mPossiblePairs[pairIndex];
-    Collider* collider1 = static_cast<Collider*>(clientPair->mClientData[0]);
-    Collider* collider2 = static_cast<Collider*>(clientPair->mClientData[1]);
-    // Convert the proxy to a collider
-    ColliderPair pair(collider1, collider2);
-
-    // Test for collision
-    if (!mCollisionManager->TestCollision(pair, tempManifolds))
+    NarrowPhaseChunk& chunk = chunks[chunkIndex];
+    for (uint collisionIndex = 0; collisionIndex < chunk.mCollisions.Size(); ++collisionIndex)
     {
-      tempManifolds.Clear();
-      continue;
-    }
+      NarrowPhaseChunk::Collision& collision = chunk.mCollisions[collisionIndex];
 
-    // If tracking is enabled, we need to record the collision
-    if (mBroadPhase->IsTracking())
-    {
-      NodePointerPair nodePair(clientPair->mClientData[0], clientPair->mClientData[1]);
-      Collisions.PushBack(nodePair);
-    }
+      // If tracking is enabled, we need to record the collision
+      if (mBroadPhase->IsTracking())
+      {
+        ClientPair& clientPair = mPossiblePairs[collision.mPairIndex];
+        NodePointerPair nodePair(clientPair.mClientData[0], clientPair.mClientData[1]);
+        Collisions.PushBack(nodePair);
+      }
 
-    // Add all manifolds to the contact manager
-    for (uint i = 0; i < tempManifolds.Size(); ++i)
-    {
-      Physics::Manifold& manifold = tempManifolds[i];
-      mContactManager->AddManifold(tempManifolds[i]);
-      manifold.Clear();
+      // Add all manifolds to the contact manager
+      for (uint i = collision.mManifoldStart; i < collision.mManifoldEnd; ++i)
+        mContactManager->AddManifold(chunk.mManifolds[i]);
     }
-
-    tempManifolds.Clear();
   }
 
   mBroadPhase->RecordFrameResults(Collisions);
@@ -1626,7 +1813,7 @@ void PhysicsSpace::RemoveComponent(Collider* collider)
 
   u32 id = CogId(collider->GetOwner()).GetId();
 
-  HashSet<u64>::range range = mFilteredPairs.All();
+  FlatHashSet<u64>::range range = mFilteredPairs.All();
   while (!range.Empty())
   {
     u64 packedId = range.Front();
@@ -1720,9 +1907,11 @@ BroadPhasePackage* PhysicsSpace::ReplaceBroadPhase(BroadPhasePackage* newBroadPh
 
   FlushPhysicsQueue();
 
-  // Swap the broad phases
+  // Swap the broad phases. The new broad phase reports all of its pairs as
+  // beginning so the old pairs have to be forgotten.
   BroadPhasePackage* old = mBroadPhase;
   mBroadPhase = newBroadPhase;
+  ClearDynamicPairs();
 
   // Re-insert all colliders
   r = mDynamicColliders.All();
@@ -177,6 +177,10 @@ public:
   void IntegrateBodiesPosition(real dt);
   /// Updates all BroadPhases and then finds all possible collision pairs.
   void BroadPhase();
+  /// Applies the pairs that began and ended in the dynamic BroadPhase to the
+  /// kept dynamic pairs.
+  void UpdateDynamicPairs(ClientPairArray& begun, ClientPairArray& ended);
+  void ClearDynamicPairs();
   /// Takes the possible collisions from the BroadPhase step and checks if they
   /// actually collide. If they do collide then they are added to the
   /// IslandManager.
@@ -387,6 +391,12 @@ private:
   // Stores the objects returned from the broad phase for that frame.  It is
   // not created on the stack each frame to avoid allocations.
   ClientPairArray mPossiblePairs;
+  // The pairs within the dynamic broad phase. When the broad phase keeps its
+  // pairs between updates, this is kept up to date from the pairs that began
+  // and ended instead of copying every pair out of the broad phase.
+  ClientPairArray mDynamicPairs;
+  // Where each pair is in mDynamicPairs so ended pairs can be removed.
+  HashMap<NodePointerPair, uint> mDynamicPairIndices;
 
   // Stores all broad phase information.
   BroadPhasePackage* mBroadPhase;
@@ -448,7 +458,7 @@ public:
   HandleOf<CollisionTable> mCollisionTable;
 
   uint mSubStepCount;
-  HashSet<u64> mFilteredPairs;
+  FlatHashSet<u64> mFilteredPairs;
 
   // Dt of the current iteration. Stored for when I don't want to pass down dt
   // 20 layers to use in one place. The object can grab this from it's space
@@ -117,6 +117,7 @@ public:
 #include "ConstraintFragments.hpp"
 #include "ConstraintHelpers.hpp"
 #include "Contact.hpp"
+#include "ContactBatchFragments.hpp"
 #include "IConstraintSolver.hpp"
 #include "BasicSolver.hpp"
 #include "GenericBasicSolver.hpp"
@@ -1024,16 +1024,30 @@ void RigidBody::UpdateResourcesAndQueue()
 }
 
 void RigidBody::UpdateCenterMass(Vec3Param offset)
+{
+  if (UpdateCenterMassThreaded(offset))
+    Transform::NotifyClampedTranslation(GetSpace(), GetOwner());
+}
+
+bool RigidBody::UpdateCenterMassThreaded(Vec3Param offset)
 {
   mCenterOfMass += offset;
+
   // Clamp the center of mass to avoid getting to bad floating point positions
-  mCenterOfMass = Transform::ClampTranslation(GetSpace(), GetOwner(), mCenterOfMass);
+  // (the space can be null if this happens before being initialized)
+  bool wasClamped = false;
+  if (Space* space = GetSpace())
+  {
+    real maxTranslation = space->mMaxObjectPosition;
+    mCenterOfMass = Math::DebugClamp(mCenterOfMass, Vec3(-maxTranslation), Vec3(maxTranslation), wasClamped);
+  }
 
   // Bring the position offset into world space so we can update the cached
   // world-space translation
   WorldTransformation* transform = mPhysicsNode->GetTransform();
   Vec3 worldPositionOffset = Math::Transform(transform->GetWorldRotation(), mPositionOffset);
   transform->SetTranslation(mCenterOfMass + worldPositionOffset);
+  return wasClamped;
 }
 
 void RigidBody::UpdateOrientation(QuatParam offset)
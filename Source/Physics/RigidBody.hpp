@@ -322,6 +322,10 @@ public:
   /// Updates the Rigid Body's center of mass by an offset vector.
   /// Also updates the cached world transform data.
   void UpdateCenterMass(Vec3Param offset);
+  /// Same as UpdateCenterMass but a clamped position is returned instead of
+  /// reported, so it's safe to call for different bodies at the same time.
+  /// Returns true if the center of mass was clamped.
+  bool UpdateCenterMassThreaded(Vec3Param offset);
   /// Updates the Rigid Body's orientation by an offset vector (for integration,
   /// this does a small angle approximation). This updates the body's cached
   /// world transform data as we not only rotate but the position might be
@@ -13,12 +13,16 @@ struct ConstraintBatch
   ConstraintBatch()
   {
     ConstraintCount = 0;
+    MoleculeOffset = 0;
   }
   ~ConstraintBatch()
   {
     Joints.Clear();
   }
   uint ConstraintCount;
+  /// Index of this batch's first molecule in the solver's molecule array.
+  /// Lets each batch walk its own molecules independently of the others.
+  uint MoleculeOffset;
   typedef InList<JointType, &JointType::SolverLink> JointList;
   JointList Joints;
 
@@ -125,15 +129,29 @@ void GroupOperationTwoParamFragment(ConstraintGroup<typename ListType::value_typ
   }
 }
 
+/// Returns the body a constraint writes velocity to through the given
+/// collider. Static and kinematic bodies (and colliders without a body) are
+/// never written to by the solver, so they return null and can be shared by
+/// any number of batches in a phase.
+template <typename JointType>
+RigidBody* GetSolverWriteBody(JointType* joint, uint index)
+{
+  RigidBody* body = joint->GetCollider(index)->GetActiveBody();
+  if (body == nullptr || !body->IsDynamic())
+    return nullptr;
+  return body;
+}
+
 template <typename ListType>
-void SplitConstraints(ListType& joints, ConstraintGroup<typename ListType::value_type>& phases)
+void SplitConstraints(ListType& joints,
+                      ConstraintGroup<typename ListType::value_type>& phases,
+                      uint batchesPerPhase = 2)
 {
   typedef ConstraintPhase<typename ListType::value_type> PhaseType;
   typedef ConstraintBatch<typename ListType::value_type> BatchType;
 
-  HashSet<uint> bodySet;
+  HashSet<RigidBody*> bodySet;
   uint batchSize = 32;
-  uint batchesPerPhase = 2;
 
   PhaseType* phase = nullptr;
   BatchType* batch = nullptr;
@@ -160,13 +178,14 @@ void SplitConstraints(ListType& joints, ConstraintGroup<typename ListType::value
       typename ListType::pointer joint = &(range.Front());
       range.PopFront();
 
-      // get the id of the two bodies involved in this joint
-      uint idA = joint->GetCollider(0)->mId;
-      uint idB = joint->GetCollider(1)->mId;
+      // get the two bodies this joint writes velocity to. Multiple colliders
+      // can share one active body so the colliders can't be used as the key.
+      RigidBody* bodyA = GetSolverWriteBody(joint, 0);
+      RigidBody* bodyB = GetSolverWriteBody(joint, 1);
 
       // if either of the bodies have been used in this phase, then skip this
       // joint
-      if (!bodySet.Find(idA).Empty() || !bodySet.Find(idB).Empty())
+      if ((bodyA != nullptr && bodySet.Contains(bodyA)) || (bodyB != nullptr && bodySet.Contains(bodyB)))
         continue;
 
       // if adding this joint would make the batch too large, make a new batch
@@ -192,8 +211,10 @@ void SplitConstraints(ListType& joints, ConstraintGroup<typename ListType::value
       }
 
       // mark both of these bodies as being used for this phase
-      bodySet.Insert(idA);
-      bodySet.Insert(idB);
+      if (bodyA != nullptr)
+        bodySet.Insert(bodyA);
+      if (bodyB != nullptr)
+        bodySet.Insert(bodyB);
 
       // put the joint in this batch
       ListType::Unlink(joint);
@@ -204,6 +225,102 @@ void SplitConstraints(ListType& joints, ConstraintGroup<typename ListType::value
   }
 }
 
+/// Assigns each batch the offset of its first molecule. Offsets are handed out
+/// in the same order the group operations walk the batches so the molecule
+/// layout matches walking the whole group with one MoleculeWalker.
+template <typename JointType>
+void AssignMoleculeOffsets(ConstraintGroup<JointType>& group, uint& moleculeOffset)
+{
+  typedef ConstraintGroup<JointType> JointGroup;
+  typedef ConstraintPhase<JointType> JointPhase;
+
+  typename JointGroup::PhaseTypeList::range phaseRange = group.Phases.All();
+  for (; !phaseRange.Empty(); phaseRange.PopFront())
+  {
+    JointPhase& phase = phaseRange.Front();
+    typename JointPhase::JointBatches::range range = phase.Batches.All();
+    for (; !range.Empty(); range.PopFront())
+    {
+      range.Front().MoleculeOffset = moleculeOffset;
+      moleculeOffset += range.Front().ConstraintCount;
+    }
+  }
+}
+
+template <typename ListType, typename Functor>
+void BatchOperationFragment(ConstraintBatch<typename ListType::value_type>& batch,
+                            MoleculeWalker& molecules,
+                            Functor operation)
+{
+  MoleculeWalker batchMolecules = molecules;
+  batchMolecules += batch.MoleculeOffset;
+  operation(batch.Joints, batchMolecules);
+}
+
+/// Runs a group operation for a single batch as a task.
+template <typename ListType, typename Functor>
+struct ConstraintBatchTask
+{
+  static void Run(void* userData)
+  {
+    ConstraintBatchTask* task = static_cast<ConstraintBatchTask*>(userData);
+    BatchOperationFragment<ListType>(*task->mBatch, task->mMolecules, task->mOperation);
+  }
+
+  ConstraintBatch<typename ListType::value_type>* mBatch;
+  MoleculeWalker mMolecules;
+  Functor mOperation;
+};
+
+/// Same as GroupOperationParamFragment, but the batches of each phase are run
+/// in parallel on the task scheduler. Batches in a phase never share a body so
+/// they can be solved at the same time. Each phase is finished before the next
+/// one starts, which gives the same results as running the phases serially.
+template <typename ListType, typename Functor>
+void ThreadedGroupOperationFragment(ConstraintGroup<typename ListType::value_type>& group,
+                                    MoleculeWalker& molecules,
+                                    Functor operation)
+{
+  typedef ConstraintGroup<typename ListType::value_type> JointGroup;
+  typedef ConstraintPhase<typename ListType::value_type> JointPhase;
+  typedef ConstraintBatch<typename ListType::value_type> JointBatch;
+  typedef ConstraintBatchTask<ListType, Functor> BatchTask;
+
+  Array<BatchTask> tasks;
+  typename JointGroup::PhaseTypeList::range phaseRange = group.Phases.All();
+  for (; !phaseRange.Empty(); phaseRange.PopFront())
+  {
+    JointPhase& phase = phaseRange.Front();
+    typename JointPhase::JointBatches::range range = phase.Batches.All();
+    if (range.Empty())
+      continue;
+
+    // The first batch is run on this thread while the workers take the rest
+    JointBatch& firstBatch = range.Front();
+    range.PopFront();
+
+    // Tasks hold pointers into this array so it can't grow while they run
+    tasks.Clear();
+    for (typename JointPhase::JointBatches::range countRange = range; !countRange.Empty(); countRange.PopFront())
+      tasks.PushBack();
+
+    TaskCounter counter;
+    for (uint i = 0; !range.Empty(); range.PopFront(), ++i)
+    {
+      BatchTask& task = tasks[i];
+      task.mBatch = &range.Front();
+      task.mMolecules = molecules;
+      task.mOperation = operation;
+      PL::gJobs->AddTask(&BatchTask::Run, &task, &counter);
+    }
+
+    BatchOperationFragment<ListType>(firstBatch, molecules, operation);
+
+    // Barrier between phases
+    PL::gJobs->WaitFor(counter);
+  }
+}
+
 template <typename ListType>
 void CollectJoints(ListType& inList, ListType& outList)
 {
@@ -24,14 +24,26 @@ namespace Plasma
 namespace Physics
 {
 
-template <typename JointList>
-void ThreadSolveFunction(JointList& joints, MoleculeWalker molecules, uint startIndex)
+// How many batches of constraints SplitConstraints can put in one phase. This
+// is the most batches that can be solved at the same time.
+const uint cThreadedBatchesPerPhase = 8;
+
+// Solves one batch for a given velocity iteration. This is a functor instead
+// of a function so the iteration index can be carried into the batch tasks.
+template <typename ListType>
+struct ThreadSolveFunction
 {
-  MoleculeWalker mols = molecules;
-  mols += startIndex;
+  ThreadSolveFunction(uint iteration = 0) : mIteration(iteration)
+  {
+  }
 
-  IterateVelocitiesFragment(joints, mols, 0);
-}
+  void operator()(ListType& jointList, MoleculeWalker& molecules)
+  {
+    IterateVelocitiesFragmentList(jointList, molecules, mIteration);
+  }
+
+  uint mIteration;
+};
 
 ThreadedSolver::ThreadedSolver()
 {
@@ -121,11 +133,16 @@ void ThreadedSolver::UpdateData()
 
   MoleculeWalker molecules(mMolecules.Data(), sizeof(ConstraintMolecule), 0);
 
-  SplitConstraints(mContacts, mContactPhases);
-  SplitConstraints(mJoints, mJointPhases);
+  SplitConstraints(mContacts, mContactPhases, cThreadedBatchesPerPhase);
+  SplitConstraints(mJoints, mJointPhases, cThreadedBatchesPerPhase);
+
+  uint moleculeOffset = 0;
+  AssignMoleculeOffsets(mContactPhases, moleculeOffset);
+  AssignMoleculeOffsets(mJointPhases, moleculeOffset);
+  ErrorIf(moleculeOffset > mConstraintCount, "Constraint phases reference more molecules than were allocated.");
 
-  GroupOperationParamFragment<ContactList>(mContactPhases, molecules, UpdateDataFragmentList<ContactList>);
-  GroupOperationParamFragment<JointList>(mJointPhases, molecules, UpdateDataFragmentList<JointList>);
+  ThreadedGroupOperationFragment<ContactList>(mContactPhases, molecules, UpdateDataFragmentList<ContactList>);
+  ThreadedGroupOperationFragment<JointList>(mJointPhases, molecules, UpdateDataFragmentList<JointList>);
 }
 
 void ThreadedSolver::WarmStart()
@@ -135,8 +152,8 @@ void ThreadedSolver::WarmStart()
 
   MoleculeWalker molecules(mMolecules.Data(), sizeof(ConstraintMolecule), 0);
 
-  GroupOperationParamFragment<ContactList>(mContactPhases, molecules, WarmStartFragmentList<ContactList>);
-  GroupOperationParamFragment<JointList>(mJointPhases, molecules, WarmStartFragmentList<JointList>);
+  ThreadedGroupOperationFragment<ContactList>(mContactPhases, molecules, WarmStartFragmentList<ContactList>);
+  ThreadedGroupOperationFragment<JointList>(mJointPhases, molecules, WarmStartFragmentList<JointList>);
 }
 
 void ThreadedSolver::SolveVelocities()
@@ -150,10 +167,8 @@ void ThreadedSolver::IterateVelocities(uint iteration)
 {
   MoleculeWalker molecules(mMolecules.Data(), sizeof(ConstraintMolecule), 0);
 
-  GroupOperationTwoParamFragment<ContactList>(
-      mContactPhases, molecules, iteration, IterateVelocitiesFragmentList<ContactList>);
-  GroupOperationTwoParamFragment<JointList>(
-      mJointPhases, molecules, iteration, IterateVelocitiesFragmentList<JointList>);
+  ThreadedGroupOperationFragment<ContactList>(mContactPhases, molecules, ThreadSolveFunction<ContactList>(iteration));
+  ThreadedGroupOperationFragment<JointList>(mJointPhases, molecules, ThreadSolveFunction<JointList>(iteration));
 }
 
 void ThreadedSolver::SolvePositions()
@@ -194,8 +209,8 @@ void ThreadedSolver::Commit()
 {
   MoleculeWalker molecules(mMolecules.Data(), sizeof(ConstraintMolecule), 0);
 
-  GroupOperationParamFragment<ContactList>(mContactPhases, molecules, CommitFragmentList<ContactList>);
-  GroupOperationParamFragment<JointList>(mJointPhases, molecules, CommitFragmentList<JointList>);
+  ThreadedGroupOperationFragment<ContactList>(mContactPhases, molecules, CommitFragmentList<ContactList>);
+  ThreadedGroupOperationFragment<JointList>(mJointPhases, molecules, CommitFragmentList<JointList>);
 }
 
 void ThreadedSolver::BatchEvents()
@@ -0,0 +1,68 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// Platforms without file mapping read the whole file into memory instead
+
+MappedFile::MappedFile() : mData(nullptr), mSize(0), mMapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(Status& status, StringParam filePath)
+{
+  Close();
+
+  size_t size = 0;
+  byte* data = ReadFileIntoMemory(filePath.c_str(), size);
+  if (data == nullptr || size == 0)
+  {
+    if (data != nullptr)
+      plDeallocate(data);
+
+    status.SetFailed(String::Format("Failed to read file '%s'", filePath.c_str()));
+    return false;
+  }
+
+  mData = data;
+  mSize = size;
+  return true;
+}
+
+void MappedFile::Close()
+{
+  if (mData == nullptr)
+    return;
+
+  plDeallocate(mData);
+  mData = nullptr;
+  mSize = 0;
+}
+
+bool MappedFile::IsOpen()
+{
+  return mData != nullptr;
+}
+
+bool MappedFile::IsMapped()
+{
+  return mMapped;
+}
+
+const byte* MappedFile::GetData()
+{
+  return mData;
+}
+
+size_t MappedFile::GetSize()
+{
+  return mSize;
+}
+
+} // namespace Plasma
@@ -120,6 +120,11 @@ void GetMemoryStatus(MemoryInfo& data)
 {
 }
 
+uint GetHardwareThreadCount()
+{
+  return 1;
+}
+
 String GetEnvironmentalVariable(StringParam variable)
 {
   return String();
@@ -0,0 +1,87 @@
+// MIT Licensed (see LICENSE.md).
+#include "Precompiled.hpp"
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Plasma
+{
+
+MappedFile::MappedFile() : mData(nullptr), mSize(0), mMapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(Status& status, StringParam filePath)
+{
+  Close();
+
+  int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+  if (fileDescriptor == -1)
+  {
+    status.SetFailed(String::Format("Failed to open file '%s' (%s)", filePath.c_str(), strerror(errno)));
+    return false;
+  }
+
+  struct stat fileInfo;
+  if (fstat(fileDescriptor, &fileInfo) != 0 || fileInfo.st_size <= 0)
+  {
+    status.SetFailed(String::Format("Failed to get the size of file '%s'", filePath.c_str()));
+    close(fileDescriptor);
+    return false;
+  }
+
+  size_t size = (size_t)fileInfo.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+
+  // The mapping keeps its own reference to the file
+  close(fileDescriptor);
+
+  if (data == MAP_FAILED)
+  {
+    status.SetFailed(String::Format("Failed to map file '%s' (%s)", filePath.c_str(), strerror(errno)));
+    return false;
+  }
+
+  mData = (byte*)data;
+  mSize = size;
+  mMapped = true;
+  return true;
+}
+
+void MappedFile::Close()
+{
+  if (mData == nullptr)
+    return;
+
+  munmap(mData, mSize);
+  mData = nullptr;
+  mSize = 0;
+  mMapped = false;
+}
+
+bool MappedFile::IsOpen()
+{
+  return mData != nullptr;
+}
+
+bool MappedFile::IsMapped()
+{
+  return mMapped;
+}
+
+const byte* MappedFile::GetData()
+{
+  return mData;
+}
+
+size_t MappedFile::GetSize()
+{
+  return mSize;
+}
+
+} // namespace Plasma
@@ -248,6 +248,11 @@ void GetMemoryStatus(MemoryInfo& data)
 }
 #endif
 
+uint GetHardwareThreadCount()
+{
+  return (uint)Math::Max(SDL_GetCPUCount(), 1);
+}
+
 String GetVersionString()
 {
   SDL_version version;
@@ -331,6 +331,13 @@ void GetMemoryStatus(MemoryInfo& data)
   }
 }
 
+uint GetHardwareThreadCount()
+{
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  return Math::Max((uint)systemInfo.dwNumberOfProcessors, 1u);
+}
+
 typedef void(WINAPI* GetNativeSystemInfoPtr)(LPSYSTEM_INFO);
 
 String GetVersionString()
@@ -112,6 +112,12 @@ bool AttenuatorNode::GetOutputSamples(BufferType* outputBuffer,
 {
   unsigned bufferSize = outputBuffer->Size();
 
+  // Check if the listener needs to be added to the map. This is done before
+  // getting input so that the attenuation can still be estimated for instances
+  // which are not currently producing audio.
+  if (listener && !DataPerListener.FindValue(listener, nullptr))
+    DataPerListener[listener] = new AttenuationPerListener();
+
   // Get input and return if there is no data
   if (!AccumulateInputSamples(bufferSize, numberOfChannels, listener))
     return false;
@@ -123,43 +129,17 @@ bool AttenuatorNode::GetOutputSamples(BufferType* outputBuffer,
     return true;
   }
 
-  // Get the relative position with the listener
-  Math::Vec3 relativePosition = listener->GetRelativePositionThreaded(mPosition.Get(AudioThreads::MixThread));
-  // Save the distance value
-  float distance = relativePosition.Length();
-
-  // Account for the listener's attenuation scale (this is supposed to act like
-  // a multiplier on the start and end distances)
-  if (listener->GetAttenuationScale() <= 0.0f)
-    distance = mAttenEndDist.Get(AudioThreads::MixThread);
-  else
-    distance /= listener->GetAttenuationScale();
+  float distance = GetDistanceThreaded(listener);
 
   // If we are outside the max distance and the minimum volume is plasma, there is
   // no audio
   if (distance >= mAttenEndDist.Get(AudioThreads::MixThread) && mMinimumVolume.Get(AudioThreads::MixThread) == 0.0f)
+  {
+    DataPerListener[listener]->PreviousVolume = 0.0f;
     return false;
+  }
 
-  float attenuatedVolume;
-  // If the distance is further than the attenuation end distance, the volume is
-  // the end volume
-  if (distance >= mAttenEndDist.Get(AudioThreads::MixThread))
-    attenuatedVolume = mMinimumVolume.Get(AudioThreads::MixThread);
-  // If the distance is less than the attenuation start distance, the volume is
-  // not attenuated
-  else if (distance <= mAttenStartDist.Get(AudioThreads::MixThread))
-    attenuatedVolume = 1.0f;
-  // If the attenuation start and end are too close together than just use end
-  // volume
-  else if (mAttenEndDist.Get(AudioThreads::MixThread) - mAttenStartDist.Get(AudioThreads::MixThread) <= 0.1f)
-    attenuatedVolume = mMinimumVolume.Get(AudioThreads::MixThread);
-  // Otherwise, get the value using the falloff curve on the interpolator
-  else
-    attenuatedVolume = DistanceInterpolator.ValueAtDistance(distance - mAttenStartDist.Get(AudioThreads::MixThread));
-
-  // Check if the listener needs to be added to the map
-  if (!DataPerListener.FindValue(listener, nullptr))
-    DataPerListener[listener] = new AttenuationPerListener();
+  float attenuatedVolume = GetVolumeAtDistanceThreaded(distance);
 
   AttenuationPerListener& listenerData = *DataPerListener[listener];
 
@@ -206,10 +186,16 @@ float AttenuatorNode::GetVolumeChangeFromOutputsThreaded()
   forRange (HandleOf<SoundNode> node, GetOutputs(AudioThreads::MixThread)->All())
     volume += node->GetVolumeChangeFromOutputsThreaded();
 
-  // If there are multiple listeners, the sounds they hear are added together
+  // If no listener has requested output yet, assume the volume isn't attenuated
+  if (DataPerListener.Empty())
+    return volume;
+
+  // If there are multiple listeners, the sounds they hear are added together.
+  // The volume is calculated from the current positions rather than using the
+  // previous volume, which is out of date if the input has stopped producing audio.
   float attenuatorVolume = 0.0f;
-  forRange (AttenuationPerListener* data, DataPerListener.Values())
-    attenuatorVolume += data->PreviousVolume;
+  forRange (DataPerListenerMapType::pair mapPair, DataPerListener.All())
+    attenuatorVolume += GetVolumeAtDistanceThreaded(GetDistanceThreaded(mapPair.first));
 
   // Return the output volume modified by this node's volume
   return volume * attenuatorVolume;
@@ -228,6 +214,42 @@ void AttenuatorNode::RemoveListenerThreaded(SoundEvent* event)
   }
 }
 
+float AttenuatorNode::GetDistanceThreaded(ListenerNode* listener)
+{
+  // Get the relative position with the listener
+  Math::Vec3 relativePosition = listener->GetRelativePositionThreaded(mPosition.Get(AudioThreads::MixThread));
+  // Save the distance value
+  float distance = relativePosition.Length();
+
+  // Account for the listener's attenuation scale (this is supposed to act like
+  // a multiplier on the start and end distances)
+  if (listener->GetAttenuationScale() <= 0.0f)
+    distance = mAttenEndDist.Get(AudioThreads::MixThread);
+  else
+    distance /= listener->GetAttenuationScale();
+
+  return distance;
+}
+
+float AttenuatorNode::GetVolumeAtDistanceThreaded(float distance)
+{
+  // If the distance is further than the attenuation end distance, the volume is
+  // the end volume
+  if (distance >= mAttenEndDist.Get(AudioThreads::MixThread))
+    return mMinimumVolume.Get(AudioThreads::MixThread);
+  // If the distance is less than the attenuation start distance, the volume is
+  // not attenuated
+  else if (distance <= mAttenStartDist.Get(AudioThreads::MixThread))
+    return 1.0f;
+  // If the attenuation start and end are too close together than just use end
+  // volume
+  else if (mAttenEndDist.Get(AudioThreads::MixThread) - mAttenStartDist.Get(AudioThreads::MixThread) <= 0.1f)
+    return mMinimumVolume.Get(AudioThreads::MixThread);
+  // Otherwise, get the value using the falloff curve on the interpolator
+  else
+    return DistanceInterpolator.ValueAtDistance(distance - mAttenStartDist.Get(AudioThreads::MixThread));
+}
+
 void AttenuatorNode::UpdateDistanceInterpolator()
 {
   DistanceInterpolator.SetValues(1.0f,
@@ -61,6 +61,10 @@ private:
                         const bool firstRequest) override;
   float GetVolumeChangeFromOutputsThreaded() override;
   void RemoveListenerThreaded(SoundEvent* event) override;
+  // Returns the distance to the listener, adjusted by its attenuation scale
+  float GetDistanceThreaded(ListenerNode* listener);
+  // Returns the attenuated volume at the specified distance
+  float GetVolumeAtDistanceThreaded(float distance);
   void UpdateDistanceInterpolator();
   void UpdateLowPassInterpolator();
 
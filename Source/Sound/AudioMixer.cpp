@@ -95,6 +95,12 @@ void AudioMixer::StartMixing(Status& status)
     }
 
     PlasmaPrint("Audio mix thread initialized\n");
+
+    // Start up the threads that help the mix thread evaluate independent nodes
+    MixHelpers.Start();
+
+    // Start up the threads that decode streaming audio
+    StreamDecoders.Start();
   }
 
   // Start audio output stream
@@ -121,6 +127,13 @@ void AudioMixer::ShutDown()
     MixThread.Close();
   }
 
+  // Nothing uses the helper threads once the mix thread is done
+  MixHelpers.ShutDown();
+  // Release the playing SoundInstances
+  Voices.ShutDown();
+  // Nothing reads streaming audio once the mix thread is done
+  StreamDecoders.ShutDown();
+
   // Shut down audio output, input, and API
   AudioIO.StopStreams(true, true);
   AudioIO.ShutDown();
@@ -277,6 +290,11 @@ void AudioMixer::SetMinimumVolumeThreshold(const float volume)
   AddTask(CreateFunctor(&AudioMixer::mMinimumVolumeThresholdThreaded, this, volume), nullptr);
 }
 
+void AudioMixer::SetMaxRealVoices(const unsigned voices)
+{
+  AddTask(CreateFunctor(&VoiceManager::mMaxRealVoicesThreaded, &Voices, voices), nullptr);
+}
+
 void AudioMixer::SetSendUncompressedMicInput(const bool sendInput)
 {
   if (sendInput == mSendMicrophoneInputUncompressed)
@@ -369,11 +387,17 @@ bool AudioMixer::MixCurrentInstancesThreaded()
   // Resize BufferForOutput to match samples needed
   BufferForOutput.Resize(mixFrames * mixChannels);
 
+  // Decide which SoundInstances will process audio in this mix
+  Voices.UpdateThreaded(mixFrames);
+
   // Get samples from output node
   bool isThereData = FinalOutputNode->GetOutputSamples(&BufferForOutput, mixChannels, nullptr, true);
 
   ++mMixVersionThreaded;
 
+  // Refill the streaming audio that was read during this mix
+  StreamDecoders.UpdateThreaded(mixFrames);
+
   // Set the size of the MixedOutput buffer
   MixedOutput.Resize(samplesNeeded);
 
@@ -27,8 +27,9 @@ public:
   AudioMixer();
 
   // Sets up variables, initializes audio input and output, starts mix thread
+  // and mix helper threads
   void StartMixing(Status& status);
-  // Shuts down the mix thread, shuts down audio output
+  // Shuts down the mix thread and mix helper threads, shuts down audio output
   void ShutDown();
   // Update function on the main thread, should be called every game update
   void Update();
@@ -63,6 +64,8 @@ public:
   float GetRMSOutputVolume();
   // Sets the minimum volume at which SoundInstances will process audio.
   void SetMinimumVolumeThreshold(const float volume);
+  // Sets the maximum number of SoundInstances that will process audio at once.
+  void SetMaxRealVoices(const unsigned voices);
   // If true, events will be sent with microphone input data as float samples
   void SetSendUncompressedMicInput(const bool sendInput);
   // If true, events will be sent with compressed microphone input data as bytes
@@ -95,6 +98,12 @@ public:
   HandleOf<OutputNode> FinalOutputNode;
   // The interface for audio input and output
   AudioIOInterface AudioIO;
+  // Threads which help the mix thread evaluate the sound node graph
+  MixHelperThreads MixHelpers;
+  // Decides which SoundInstances process audio
+  VoiceManager Voices;
+  // Threads which decode streaming audio ahead of the mix
+  StreamDecodingThreads StreamDecoders;
 
 private:
   // Adds current sounds into the output buffer. Will return false when the
@@ -616,8 +616,7 @@ bool HighPassNode::GetOutputSamples(BufferType* outputBuffer,
   }
 
   // Apply filter
-  for (unsigned i = 0; i < bufferSize; i += numberOfChannels)
-    filter->ProcessFrame(mInputSamplesThreaded.Data() + i, outputBuffer->Data() + i, numberOfChannels);
+  filter->ProcessBuffer(mInputSamplesThreaded.Data(), outputBuffer->Data(), numberOfChannels, bufferSize);
 
   AddBypassThreaded(outputBuffer);
 
@@ -718,8 +717,7 @@ bool BandPassNode::GetOutputSamples(BufferType* outputBuffer,
   }
 
   // Apply filter
-  for (unsigned i = 0; i < bufferSize; i += numberOfChannels)
-    filter->ProcessFrame(mInputSamplesThreaded.Data() + i, outputBuffer->Data() + i, numberOfChannels);
+  filter->ProcessBuffer(mInputSamplesThreaded.Data(), outputBuffer->Data(), numberOfChannels, bufferSize);
 
   AddBypassThreaded(outputBuffer);
 
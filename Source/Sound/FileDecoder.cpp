@@ -118,6 +118,28 @@ unsigned PacketDecoder::OpenAndReadHeader(Status& status, const String& fileName
   return (unsigned)size - sizeof(FileHeader);
 }
 
+unsigned PacketDecoder::ReadHeader(Status& status, DataBlock fileData, FileHeader* header)
+{
+  // Check for an invalid size
+  if (fileData.Data == nullptr || fileData.Size < sizeof(FileHeader))
+  {
+    status.SetFailed("Unable to read audio data");
+    return 0;
+  }
+
+  memcpy((void*)header, fileData.Data, sizeof(FileHeader));
+
+  // If this isn't the right type of file, set the failed message and return
+  if (header->Name[0] != 'Z' || header->Name[1] != 'E')
+  {
+    status.SetFailed("Audio data is an incorrect format");
+    return 0;
+  }
+
+  // Return the size of the data excluding the header
+  return (unsigned)fileData.Size - sizeof(FileHeader);
+}
+
 bool PacketDecoder::CreateDecoders(Status& status, OpusDecoder** decoderArray, int howMany)
 {
   int error;
@@ -146,6 +168,23 @@ bool PacketDecoder::CreateDecoders(Status& status, OpusDecoder** decoderArray, i
   return true;
 }
 
+bool PacketDecoder::CopyDecoders(Status& status,
+                                 OpusDecoder** decoderArray,
+                                 OpusDecoder* const* sourceArray,
+                                 int howMany)
+{
+  if (!CreateDecoders(status, decoderArray, howMany))
+    return false;
+
+  // Opus decoder state is a single block of memory with no pointers, so it can
+  // be copied directly
+  int decoderSize = opus_decoder_get_size(1);
+  for (int i = 0; i < howMany; ++i)
+    memcpy(decoderArray[i], sourceArray[i], decoderSize);
+
+  return true;
+}
+
 void PacketDecoder::DestroyDecoders(OpusDecoder** decoderArray, int howMany)
 {
   // Destroy each decoder if it exists
@@ -367,7 +406,8 @@ DecompressedDecoder::DecompressedDecoder(Status& status,
     AudioFileDecoder(0, 0, callback, callbackData),
     mCompressedData(nullptr),
     mDataIndex(0),
-    mDataSize(0)
+    mDataSize(0),
+    mOwnsData(true)
 {
   // If no valid callback was provided, don't do anything
   if (!callback)
@@ -389,6 +429,40 @@ DecompressedDecoder::DecompressedDecoder(Status& status,
   StartDecodingThread();
 }
 
+DecompressedDecoder::DecompressedDecoder(Status& status,
+                                         DataBlock fileData,
+                                         FileDecoderCallback callback,
+                                         void* callbackData) :
+    AudioFileDecoder(0, 0, callback, callbackData),
+    mCompressedData(nullptr),
+    mDataIndex(0),
+    mDataSize(0),
+    mOwnsData(false)
+{
+  // If no valid callback was provided, don't do anything
+  if (!callback)
+    return;
+
+  // Decode straight from the data after the header
+  FileHeader header;
+  mDataSize = PacketDecoder::ReadHeader(status, fileData, &header);
+  if (status.Failed())
+    return;
+
+  mCompressedData = fileData.Data + sizeof(FileHeader);
+  mSamplesPerChannel = header.SamplesPerChannel;
+  mChannels = header.Channels;
+
+  // Create a decoder for each channel
+  if (!PacketDecoder::CreateDecoders(status, mDecoders, mChannels))
+  {
+    ClearData();
+    return;
+  }
+
+  StartDecodingThread();
+}
+
 DecompressedDecoder::~DecompressedDecoder()
 {
   ClearData();
@@ -456,10 +530,11 @@ void DecompressedDecoder::ClearData()
 {
   AudioFileDecoder::ClearData();
 
-  // If there is data in the buffer, delete it
+  // If there is data in the buffer, delete it (if it's ours)
   if (mCompressedData)
   {
-    delete[] mCompressedData;
+    if (mOwnsData)
+      delete[] mCompressedData;
     mCompressedData = nullptr;
   }
 }
@@ -486,11 +561,9 @@ StreamingDecoder::StreamingDecoder(Status& status,
   if (!callback || !inputFile->IsOpen())
     return;
 
-  // If creating the decoders fails then return without starting the thread
-  if (!PacketDecoder::CreateDecoders(status, mDecoders, mChannels))
-    return;
-
-  StartDecodingThread();
+  // Packets are decoded by the StreamDecodingThreads, so no decoding thread
+  // is started
+  PacketDecoder::CreateDecoders(status, mDecoders, mChannels);
 }
 
 StreamingDecoder::StreamingDecoder(Status& status,
@@ -512,11 +585,33 @@ StreamingDecoder::StreamingDecoder(Status& status,
   if (!callback || !inputData)
     return;
 
-  // If creating the decoders fails then return without starting the thread
-  if (!PacketDecoder::CreateDecoders(status, mDecoders, mChannels))
+  // Packets are decoded by the StreamDecodingThreads, so no decoding thread
+  // is started
+  PacketDecoder::CreateDecoders(status, mDecoders, mChannels);
+}
+
+StreamingDecoder::StreamingDecoder(Status& status,
+                                   const StreamingDecoder& other,
+                                   FileDecoderCallback callback,
+                                   void* callbackData) :
+    AudioFileDecoder(other.mChannels, other.mSamplesPerChannel, callback, callbackData),
+    mCompressedData(other.mCompressedData),
+    mDataIndex(other.mDataIndex),
+    mDataSize(other.mDataSize),
+    mInputFile(other.mInputFile),
+    mFilePosition(other.mFilePosition),
+    mLock(other.mLock)
+{
+  // If the other decoder has nothing to decode, neither does this one
+  if (!callback || !other.mDecoders[0])
     return;
 
-  StartDecodingThread();
+  PacketDecoder::CopyDecoders(status, mDecoders, other.mDecoders, mChannels);
+}
+
+StreamingDecoder::~StreamingDecoder()
+{
+  ClearData();
 }
 
 void StreamingDecoder::DecodingLoopThreaded()
@@ -545,29 +640,13 @@ int StreamingDecoder::GetNextPacket(byte* packetData)
     return PacketDecoder::GetPacketFromFile(packetData, mInputFile, &mFilePosition, mLock);
 }
 
-void StreamingDecoder::Reset()
+bool StreamingDecoder::DecodeNextPacketThreaded()
 {
-  // Stop any current decoding
-  StopDecodingThread();
-
-  // Reset the semaphore and shut down signal
-  DecodingSemaphore.Reset();
-  mShutDownSignal.Set(cFalse);
-
-  // Reset the read positions
-  mDataIndex = 0;
-  mFilePosition = sizeof(FileHeader);
-
-  // Destroy the current decoders (since they rely on history for decoding, they
-  // can't continue from the beginning of the file)
-  ClearData();
+  // If the decoders weren't created there is nothing to decode
+  if (!mDecoders[0])
+    return false;
 
-  // Create new decoders
-  Status status;
-  PacketDecoder::CreateDecoders(status, mDecoders, mChannels);
-
-  // Restart the decoding thread
-  StartDecodingThread();
+  return DecodePacketThreaded();
 }
 
 } // namespace Plasma
@@ -63,9 +63,15 @@ public:
   // Reads the header data of the file into the object and returns the size of
   // the file's data
   static unsigned OpenAndReadHeader(Plasma::Status& status, const String& fileName, File* file, FileHeader* header);
+  // Reads the header of a file that is already in memory and returns the size
+  // of the file's data (which follows the header)
+  static unsigned ReadHeader(Plasma::Status& status, DataBlock fileData, FileHeader* header);
   // Creates the requested number of opus decoders, returns false if
   // unsuccessful
   static bool CreateDecoders(Status& status, OpusDecoder** decoderArray, int howMany);
+  // Creates the requested number of opus decoders with the same decoding state
+  // as the source decoders, returns false if unsuccessful
+  static bool CopyDecoders(Status& status, OpusDecoder** decoderArray, OpusDecoder* const* sourceArray, int howMany);
   // Destroys the requested number of opus decoders, setting the pointers to
   // null
   static void DestroyDecoders(OpusDecoder** decoderArray, int howMany);
@@ -139,6 +145,12 @@ public:
                       const Plasma::String& fileName,
                       FileDecoderCallback callback,
                       void* callbackData);
+  // The file data must stay valid for as long as the decoder exists, and will
+  // not be deleted by this decoder
+  DecompressedDecoder(Plasma::Status& status,
+                      DataBlock fileData,
+                      FileDecoderCallback callback,
+                      void* callbackData);
   ~DecompressedDecoder();
 
   // Should only be called when starting the decoding thread
@@ -159,6 +171,9 @@ private:
   unsigned mDataIndex;
   // The size of the compressed data
   unsigned mDataSize;
+  // If true, the compressed data was read in from the file and is deleted by
+  // this decoder
+  bool mOwnsData;
 };
 
 // Streaming Decoder
@@ -184,14 +199,23 @@ public:
                    unsigned frames,
                    FileDecoderCallback callback,
                    void* callbackData);
+  // Continues decoding from the other decoder's current position, reading from
+  // the same data or file
+  StreamingDecoder(Plasma::Status& status,
+                   const StreamingDecoder& other,
+                   FileDecoderCallback callback,
+                   void* callbackData);
+  ~StreamingDecoder();
 
   // Should only be called when starting the decoding thread
   void DecodingLoopThreaded() override;
   // Fills in the provided buffer with the next packet data. Returns -1 if
   // getting packet fails or if the end of the data was reached.
   int GetNextPacket(byte* packetData) override;
-  // Resets streaming decoding to the beginning
-  void Reset();
+  // Decodes the next packet and passes it to the callback. Returns false if the
+  // end of the data was reached. Used by the StreamDecodingThreads instead of a
+  // decoding thread for each stream.
+  bool DecodeNextPacketThreaded();
 
 private:
   // The data read in from the file, if streaming from memory (will not be
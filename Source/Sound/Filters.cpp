@@ -2,6 +2,10 @@
 
 #include "Precompiled.hpp"
 
+#if defined(PlasmaSse2)
+#  include <emmintrin.h>
+#endif
+
 namespace Plasma
 {
 
@@ -50,6 +54,153 @@ void BiQuad::AddHistoryTo(BiQuad& otherFilter)
   otherFilter.y_2 += y_2;
 }
 
+// Multichannel BiQuad Filter
+
+MultiChannelBiQuad::MultiChannelBiQuad() : a0(0), a1(0), a2(0), b1(0), b2(0)
+{
+  FlushDelays();
+}
+
+void MultiChannelBiQuad::FlushDelays()
+{
+  memset(x_1, 0, sizeof(float) * cMaxChannels);
+  memset(x_2, 0, sizeof(float) * cMaxChannels);
+  memset(y_1, 0, sizeof(float) * cMaxChannels);
+  memset(y_2, 0, sizeof(float) * cMaxChannels);
+}
+
+void MultiChannelBiQuad::SetValues(const float a0_, const float a1_, const float a2_, const float b1_, const float b2_)
+{
+  a0 = a0_;
+  a1 = a1_;
+  a2 = a2_;
+  b1 = b1_;
+  b2 = b2_;
+}
+
+void MultiChannelBiQuad::ProcessFrame(const float* input, float* output, const unsigned numChannels)
+{
+  ProcessBuffer(input, output, numChannels, numChannels);
+}
+
+#if defined(PlasmaSse2)
+// One step of the filter for every lane, in the same order as the scalar
+// version so both give the same results
+static inline __m128 BiQuadStepSse(__m128 x, __m128& x1, __m128& x2, __m128& y1, __m128& y2, const __m128* values)
+{
+  __m128 y = _mm_mul_ps(values[0], x);
+  y = _mm_add_ps(y, _mm_mul_ps(values[1], x1));
+  y = _mm_add_ps(y, _mm_mul_ps(values[2], x2));
+  y = _mm_sub_ps(y, _mm_mul_ps(values[3], y1));
+  y = _mm_sub_ps(y, _mm_mul_ps(values[4], y2));
+
+  y2 = y1;
+  y1 = y;
+  x2 = x1;
+  x1 = x;
+  return y;
+}
+
+// Loads and stores two floats in the low half of a register
+static inline __m128 LoadPairSse(const float* values)
+{
+  return _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)values);
+}
+
+static inline void StorePairSse(float* values, __m128 pair)
+{
+  _mm_storel_pi((__m64*)values, pair);
+}
+#endif
+
+void MultiChannelBiQuad::ProcessBuffer(const float* input,
+                                       float* output,
+                                       const unsigned numChannels,
+                                       const unsigned bufferSize)
+{
+  ErrorIf(numChannels > cMaxChannels, "Audio Engine: Too many channels passed to BiQuad filter");
+
+  unsigned channel = 0;
+
+#if defined(PlasmaSse2)
+  __m128 values[5] = {_mm_set1_ps(a0), _mm_set1_ps(a1), _mm_set1_ps(a2), _mm_set1_ps(b1), _mm_set1_ps(b2)};
+
+  // Each group of four channels is filtered through the whole buffer with its
+  // history kept in registers
+  for (; channel + 4 <= numChannels; channel += 4)
+  {
+    __m128 x1 = _mm_loadu_ps(x_1 + channel);
+    __m128 x2 = _mm_loadu_ps(x_2 + channel);
+    __m128 y1 = _mm_loadu_ps(y_1 + channel);
+    __m128 y2 = _mm_loadu_ps(y_2 + channel);
+
+    for (unsigned i = channel; i < bufferSize; i += numChannels)
+      _mm_storeu_ps(output + i, BiQuadStepSse(_mm_loadu_ps(input + i), x1, x2, y1, y2, values));
+
+    _mm_storeu_ps(x_1 + channel, x1);
+    _mm_storeu_ps(x_2 + channel, x2);
+    _mm_storeu_ps(y_1 + channel, y1);
+    _mm_storeu_ps(y_2 + channel, y2);
+  }
+
+  // A remaining pair of channels (such as stereo) uses half a register
+  if (channel + 2 <= numChannels)
+  {
+    __m128 x1 = LoadPairSse(x_1 + channel);
+    __m128 x2 = LoadPairSse(x_2 + channel);
+    __m128 y1 = LoadPairSse(y_1 + channel);
+    __m128 y2 = LoadPairSse(y_2 + channel);
+
+    for (unsigned i = channel; i < bufferSize; i += numChannels)
+      StorePairSse(output + i, BiQuadStepSse(LoadPairSse(input + i), x1, x2, y1, y2, values));
+
+    StorePairSse(x_1 + channel, x1);
+    StorePairSse(x_2 + channel, x2);
+    StorePairSse(y_1 + channel, y1);
+    StorePairSse(y_2 + channel, y2);
+    channel += 2;
+  }
+#endif
+
+  // Any channels left are filtered one at a time
+  for (; channel < numChannels; ++channel)
+  {
+    float x1 = x_1[channel];
+    float x2 = x_2[channel];
+    float y1 = y_1[channel];
+    float y2 = y_2[channel];
+
+    for (unsigned i = channel; i < bufferSize; i += numChannels)
+    {
+      float x = input[i];
+      float y = (a0 * x) + (a1 * x1) + (a2 * x2) - (b1 * y1) - (b2 * y2);
+
+      y2 = y1;
+      y1 = y;
+      x2 = x1;
+      x1 = x;
+
+      output[i] = y;
+    }
+
+    x_1[channel] = x1;
+    x_2[channel] = x2;
+    y_1[channel] = y1;
+    y_2[channel] = y2;
+  }
+}
+
+void MultiChannelBiQuad::AddHistoryTo(MultiChannelBiQuad& otherFilter)
+{
+  for (unsigned i = 0; i < cMaxChannels; ++i)
+  {
+    otherFilter.x_1[i] += x_1[i];
+    otherFilter.x_2[i] += x_2[i];
+    otherFilter.y_1[i] += y_1[i];
+    otherFilter.y_2[i] += y_2[i];
+  }
+}
+
 // Delay Filter
 
 Delay::Delay(float maxDelayTime, int sampleRate) :
@@ -149,6 +300,57 @@ void Delay::ProcessAudio(const float input, float* output)
   WriteDelayAndInc(input);
 }
 
+void Delay::ProcessBlock(const float* input, float* output, const unsigned count)
+{
+  float fraction = mDelayInSamples - (int)mDelayInSamples;
+  bool noDelay = mDelayInSamples == 0;
+
+  for (int remaining = (int)count; remaining > 0;)
+  {
+    int samples = GetContiguousSamples(remaining);
+    float* write = mBuffer + mWriteIndex;
+    const float* read = mBuffer + mReadIndex;
+    const float* prevRead = mBuffer + mPrevReadIndex;
+
+    for (int i = 0; i < samples; ++i)
+    {
+      float inputSample = input[i];
+      if (noDelay)
+        output[i] = inputSample * mOutputAttenuation;
+      else
+        output[i] = (prevRead[i] + ((read[i] - prevRead[i]) * fraction)) * mOutputAttenuation;
+      write[i] = inputSample;
+    }
+
+    AdvanceIndexes(samples);
+    input += samples;
+    output += samples;
+    remaining -= samples;
+  }
+}
+
+int Delay::GetContiguousSamples(const int count)
+{
+  int samples = Math::Min(count, mBufferSize - mWriteIndex);
+  samples = Math::Min(samples, mBufferSize - mReadIndex);
+  return Math::Min(samples, mBufferSize - mPrevReadIndex);
+}
+
+void Delay::AdvanceIndexes(const int count)
+{
+  mWriteIndex += count;
+  if (mWriteIndex == mBufferSize)
+    mWriteIndex = 0;
+
+  mReadIndex += count;
+  if (mReadIndex == mBufferSize)
+    mReadIndex = 0;
+
+  mPrevReadIndex += count;
+  if (mPrevReadIndex == mBufferSize)
+    mPrevReadIndex = 0;
+}
+
 // DelayAPF Filter
 
 DelayAPF::DelayAPF(const float maxDelayTime, const int sampleRate) : mAPFg(0), Delay(maxDelayTime, sampleRate)
@@ -173,6 +375,43 @@ void DelayAPF::ProcessAudio(const float input, float* output)
   WriteDelayAndInc(inputWithDelay);
 }
 
+void DelayAPF::ProcessBlock(const float* input, float* output, const unsigned count)
+{
+  float fraction = mDelayInSamples - (int)mDelayInSamples;
+  // The read and write indexes move together, so this is the same for the
+  // whole block
+  bool passThrough = mReadIndex == mWriteIndex;
+
+  for (int remaining = (int)count; remaining > 0;)
+  {
+    int samples = GetContiguousSamples(remaining);
+    float* write = mBuffer + mWriteIndex;
+    const float* read = mBuffer + mReadIndex;
+    const float* prevRead = mBuffer + mPrevReadIndex;
+
+    for (int i = 0; i < samples; ++i)
+    {
+      float inputSample = input[i];
+      if (passThrough)
+      {
+        write[i] = inputSample;
+        output[i] = inputSample;
+        continue;
+      }
+
+      float delayedSample = prevRead[i] + ((read[i] - prevRead[i]) * fraction);
+      float inputWithDelay = inputSample + (mAPFg * delayedSample);
+      output[i] = delayedSample + (-mAPFg * inputWithDelay);
+      write[i] = inputWithDelay;
+    }
+
+    AdvanceIndexes(samples);
+    input += samples;
+    output += samples;
+    remaining -= samples;
+  }
+}
+
 // Comb Filter
 
 Comb::Comb(const float maxDelayTime, const int sampleRate) : mCombG(0), Delay(maxDelayTime, sampleRate)
@@ -198,6 +437,40 @@ void Comb::ProcessAudio(const float input, float* output)
   WriteDelayAndInc(input + (mCombG * (*output)));
 }
 
+void Comb::ProcessBlock(const float* input, float* output, const unsigned count)
+{
+  float fraction = mDelayInSamples - (int)mDelayInSamples;
+  bool passThrough = mReadIndex == mWriteIndex;
+
+  for (int remaining = (int)count; remaining > 0;)
+  {
+    int samples = GetContiguousSamples(remaining);
+    float* write = mBuffer + mWriteIndex;
+    const float* read = mBuffer + mReadIndex;
+    const float* prevRead = mBuffer + mPrevReadIndex;
+
+    for (int i = 0; i < samples; ++i)
+    {
+      float inputSample = input[i];
+      if (passThrough)
+      {
+        write[i] = inputSample;
+        output[i] = inputSample;
+        continue;
+      }
+
+      float delayedSample = prevRead[i] + ((read[i] - prevRead[i]) * fraction);
+      output[i] = delayedSample;
+      write[i] = inputSample + (mCombG * delayedSample);
+    }
+
+    AdvanceIndexes(samples);
+    input += samples;
+    output += samples;
+    remaining -= samples;
+  }
+}
+
 // Low Pass Comb Filter
 
 LPComb::LPComb(const float maxDelayTime, const int sampleRate) :
@@ -236,6 +509,44 @@ void LPComb::ProcessAudio(const float input, float* output)
   WriteDelayAndInc(*output);
 }
 
+void LPComb::ProcessBlock(const float* input, float* output, const unsigned count)
+{
+  float fraction = mDelayInSamples - (int)mDelayInSamples;
+  bool passThrough = mReadIndex == mWriteIndex;
+  float prevSample = mPrevSample;
+
+  for (int remaining = (int)count; remaining > 0;)
+  {
+    int samples = GetContiguousSamples(remaining);
+    float* write = mBuffer + mWriteIndex;
+    const float* read = mBuffer + mReadIndex;
+    const float* prevRead = mBuffer + mPrevReadIndex;
+
+    for (int i = 0; i < samples; ++i)
+    {
+      float inputSample = input[i];
+      if (passThrough)
+      {
+        write[i] = inputSample;
+        output[i] = inputSample;
+        continue;
+      }
+
+      prevSample = prevRead[i] + ((read[i] - prevRead[i]) * fraction) + (mLPFg * prevSample);
+      float outputSample = inputSample + (mCombG * prevSample);
+      output[i] = outputSample;
+      write[i] = outputSample;
+    }
+
+    AdvanceIndexes(samples);
+    input += samples;
+    output += samples;
+    remaining -= samples;
+  }
+
+  mPrevSample = prevSample;
+}
+
 // Pole Low Pass Filter
 
 OnePoleLP::OnePoleLP() : mLPFg(0), mPrevSample(0)
@@ -260,14 +571,23 @@ void OnePoleLP::ProcessAudio(const float input, float* output)
   mPrevSample = *output;
 }
 
+void OnePoleLP::ProcessBlock(const float* input, float* output, const unsigned count)
+{
+  float prevSample = mPrevSample;
+  for (unsigned i = 0; i < count; ++i)
+  {
+    prevSample = (input[i] * mInvG) + (mLPFg * prevSample);
+    output[i] = prevSample;
+  }
+
+  mPrevSample = prevSample;
+}
+
 // Low Pass Filter
 
 LowPassFilter::LowPassFilter() : CutoffFrequency(20001.0f), HalfPI(Math::cPi / 2.0f), SqRoot2(Math::Sqrt(2.0f))
 {
   SetCutoffValues();
-
-  for (unsigned i = 0; i < cMaxChannels; ++i)
-    BiQuadsPerChannel[i].FlushDelays();
 }
 
 void LowPassFilter::SetCutoffValues()
@@ -284,8 +604,7 @@ void LowPassFilter::SetCutoffValues()
   float beta1 = 2.0f * alpha * (1.0f - Csq);
   float beta2 = alpha * (1.0f - (SqRoot2 * C) + Csq);
 
-  for (unsigned i = 0; i < cMaxChannels; ++i)
-    BiQuadsPerChannel[i].SetValues(alpha, 2.0f * alpha, alpha, beta1, beta2);
+  BiQuadChannels.SetValues(alpha, 2.0f * alpha, alpha, beta1, beta2);
 }
 
 void LowPassFilter::SetCutoffFrequency(float value)
@@ -296,10 +615,7 @@ void LowPassFilter::SetCutoffFrequency(float value)
 
 void LowPassFilter::MergeWith(LowPassFilter& otherFilter)
 {
-  for (int i = 0; i < cMaxChannels; ++i)
-  {
-    BiQuadsPerChannel[i].AddHistoryTo(otherFilter.BiQuadsPerChannel[i]);
-  }
+  BiQuadChannels.AddHistoryTo(otherFilter.BiQuadChannels);
 }
 
 void LowPassFilter::ProcessFrame(const float* input, float* output, const unsigned numChannels)
@@ -310,8 +626,7 @@ void LowPassFilter::ProcessFrame(const float* input, float* output, const unsign
   }
   else
   {
-    for (unsigned i = 0; i < numChannels; ++i)
-      output[i] = BiQuadsPerChannel[i].DoBiQuad(input[i]);
+    BiQuadChannels.ProcessFrame(input, output, numChannels);
   }
 }
 
@@ -326,8 +641,7 @@ void LowPassFilter::ProcessBuffer(const float* input,
     return;
   }
 
-  for (unsigned i = 0; i < numSamples; i += numChannels)
-    ProcessFrame(input + i, output + i, numChannels);
+  BiQuadChannels.ProcessBuffer(input, output, numChannels, numSamples);
 }
 
 float LowPassFilter::GetCutoffFrequency()
@@ -340,9 +654,6 @@ float LowPassFilter::GetCutoffFrequency()
 HighPassFilter::HighPassFilter() : CutoffFrequency(10.0f), HalfPI(Math::cPi / 2.0f), SqRoot2(Math::Sqrt(2.0f))
 {
   SetCutoffValues();
-
-  for (unsigned i = 0; i < cMaxChannels; ++i)
-    BiQuadsPerChannel[i].FlushDelays();
 }
 
 void HighPassFilter::SetCutoffValues()
@@ -358,8 +669,7 @@ void HighPassFilter::SetCutoffValues()
   float beta1 = 2.0f * alpha * (Csq - 1.0f);
   float beta2 = alpha * (1.0f - (SqRoot2 * C) + Csq);
 
-  for (unsigned i = 0; i < cMaxChannels; ++i)
-    BiQuadsPerChannel[i].SetValues(alpha, -2.0f * alpha, alpha, beta1, beta2);
+  BiQuadChannels.SetValues(alpha, -2.0f * alpha, alpha, beta1, beta2);
 }
 
 void HighPassFilter::SetCutoffFrequency(const float value)
@@ -370,10 +680,7 @@ void HighPassFilter::SetCutoffFrequency(const float value)
 
 void HighPassFilter::MergeWith(HighPassFilter& otherFilter)
 {
-  for (int i = 0; i < cMaxChannels; ++i)
-  {
-    BiQuadsPerChannel[i].AddHistoryTo(otherFilter.BiQuadsPerChannel[i]);
-  }
+  BiQuadChannels.AddHistoryTo(otherFilter.BiQuadChannels);
 }
 
 void HighPassFilter::ProcessFrame(const float* input, float* output, const unsigned numChannels)
@@ -381,10 +688,18 @@ void HighPassFilter::ProcessFrame(const float* input, float* output, const unsig
   if (CutoffFrequency < 20.0f)
     memcpy(output, input, sizeof(float) * numChannels);
   else
-  {
-    for (unsigned i = 0; i < numChannels; ++i)
-      output[i] = BiQuadsPerChannel[i].DoBiQuad(input[i]);
-  }
+    BiQuadChannels.ProcessFrame(input, output, numChannels);
+}
+
+void HighPassFilter::ProcessBuffer(const float* input,
+                                   float* output,
+                                   const unsigned numChannels,
+                                   const unsigned bufferSize)
+{
+  if (CutoffFrequency < 20.0f)
+    memcpy(output, input, sizeof(float) * bufferSize);
+  else
+    BiQuadChannels.ProcessBuffer(input, output, numChannels, bufferSize);
 }
 
 // Band Pass Filter
@@ -392,10 +707,6 @@ void HighPassFilter::ProcessFrame(const float* input, float* output, const unsig
 BandPassFilter::BandPassFilter() : Quality(0.669f), CentralFreq(1000.0f)
 {
   ResetFrequencies();
-
-  memset(PreviousInput, 0, sizeof(float) * cMaxChannels);
-  memset(PreviousOutput1, 0, sizeof(float) * cMaxChannels);
-  memset(PreviousOutput2, 0, sizeof(float) * cMaxChannels);
 }
 
 void BandPassFilter::SetFrequency(const float freq)
@@ -414,26 +725,20 @@ void BandPassFilter::SetQuality(const float Q)
 
 void BandPassFilter::MergeWith(BandPassFilter& otherFilter)
 {
-  for (int i = 0; i < cMaxChannels; ++i)
-  {
-    otherFilter.PreviousInput[i] += PreviousInput[i];
-    otherFilter.PreviousOutput1[i] += PreviousOutput1[i];
-    otherFilter.PreviousOutput2[i] += PreviousOutput2[i];
-  }
+  BiQuadChannels.AddHistoryTo(otherFilter.BiQuadChannels);
 }
 
 void BandPassFilter::ProcessFrame(const float* input, float* output, const unsigned numChannels)
 {
-  for (unsigned i = 0; i < numChannels; ++i)
-  {
-    float inputSample = input[i];
-    output[i] = (AlphaHP * (1 - AlphaLP) * (inputSample - PreviousInput[i])) +
-                ((AlphaHP + AlphaLP) * PreviousOutput1[i]) - (AlphaLP * AlphaHP * PreviousOutput2[i]);
+  BiQuadChannels.ProcessFrame(input, output, numChannels);
+}
 
-    PreviousInput[i] = inputSample;
-    PreviousOutput2[i] = PreviousOutput1[i];
-    PreviousOutput1[i] = output[i];
-  }
+void BandPassFilter::ProcessBuffer(const float* input,
+                                   float* output,
+                                   const unsigned numChannels,
+                                   const unsigned bufferSize)
+{
+  BiQuadChannels.ProcessBuffer(input, output, numChannels, bufferSize);
 }
 
 void BandPassFilter::ResetFrequencies()
@@ -447,6 +752,10 @@ void BandPassFilter::ResetFrequencies()
 
   AlphaLP = cSystemSampleRate / ((LowPassCutoff * 2.0f * Math::cPi) + cSystemSampleRate);
   AlphaHP = cSystemSampleRate / ((HighPassCutoff * 2.0f * Math::cPi) + cSystemSampleRate);
+
+  // y[n] = AlphaHP(1 - AlphaLP)(x[n] - x[n-1]) + (AlphaHP + AlphaLP)y[n-1] - AlphaHP * AlphaLP * y[n-2]
+  float gain = AlphaHP * (1.0f - AlphaLP);
+  BiQuadChannels.SetValues(gain, -gain, 0.0f, -(AlphaHP + AlphaLP), AlphaLP * AlphaHP);
 }
 
 // Oscillator
@@ -1209,40 +1518,25 @@ Equalizer::Equalizer(float* values)
 
 void Equalizer::ProcessBuffer(const float* input, float* output, const unsigned numChannels, const unsigned bufferSize)
 {
-  Plasma::Array<float> resultSamples(numChannels);
+  // Each band filters the whole buffer at once, then its gain is applied frame
+  // by frame so the gain interpolation still happens per frame
+  mBandSamples.Resize(bufferSize);
+  memset(output, 0, sizeof(float) * bufferSize);
 
-  for (unsigned i = 0; i < bufferSize; i += numChannels)
-  {
-    LowPass.ProcessFrame(input + i, resultSamples.Data(), numChannels);
-    if (!LowPassInterpolator.Finished())
-      mBandGains[EqualizerBands::Below80] = LowPassInterpolator.NextValue();
-    for (unsigned j = 0; j < numChannels; ++j)
-      output[i + j] = resultSamples[j] * mBandGains[EqualizerBands::Below80];
+  LowPass.ProcessBuffer(input, mBandSamples.Data(), numChannels, bufferSize);
+  AddBandToOutput(output, numChannels, bufferSize, EqualizerBands::Below80, LowPassInterpolator);
 
-    Band1.ProcessFrame(input + i, resultSamples.Data(), numChannels);
-    if (!Band1Interpolator.Finished())
-      mBandGains[EqualizerBands::At150] = Band1Interpolator.NextValue();
-    for (unsigned j = 0; j < numChannels; ++j)
-      output[i + j] += resultSamples[j] * mBandGains[EqualizerBands::At150];
+  Band1.ProcessBuffer(input, mBandSamples.Data(), numChannels, bufferSize);
+  AddBandToOutput(output, numChannels, bufferSize, EqualizerBands::At150, Band1Interpolator);
 
-    Band2.ProcessFrame(input + i, resultSamples.Data(), numChannels);
-    if (!Band2Interpolator.Finished())
-      mBandGains[EqualizerBands::At600] = Band2Interpolator.NextValue();
-    for (unsigned j = 0; j < numChannels; ++j)
-      output[i + j] += resultSamples[j] * mBandGains[EqualizerBands::At600];
+  Band2.ProcessBuffer(input, mBandSamples.Data(), numChannels, bufferSize);
+  AddBandToOutput(output, numChannels, bufferSize, EqualizerBands::At600, Band2Interpolator);
 
-    Band3.ProcessFrame(input + i, resultSamples.Data(), numChannels);
-    if (!Band3Interpolator.Finished())
-      mBandGains[EqualizerBands::At2500] = Band3Interpolator.NextValue();
-    for (unsigned j = 0; j < numChannels; ++j)
-      output[i + j] += resultSamples[j] * mBandGains[EqualizerBands::At2500];
+  Band3.ProcessBuffer(input, mBandSamples.Data(), numChannels, bufferSize);
+  AddBandToOutput(output, numChannels, bufferSize, EqualizerBands::At2500, Band3Interpolator);
 
-    HighPass.ProcessFrame(input + i, resultSamples.Data(), numChannels);
-    if (!HighPassInterpolator.Finished())
-      mBandGains[EqualizerBands::Above5000] = HighPassInterpolator.NextValue();
-    for (unsigned j = 0; j < numChannels; ++j)
-      output[i + j] += resultSamples[j] * mBandGains[EqualizerBands::Above5000];
-  }
+  HighPass.ProcessBuffer(input, mBandSamples.Data(), numChannels, bufferSize);
+  AddBandToOutput(output, numChannels, bufferSize, EqualizerBands::Above5000, HighPassInterpolator);
 }
 
 float Equalizer::GetBandGain(EqualizerBands::Enum whichBand)
@@ -1275,6 +1569,25 @@ void Equalizer::MergeWith(Equalizer& otherFilter)
   Band3.MergeWith(otherFilter.Band3);
 }
 
+void Equalizer::AddBandToOutput(float* output,
+                                const unsigned numChannels,
+                                const unsigned bufferSize,
+                                EqualizerBands::Enum whichBand,
+                                InterpolatingObject& interpolator)
+{
+  float& gain = mBandGains[whichBand];
+  const float* bandSamples = mBandSamples.Data();
+
+  for (unsigned i = 0; i < bufferSize; i += numChannels)
+  {
+    if (!interpolator.Finished())
+      gain = interpolator.NextValue();
+
+    for (unsigned j = 0; j < numChannels; ++j)
+      output[i + j] += bandSamples[i + j] * gain;
+  }
+}
+
 void Equalizer::SetFilterData()
 {
   LowPass.SetCutoffFrequency(79.62f);
@@ -1354,6 +1667,36 @@ float ReverbData::ProcessSample(const float input)
   return result;
 }
 
+void ReverbData::ProcessBlock(float* samples, const unsigned count)
+{
+  mCombSamples.Resize(count);
+  mCombOutput.Resize(count);
+  float* combSamples = mCombSamples.Data();
+  float* combOutput = mCombOutput.Data();
+
+  PreDelay.ProcessBlock(samples, samples, count);
+  InputAP_1.ProcessBlock(samples, samples, count);
+  InputAP_2.ProcessBlock(samples, samples, count);
+  InputLP.ProcessBlock(samples, samples, count);
+
+  Comb_1.ProcessBlock(samples, combSamples, count);
+
+  Comb_2.ProcessBlock(samples, combOutput, count);
+  for (unsigned i = 0; i < count; ++i)
+    combSamples[i] -= combOutput[i];
+
+  LPComb_1.ProcessBlock(samples, combOutput, count);
+  for (unsigned i = 0; i < count; ++i)
+    combSamples[i] += combOutput[i];
+
+  LPComb_2.ProcessBlock(samples, combOutput, count);
+  for (unsigned i = 0; i < count; ++i)
+    samples[i] = 0.15f * (combSamples[i] - combOutput[i]);
+
+  DampingLP.ProcessBlock(samples, samples, count);
+  OutputAP.ProcessBlock(samples, samples, count);
+}
+
 // Reverb
 
 Reverb::Reverb() : TimeMSec(1000.0f), LPgain(0.5f), WetValue(0.5f)
@@ -1364,35 +1707,56 @@ Reverb::Reverb() : TimeMSec(1000.0f), LPgain(0.5f), WetValue(0.5f)
 
 bool Reverb::ProcessBuffer(const float* input, float* output, const unsigned numChannels, const unsigned bufferSize)
 {
-  bool hasOutput(false);
-  for (unsigned i = 0; i < bufferSize; i += numChannels)
+  unsigned frames = bufferSize / numChannels;
+
+  // Get the wet level for every frame first, so each channel can be run through
+  // the reverb filters as one block
+  mWetValues.Resize(frames);
+  bool isWet(false);
+  for (unsigned frame = 0; frame < frames; ++frame)
   {
     if (!WetValueInterpolator.Finished())
       WetValue = WetValueInterpolator.NextValue();
 
-    // Only process if reverb is turned on
+    mWetValues[frame] = WetValue;
     if (WetValue > 0)
-    {
-      for (unsigned channel = 0; channel < numChannels && channel < ChannelCount; ++channel)
-      {
-        output[i + channel] =
-            ((1.0f - WetValue) * input[i + channel]) + (WetValue * Data[channel].ProcessSample(input[i + channel]));
+      isWet = true;
+  }
 
-        if (Math::Abs(output[i + channel]) > 0.001f)
-          hasOutput = true;
-      }
+  // Only process if reverb is turned on
+  if (!isWet)
+  {
+    if (input != output)
+      memcpy(output, input, sizeof(float) * bufferSize);
+    return false;
+  }
+
+  bool hasOutput(false);
+  mChannelSamples.Resize(frames);
+  float* channelSamples = mChannelSamples.Data();
+
+  for (unsigned channel = 0; channel < numChannels; ++channel)
+  {
+    // Channels without reverb data are passed through
+    if (channel >= ChannelCount)
+    {
+      for (unsigned i = channel; i < bufferSize; i += numChannels)
+        output[i] = input[i];
+      continue;
     }
-    else
+
+    for (unsigned frame = 0, i = channel; frame < frames; ++frame, i += numChannels)
+      channelSamples[frame] = input[i];
+
+    Data[channel].ProcessBlock(channelSamples, frames);
+
+    for (unsigned frame = 0, i = channel; frame < frames; ++frame, i += numChannels)
     {
-      // If not interpolating, copy the rest of the buffer
-      if (WetValueInterpolator.Finished())
-      {
-        memcpy(output, input, sizeof(float) * (bufferSize - i));
-        break;
-      }
-      // Otherwise copy just this frame
-      else
-        memcpy(output, input, sizeof(float) * numChannels);
+      float wetValue = mWetValues[frame];
+      output[i] = ((1.0f - wetValue) * input[i]) + (wetValue * channelSamples[frame]);
+
+      if (wetValue > 0 && Math::Abs(output[i]) > 0.001f)
+        hasOutput = true;
     }
   }
 
@@ -1642,7 +2006,12 @@ int NextPowerOf2(const int& value)
   return nextPowerOf2;
 }
 
-FFTConvolver::FFTConvolver() : mBlockSize(0), mSegmentCount(0), mBufferPosition(0), mCurrentSegment(0)
+FFTConvolver::FFTConvolver() :
+    mBlockSize(0),
+    mSegmentSize(0),
+    mSegmentCount(0),
+    mBufferPosition(0),
+    mCurrentSegment(0)
 {
 }
 
@@ -1667,29 +2036,33 @@ bool FFTConvolver::Initialize(int blockSize, const float* impulseResponse, int i
   //  return true;
 
   mBlockSize = NextPowerOf2(blockSize);
+  mSegmentSize = mBlockSize * 2;
 
-  mStoredInputBuffer.Resize(mBlockSize);
+  mStoredInputBuffer.Resize(mBlockSize, 0.0f);
   mBufferPosition = 0;
 
-  mSegmentCount = (int)((float)irLength / (float)mBlockSize);
+  // Every part of the impulse response needs a segment, including the last
+  // partial one
+  mSegmentCount = (irLength + mBlockSize - 1) / mBlockSize;
   mCurrentSegment = 0;
   for (int i = 0; i < mSegmentCount; ++i)
-    mSegments.PushBack(ComplexListType(mBlockSize));
+    mSegments.PushBack(ComplexListType(mSegmentSize));
 
+  // Each segment of the impulse response is padded with zeros to the segment size
+  Plasma::Array<float> paddedIR(mSegmentSize);
   for (int i = 0; i < mSegmentCount; ++i)
   {
-    int remaining = irLength - (i * mBlockSize);
-    int sizeToProcess;
-    if (remaining >= mBlockSize)
-      sizeToProcess = mBlockSize;
-    else
-      sizeToProcess = remaining;
-    mSegmentsIR.PushBack(ComplexListType(sizeToProcess));
-    FFT::Forward(impulseResponse + (i * mBlockSize), mSegmentsIR.Back().Data(), sizeToProcess);
+    int sizeToProcess = Math::Min(irLength - (i * mBlockSize), mBlockSize);
+    memset(paddedIR.Data(), 0, sizeof(float) * mSegmentSize);
+    memcpy(paddedIR.Data(), impulseResponse + (i * mBlockSize), sizeof(float) * sizeToProcess);
+
+    mSegmentsIR.PushBack(ComplexListType(mSegmentSize));
+    FFT::Forward(paddedIR.Data(), mSegmentsIR.Back().Data(), mSegmentSize);
   }
 
-  mConvolvedSamples.Resize(mBlockSize);
-  mOverlap.Resize(mBlockSize);
+  mPreMultiplied.Resize(mSegmentSize);
+  mConvolvedSamples.Resize(mSegmentSize);
+  mOverlap.Resize(mBlockSize, 0.0f);
 
   return true;
 }
@@ -1711,28 +2084,36 @@ void FFTConvolver::ProcessBuffer(const float* input, float* output, int length)
     // Copy input samples into the stored buffer
     memcpy(mStoredInputBuffer.Data() + mBufferPosition, input + samplesProcessed, sizeof(float) * processing);
 
-    // Forward FFT
-    FFT::Forward(mStoredInputBuffer.Data(), mSegments[mCurrentSegment].Data(), mBlockSize);
+    // Forward FFT of the stored input, padded with zeros to the segment size
+    ComplexListType& segment = mSegments[mCurrentSegment];
+    for (int i = 0; i < mBlockSize; ++i)
+      segment[i].Set(mStoredInputBuffer[i], 0.0f);
+    for (int i = mBlockSize; i < mSegmentSize; ++i)
+      segment[i].Set(0.0f, 0.0f);
+    FFT::Forward(segment.Data(), mSegmentSize);
 
-    // Complex multiplication
+    // The older segments don't change until the next block, so their products
+    // are only summed once per block
     if (mBufferPosition == 0)
     {
+      memset(mPreMultiplied.Data(), 0, sizeof(ComplexNumber) * mSegmentSize);
       for (int i = 1; i < mSegmentCount; ++i)
       {
         int index = (mCurrentSegment + i) % mSegmentCount;
-        for (int j = 0; j < mBlockSize; ++j)
-          mConvolvedSamples[j] = mSegmentsIR[i][j] * mSegments[index][j];
+        MultiplyAccumulate(mPreMultiplied.Data(), mSegmentsIR[i].Data(), mSegments[index].Data(), mSegmentSize);
       }
     }
-    for (int i = 0; i < mBlockSize; ++i)
-      mConvolvedSamples[i] += mSegments[mCurrentSegment][i] * mSegmentsIR[0][i];
+
+    // Complex multiplication
+    memcpy(mConvolvedSamples.Data(), mPreMultiplied.Data(), sizeof(ComplexNumber) * mSegmentSize);
+    MultiplyAccumulate(mConvolvedSamples.Data(), segment.Data(), mSegmentsIR[0].Data(), mSegmentSize);
 
     // Backward FFT
-    FFT::Backward(mConvolvedSamples.Data(), mBlockSize);
+    FFT::Backward(mConvolvedSamples.Data(), mSegmentSize);
 
     // Add overlap
     for (int i = 0; i < processing; ++i)
-      output[samplesProcessed + i] = mConvolvedSamples[mBufferPosition + i].mReal + mOverlap[mBufferPosition + i].mReal;
+      output[samplesProcessed + i] = mConvolvedSamples[mBufferPosition + i].mReal + mOverlap[mBufferPosition + i];
 
     // If input buffer full, go to next block
     mBufferPosition += processing;
@@ -1741,7 +2122,11 @@ void FFTConvolver::ProcessBuffer(const float* input, float* output, int length)
       mBufferPosition = 0;
 
       // Save the overlap
-      memcpy(mOverlap.Data(), mConvolvedSamples.Data() + mBlockSize, sizeof(ComplexNumber) * mBlockSize);
+      for (int i = 0; i < mBlockSize; ++i)
+        mOverlap[i] = mConvolvedSamples[mBlockSize + i].mReal;
+
+      // The next block starts out as silence until its input arrives
+      memset(mStoredInputBuffer.Data(), 0, sizeof(float) * mBlockSize);
 
       // Update current segment
       --mCurrentSegment;
@@ -1756,6 +2141,7 @@ void FFTConvolver::ProcessBuffer(const float* input, float* output, int length)
 void FFTConvolver::Reset()
 {
   mBlockSize = 0;
+  mSegmentSize = 0;
   mSegmentCount = 0;
   mBufferPosition = 0;
   mCurrentSegment = 0;
@@ -1763,10 +2149,44 @@ void FFTConvolver::Reset()
   mStoredInputBuffer.Clear();
   mSegments.Clear();
   mSegmentsIR.Clear();
+  mPreMultiplied.Clear();
   mConvolvedSamples.Clear();
   mOverlap.Clear();
 }
 
+void FFTConvolver::MultiplyAccumulate(ComplexNumber* results,
+                                      const ComplexNumber* values1,
+                                      const ComplexNumber* values2,
+                                      const int count)
+{
+  int i = 0;
+
+#if defined(PlasmaSse2)
+  // Two complex numbers fit in each register as [real, imaginary, real,
+  // imaginary]
+  __m128 signs = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f);
+  for (; i + 1 < count; i += 2)
+  {
+    __m128 first = _mm_loadu_ps(&values1[i].mReal);
+    __m128 second = _mm_loadu_ps(&values2[i].mReal);
+
+    __m128 firstReal = _mm_shuffle_ps(first, first, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 firstImaginary = _mm_shuffle_ps(first, first, _MM_SHUFFLE(3, 3, 1, 1));
+    __m128 secondSwapped = _mm_shuffle_ps(second, second, _MM_SHUFFLE(2, 3, 0, 1));
+
+    // (a + bi)(c + di) = (ac - bd) + (ad + bc)i
+    __m128 product = _mm_mul_ps(firstReal, second);
+    product = _mm_add_ps(product, _mm_mul_ps(_mm_mul_ps(firstImaginary, secondSwapped), signs));
+
+    __m128 result = _mm_loadu_ps(&results[i].mReal);
+    _mm_storeu_ps(&results[i].mReal, _mm_add_ps(result, product));
+  }
+#endif
+
+  for (; i < count; ++i)
+    results[i] += values1[i] * values2[i];
+}
+
 // ADSR envelope
 
 ADSR::ADSR() :
@@ -38,6 +38,34 @@ private:
   float b2;
 };
 
+// Multichannel BiQuad Filter
+
+// The same BiQuad filter applied to every channel of interleaved audio. The
+// history of each channel is kept side by side so that all channels in a frame
+// are filtered together, four at a time when SIMD is available.
+class MultiChannelBiQuad
+{
+public:
+  MultiChannelBiQuad();
+
+  void FlushDelays();
+  void SetValues(const float a0, const float a1, const float a2, const float b1, const float b2);
+  void ProcessFrame(const float* input, float* output, const unsigned numChannels);
+  void ProcessBuffer(const float* input, float* output, const unsigned numChannels, const unsigned bufferSize);
+  void AddHistoryTo(MultiChannelBiQuad& otherFilter);
+
+private:
+  float x_1[AudioConstants::cMaxChannels];
+  float x_2[AudioConstants::cMaxChannels];
+  float y_1[AudioConstants::cMaxChannels];
+  float y_2[AudioConstants::cMaxChannels];
+  float a0;
+  float a1;
+  float a2;
+  float b1;
+  float b2;
+};
+
 // Delay Filter
 
 class Delay
@@ -53,8 +81,15 @@ public:
   float ReadDelayAt(const float mSec);
   void WriteDelayAndInc(const float delayInput);
   virtual void ProcessAudio(const float input, float* output);
+  // Processes a block of samples. The input and output can be the same buffer.
+  virtual void ProcessBlock(const float* input, float* output, const unsigned count);
 
 protected:
+  // Returns how many of the samples can be processed before an index wraps
+  int GetContiguousSamples(const int count);
+  // Moves all indexes forward by the number of samples
+  void AdvanceIndexes(const int count);
+
   float* mBuffer;
   float mDelayInSamples;
   float mOutputAttenuation;
@@ -80,6 +115,7 @@ public:
     mAPFg = g;
   }
   void ProcessAudio(const float input, float* output) override;
+  void ProcessBlock(const float* input, float* output, const unsigned count) override;
 
 private:
   float mAPFg;
@@ -101,6 +137,7 @@ public:
   }
   void SetCombGWithRT60(const float RT);
   void ProcessAudio(const float input, float* output) override;
+  void ProcessBlock(const float* input, float* output, const unsigned count) override;
 
 private:
   float mCombG;
@@ -119,6 +156,7 @@ public:
   void SetG(const float combG, const float overallGain);
   void SetGWithRT60(const float RT, const float overallGain);
   void ProcessAudio(const float input, float* output) override;
+  void ProcessBlock(const float* input, float* output, const unsigned count) override;
 
 private:
   float mCombG;
@@ -139,6 +177,7 @@ public:
   void SetLPFg(const float g);
   void Initialize();
   void ProcessAudio(const float input, float* output);
+  void ProcessBlock(const float* input, float* output, const unsigned count);
 
 private:
   float mLPFg;
@@ -165,7 +204,7 @@ private:
   float SqRoot2;
   float HalfPI;
 
-  BiQuad BiQuadsPerChannel[AudioConstants::cMaxChannels];
+  MultiChannelBiQuad BiQuadChannels;
 
   void SetCutoffValues();
 };
@@ -178,6 +217,7 @@ public:
   HighPassFilter();
 
   void ProcessFrame(const float* input, float* output, const unsigned numChannels);
+  void ProcessBuffer(const float* input, float* output, const unsigned numChannels, const unsigned bufferSize);
 
   void SetCutoffFrequency(const float value);
   void MergeWith(HighPassFilter& otherFilter);
@@ -187,7 +227,7 @@ private:
   float SqRoot2;
   float HalfPI;
 
-  BiQuad BiQuadsPerChannel[AudioConstants::cMaxChannels];
+  MultiChannelBiQuad BiQuadChannels;
 
   void SetCutoffValues();
 };
@@ -200,6 +240,7 @@ public:
   BandPassFilter();
 
   void ProcessFrame(const float* input, float* output, const unsigned numChannels);
+  void ProcessBuffer(const float* input, float* output, const unsigned numChannels, const unsigned bufferSize);
 
   void SetFrequency(const float frequency);
   void SetQuality(const float Q);
@@ -212,9 +253,8 @@ private:
   float HighPassCutoff;
   float AlphaLP;
   float AlphaHP;
-  float PreviousInput[AudioConstants::cMaxChannels];
-  float PreviousOutput1[AudioConstants::cMaxChannels];
-  float PreviousOutput2[AudioConstants::cMaxChannels];
+  // The high pass and low pass stages combined into one BiQuad
+  MultiChannelBiQuad BiQuadChannels;
 
   void ResetFrequencies();
 };
@@ -524,7 +564,16 @@ private:
   InterpolatingObject Band2Interpolator;
   InterpolatingObject Band3Interpolator;
 
+  // The output of one band, before its gain is applied
+  Plasma::Array<float> mBandSamples;
+
   void SetFilterData();
+  // Applies the band's gain to its output and adds it to the output buffer
+  void AddBandToOutput(float* output,
+                       const unsigned numChannels,
+                       const unsigned bufferSize,
+                       EqualizerBands::Enum whichBand,
+                       InterpolatingObject& interpolator);
 };
 
 // Reverb Filter
@@ -536,6 +585,8 @@ public:
 
   void Initialize(const float lpGain);
   float ProcessSample(const float input);
+  // Processes a block of samples in place, one filter stage at a time
+  void ProcessBlock(float* samples, const unsigned count);
 
   Delay PreDelay;
 
@@ -555,6 +606,12 @@ public:
 
   // Output diffusion
   DelayAPF OutputAP;
+
+private:
+  // The summed output of the comb filters
+  Plasma::Array<float> mCombSamples;
+  // The output of a single comb filter
+  Plasma::Array<float> mCombOutput;
 };
 
 class Reverb
@@ -586,6 +643,10 @@ private:
   float WetValue;
   // Used to interpolate the wet level
   InterpolatingObject WetValueInterpolator;
+  // The wet level for each frame of the buffer being processed
+  Plasma::Array<float> mWetValues;
+  // The samples of one channel being processed
+  Plasma::Array<float> mChannelSamples;
 };
 
 // Complex Number
@@ -642,16 +703,29 @@ public:
   void Reset();
 
 private:
+  typedef Plasma::Array<ComplexNumber> ComplexListType;
+
+  // Adds the products of each pair of values to the results
+  static void MultiplyAccumulate(ComplexNumber* results,
+                                 const ComplexNumber* values1,
+                                 const ComplexNumber* values2,
+                                 const int count);
+
   int mBlockSize;
+  // Each segment is transformed with twice the block size, so the
+  // convolution of a block doesn't wrap around
+  int mSegmentSize;
   int mSegmentCount;
   Plasma::Array<float> mStoredInputBuffer;
   int mBufferPosition;
   int mCurrentSegment;
-  typedef Plasma::Array<ComplexNumber> ComplexListType;
   Plasma::Array<ComplexListType> mSegments;
   Plasma::Array<ComplexListType> mSegmentsIR;
+  // The sum of every segment but the current one multiplied by the impulse
+  // response, which doesn't change until the next block
+  ComplexListType mPreMultiplied;
   ComplexListType mConvolvedSamples;
-  ComplexListType mOverlap;
+  Plasma::Array<float> mOverlap;
 };
 
 static int NextPowerOf2(const int& value);
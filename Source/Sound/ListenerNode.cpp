@@ -72,6 +72,11 @@ Math::Vec3 ListenerNode::GetRelativeFacingThreaded(Math::Vec3Param facingDirecti
   return Math::Transform(mWorldToLocalThreaded, facingDirection);
 }
 
+bool ListenerNode::IgnoresListenerThreaded()
+{
+  return true;
+}
+
 bool ListenerNode::GetOutputSamples(BufferType* outputBuffer,
                                     const unsigned numberOfChannels,
                                     ListenerNode* listener,
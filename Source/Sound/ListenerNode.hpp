@@ -54,6 +54,9 @@ public:
   Vec3 GetRelativeVelocityThreaded(Vec3Param otherVelocity);
   // Gets the relative facing direction of this listener
   Vec3 GetRelativeFacingThreaded(Vec3Param facingDirection);
+  // Inputs are always mixed for this listener, so the output is the same no
+  // matter which listener asks for it
+  bool IgnoresListenerThreaded() override;
 
 private:
   bool GetOutputSamples(BufferType* outputBuffer,
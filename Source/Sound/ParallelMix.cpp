@@ -0,0 +1,134 @@
+// MIT Licensed (see LICENSE.md).
+
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// True on the mix helper threads, which never hand work to each other
+PlasmaThreadLocal bool IsMixHelperThread = false;
+
+// Parallel Mix Job
+
+ParallelMixJob::ParallelMixJob() : mNode(nullptr), mHasOutput(false)
+{
+}
+
+// Mix Helper Threads
+
+MixHelperThreads::MixHelperThreads() :
+    mNextJob(0),
+    mActiveHelpers(0),
+    mShuttingDown(false),
+    mJobs(nullptr),
+    mNumberOfChannels(0),
+    mListener(nullptr),
+    mRunning(false)
+{
+}
+
+MixHelperThreads::~MixHelperThreads()
+{
+  ShutDown();
+}
+
+void MixHelperThreads::Start()
+{
+  if (!ThreadingEnabled || !mThreads.Empty())
+    return;
+
+  mShuttingDown.Store(false);
+
+  mThreads.Resize(cMaxHelperThreads);
+  for (uint i = 0; i < mThreads.Size(); ++i)
+  {
+    mThreads[i] = new Thread();
+    Thread& thread = *mThreads[i];
+    thread.Initialize(
+        &Thread::ObjectEntryCreator<MixHelperThreads, &MixHelperThreads::HelperLoopThreaded>, this, "Audio mix helper");
+  }
+}
+
+void MixHelperThreads::ShutDown()
+{
+  if (mThreads.Empty())
+    return;
+
+  // Wake up every thread without giving it work
+  mShuttingDown.Store(true);
+  for (uint i = 0; i < mThreads.Size(); ++i)
+    mWorkSignal.Increment();
+
+  for (uint i = 0; i < mThreads.Size(); ++i)
+  {
+    Thread& thread = *mThreads[i];
+    thread.WaitForCompletion();
+    thread.Close();
+  }
+
+  DeleteObjectsInContainer(mThreads);
+}
+
+bool MixHelperThreads::CanRunInParallelThreaded()
+{
+  return !IsMixHelperThread && !mRunning && !mThreads.Empty();
+}
+
+void MixHelperThreads::RunThreaded(Array<ParallelMixJob>& jobs,
+                                   const unsigned numberOfChannels,
+                                   ListenerNode* listener)
+{
+  ErrorIf(!CanRunInParallelThreaded(), "Mix helper threads used while not available");
+
+  mRunning = true;
+  mJobs = &jobs;
+  mNumberOfChannels = numberOfChannels;
+  mListener = listener;
+  mNextJob.Store(0);
+
+  // The calling thread takes jobs too, so only wake up as many helpers as
+  // there are other jobs
+  s32 helpers = (s32)Math::Min(mThreads.Size(), jobs.Size() - 1);
+  mActiveHelpers.Store(helpers);
+  for (s32 i = 0; i < helpers; ++i)
+    mWorkSignal.Increment();
+
+  RunJobsThreaded();
+
+  // The last jobs are already running on the helpers, so this wait is short
+  while (mActiveHelpers.Load() != 0)
+    Os::Sleep(0);
+
+  mJobs = nullptr;
+  mListener = nullptr;
+  mRunning = false;
+}
+
+OsInt MixHelperThreads::HelperLoopThreaded()
+{
+  IsMixHelperThread = true;
+
+  while (true)
+  {
+    mWorkSignal.WaitAndDecrement();
+    if (mShuttingDown.Load())
+      break;
+
+    RunJobsThreaded();
+    mActiveHelpers.FetchSubtract(1);
+  }
+
+  return 0;
+}
+
+void MixHelperThreads::RunJobsThreaded()
+{
+  Array<ParallelMixJob>& jobs = *mJobs;
+  for (s32 index = mNextJob.FetchAdd(1); index < (s32)jobs.Size(); index = mNextJob.FetchAdd(1))
+  {
+    ParallelMixJob& job = jobs[index];
+    job.mHasOutput = job.mNode->Evaluate(&job.mBuffer, mNumberOfChannels, mListener);
+  }
+}
+
+} // namespace Plasma
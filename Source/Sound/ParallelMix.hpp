@@ -0,0 +1,79 @@
+// MIT Licensed (see LICENSE.md).
+
+#pragma once
+
+namespace Plasma
+{
+
+class ListenerNode;
+class SoundNode;
+
+// Parallel Mix Job
+
+// One input of a sound node, evaluated by the mix helper threads
+class ParallelMixJob
+{
+public:
+  ParallelMixJob();
+
+  // The input node to evaluate
+  SoundNode* mNode;
+  // Filled with the output of the input node
+  BufferType mBuffer;
+  // True if the input node had valid output
+  bool mHasOutput;
+};
+
+// Mix Helper Threads
+
+// Threads that help the mix thread evaluate independent parts of the sound node
+// graph. The mix thread hands over the inputs of a node, helps evaluate them,
+// and then waits for the helpers to finish before combining the outputs.
+class MixHelperThreads
+{
+public:
+  MixHelperThreads();
+  ~MixHelperThreads();
+
+  // Starts the helper threads. Does nothing if threading is disabled.
+  void Start();
+  // Stops all helper threads and waits for them to finish
+  void ShutDown();
+  // Returns true if the calling thread can hand work to the helper threads.
+  // Helper threads can't, and neither can the mix thread while they are busy.
+  bool CanRunInParallelThreaded();
+  // Evaluates every job on the helper threads and the calling thread, returning
+  // once all of them are finished. Every job must be independent of the others.
+  void RunThreaded(Array<ParallelMixJob>& jobs, const unsigned numberOfChannels, ListenerNode* listener);
+  // Looping function on each helper thread
+  OsInt HelperLoopThreaded();
+
+  // The most helper threads that will be started (there is no point in more,
+  // since they compete with the game for cores)
+  static const unsigned cMaxHelperThreads = 3;
+
+private:
+  // Takes jobs from the current list until there are none left
+  void RunJobsThreaded();
+
+  // The helper threads
+  Array<Thread*> mThreads;
+  // Incremented once for each helper thread that should look for work
+  Semaphore mWorkSignal;
+  // Index of the next job in the list to evaluate
+  Atomic<s32> mNextJob;
+  // The number of helper threads which were woken up and haven't finished
+  Atomic<s32> mActiveHelpers;
+  // Tells the helper threads to stop
+  Atomic<bool> mShuttingDown;
+  // The list of jobs currently being evaluated
+  Array<ParallelMixJob>* mJobs;
+  // The number of channels for the current jobs
+  unsigned mNumberOfChannels;
+  // The listener for the current jobs
+  ListenerNode* mListener;
+  // True while jobs are being evaluated
+  bool mRunning;
+};
+
+} // namespace Plasma
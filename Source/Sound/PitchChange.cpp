@@ -165,6 +165,23 @@ void PitchChangeHandler::ProcessBuffer(BufferType* inputBuffer, BufferType* outp
   memcpy(CurrentData.LastSamples, inputBuffer->Data() + (mInputSampleCount - mChannels), sizeof(float) * mChannels);
 }
 
+void PitchChangeHandler::SkipBuffer(unsigned outputFrames)
+{
+  if (CurrentData.mInterpolating)
+  {
+    CurrentData.mInterpolationFramesProcessed += outputFrames;
+    mPitchFactor = PitchInterpolator.ValueAtIndex(CurrentData.mInterpolationFramesProcessed);
+
+    // Check if the interpolation is finished
+    if (CurrentData.mInterpolationFramesProcessed >= mFramesToInterpolate)
+      CurrentData.mInterpolating = false;
+  }
+
+  // The next buffer will not continue from the skipped audio
+  CurrentData.mPitchFrameIndex = 0.0;
+  ResetLastSamples();
+}
+
 float PitchChangeHandler::GetPitchFactor()
 {
   return mPitchFactor;
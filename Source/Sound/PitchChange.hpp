@@ -15,6 +15,9 @@ public:
   void CalculateBufferSize(unsigned outputSampleCount, unsigned numberOfChannels);
   // Interpolates the audio samples in inputSamples into outputBuffer
   void ProcessBuffer(BufferType* inputBuffer, BufferType* outputBuffer);
+  // Moves forward as if a buffer of this many frames had been processed, without
+  // processing any audio (must be called after CalculateBufferSize)
+  void SkipBuffer(unsigned outputFrames);
   // Returns the current pitch factor
   float GetPitchFactor();
   // Sets the pitch factor over the specified number of seconds
@@ -40,16 +40,7 @@ void Sound::CreateAsset(Status& status, StringParam assetName, StringParam fileN
       audioFile.Close();
 
       if (status.Succeeded())
-      {
-        float fileLength = (float)header.SamplesPerChannel / (float)AudioConstants::cSystemSampleRate;
-
-        if (fileLength < mStreamFromMemoryLength)
-          loadType = AudioFileLoadType::Uncompressed;
-        else if (fileLength < mStreamFromFileLength)
-          loadType = AudioFileLoadType::StreamFromMemory;
-        else
-          loadType = AudioFileLoadType::StreamFromFile;
-      }
+        loadType = GetAutoLoadType(header);
     }
   }
 
@@ -67,6 +58,51 @@ void Sound::CreateAsset(Status& status, StringParam assetName, StringParam fileN
   }
 }
 
+void Sound::CreateAsset(Status& status,
+                        StringParam assetName,
+                        DataBlock fileData,
+                        PackedResourceFile* dataOwner,
+                        AudioFileLoadType::Enum loadType)
+{
+  if (loadType == AudioFileLoadType::Auto)
+  {
+    FileHeader header;
+    Status headerStatus;
+    PacketDecoder::ReadHeader(headerStatus, fileData, &header);
+    if (headerStatus.Succeeded())
+      loadType = GetAutoLoadType(header);
+  }
+
+  if (loadType == AudioFileLoadType::StreamFromFile || loadType == AudioFileLoadType::StreamFromMemory)
+    mAsset = new StreamingSoundAsset(status, fileData, Name);
+  else
+    mAsset = new DecompressedSoundAsset(status, fileData, Name);
+
+  if (status.Failed())
+  {
+    DoNotifyError("Error Creating Sound", status.Message);
+
+    if (mAsset)
+      SafeDelete(mAsset);
+  }
+  else
+  {
+    mAsset->mDataOwner = dataOwner;
+  }
+}
+
+AudioFileLoadType::Enum Sound::GetAutoLoadType(FileHeader& header)
+{
+  float fileLength = (float)header.SamplesPerChannel / (float)AudioConstants::cSystemSampleRate;
+
+  if (fileLength < mStreamFromMemoryLength)
+    return AudioFileLoadType::Uncompressed;
+  else if (fileLength < mStreamFromFileLength)
+    return AudioFileLoadType::StreamFromMemory;
+  else
+    return AudioFileLoadType::StreamFromFile;
+}
+
 float Sound::GetLength()
 {
   if (mAsset)
@@ -139,10 +175,18 @@ void SoundLoader::ReloadFromFile(Resource* resource, ResourceEntry& entry)
   LoadSound(sound, entry);
 }
 
+bool SoundLoader::CanLoadFromBlock()
+{
+  return true;
+}
+
 bool SoundLoader::LoadSound(Sound* sound, ResourceEntry& entry)
 {
   Plasma::Status status;
-  sound->CreateAsset(status, entry.Name, entry.FullPath.c_str(), mLoadType);
+  if (entry.Block.Data != nullptr)
+    sound->CreateAsset(status, entry.Name, entry.Block, entry.BlockOwner, mLoadType);
+  else
+    sound->CreateAsset(status, entry.Name, entry.FullPath.c_str(), mLoadType);
 
   if (status.Failed())
   {
@@ -31,6 +31,18 @@ public:
   const float mStreamFromFileLength = 60.0f;
 
   void CreateAsset(Status& status, StringParam assetName, StringParam fileName, AudioFileLoadType::Enum loadType);
+  // Creates the asset from the data of a packed resource (the asset keeps the
+  // packed data alive and reads from it instead of copying it)
+  void CreateAsset(Status& status,
+                   StringParam assetName,
+                   DataBlock fileData,
+                   PackedResourceFile* dataOwner,
+                   AudioFileLoadType::Enum loadType);
+
+private:
+  // Picks how to load a sound that was set to load automatically, based on its
+  // length
+  AudioFileLoadType::Enum GetAutoLoadType(FileHeader& header);
 };
 
 // Sound Display
@@ -55,6 +67,7 @@ public:
   HandleOf<Resource> LoadFromBlock(ResourceEntry& entry) override;
   HandleOf<Resource> LoadFromFile(ResourceEntry& entry) override;
   void ReloadFromFile(Resource* resource, ResourceEntry& entry) override;
+  bool CanLoadFromBlock() override;
   bool LoadSound(Sound* sound, ResourceEntry& entry);
 
   AudioFileLoadType::Enum mLoadType;
@@ -71,6 +71,23 @@ DecompressedSoundAsset::DecompressedSoundAsset(Status& status, const String& fil
   }
 }
 
+DecompressedSoundAsset::DecompressedSoundAsset(Status& status, DataBlock fileData, const String& assetName) :
+    SoundAsset(assetName, false),
+    mDecoder(status, fileData, DecompressedDecodingCallback, (void*)this),
+    mSamplesAvailableShared(0)
+{
+  if (status.Succeeded())
+  {
+    mDecoder.DecodeNextSection();
+
+    mFileLength = (float)mDecoder.mSamplesPerChannel / AudioConstants::cSystemSampleRate;
+    mChannels = mDecoder.mChannels;
+    mFrameCount = mDecoder.mSamplesPerChannel;
+
+    mSamples.Resize(mFrameCount * mChannels);
+  }
+}
+
 void DecompressedSoundAsset::AppendSamplesThreaded(BufferType* buffer,
                                                    const unsigned frameIndex,
                                                    unsigned samplesRequested,
@@ -128,44 +145,12 @@ void DecompressedSoundAsset::DecodingCallback(DecodedPacket* packet)
 
 // Streaming Data Per Instance
 
-static void StreamingDecodingCallback(DecodedPacket* packet, void* data)
-{
-  ((StreamingDataPerInstance*)data)->DecodingCallback(packet);
-}
-
-StreamingDataPerInstance::StreamingDataPerInstance(
-    Status& status, File* inputFile, ThreadLock* lock, unsigned channels, unsigned frames, unsigned instanceID) :
-    mDecoder(status, inputFile, lock, channels, frames, StreamingDecodingCallback, this),
-    mPreviousSamples(0),
+StreamingDataPerInstance::StreamingDataPerInstance(unsigned channels, unsigned instanceID) :
+    mReader(channels),
     mInstanceID(instanceID)
 {
 }
 
-StreamingDataPerInstance::StreamingDataPerInstance(
-    Status& status, byte* inputData, unsigned dataSize, unsigned channels, unsigned frames, unsigned instanceID) :
-    mDecoder(status, inputData, dataSize, channels, frames, StreamingDecodingCallback, this),
-    mPreviousSamples(0),
-    mInstanceID(instanceID)
-{
-}
-
-void StreamingDataPerInstance::Reset()
-{
-  mDecoder.Reset();
-  mPreviousSamples = 0;
-
-  // Clear any existing data from the decoded packet queue
-  DecodedPacket packet;
-  while (mDecodedPacketQueue.Read(packet))
-  {
-  }
-}
-
-void StreamingDataPerInstance::DecodingCallback(DecodedPacket* packet)
-{
-  mDecodedPacketQueue.Write(*packet);
-}
-
 // Streaming Sound Asset
 
 LightningDefineType(StreamingSoundAsset, builder, Type)
@@ -177,6 +162,7 @@ StreamingSoundAsset::StreamingSoundAsset(Status& status,
                                          AudioFileLoadType::Enum loadType,
                                          const String& assetName) :
     SoundAsset(assetName, true),
+    mNewestStream(nullptr),
     mFileName(fileName)
 {
   FileHeader header;
@@ -207,6 +193,25 @@ StreamingSoundAsset::StreamingSoundAsset(Status& status,
   mFileLength = (float)mFrameCount / (float)AudioConstants::cSystemSampleRate;
 }
 
+StreamingSoundAsset::StreamingSoundAsset(Status& status, DataBlock fileData, const String& assetName) :
+    SoundAsset(assetName, true),
+    mNewestStream(nullptr)
+{
+  FileHeader header;
+  unsigned dataSize = PacketDecoder::ReadHeader(status, fileData, &header);
+  if (status.Failed())
+    return;
+
+  // Whether the sound was set to stream from memory or from a file, we stream
+  // straight from the packed data (if it's mapped, pages are only read from
+  // disk as they're played, which is all streaming from the file would do)
+  mPackedFileData = DataBlock(fileData.Data + sizeof(FileHeader), dataSize);
+
+  mChannels = header.Channels;
+  mFrameCount = header.SamplesPerChannel;
+  mFileLength = (float)mFrameCount / (float)AudioConstants::cSystemSampleRate;
+}
+
 StreamingSoundAsset::~StreamingSoundAsset()
 {
   // Delete any existing instance data objects (though this shouldn't happen
@@ -215,6 +220,7 @@ StreamingSoundAsset::~StreamingSoundAsset()
   {
     StreamingDataPerInstance* data = &mDataPerInstanceList.Front();
     mDataPerInstanceList.PopFront();
+    StopStreamThreaded(data);
     delete data;
   }
 }
@@ -241,11 +247,7 @@ void StreamingSoundAsset::AppendSamplesThreaded(BufferType* buffer,
   }
 
   // Translate from frames to sample location
-  unsigned sampleIndex = frameIndex * mChannels;
-  // Adjust the sample index to be within the current buffer
-  sampleIndex -= data->mPreviousSamples;
-
-  CopySamplesIntoBuffer(buffer->Data() + originalBufferSize, sampleIndex, samplesRequested, data);
+  data->mReader.ReadSamplesThreaded(buffer->Data() + originalBufferSize, frameIndex * mChannels, samplesRequested);
 }
 
 void StreamingSoundAsset::ResetStreamingFile(unsigned instanceID)
@@ -253,45 +255,22 @@ void StreamingSoundAsset::ResetStreamingFile(unsigned instanceID)
   StreamingDataPerInstance* data = GetInstanceData(instanceID);
   if (data)
   {
-    data->Reset();
-    data->mDecoder.DecodeNextSection();
+    // The decoder can't jump back, so start decoding from the beginning with a
+    // new stream
+    StopStreamThreaded(data);
+    data->mReader.Reset();
+    StartStreamThreaded(data);
   }
 }
 
 void StreamingSoundAsset::OnAddInstanceThreaded(unsigned instanceID)
 {
-  Plasma::Status status;
-  StreamingDataPerInstance* data = nullptr;
-
-  // If there is data in the buffer, create the instance data for streaming from
-  // memory
-  if (!mInputFileData.Empty())
-    data = new StreamingDataPerInstance(
-        status, mInputFileData.Data(), mInputFileData.Size(), mChannels, mFrameCount, instanceID);
-  // Otherwise, check if the file name is set
-  else if (!mFileName.Empty())
-  {
-    // If the input file is not open (because there are no current instances)
-    // open it
-    if (!mInputFile.IsOpen())
-    {
-      mInputFile.Open(mFileName, Plasma::FileMode::Read, Plasma::FileAccessPattern::Sequential);
-      ErrorIf(!mInputFile.IsOpen(), "Could not open streaming audio file to play a new instance");
-      if (!mInputFile.IsOpen())
-        return;
-    }
-
-    // Create the instance data for streaming from file
-    data = new StreamingDataPerInstance(status, &mInputFile, &mLock, mChannels, mFrameCount, instanceID);
-  }
-
-  ErrorIf(!data, "No data or file name to play streaming audio asset");
+  StreamingDataPerInstance* data = new StreamingDataPerInstance(mChannels, instanceID);
 
-  // If there was a problem creating the instance data, delete it
-  if (status.Failed())
+  // If there was a problem starting the stream, delete the data
+  if (!StartStreamThreaded(data))
     delete data;
-  // Make sure the data object was created before adding it to the list
-  else if (data)
+  else
     mDataPerInstanceList.PushBack(data);
 }
 
@@ -303,6 +282,7 @@ void StreamingSoundAsset::OnRemoveInstanceThreaded(unsigned instanceID)
   {
     // Remove it from the list and delete it
     mDataPerInstanceList.Erase(data);
+    StopStreamThreaded(data);
     delete data;
 
     // If there are no current instances playing, close the input file
@@ -322,48 +302,76 @@ Plasma::StreamingDataPerInstance* StreamingSoundAsset::GetInstanceData(unsigned
   return nullptr;
 }
 
-void StreamingSoundAsset::CopySamplesIntoBuffer(float* outputBuffer,
-                                                unsigned sampleIndex,
-                                                unsigned samplesRequested,
-                                                StreamingDataPerInstance* data)
+bool StreamingSoundAsset::StartStreamThreaded(StreamingDataPerInstance* data)
 {
-  // Check if the requested index is past the end of the Samples buffer
-  while (sampleIndex >= data->mSamples.Size())
+  StreamDecodingThreads& decodingThreads = PL::gSound->Mixer.StreamDecoders;
+
+  // Make sure the reader can keep up with the mix (the reader isn't attached to
+  // a stream, so nothing is writing to it)
+  data->mReader.Reserve(decodingThreads.GetReaderFrames());
+
+  // If the newest stream hasn't started decoding, share its decoded samples
+  // rather than decoding the same audio again
+  if (mNewestStream && !mNewestStream->mStarted)
   {
-    DecodedPacket packet;
-    // If there are no packets available, set the buffer to plasma and return
-    if (!data->mDecodedPacketQueue.Read(packet))
-    {
-      // Trigger another decoded buffer
-      data->mDecoder.DecodeNextSection();
+    decodingThreads.AddReaderThreaded(mNewestStream, &data->mReader);
+    return true;
+  }
 
-      memset(outputBuffer, 0, sizeof(float) * samplesRequested);
-      return;
+  Plasma::Status status;
+  DecodedStream* stream = nullptr;
+
+  // If the asset was created from packed data, stream from that
+  if (mPackedFileData.Data != nullptr)
+    stream = new DecodedStream(status, mPackedFileData.Data, mPackedFileData.Size, mChannels, mFrameCount);
+  // If there is data in the buffer, stream from memory
+  else if (!mInputFileData.Empty())
+    stream = new DecodedStream(status, mInputFileData.Data(), mInputFileData.Size(), mChannels, mFrameCount);
+  // Otherwise, check if the file name is set
+  else if (!mFileName.Empty())
+  {
+    // If the input file is not open (because there are no current instances)
+    // open it
+    if (!mInputFile.IsOpen())
+    {
+      mInputFile.Open(mFileName, Plasma::FileMode::Read, Plasma::FileAccessPattern::Sequential);
+      ErrorIf(!mInputFile.IsOpen(), "Could not open streaming audio file to play a new instance");
+      if (!mInputFile.IsOpen())
+        return false;
     }
 
-    // Increase the previous samples variable
-    data->mPreviousSamples += data->mSamples.Size();
-    // Adjust the sampleIndex
-    sampleIndex -= data->mSamples.Size();
-    // Remove the old samples
-    data->mSamples.Clear();
-    // Move the decoded data into the Samples buffer
-    data->mSamples.Swap(packet.mSamples);
-
-    // Trigger another decoded buffer
-    data->mDecoder.DecodeNextSection();
+    // Create the stream for streaming from file
+    stream = new DecodedStream(status, &mInputFile, &mLock, mChannels, mFrameCount);
   }
 
-  // Copy either the number of samples requested or the samples available,
-  // whichever is smaller
-  unsigned samplesCopied = Math::Min(samplesRequested, (unsigned)(data->mSamples.Size() - sampleIndex));
-  memcpy(outputBuffer, data->mSamples.Data() + sampleIndex, sizeof(float) * samplesCopied);
+  ErrorIf(!stream, "No data or file name to play streaming audio asset");
+
+  // If there was a problem creating the stream, delete it
+  if (status.Failed())
+  {
+    delete stream;
+    return false;
+  }
+  // Make sure the stream was created before using it
+  else if (!stream)
+    return false;
 
-  // If we did not copy enough samples, keep trying (in case there is another
-  // decoded buffer available)
-  if (samplesCopied < samplesRequested)
-    CopySamplesIntoBuffer(
-        outputBuffer + samplesCopied, sampleIndex + samplesCopied, samplesRequested - samplesCopied, data);
+  stream->mReaders.PushBack(&data->mReader);
+  data->mReader.mStream = stream;
+  decodingThreads.AddStreamThreaded(stream);
+
+  mNewestStream = stream;
+
+  return true;
+}
+
+void StreamingSoundAsset::StopStreamThreaded(StreamingDataPerInstance* data)
+{
+  // If this was the last reader the stream is deleted, so make sure it can't be
+  // shared with another instance
+  DecodedStream* deletedStream = PL::gSound->Mixer.StreamDecoders.RemoveReaderThreaded(&data->mReader);
+  if (deletedStream && deletedStream == mNewestStream)
+    mNewestStream = nullptr;
 }
 
 } // namespace Plasma
@@ -40,6 +40,9 @@ public:
   unsigned mFrameCount;
   // The name of the asset
   const String mName;
+  // Keeps the packed resource data the asset reads from alive (null when the
+  // asset was created from a file)
+  HandleOf<PackedResourceFile> mDataOwner;
 
 private:
   // Number of existing references from sound instances.
@@ -63,6 +66,8 @@ public:
   LightningDeclareType(DecompressedSoundAsset, TypeCopyMode::ReferenceType);
 
   DecompressedSoundAsset(Status& status, const String& fileName, const String& assetName);
+  // The file data must stay valid for as long as the asset exists
+  DecompressedSoundAsset(Status& status, DataBlock fileData, const String& assetName);
 
   // Appends the specified number of samples to the array, starting at the
   // specified frame index.
@@ -87,30 +92,13 @@ private:
 class StreamingDataPerInstance
 {
 public:
-  // The file object must be already open, and will not be closed by this
-  // decoder
-  StreamingDataPerInstance(
-      Status& status, File* inputFile, ThreadLock* lock, unsigned channels, unsigned frames, unsigned instanceID);
-  // The input data buffer must already exist, and will not be deleted by this
-  // decoder
-  StreamingDataPerInstance(
-      Status& status, byte* inputData, unsigned dataSize, unsigned channels, unsigned frames, unsigned instanceID);
-
-  // Resets the data to start streaming from the beginning of the file
-  void Reset();
-  // Called by the decoder to pass off decoded samples
-  void DecodingCallback(DecodedPacket* packet);
+  StreamingDataPerInstance(unsigned channels, unsigned instanceID);
 
-  // The current buffer of decoded samples
-  BufferType mSamples;
-  // Keeps track of previously played samples to translate indexes
-  unsigned mPreviousSamples;
-  // The decoder object
-  StreamingDecoder mDecoder;
+  // The decoded samples for this instance, and the stream decoding them (may
+  // be shared with other instances that are at the same position)
+  StreamReader mReader;
   // The ID of the instance associated with this data
   unsigned mInstanceID;
-  // The list of decoded packets to process
-  LockFreeQueue<DecodedPacket> mDecodedPacketQueue;
 
   Link<StreamingDataPerInstance> link;
 };
@@ -126,6 +114,9 @@ public:
                       const String& fileName,
                       AudioFileLoadType::Enum loadType,
                       const String& assetName);
+  // Streams from the file data, which must stay valid for as long as the asset
+  // exists
+  StreamingSoundAsset(Status& status, DataBlock fileData, const String& assetName);
   ~StreamingSoundAsset();
 
   // Appends the specified number of samples to the array, starting at the
@@ -145,20 +136,25 @@ private:
   // Looks for a specific instance ID in the data list. Returns null if not
   // found.
   StreamingDataPerInstance* GetInstanceData(unsigned instanceID);
-  // Copies available decoded samples into the provided buffer
-  void CopySamplesIntoBuffer(float* outputBuffer,
-                             unsigned sampleIndex,
-                             unsigned samplesRequested,
-                             StreamingDataPerInstance* data);
+  // Starts decoding from the beginning of the file for this instance. If the
+  // newest stream hasn't started decoding, the instance shares it. Returns
+  // false if a stream could not be created.
+  bool StartStreamThreaded(StreamingDataPerInstance* data);
+  // Stops decoding for this instance
+  void StopStreamThreaded(StreamingDataPerInstance* data);
 
   // Decoded data per instance
   InList<StreamingDataPerInstance> mDataPerInstanceList;
+  // The most recently created stream
+  DecodedStream* mNewestStream;
   // If streaming from file, the file object to keep open
   File mInputFile;
   // The name of the file
   String mFileName;
   // If streaming from memory, the data read in from the file
   Array<byte> mInputFileData;
+  // If streaming from packed data, the data after the file header (not owned)
+  DataBlock mPackedFileData;
   // Used to lock when reading from the input file
   ThreadLock mLock;
 };
@@ -289,6 +289,7 @@ LightningDefineType(SoundCue, builder, type)
   LightningBindGetterSetterProperty(SemitoneVariation)
       ->Add(new EditorSlider(0.0f, 12.0f, 0.1f))
       ->PlasmaFilterBool(mUseSemitoneVariation);
+  LightningBindGetterSetterProperty(Priority);
   LightningBindGetterSetterProperty(Attenuator);
   LightningBindFieldProperty(mShowMusicOptions)->AddAttribute(PropertyAttributes::cInvalidatesObject);
   LightningBindGetterSetterProperty(BeatsPerMinute)->PlasmaFilterBool(mShowMusicOptions);
@@ -319,6 +320,7 @@ SoundCue::SoundCue() :
     mPitch(0.0f),
     mPitchVariation(0.0f),
     mSemitoneVariation(0),
+    mPriority(0),
     mDecibelVariation(0),
     mShowMusicOptions(false),
     mBeatsPerMinute(0),
@@ -348,6 +350,7 @@ void SoundCue::Serialize(Serializer& stream)
   SerializeNameDefault(mUseSemitoneVariation, false);
   SerializeNameDefault(mPitchVariation, 0.0f);
   SerializeNameDefault(mSemitoneVariation, 0.0f);
+  SerializeNameDefault(mPriority, 0);
   SerializeNameDefault(mShowMusicOptions, false);
   SerializeNameDefault(mBeatsPerMinute, 0.0f);
   SerializeNameDefault(mTimeSigBeats, 0.0f);
@@ -466,6 +469,16 @@ void SoundCue::SetSemitoneVariation(float variation)
   mSemitoneVariation = Math::Clamp(variation, 0.0f, cMaxSemitonesValue);
 }
 
+int SoundCue::GetPriority()
+{
+  return mPriority;
+}
+
+void SoundCue::SetPriority(int priority)
+{
+  mPriority = priority;
+}
+
 float SoundCue::GetBeatsPerMinute()
 {
   return mBeatsPerMinute;
@@ -614,6 +627,8 @@ HandleOf<SoundInstance> SoundCue::PlayCue(SoundSpace* space, HandleOf<SoundNode>
     return nullptr;
   }
 
+  instance->SetPriority(mPriority);
+
   // Set the time settings on the instance
   if (entry->GetStartTime() > 0.0f)
     instance->SetTime(entry->GetStartTime());
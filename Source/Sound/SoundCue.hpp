@@ -218,6 +218,11 @@ public:
   /// be chosen randomly between -5 and 5.
   float GetSemitoneVariation();
   void SetSemitoneVariation(float variation);
+  /// The Priority of the SoundInstances played by this SoundCue. When more
+  /// SoundInstances are playing than the audio system allows, the ones with the
+  /// lowest Priority will stop processing audio first.
+  int GetPriority();
+  void SetPriority(int priority);
   /// If true, the music options will be shown. If false, they will be hidden.
   bool mShowMusicOptions;
   /// The speed of the music, using beats per minute.
@@ -265,6 +270,7 @@ private:
   float mDecibelVariation;
   float mPitchVariation;
   float mSemitoneVariation;
+  int mPriority;
   float mBeatsPerMinute;
   float mTimeSigBeats;
   float mTimeSigValue;
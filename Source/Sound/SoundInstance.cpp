@@ -244,6 +244,8 @@ LightningDefineType(SoundInstance, builder, type)
   LightningBindGetterSetter(Pitch);
   LightningBindGetterSetter(Semitones);
   LightningBindGetter(IsPlaying);
+  LightningBindGetterSetter(Priority);
+  LightningBindGetter(IsVirtual);
   LightningBindGetter(SoundNode);
   LightningBindMethod(InterpolatePitch);
   LightningBindMethod(InterpolateSemitones);
@@ -290,6 +292,8 @@ SoundInstance::SoundInstance(Status& status, SoundSpace* space, SoundAsset* asse
     mNotifyTime(0.0f),
     mCustomNotifySent(false),
     mPitchSemitones(0.0f),
+    mPriority(0),
+    mIsVirtual(cFalse),
     mFrameIndexThreaded(0),
     mPausingThreaded(false),
     mStoppingThreaded(false),
@@ -302,6 +306,10 @@ SoundInstance::SoundInstance(Status& status, SoundSpace* space, SoundAsset* asse
     mLoopEndFrameThreaded(asset->mFrameCount),
     mLoopTailFramesThreaded(0),
     PausingModifierThreaded(nullptr),
+    mVirtualThreaded(false),
+    mVirtualizingThreaded(false),
+    mVirtualFrameCountThreaded(0),
+    VirtualModifierThreaded(nullptr),
     mSavedOutputVersionThreaded(PL::gSound->Mixer.mMixVersionThreaded - 1)
 {
   Fade.mInstanceID = cNodeID;
@@ -417,6 +425,21 @@ bool SoundInstance::GetIsPlaying()
   return mFinished.Get() == cFalse;
 }
 
+int SoundInstance::GetPriority()
+{
+  return mPriority.Get();
+}
+
+void SoundInstance::SetPriority(int priority)
+{
+  mPriority.Set(priority);
+}
+
+bool SoundInstance::GetIsVirtual()
+{
+  return mIsVirtual.Get() == cTrue;
+}
+
 HandleOf<SoundNode> SoundInstance::GetSoundNode()
 {
   // TODO deprecate this
@@ -605,6 +628,9 @@ void SoundInstance::Play(bool loop, SoundNode* outputNode, bool startPaused)
   else if (mSpace)
     mSpace->GetInputNode()->AddInputNode(this);
 
+  // Let the voice manager decide whether this instance processes audio
+  PL::gSound->Mixer.AddTask(CreateFunctor(&VoiceManager::AddVoiceThreaded, &PL::gSound->Mixer.Voices, this), this);
+
   if (!startPaused)
     SetPaused(false);
 }
@@ -673,14 +699,23 @@ bool SoundInstance::GetOutputForThisMixThreaded(BufferType* outputBuffer, const
     if (mFinished.Get() == cTrue || mPaused.Get() == cTrue)
       return false;
 
-    // if (mVirtual)
-    //{
-    //  SkipForward(bufferFrames);
-    //  return false;
-    //}
-
     // Reset the InputSamples buffer
     mInputSamplesThreaded.Clear();
+
+    // If virtual, only keep track of the playback position
+    if (mVirtualThreaded)
+    {
+      SkipForwardThreaded(outputBuffer->Size() / numberOfChannels, numberOfChannels);
+
+      if (mPaused.Get() == cTrue && PausingModifierThreaded)
+      {
+        PausingModifierThreaded->Active = false;
+        PausingModifierThreaded = nullptr;
+      }
+
+      return false;
+    }
+
     // Fill the InputSamples buffer with the needed number of samples
     AddSamplesToBufferThreaded(&mInputSamplesThreaded, outputBuffer->Size() / numberOfChannels, numberOfChannels);
 
@@ -695,6 +730,14 @@ bool SoundInstance::GetOutputForThisMixThreaded(BufferType* outputBuffer, const
     ErrorIf(outputBuffer->Size() != mInputSamplesThreaded.Size(), "Buffer sizes do not match in SoundInstance output");
     memcpy(outputBuffer->Data(), mInputSamplesThreaded.Data(), sizeof(float) * outputBuffer->Size());
 
+    // Check if finished fading out to become virtual
+    if (mVirtualizingThreaded)
+    {
+      mVirtualFrameCountThreaded += outputBuffer->Size() / numberOfChannels;
+      if (mVirtualFrameCountThreaded >= cPropertyChangeFrames)
+        FinishVirtualizingThreaded();
+    }
+
     if (mPaused.Get() == cTrue && PausingModifierThreaded)
     {
       PausingModifierThreaded->Active = false;
@@ -714,6 +757,72 @@ float SoundInstance::GetAttenuationThisMixThreaded()
   return volume;
 }
 
+float SoundInstance::GetEstimatedVolumeThreaded(unsigned frames)
+{
+  // Determine overall volume at the beginning and end of the mix
+  float volume1 = mVolume.Get(AudioThreads::MixThread);
+  float volume2 = volume1;
+
+  // If interpolating volume, get the volumes from the interpolator
+  if (mInterpolatingVolumeThreaded)
+  {
+    volume1 = VolumeInterpolatorThreaded.GetCurrentValue();
+    volume2 = VolumeInterpolatorThreaded.ValueAtIndex(VolumeInterpolatorThreaded.GetCurrentFrame() + frames);
+  }
+
+  // Adjust with all volume modifiers, except the one fading out to become
+  // virtual (the estimate is the volume this instance would have if it kept
+  // processing audio)
+  forRange (InstanceVolumeModifier* modifier, VolumeModListThreaded.All())
+  {
+    if (modifier->Active && modifier != VirtualModifierThreaded)
+    {
+      volume1 *= modifier->GetCurrentVolume();
+      volume2 *= modifier->GetFutureVolume(frames);
+    }
+  }
+
+  return Math::Max(volume1, volume2) * GetAttenuationThisMixThreaded();
+}
+
+void SoundInstance::SetVirtualThreaded(bool makeVirtual, bool fadeOut)
+{
+  if (makeVirtual)
+  {
+    // Nothing to do if already virtual or becoming virtual
+    if (mVirtualThreaded || mVirtualizingThreaded)
+      return;
+
+    if (fadeOut)
+    {
+      mVirtualizingThreaded = true;
+      mVirtualFrameCountThreaded = 0;
+      VirtualModifierThreaded = GetAvailableVolumeModThreaded();
+      VirtualModifierThreaded->Reset(1.0f, 0.0f, cPropertyChangeFrames, 0u);
+    }
+    else
+      FinishVirtualizingThreaded();
+  }
+  // If still fading out, fade back in from the current volume
+  else if (mVirtualizingThreaded)
+  {
+    mVirtualizingThreaded = false;
+    VirtualModifierThreaded->Reset(
+        VirtualModifierThreaded->GetCurrentVolume(), 1.0f, cPropertyChangeFrames, cPropertyChangeFrames);
+    VirtualModifierThreaded = nullptr;
+  }
+  // If virtual, start processing audio again with a fade in
+  else if (mVirtualThreaded)
+  {
+    mVirtualThreaded = false;
+    mIsVirtual.Set(cFalse);
+
+    InstanceVolumeModifier* mod = GetAvailableVolumeModThreaded();
+    if (mod)
+      mod->Reset(0.0f, 1.0f, cPropertyChangeFrames, cPropertyChangeFrames);
+  }
+}
+
 void SoundInstance::DispatchInstanceEventFromMixThread(const String eventID)
 {
   SoundInstanceEvent event(this);
@@ -883,6 +992,92 @@ void SoundInstance::AddSamplesToBufferThreaded(BufferType* buffer, unsigned outp
   // Add the samples to the end of the supplied buffer
   AppendToBuffer(buffer, samples, 0, samples.Size());
 
+  UpdatePlaybackStateThreaded(inputFrames);
+}
+
+void SoundInstance::SkipForwardThreaded(unsigned outputFrames, unsigned outputChannels)
+{
+  // Saved samples will not be heard, so they count as part of the skipped audio
+  unsigned savedFrames = Math::Min((unsigned)SavedSamplesThreaded.Size() / outputChannels, outputFrames);
+  SavedSamplesThreaded.Clear();
+  outputFrames -= savedFrames;
+
+  // Volume modifiers keep changing as if the audio was processed
+  forRange (InstanceVolumeModifier* modifier, VolumeModListThreaded.All())
+    modifier->SkipForward(outputFrames + savedFrames);
+
+  if (outputFrames == 0)
+    return;
+
+  // Streaming audio can only be decoded in order, so the samples still need to
+  // be read even though they are not used
+  if (mAssetObject->mStreaming)
+  {
+    BufferType samples;
+    AddSamplesToBufferThreaded(&samples, outputFrames, outputChannels);
+    return;
+  }
+
+  unsigned inputFrames = outputFrames;
+
+  // If pitch shifting, determine number of asset frames that would be used
+  if (mPitchShiftingThreaded)
+  {
+    bool interpolating = Pitch.Interpolating();
+
+    Pitch.CalculateBufferSize(outputFrames * outputChannels, outputChannels);
+    inputFrames = Pitch.GetInputFrameCount();
+    Pitch.SkipBuffer(outputFrames);
+
+    if (interpolating)
+      mPitchSemitones.Set(12.0f * Math::Log2(Pitch.GetPitchFactor()), AudioThreads::MixThread);
+  }
+
+  // Store the starting frame
+  int startingFrameIndex = mFrameIndexThreaded;
+  // Move the frame index forward
+  mFrameIndexThreaded += inputFrames;
+
+  // Check if we are looping and reached the loop end frame
+  if (mLooping.Get() == cTrue &&
+      (mFrameIndexThreaded >= mLoopEndFrameThreaded || mFrameIndexThreaded >= mEndFrameThreaded))
+  {
+    // Number of frames that would have been played after looping
+    unsigned framesAfterLoop = inputFrames;
+    if (startingFrameIndex < mLoopEndFrameThreaded)
+      framesAfterLoop = mFrameIndexThreaded - Math::Min(mLoopEndFrameThreaded, mEndFrameThreaded);
+
+    LoopThreaded();
+    mFrameIndexThreaded += framesAfterLoop;
+  }
+  // Check if we reached the end of the audio
+  else if (mFrameIndexThreaded >= mEndFrameThreaded)
+  {
+    FinishedCleanUpThreaded();
+  }
+
+  // Move the volume interpolation forward
+  if (mInterpolatingVolumeThreaded)
+  {
+    VolumeInterpolatorThreaded.JumpForward(outputFrames);
+
+    if (VolumeInterpolatorThreaded.Finished())
+    {
+      mInterpolatingVolumeThreaded = false;
+      mVolume.Set(VolumeInterpolatorThreaded.GetEndValue(), AudioThreads::MixThread);
+
+      PL::gSound->Mixer.AddTaskThreaded(CreateFunctor(&SoundInstance::DispatchEventFromMixThread,
+                                                     (SoundNode*)this,
+                                                     Events::AudioInterpolationDone),
+                                       this);
+    }
+  }
+
+  UpdatePlaybackStateThreaded(inputFrames);
+}
+
+void SoundInstance::UpdatePlaybackStateThreaded(unsigned inputFrames)
+{
   // Check for pausing or stopping
   if (mPausingThreaded || mStoppingThreaded)
   {
@@ -909,8 +1104,9 @@ void SoundInstance::AddSamplesToBufferThreaded(BufferType* buffer, unsigned outp
 
 void SoundInstance::LoopThreaded()
 {
-  // Handle fading if we're not at the end of the audio
-  if (mLoopEndFrameThreaded < mEndFrameThreaded)
+  // Handle fading if we're not at the end of the audio (a virtual instance
+  // doesn't process audio, so it doesn't need to fade)
+  if (mLoopEndFrameThreaded < mEndFrameThreaded && !mVirtualThreaded)
   {
     // Use the default cross fade size if streaming or if the variable hasn't
     // been set
@@ -982,32 +1178,22 @@ void SoundInstance::FinishedCleanUpThreaded()
   PL::gSound->Mixer.AddTaskThreaded(CreateFunctor(&SoundAsset::RemoveInstance, *mAssetObject, cNodeID), this);
 }
 
-bool SoundInstance::BelowMinimumVolumeThreaded(unsigned frames)
+void SoundInstance::FinishVirtualizingThreaded()
 {
-  // Determine overall volume at the beginning and end of the mix
-  float volume1 = mVolume.Get(AudioThreads::MixThread);
-  float volume2 = volume1;
+  mVirtualizingThreaded = false;
+  mVirtualThreaded = true;
+  mIsVirtual.Set(cTrue);
 
-  // If interpolating volume, get the volume at the end of the mix
-  if (mInterpolatingVolumeThreaded)
-    volume2 = VolumeInterpolatorThreaded.ValueAtIndex(mFrameIndexThreaded + frames);
-
-  // Adjust with all volume modifiers
-  forRange (InstanceVolumeModifier* modifier, VolumeModListThreaded.All())
+  if (VirtualModifierThreaded)
   {
-    if (modifier->Active)
-    {
-      volume1 *= modifier->GetCurrentVolume();
-      volume2 *= modifier->GetFutureVolume(frames);
-    }
+    VirtualModifierThreaded->Active = false;
+    VirtualModifierThreaded = nullptr;
   }
 
-  // Return true if both volumes lower than minimum volume threshold
-  if (volume1 < PL::gSound->Mixer.mMinimumVolumeThresholdThreaded &&
-      volume2 < PL::gSound->Mixer.mMinimumVolumeThresholdThreaded)
-    return true;
-  else
-    return false;
+  // Any saved audio or fade in progress would not line up with the audio when
+  // this instance starts processing again
+  SavedSamplesThreaded.Clear();
+  Fade.mFading = false;
 }
 
 void SoundInstance::RemoveFromAllTagsThreaded()
@@ -1040,6 +1226,11 @@ void SoundInstance::ResetMusicBeatsThreaded()
   MusicNotify.ResetBeats((float)mCurrentTime.Get(AudioThreads::MixThread), this);
 }
 
+bool SoundInstance::CanEvaluateInParallelThreaded()
+{
+  return TagListThreaded.Empty();
+}
+
 void SoundInstance::DisconnectThisAndAllInputs()
 {
   SoundNode::DisconnectThisAndAllInputs();
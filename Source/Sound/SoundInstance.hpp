@@ -183,6 +183,16 @@ public:
   /// This Property will be true while the SoundInstance is playing, then will
   /// become false when its sound has stopped.
   bool GetIsPlaying();
+  /// When more SoundInstances are playing than the MaxRealVoices setting on
+  /// AudioSettings allows, the ones with the lowest Priority stop processing
+  /// audio until there is room for them again. Among instances with the same
+  /// Priority, the quietest ones are the first to stop.
+  int GetPriority();
+  void SetPriority(int priority);
+  /// This Property will be true while the SoundInstance is too quiet to be heard
+  /// or was dropped because of its Priority. It keeps track of its playback
+  /// position but does not process any audio until it becomes audible again.
+  bool GetIsVirtual();
   /// The SoundNode associated with this SoundInstance.
   HandleOf<SoundNode> GetSoundNode();
   /// When this Property is true the SoundInstance will loop indefinitely. If
@@ -244,8 +254,17 @@ public:
   bool GetOutputForThisMixThreaded(BufferType* buffer, const unsigned numberOfChannels);
   // Gets the cumulative volume attenuation from all output nodes
   float GetAttenuationThisMixThreaded();
+  // Returns the highest volume this instance will have over the specified number
+  // of frames, including volume modifiers and attenuation from output nodes
+  float GetEstimatedVolumeThreaded(unsigned frames);
+  // Sets whether the instance should stop processing audio and only keep track
+  // of its position. If fadeOut is true, the audio fades out before stopping.
+  void SetVirtualThreaded(bool makeVirtual, bool fadeOut);
 
   void DispatchInstanceEventFromMixThread(const String eventID);
+  // Tags read the output of all their instances, so tagged instances must be
+  // evaluated on the same thread
+  bool CanEvaluateInParallelThreaded() override;
 
 private:
   bool GetOutputSamples(BufferType* outputBuffer,
@@ -264,8 +283,12 @@ private:
                                         const unsigned outputChannels);
   // Sends notification and removes instance from any associated tags.
   void FinishedCleanUpThreaded();
-  // Check for whether the total volume is lower than the minimum.
-  bool BelowMinimumVolumeThreaded(unsigned frames);
+  // Moves the playback position forward without processing any audio
+  void SkipForwardThreaded(unsigned outputFrames, unsigned outputChannels);
+  // Handles pausing, stopping, and notifications after moving forward
+  void UpdatePlaybackStateThreaded(unsigned inputFrames);
+  // Stops processing audio once the fade out is finished
+  void FinishVirtualizingThreaded();
   // Removes this instance from all tags it is associated with.
   void RemoveFromAllTagsThreaded();
   // Handle music beat notifications.
@@ -325,6 +348,10 @@ private:
   Threaded<bool> mCustomNotifySent;
   // The current number of semitones by which the pitch is being changed.
   Threaded<float> mPitchSemitones;
+  // Used to decide which instances are virtualized first.
+  ThreadedInt mPriority;
+  // If true, the instance is not processing audio.
+  ThreadedInt mIsVirtual;
 
   const float cMaxLoopTailTime = 30.0f;
 
@@ -354,6 +381,14 @@ private:
   int mLoopTailFramesThreaded;
   // Used to control volume modifications while pausing.
   InstanceVolumeModifier* PausingModifierThreaded;
+  // If true, the instance is only keeping track of its position.
+  bool mVirtualThreaded;
+  // If true, sound is ramping volume down to plasma to become virtual.
+  bool mVirtualizingThreaded;
+  // Counts number of frames until becoming virtual.
+  unsigned mVirtualFrameCountThreaded;
+  // Used to control volume modifications while becoming virtual.
+  InstanceVolumeModifier* VirtualModifierThreaded;
   // Used to interpolate from one volume to another.
   InterpolatingObject VolumeInterpolatorThreaded;
   // Volume adjustments, used by the instance and by tags.
@@ -37,6 +37,7 @@ LightningDefineType(SoundNode, builder, type)
   LightningBindGetter(OutputCount);
   LightningBindGetterSetter(BypassPercent)->AddAttribute(DeprecatedAttribute);
   LightningBindGetterSetter(BypassValue);
+  LightningBindGetter(ProcessingTime);
 
   PlasmaBindEvent(Events::AudioInterpolationDone, SoundEvent);
   PlasmaBindEvent(Events::SoundNodeDisconnected, SoundEvent);
@@ -55,7 +56,12 @@ SoundNode::SoundNode(StringParam name, int ID, bool listenerDependent, bool gene
     mValidOutputLastMix(false),
     mListenerDependentThreaded(listenerDependent),
     mBypassValue(0.0f),
-    mGeneratorThreaded(generator)
+    mGeneratorThreaded(generator),
+    mInputTimeThreaded(0.0),
+    mProcessingTimeThreaded(0.0),
+    mProcessingNanoseconds(0),
+    mParallelClaimIDThreaded(0),
+    mParallelClaimIndexThreaded(0)
 {
   ConnectThisTo(&(PL::gSound->Mixer), Events::SoundListenerRemoved, RemoveListenerThreaded);
 }
@@ -319,6 +325,11 @@ void SoundNode::SetBypassValue(float value)
   mBypassValue.Set(Math::Clamp(value, 0.0f, 1.0f), AudioThreads::MainThread);
 }
 
+float SoundNode::GetProcessingTime()
+{
+  return mProcessingNanoseconds.Get() / 1000000.0f;
+}
+
 void SoundNode::DisconnectThisAndAllInputs()
 {
   // Call this function on all input nodes (removes inputs)
@@ -410,7 +421,7 @@ bool SoundNode::Evaluate(BufferType* outputBuffer, const unsigned numberOfChanne
       mMixedListenerThreaded = listener;
 
       // Get output
-      hasOutput = GetOutputSamples(&mMixedOutputThreaded, numberOfChannels, listener, false);
+      hasOutput = GetTimedOutputSamplesThreaded(&mMixedOutputThreaded, numberOfChannels, listener, false);
 
       if (mValidOutputLastMix.Get() == cFalse && hasOutput)
         mValidOutputLastMix.Set(cTrue);
@@ -429,28 +440,17 @@ bool SoundNode::Evaluate(BufferType* outputBuffer, const unsigned numberOfChanne
     mMixedVersionThreaded = PL::gSound->Mixer.mMixVersionThreaded;
     mNumMixedChannelsThreaded = numberOfChannels;
     mMixedListenerThreaded = listener;
+    mProcessingTimeThreaded = 0.0;
 
     // Set mixed array to same size as output array
     mMixedOutputThreaded.Resize(outputBuffer->Size());
 
-    // Check whether this node's data can be saved
-    mOkayToSaveThreaded = !mListenerDependentThreaded;
-    // If this node can be saved, check all its inputs to verify
-    // (if any inputs can't be saved, neither can this node)
-    if (mOkayToSaveThreaded)
-    {
-      forRange (SoundNode* input, mInputs[AudioThreads::MixThread].All())
-      {
-        if (!input->mOkayToSaveThreaded)
-        {
-          mOkayToSaveThreaded = false;
-          break;
-        }
-      }
-    }
-
     // Get output
-    hasOutput = GetOutputSamples(&mMixedOutputThreaded, numberOfChannels, listener, true);
+    hasOutput = GetTimedOutputSamplesThreaded(&mMixedOutputThreaded, numberOfChannels, listener, true);
+
+    // Now that the inputs have been mixed, check whether this output can be
+    // reused for other listeners during this mix
+    mOkayToSaveThreaded = IsListenerInvariantThreaded();
 
     ErrorIf(hasOutput && (mMixedOutputThreaded[0] > 10.0f || mMixedOutputThreaded[0] < -10.0f),
             "Audio data is outside of normal values");
@@ -475,6 +475,47 @@ bool SoundNode::Evaluate(BufferType* outputBuffer, const unsigned numberOfChanne
   return hasOutput;
 }
 
+bool SoundNode::IsListenerInvariantThreaded()
+{
+  if (mListenerDependentThreaded)
+    return false;
+  if (IgnoresListenerThreaded())
+    return true;
+
+  // If any input mixed this version can't be saved, neither can this node.
+  // Inputs that weren't mixed didn't contribute to the output.
+  unsigned mixVersion = PL::gSound->Mixer.mMixVersionThreaded;
+  forRange (SoundNode* input, mInputs[AudioThreads::MixThread].All())
+  {
+    if (input->mMixedVersionThreaded == mixVersion && !input->mOkayToSaveThreaded)
+      return false;
+  }
+
+  return true;
+}
+
+// Adds the output of an input node to the accumulated input samples
+static void AddInputToSamples(BufferType* inputSamples, BufferType* newSamples, bool& isThereInput)
+{
+  ErrorIf((*newSamples)[0] > 10.0f || (*newSamples)[0] < -10.0f, "Audio data is outside of normal limits");
+
+  // If this is the first input data, just swap the buffers
+  if (!isThereInput)
+  {
+    isThereInput = true;
+    inputSamples->Swap(*newSamples);
+  }
+  // Otherwise add the new samples to the existing ones
+  else
+  {
+    for (BufferRange myData = inputSamples->All(), newData = newSamples->All(); !myData.Empty();
+         myData.PopFront(), newData.PopFront())
+    {
+      myData.Front() += newData.Front();
+    }
+  }
+}
+
 bool SoundNode::AccumulateInputSamples(const unsigned howManySamples,
                                        const unsigned numberOfChannels,
                                        ListenerNode* listener)
@@ -483,41 +524,144 @@ bool SoundNode::AccumulateInputSamples(const unsigned howManySamples,
   if (mInputs[AudioThreads::MixThread].Empty())
     return false;
 
-  BufferType tempBuffer(howManySamples);
+  // Time spent on inputs is not counted as this node's processing time
+  Timer timer;
+
   bool isThereInput(false);
 
   // Reset buffer
   mInputSamplesThreaded.Resize(howManySamples);
 
-  // Get samples from all inputs
-  forRange (SoundNode* input, mInputs[AudioThreads::MixThread].All())
+  // If there are enough independent inputs, evaluate them on the helper threads
+  if (!AccumulateInputSamplesInParallel(howManySamples, numberOfChannels, listener, isThereInput))
   {
-    // Check if this input has actual output data
-    if (input->Evaluate(&tempBuffer, numberOfChannels, listener))
-    {
-      ErrorIf(tempBuffer[0] > 10.0f || tempBuffer[0] < -10.0f, "Audio data is outside of normal limits");
+    BufferType tempBuffer(howManySamples);
 
-      // If this is the first input data, just swap the buffers
-      if (!isThereInput)
-      {
-        isThereInput = true;
-        mInputSamplesThreaded.Swap(tempBuffer);
-      }
-      // Otherwise add the new samples to the existing ones
-      else
-      {
-        for (BufferRange myData = mInputSamplesThreaded.All(), newData = tempBuffer.All(); !myData.Empty();
-             myData.PopFront(), newData.PopFront())
-        {
-          myData.Front() += newData.Front();
-        }
-      }
+    // Get samples from all inputs
+    forRange (SoundNode* input, mInputs[AudioThreads::MixThread].All())
+    {
+      // Check if this input has actual output data
+      if (input->Evaluate(&tempBuffer, numberOfChannels, listener))
+        AddInputToSamples(&mInputSamplesThreaded, &tempBuffer, isThereInput);
     }
   }
 
+  mInputTimeThreaded += timer.UpdateAndGetTime();
+
   return isThereInput;
 }
 
+bool SoundNode::AccumulateInputSamplesInParallel(const unsigned howManySamples,
+                                                 const unsigned numberOfChannels,
+                                                 ListenerNode* listener,
+                                                 bool& isThereInput)
+{
+  // Fewer inputs than this are not worth the overhead of waking the helpers
+  const unsigned cMinParallelInputs = 4;
+
+  NodeListType& inputs = mInputs[AudioThreads::MixThread];
+  MixHelperThreads& helpers = PL::gSound->Mixer.MixHelpers;
+  if (inputs.Size() < cMinParallelInputs || !helpers.CanRunInParallelThreaded())
+    return false;
+
+  // Find the inputs that don't share any nodes with each other. This node is
+  // claimed first so that a loop back to it keeps that input on this thread.
+  static unsigned sClaimID = 0;
+  ++sClaimID;
+
+  Array<bool> serialInputs(inputs.Size(), false);
+  mParallelClaimIDThreaded = sClaimID;
+  mParallelClaimIndexThreaded = -1;
+  for (unsigned i = 0; i < inputs.Size(); ++i)
+    inputs[i]->ClaimForParallelMixThreaded(sClaimID, (int)i, serialInputs);
+
+  unsigned parallelCount = 0;
+  for (unsigned i = 0; i < serialInputs.Size(); ++i)
+  {
+    if (!serialInputs[i])
+      ++parallelCount;
+  }
+
+  if (parallelCount < 2)
+    return false;
+
+  // Evaluate the independent inputs on the helper threads
+  mParallelJobsThreaded.Resize(parallelCount);
+  unsigned jobIndex = 0;
+  for (unsigned i = 0; i < inputs.Size(); ++i)
+  {
+    if (serialInputs[i])
+      continue;
+
+    ParallelMixJob& job = mParallelJobsThreaded[jobIndex++];
+    job.mNode = inputs[i];
+    job.mBuffer.Resize(howManySamples);
+    job.mHasOutput = false;
+  }
+
+  helpers.RunThreaded(mParallelJobsThreaded, numberOfChannels, listener);
+
+  forRange (ParallelMixJob& job, mParallelJobsThreaded.All())
+  {
+    if (job.mHasOutput)
+      AddInputToSamples(&mInputSamplesThreaded, &job.mBuffer, isThereInput);
+    job.mNode = nullptr;
+  }
+
+  // The remaining inputs are evaluated on this thread, now that the helpers are
+  // finished with the nodes they share
+  BufferType tempBuffer(howManySamples);
+  for (unsigned i = 0; i < inputs.Size(); ++i)
+  {
+    if (serialInputs[i] && inputs[i]->Evaluate(&tempBuffer, numberOfChannels, listener))
+      AddInputToSamples(&mInputSamplesThreaded, &tempBuffer, isThereInput);
+  }
+
+  return true;
+}
+
+void SoundNode::ClaimForParallelMixThreaded(unsigned claimID, int inputIndex, Array<bool>& serialInputs)
+{
+  // Already claimed during this evaluation
+  if (mParallelClaimIDThreaded == claimID)
+  {
+    // Reached through a different input (or is the node being evaluated), so
+    // every input that uses it must stay on the same thread
+    if (mParallelClaimIndexThreaded != inputIndex)
+    {
+      serialInputs[inputIndex] = true;
+      if (mParallelClaimIndexThreaded >= 0)
+        serialInputs[mParallelClaimIndexThreaded] = true;
+    }
+    return;
+  }
+
+  mParallelClaimIDThreaded = claimID;
+  mParallelClaimIndexThreaded = inputIndex;
+
+  if (!CanEvaluateInParallelThreaded())
+    serialInputs[inputIndex] = true;
+
+  forRange (SoundNode* input, mInputs[AudioThreads::MixThread].All())
+    input->ClaimForParallelMixThreaded(claimID, inputIndex, serialInputs);
+}
+
+bool SoundNode::GetTimedOutputSamplesThreaded(BufferType* outputBuffer,
+                                              const unsigned numberOfChannels,
+                                              ListenerNode* listener,
+                                              const bool firstRequest)
+{
+  mInputTimeThreaded = 0.0;
+  Timer timer;
+
+  bool hasOutput = GetOutputSamples(outputBuffer, numberOfChannels, listener, firstRequest);
+
+  mProcessingTimeThreaded += Math::Max(timer.UpdateAndGetTime() - mInputTimeThreaded, 0.0);
+  mProcessingNanoseconds.Set((int)(mProcessingTimeThreaded * 1000000000.0));
+
+  return hasOutput;
+}
+
 void SoundNode::AddBypassThreaded(BufferType* outputBuffer)
 {
   // If some of the node's output should be bypassed, adjust the output buffer
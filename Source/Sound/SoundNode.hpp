@@ -72,6 +72,9 @@ public:
   /// the node does.
   float GetBypassValue();
   void SetBypassValue(float value);
+  /// The time, in milliseconds, that this node spent processing audio during
+  /// the last mix. Does not include the time spent by its input nodes.
+  float GetProcessingTime();
 
   // Internals
   // The ID given to this sound node when it was constructed
@@ -101,7 +104,22 @@ public:
   // The output node will return 1.0. Nodes which modify volume should implement
   // this function and multiply their volume with the return value.
   virtual float GetVolumeChangeFromOutputsThreaded();
-  // Handles getting the output from the sound node
+  // Returns false if this node uses data shared with other nodes while mixing,
+  // so it can't be evaluated on a mix helper thread alongside them
+  virtual bool CanEvaluateInParallelThreaded()
+  {
+    return true;
+  }
+  // Returns true if this node's output is the same for every listener no matter
+  // what its inputs are, such as a node which mixes its inputs for a listener
+  // of its own
+  virtual bool IgnoresListenerThreaded()
+  {
+    return false;
+  }
+  // Handles getting the output from the sound node. Output that doesn't depend
+  // on the listener is only processed once per mix and reused for every
+  // listener.
   bool Evaluate(BufferType* outputBuffer, const unsigned numberOfChannels, ListenerNode* listener);
   // Adds the output from all input nodes to the InputSamples buffer
   bool AccumulateInputSamples(const unsigned howManySamples, const unsigned numberOfChannels, ListenerNode* listener);
@@ -113,6 +131,28 @@ public:
   void RemoveInputNodeThreaded(HandleOf<SoundNode> node);
 
 private:
+  // Gets the output from GetOutputSamples and adds the time taken, minus the
+  // time taken by input nodes, to the processing time for this mix
+  bool GetTimedOutputSamplesThreaded(BufferType* outputBuffer,
+                                     const unsigned numberOfChannels,
+                                     ListenerNode* listener,
+                                     const bool firstRequest);
+  // Returns true if the output from the current mix can be reused for every
+  // listener: this node isn't listener dependent, and either ignores the
+  // listener or none of the inputs mixed this version are listener dependent
+  bool IsListenerInvariantThreaded();
+  // Evaluates the inputs that don't share nodes with each other on the mix
+  // helper threads. Returns false if there weren't enough of them to be worth
+  // it, in which case nothing was evaluated.
+  bool AccumulateInputSamplesInParallel(const unsigned howManySamples,
+                                        const unsigned numberOfChannels,
+                                        ListenerNode* listener,
+                                        bool& isThereInput);
+  // Marks this node and all nodes it gets input from as belonging to the
+  // specified input, or marks the input as serial if a node already belongs
+  // to a different one or can't be evaluated in parallel
+  void ClaimForParallelMixThreaded(unsigned claimID, int inputIndex, Array<bool>& serialInputs);
+
   // If false, this node's output should not be saved into the MixedOutput
   // buffer
   bool mOkayToSaveThreaded;
@@ -140,6 +180,17 @@ private:
   Threaded<float> mBypassValue;
   // If true, this is a node which generates audio
   bool mGeneratorThreaded;
+  // Time spent evaluating input nodes during the current GetOutputSamples call
+  double mInputTimeThreaded;
+  // Time spent processing audio during the current mix version
+  double mProcessingTimeThreaded;
+  // The processing time for the last mix in nanoseconds
+  ThreadedInt mProcessingNanoseconds;
+  // The last parallel evaluation this node was claimed by, and by which input
+  unsigned mParallelClaimIDThreaded;
+  int mParallelClaimIndexThreaded;
+  // Inputs being evaluated on the mix helper threads
+  Array<ParallelMixJob> mParallelJobsThreaded;
 
   // Must be implemented to provide the output of this sound node
   virtual bool GetOutputSamples(BufferType* outputBuffer,
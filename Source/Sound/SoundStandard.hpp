@@ -43,8 +43,11 @@ public:
 #include "VBAP.hpp"
 #include "PitchChange.hpp"
 #include "FileDecoder.hpp"
+#include "StreamDecoding.hpp"
 #include "VolumeModifier.hpp"
 #include "SoundAsset.hpp"
+#include "ParallelMix.hpp"
+#include "VoiceManager.hpp"
 #include "SoundNode.hpp"
 #include "SoundTag.hpp"
 #include "AudioMixer.hpp"
@@ -86,6 +86,8 @@ LightningDefineType(SoundSystem, builder, type)
   LightningBindGetter(PeakOutputLevel);
   LightningBindGetter(RMSOutputLevel);
   LightningBindGetter(PeakInputLevel);
+  LightningBindGetter(RealVoiceCount);
+  LightningBindGetter(VirtualVoiceCount);
   LightningBindMethod(GetNodeGraphInfo);
   LightningBindGetterSetter(LatencySetting);
   LightningBindGetterSetter(DispatchMicrophoneUncompressedFloatData);
@@ -214,6 +216,16 @@ float SoundSystem::GetPeakInputLevel()
   return Mixer.GetPeakInputVolume();
 }
 
+int SoundSystem::GetRealVoiceCount()
+{
+  return (int)Mixer.Voices.GetRealVoiceCount();
+}
+
+int SoundSystem::GetVirtualVoiceCount()
+{
+  return (int)Mixer.Voices.GetVirtualVoiceCount();
+}
+
 AudioLatency::Enum SoundSystem::GetLatencySetting()
 {
   return mLatency;
@@ -465,12 +477,14 @@ LightningDefineType(AudioSettings, builder, type)
   LightningBindGetterSetterProperty(Seed)->PlasmaFilterEquality(mUseRandomSeed, bool, false);
   LightningBindGetterSetterProperty(MixType);
   LightningBindGetterSetterProperty(MinVolumeThreshold)->Add(new EditorSlider(0.0f, 0.2f, 0.001f));
+  LightningBindGetterSetterProperty(MaxRealVoices);
   LightningBindGetterSetterProperty(LatencySetting);
 }
 
 AudioSettings::AudioSettings() :
     mSystemVolume(1.0f),
     mMinVolumeThreshold(0.015f),
+    mMaxRealVoices(0),
     mMixType(AudioMixTypes::AutoDetect),
     mLatency(AudioLatency::Low),
     mUseRandomSeed(true),
@@ -483,6 +497,7 @@ void AudioSettings::Serialize(Serializer& stream)
   SerializeNameDefault(mSystemVolume, 1.0f);
   SerializeEnumNameDefault(AudioMixTypes, mMixType, AudioMixTypes::AutoDetect);
   SerializeNameDefault(mMinVolumeThreshold, 0.015f);
+  SerializeNameDefault(mMaxRealVoices, 0u);
   SerializeEnumNameDefault(AudioLatency, mLatency, AudioLatency::Low);
   SerializeNameDefault(mUseRandomSeed, true);
   SerializeNameDefault(mSeed, 0u);
@@ -493,6 +508,7 @@ void AudioSettings::Initialize(CogInitializer& initializer)
   PL::gSound->Mixer.SetVolume(mSystemVolume);
   SetMixType(mMixType);
   PL::gSound->Mixer.SetMinimumVolumeThreshold(mMinVolumeThreshold);
+  PL::gSound->Mixer.SetMaxRealVoices(mMaxRealVoices);
   PL::gSound->SetLatencySetting(mLatency);
   PL::gSound->mUseRandomSeed = mUseRandomSeed;
   PL::gSound->mSeed = mSeed;
@@ -569,6 +585,17 @@ void AudioSettings::SetMinVolumeThreshold(float volume)
   PL::gSound->Mixer.SetMinimumVolumeThreshold(mMinVolumeThreshold);
 }
 
+uint AudioSettings::GetMaxRealVoices()
+{
+  return mMaxRealVoices;
+}
+
+void AudioSettings::SetMaxRealVoices(uint voices)
+{
+  mMaxRealVoices = voices;
+  PL::gSound->Mixer.SetMaxRealVoices(mMaxRealVoices);
+}
+
 Plasma::AudioLatency::Enum AudioSettings::GetLatencySetting()
 {
   return mLatency;
@@ -135,6 +135,11 @@ public:
   /// data, this value will be the highest peak volume in the last batch of
   /// input.
   float GetPeakInputLevel();
+  /// The number of SoundInstances which processed audio in the last mix.
+  int GetRealVoiceCount();
+  /// The number of SoundInstances which were virtual in the last mix (they kept
+  /// track of their position but did not process any audio).
+  int GetVirtualVoiceCount();
   /// Using the high latency setting can fix some audio problems (such as clicks
   /// and static) but can lead to a slight delay in the audio
   AudioLatency::Enum GetLatencySetting();
@@ -270,6 +275,11 @@ public:
   /// This is a floating point volume number, not decibels.
   float GetMinVolumeThreshold();
   void SetMinVolumeThreshold(float volume);
+  /// The maximum number of SoundInstances that will process audio at the same
+  /// time. When more are playing, the ones with the lowest Priority and volume
+  /// will be virtualized. If this value is 0 (the default) there is no limit.
+  uint GetMaxRealVoices();
+  void SetMaxRealVoices(uint voices);
   /// Using the high latency setting can fix some audio problems (such as clicks
   /// and static) but can lead to a slight delay in the audio
   AudioLatency::Enum GetLatencySetting();
@@ -285,6 +295,7 @@ public:
 private:
   float mSystemVolume;
   float mMinVolumeThreshold;
+  uint mMaxRealVoices;
   AudioMixTypes::Enum mMixType;
   AudioLatency::Enum mLatency;
   bool mUseRandomSeed;
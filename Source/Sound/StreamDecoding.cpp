@@ -0,0 +1,409 @@
+// MIT Licensed (see LICENSE.md).
+
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// Stream Reader
+
+StreamReader::StreamReader(unsigned channels) :
+    mStream(nullptr),
+    mBuffer(nullptr),
+    mBufferSize(0),
+    mChannels(channels),
+    mSamplesRead(0)
+{
+}
+
+StreamReader::~StreamReader()
+{
+  delete[] mBuffer;
+}
+
+void StreamReader::ReadSamplesThreaded(float* buffer, unsigned sampleIndex, unsigned samplesRequested)
+{
+  // If the instance moved past the samples that were read (because they weren't
+  // decoded in time, or it is starting from a later position) skip ahead
+  if (sampleIndex > mSamplesRead)
+    mSamplesRead += SkipSamplesThreaded(sampleIndex - mSamplesRead);
+
+  // If still not at the requested position, or trying to read samples that are
+  // already gone, there is nothing to copy
+  if (sampleIndex != mSamplesRead)
+  {
+    memset(buffer, 0, sizeof(float) * samplesRequested);
+    return;
+  }
+
+  unsigned samplesCopied = mSamples.Read(buffer, samplesRequested);
+  mSamplesRead += samplesCopied;
+
+  // Set any samples that weren't decoded yet to plasma
+  if (samplesCopied < samplesRequested)
+    memset(buffer + samplesCopied, 0, sizeof(float) * (samplesRequested - samplesCopied));
+}
+
+void StreamReader::Reset()
+{
+  mSamples.ResetBuffer();
+  mSamplesRead = 0;
+}
+
+void StreamReader::Reserve(unsigned frames)
+{
+  // The ring buffer size must be a power of 2
+  unsigned size = NextPowerOfTwo(frames * mChannels);
+  if (size <= mBufferSize)
+    return;
+
+  float* buffer = new float[size];
+  RingBuffer samples;
+  samples.Initialize(sizeof(float), size, buffer);
+
+  // Move over the samples that haven't been read (they all fit, since the new
+  // buffer is bigger)
+  float movedSamples[1024];
+  unsigned samplesMoved;
+  while ((samplesMoved = mSamples.Read(movedSamples, 1024)) != 0)
+    samples.Write(movedSamples, samplesMoved);
+
+  delete[] mBuffer;
+  mBuffer = buffer;
+  mBufferSize = size;
+  mSamples = samples;
+}
+
+unsigned StreamReader::SkipSamplesThreaded(unsigned samplesToSkip)
+{
+  float discardedSamples[1024];
+
+  unsigned samplesSkipped = 0;
+  while (samplesSkipped < samplesToSkip)
+  {
+    unsigned samplesRead = mSamples.Read(discardedSamples, Math::Min(samplesToSkip - samplesSkipped, 1024u));
+    if (samplesRead == 0)
+      break;
+
+    samplesSkipped += samplesRead;
+  }
+
+  return samplesSkipped;
+}
+
+// Decoded Stream
+
+static void StreamDecodingCallback(DecodedPacket* packet, void* data)
+{
+  ((DecodedStream*)data)->DecodingCallback(packet);
+}
+
+DecodedStream::DecodedStream(
+    Status& status, File* inputFile, ThreadLock* lock, unsigned channels, unsigned frames) :
+    mDecoder(status, inputFile, lock, channels, frames, StreamDecodingCallback, this),
+    mStarted(false),
+    mBusy(false),
+    mFinished(false)
+{
+}
+
+DecodedStream::DecodedStream(
+    Status& status, byte* inputData, unsigned dataSize, unsigned channels, unsigned frames) :
+    mDecoder(status, inputData, dataSize, channels, frames, StreamDecodingCallback, this),
+    mStarted(false),
+    mBusy(false),
+    mFinished(false)
+{
+}
+
+DecodedStream::DecodedStream(Status& status, DecodedStream& other) :
+    mDecoder(status, other.mDecoder, StreamDecodingCallback, this),
+    mStarted(true),
+    mBusy(false),
+    mFinished(other.mFinished)
+{
+}
+
+void DecodedStream::DecodingCallback(DecodedPacket* packet)
+{
+  // Readers without room were moved to their own streams before decoding, and
+  // readers only make more room, so the whole packet will fit
+  forRange (StreamReader* reader, mReaders.All())
+    reader->mSamples.Write(packet->mSamples.Data(), packet->mSamples.Size());
+}
+
+bool DecodedStream::NeedsDecoding()
+{
+  if (!mStarted || mFinished || mReaders.Empty())
+    return false;
+
+  // Readers that fall behind (because they are paused or playing at a lower
+  // pitch) don't hold back the others, see SplitFullReaders
+  unsigned packetSamples = AudioFileEncoder::cPacketFrames * mDecoder.mChannels;
+  forRange (StreamReader* reader, mReaders.All())
+  {
+    if (reader->mSamples.GetWriteAvailable() >= packetSamples)
+      return true;
+  }
+
+  return false;
+}
+
+// Stream Decoding Threads
+
+// Returns the number of frames a reader needs to hold so that a mix of the
+// specified size at the highest pitch can be read from it, with a packet to
+// spare for the decoding threads to refill
+static unsigned GetReaderFramesForMix(unsigned mixFrames)
+{
+  return (unsigned)(mixFrames * AudioConstants::cMaxPitchValue) + AudioFileEncoder::cPacketFrames;
+}
+
+StreamDecodingThreads::StreamDecodingThreads() :
+    mPendingSignals(0),
+    mShuttingDown(false),
+    mNextStream(0),
+    mReaderFrames(GetReaderFramesForMix(0))
+{
+}
+
+StreamDecodingThreads::~StreamDecodingThreads()
+{
+  ShutDown();
+}
+
+void StreamDecodingThreads::Start()
+{
+  if (!ThreadingEnabled || !mThreads.Empty())
+    return;
+
+  mShuttingDown.Store(false);
+
+  mThreads.Resize(cDecodingThreads);
+  for (uint i = 0; i < mThreads.Size(); ++i)
+  {
+    mThreads[i] = new Thread();
+    Thread& thread = *mThreads[i];
+    thread.Initialize(&Thread::ObjectEntryCreator<StreamDecodingThreads, &StreamDecodingThreads::DecodingLoopThreaded>,
+                      this,
+                      "Audio stream decoding");
+  }
+}
+
+void StreamDecodingThreads::ShutDown()
+{
+  if (mThreads.Empty())
+    return;
+
+  // Wake up every thread without giving it work
+  mShuttingDown.Store(true);
+  for (uint i = 0; i < mThreads.Size(); ++i)
+    mWorkSignal.Increment();
+
+  for (uint i = 0; i < mThreads.Size(); ++i)
+  {
+    Thread& thread = *mThreads[i];
+    thread.WaitForCompletion();
+    thread.Close();
+  }
+
+  DeleteObjectsInContainer(mThreads);
+}
+
+void StreamDecodingThreads::AddStreamThreaded(DecodedStream* stream)
+{
+  mLock.Lock();
+  mStreams.PushBack(stream);
+  mLock.Unlock();
+}
+
+void StreamDecodingThreads::AddReaderThreaded(DecodedStream* stream, StreamReader* reader)
+{
+  ErrorIf(stream->mStarted, "Adding a reader to a stream that already started decoding");
+
+  mLock.Lock();
+  stream->mReaders.PushBack(reader);
+  reader->mStream = stream;
+  mLock.Unlock();
+}
+
+DecodedStream* StreamDecodingThreads::RemoveReaderThreaded(StreamReader* reader)
+{
+  mLock.Lock();
+
+  // Wait for a decoding thread to finish with the reader's stream (this is
+  // never longer than decoding a single packet). The reader may be moved to
+  // its own stream in the meantime, so check its stream again after waiting.
+  while (reader->mStream && reader->mStream->mBusy)
+  {
+    mLock.Unlock();
+    Os::Sleep(0);
+    mLock.Lock();
+  }
+
+  DecodedStream* stream = reader->mStream;
+  if (!stream)
+  {
+    mLock.Unlock();
+    return nullptr;
+  }
+
+  stream->mReaders.EraseValue(reader);
+  reader->mStream = nullptr;
+  bool removeStream = stream->mReaders.Empty();
+  if (removeStream)
+    mStreams.EraseValue(stream);
+
+  mLock.Unlock();
+
+  if (!removeStream)
+    return nullptr;
+
+  delete stream;
+  return stream;
+}
+
+void StreamDecodingThreads::UpdateThreaded(unsigned mixFrames)
+{
+  mLock.Lock();
+
+  // Streams added since the last mix can't have any more readers added, since
+  // those would need to start from the beginning
+  forRange (DecodedStream* stream, mStreams.All())
+    stream->mStarted = true;
+
+  // If this mix was bigger than any before it, make room in every reader to
+  // read the next one at the highest pitch. Nothing reads from the readers
+  // between mixes, but each stream has to wait for a decoding thread to finish
+  // writing to it. Streams can be added while waiting, so they are indexed.
+  unsigned readerFrames = GetReaderFramesForMix(mixFrames);
+  if (readerFrames > mReaderFrames)
+  {
+    mReaderFrames = readerFrames;
+
+    for (uint i = 0; i < mStreams.Size(); ++i)
+    {
+      while (mStreams[i]->mBusy)
+      {
+        mLock.Unlock();
+        Os::Sleep(0);
+        mLock.Lock();
+      }
+
+      forRange (StreamReader* reader, mStreams[i]->mReaders.All())
+        reader->Reserve(mReaderFrames);
+    }
+  }
+
+  bool anyStreams = !mStreams.Empty();
+  mLock.Unlock();
+
+  if (!anyStreams)
+    return;
+
+  // If not threaded, decode here
+  if (!ThreadingEnabled)
+  {
+    DecodeStreamsThreaded();
+    return;
+  }
+
+  // Wake up any threads that aren't already going to look for work
+  while (mPendingSignals.Load() < (s32)mThreads.Size())
+  {
+    mPendingSignals.FetchAdd(1);
+    mWorkSignal.Increment();
+  }
+}
+
+unsigned StreamDecodingThreads::GetReaderFrames()
+{
+  return mReaderFrames;
+}
+
+OsInt StreamDecodingThreads::DecodingLoopThreaded()
+{
+  while (true)
+  {
+    mWorkSignal.WaitAndDecrement();
+    if (mShuttingDown.Load())
+      break;
+
+    mPendingSignals.FetchSubtract(1);
+    DecodeStreamsThreaded();
+  }
+
+  return 0;
+}
+
+void StreamDecodingThreads::DecodeStreamsThreaded()
+{
+  while (!mShuttingDown.Load())
+  {
+    mLock.Lock();
+    DecodedStream* stream = GetStreamToDecode();
+    mLock.Unlock();
+
+    if (!stream)
+      return;
+
+    // Decode outside of the lock so other threads can use other streams
+    bool decoding = stream->mDecoder.DecodeNextPacketThreaded();
+
+    mLock.Lock();
+    stream->mFinished = !decoding;
+    stream->mBusy = false;
+    mLock.Unlock();
+  }
+}
+
+DecodedStream* StreamDecodingThreads::GetStreamToDecode()
+{
+  unsigned streamCount = mStreams.Size();
+  for (unsigned i = 0; i < streamCount; ++i)
+  {
+    unsigned index = (mNextStream + i) % streamCount;
+    DecodedStream* stream = mStreams[index];
+    if (!stream->mBusy && stream->NeedsDecoding() && SplitFullReaders(stream))
+    {
+      mNextStream = index + 1;
+      stream->mBusy = true;
+      return stream;
+    }
+  }
+
+  return nullptr;
+}
+
+bool StreamDecodingThreads::SplitFullReaders(DecodedStream* stream)
+{
+  unsigned packetSamples = AudioFileEncoder::cPacketFrames * stream->mDecoder.mChannels;
+  for (uint i = 0; i < stream->mReaders.Size();)
+  {
+    StreamReader* reader = stream->mReaders[i];
+    if (reader->mSamples.GetWriteAvailable() >= packetSamples)
+    {
+      ++i;
+      continue;
+    }
+
+    // The reader has every sample the stream decoded so far, so a copy of the
+    // decoder continues exactly where it left off
+    Status status;
+    DecodedStream* splitStream = new DecodedStream(status, *stream);
+    if (status.Failed())
+    {
+      delete splitStream;
+      return false;
+    }
+
+    splitStream->mReaders.PushBack(reader);
+    reader->mStream = splitStream;
+    mStreams.PushBack(splitStream);
+    stream->mReaders.EraseAt(i);
+  }
+
+  return true;
+}
+
+} // namespace Plasma
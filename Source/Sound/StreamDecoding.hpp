@@ -0,0 +1,150 @@
+// MIT Licensed (see LICENSE.md).
+
+#pragma once
+
+namespace Plasma
+{
+
+class DecodedStream;
+
+// Stream Reader
+
+// Decoded audio from a stream, waiting to be read by one SoundInstance
+class StreamReader
+{
+public:
+  StreamReader(unsigned channels);
+  ~StreamReader();
+
+  // Copies the requested samples into the buffer, starting at the specified
+  // sample index from the beginning of the stream. Samples which are not
+  // decoded yet are set to plasma, and will be skipped when they are decoded.
+  void ReadSamplesThreaded(float* buffer, unsigned sampleIndex, unsigned samplesRequested);
+  // Clears the decoded samples and goes back to the beginning of the stream.
+  // Should only be called when nothing is writing to the reader.
+  void Reset();
+  // Makes sure the reader can hold at least the specified number of frames,
+  // keeping any samples that haven't been read. Should only be called when
+  // nothing is writing to the reader.
+  void Reserve(unsigned frames);
+
+  // Decoded samples, written by a decoding thread and read by the instance
+  RingBuffer mSamples;
+  // The stream decoding samples for this reader, or null if it isn't reading a
+  // stream (only changed while the StreamDecodingThreads are locked)
+  DecodedStream* mStream;
+
+private:
+  // Reads and discards the specified number of samples. Returns the number of
+  // samples that were available.
+  unsigned SkipSamplesThreaded(unsigned samplesToSkip);
+
+  // The memory used by the ring buffer
+  float* mBuffer;
+  // The number of samples the ring buffer can hold
+  unsigned mBufferSize;
+  // The number of channels in the stream
+  unsigned mChannels;
+  // The number of samples from the beginning of the stream that have been read
+  unsigned mSamplesRead;
+};
+
+// Decoded Stream
+
+// Decodes a streaming audio file once for all of its readers
+class DecodedStream
+{
+public:
+  // The file object must be already open, and will not be closed by this
+  // stream
+  DecodedStream(Status& status, File* inputFile, ThreadLock* lock, unsigned channels, unsigned frames);
+  // The input data buffer must already exist, and will not be deleted by this
+  // stream
+  DecodedStream(Status& status, byte* inputData, unsigned dataSize, unsigned channels, unsigned frames);
+  // Continues decoding from where the other stream is, without any readers
+  DecodedStream(Status& status, DecodedStream& other);
+
+  // Called by the decoder to pass off decoded samples
+  void DecodingCallback(DecodedPacket* packet);
+  // Returns true if any reader has room for another decoded packet
+  bool NeedsDecoding();
+
+  // The decoder object
+  StreamingDecoder mDecoder;
+  // The readers which get the decoded samples
+  Array<StreamReader*> mReaders;
+  // If false, more readers can still start at the beginning of the stream
+  bool mStarted;
+  // If true, a decoding thread is currently decoding this stream
+  bool mBusy;
+  // If true, the end of the stream has been decoded
+  bool mFinished;
+};
+
+// Stream Decoding Threads
+
+// Threads that decode streaming audio ahead of where it is being read, so the
+// mix thread never has to run the decoder. The mix thread wakes them up after
+// each mix to refill what was read.
+class StreamDecodingThreads
+{
+public:
+  StreamDecodingThreads();
+  ~StreamDecodingThreads();
+
+  // Starts the decoding threads. Does nothing if threading is disabled.
+  void Start();
+  // Stops all decoding threads and waits for them to finish
+  void ShutDown();
+  // Adds a stream which will start decoding after the current mix. Until then,
+  // more readers can be added to it.
+  void AddStreamThreaded(DecodedStream* stream);
+  // Adds a reader to a stream that hasn't started decoding
+  void AddReaderThreaded(DecodedStream* stream, StreamReader* reader);
+  // Removes the reader from its stream. If it was the last reader, the stream
+  // is deleted and returned (the pointer is only useful for comparing).
+  // Otherwise returns null.
+  DecodedStream* RemoveReaderThreaded(StreamReader* reader);
+  // Starts decoding any new streams and wakes up the decoding threads. Decodes
+  // on the calling thread if threading is disabled. The number of frames in
+  // the mix that just finished is used to size the readers.
+  void UpdateThreaded(unsigned mixFrames);
+  // Returns the number of frames a reader needs to hold to keep up with the
+  // largest mix so far at the highest pitch (only used on the mix thread)
+  unsigned GetReaderFrames();
+  // Looping function on each decoding thread
+  OsInt DecodingLoopThreaded();
+
+  // The number of decoding threads that will be started
+  static const unsigned cDecodingThreads = 2;
+
+private:
+  // Decodes packets until no streams need more
+  void DecodeStreamsThreaded();
+  // Returns a stream that needs decoding and marks it as busy, or null if there
+  // isn't one (must be called while locked)
+  DecodedStream* GetStreamToDecode();
+  // Moves each reader of the stream that doesn't have room for another packet
+  // to its own stream, so it doesn't hold back the others. Returns false if a
+  // new stream couldn't be created (must be called while locked).
+  bool SplitFullReaders(DecodedStream* stream);
+
+  // The decoding threads
+  Array<Thread*> mThreads;
+  // Incremented once for each decoding thread that should look for work
+  Semaphore mWorkSignal;
+  // The number of times the decoding threads were signaled and haven't woken up
+  Atomic<s32> mPendingSignals;
+  // Tells the decoding threads to stop
+  Atomic<bool> mShuttingDown;
+  // Used to lock when accessing the streams or their readers
+  ThreadLock mLock;
+  // All streams that have readers
+  Array<DecodedStream*> mStreams;
+  // Index of the stream to check first, so all streams are decoded evenly
+  unsigned mNextStream;
+  // The number of frames each reader can hold (only used on the mix thread)
+  unsigned mReaderFrames;
+};
+
+} // namespace Plasma
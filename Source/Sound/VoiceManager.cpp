@@ -0,0 +1,106 @@
+// MIT Licensed (see LICENSE.md).
+
+#include "Precompiled.hpp"
+
+namespace Plasma
+{
+
+// Voice Data
+
+VoiceData::VoiceData() : mInstance(nullptr), mPriority(0), mVolume(0.0f)
+{
+}
+
+// Higher priorities come first, and within the same priority louder volumes
+// come first
+bool CompareVoices(const VoiceData& left, const VoiceData& right)
+{
+  if (left.mPriority != right.mPriority)
+    return left.mPriority > right.mPriority;
+
+  return left.mVolume > right.mVolume;
+}
+
+// Voice Manager
+
+VoiceManager::VoiceManager() : mMaxRealVoicesThreaded(0), mRealVoiceCount(0), mVirtualVoiceCount(0)
+{
+}
+
+VoiceManager::~VoiceManager()
+{
+}
+
+void VoiceManager::AddVoiceThreaded(SoundInstance* instance)
+{
+  mVoicesThreaded.PushBack(instance);
+}
+
+void VoiceManager::ShutDown()
+{
+  mVoicesThreaded.Clear();
+  mRankedVoicesThreaded.Clear();
+}
+
+void VoiceManager::UpdateThreaded(const unsigned mixFrames)
+{
+  mRankedVoicesThreaded.Clear();
+
+  for (unsigned i = 0; i < mVoicesThreaded.Size();)
+  {
+    SoundInstance* instance = mVoicesThreaded[i];
+
+    // Remove instances which are finished (order doesn't matter, so swap the
+    // last one into this slot)
+    if (!instance || !instance->GetIsPlaying())
+    {
+      mVoicesThreaded[i] = mVoicesThreaded.Back();
+      mVoicesThreaded.PopBack();
+      continue;
+    }
+
+    ++i;
+
+    // Paused instances don't process audio, so they don't need a voice
+    if (instance->GetPaused())
+      continue;
+
+    VoiceData& data = mRankedVoicesThreaded.PushBack();
+    data.mInstance = instance;
+    data.mPriority = instance->GetPriority();
+    data.mVolume = instance->GetEstimatedVolumeThreaded(mixFrames);
+  }
+
+  Sort(mRankedVoicesThreaded.All(), CompareVoices);
+
+  float threshold = PL::gSound->Mixer.mMinimumVolumeThresholdThreaded;
+  unsigned realVoices = 0;
+
+  forRange (VoiceData& data, mRankedVoicesThreaded.All())
+  {
+    // Instances which can't be heard are virtualized immediately. Instances
+    // which are audible but don't fit in the budget fade out first.
+    bool audible = data.mVolume >= threshold;
+    bool real = audible && (mMaxRealVoicesThreaded == 0 || realVoices < mMaxRealVoicesThreaded);
+
+    if (real)
+      ++realVoices;
+
+    data.mInstance->SetVirtualThreaded(!real, audible);
+  }
+
+  mRealVoiceCount.Set((int)realVoices);
+  mVirtualVoiceCount.Set((int)(mRankedVoicesThreaded.Size() - realVoices));
+}
+
+unsigned VoiceManager::GetRealVoiceCount()
+{
+  return (unsigned)mRealVoiceCount.Get();
+}
+
+unsigned VoiceManager::GetVirtualVoiceCount()
+{
+  return (unsigned)mVirtualVoiceCount.Get();
+}
+
+} // namespace Plasma
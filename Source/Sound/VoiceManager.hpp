@@ -0,0 +1,66 @@
+// MIT Licensed (see LICENSE.md).
+
+#pragma once
+
+namespace Plasma
+{
+
+class SoundInstance;
+
+// Voice Data
+
+// Information used to rank a playing SoundInstance
+class VoiceData
+{
+public:
+  VoiceData();
+
+  // The instance being ranked
+  SoundInstance* mInstance;
+  // The instance's priority
+  int mPriority;
+  // The estimated volume of the instance over the current mix
+  float mVolume;
+};
+
+// Voice Manager
+
+// Decides which SoundInstances process audio. Before every mix, all playing
+// instances are ranked by priority and then by their estimated volume after
+// attenuation. Instances which are too quiet to be heard, or which don't fit in
+// the real voice budget, become virtual: they keep track of their playback
+// position without processing any audio, and start processing again when they
+// are ranked high enough.
+class VoiceManager
+{
+public:
+  VoiceManager();
+  ~VoiceManager();
+
+  // Adds a SoundInstance to be managed. Finished instances are removed automatically.
+  void AddVoiceThreaded(SoundInstance* instance);
+  // Releases all instances
+  void ShutDown();
+  // Ranks all instances and sets which ones are virtual for the upcoming mix
+  void UpdateThreaded(const unsigned mixFrames);
+  // Returns the number of instances which processed audio in the last mix
+  unsigned GetRealVoiceCount();
+  // Returns the number of instances which were virtual in the last mix
+  unsigned GetVirtualVoiceCount();
+
+  // The maximum number of instances that will process audio at once. If plasma,
+  // there is no limit and only the volume threshold is used.
+  unsigned mMaxRealVoicesThreaded;
+
+private:
+  // All playing instances
+  Array<HandleOf<SoundInstance>> mVoicesThreaded;
+  // Instances in the order they are ranked for the current mix
+  Array<VoiceData> mRankedVoicesThreaded;
+  // Number of real instances in the last mix
+  ThreadedInt mRealVoiceCount;
+  // Number of virtual instances in the last mix
+  ThreadedInt mVirtualVoiceCount;
+};
+
+} // namespace Plasma
@@ -48,6 +48,26 @@ void InstanceVolumeModifier::ApplyVolume(float* sampleBuffer,
   }
 }
 
+void InstanceVolumeModifier::SkipForward(const unsigned frames)
+{
+  if (!Active)
+    return;
+
+  // Counts the same as a call to ApplyVolume
+  ++mLifetimeFrameCounter;
+  if (mLifetimeFrames > 0 && mLifetimeFrameCounter > mLifetimeFrames)
+  {
+    Active = false;
+    return;
+  }
+
+  if (!Interpolator.Finished())
+  {
+    Interpolator.JumpForward(frames);
+    mCurrentVolume = Interpolator.GetCurrentValue();
+  }
+}
+
 void InstanceVolumeModifier::Reset(const float startVolume,
                                    const float endVolume,
                                    const float time,
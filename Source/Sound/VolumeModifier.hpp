@@ -16,6 +16,8 @@ public:
 
   // Applies this modification to a buffer of samples.
   void ApplyVolume(float* sampleBuffer, const unsigned bufferSize, const unsigned channels);
+  // Moves forward by the specified number of frames without modifying any audio
+  void SkipForward(const unsigned frames);
   // Resets the modifier with new volume and time data.
   void Reset(const float startVolume, const float endVolume, const float changeTime, const float lifetime);
   void